@@ -0,0 +1,115 @@
+//  Echo servers over loopback TCP: one server DEALER per client, driven
+//  either by coroutines on a single zlink::executor_t thread or by one
+//  blocking thread per socket. A client thread sends one message on every
+//  client per round and then collects all the echoes.
+//
+//  Needs C++20, e.g. from the repository root:
+//    c++ -O3 -std=c++20 -Icore/include -Ibindings/cpp/include
+//      bindings/cpp/benchwithzlink/bench_coroutine_echo.cpp -lzlink
+//
+//  Usage: bench_coroutine_echo [coroutine|thread] [sockets] [rounds] [size]
+
+#include <zlink.hpp>
+#include <zlink_coro.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static zlink::task_t echo(zlink::executor_t &executor, zlink::socket_t &socket, int rounds)
+{
+    zlink::async_socket_t async(executor, socket);
+    for (int i = 0; i < rounds; ++i) {
+        zlink::message_t msg;
+        if (co_await async.recv(msg) < 0 || co_await async.send(msg) < 0)
+            co_return;
+    }
+}
+
+static void echo_blocking(zlink::socket_t &socket, int rounds)
+{
+    for (int i = 0; i < rounds; ++i) {
+        zlink::message_t msg;
+        if (socket.recv(msg) < 0 || socket.send(msg) < 0)
+            return;
+    }
+}
+
+static std::string bound_endpoint(zlink::socket_t &socket)
+{
+    char buf[256];
+    size_t size = sizeof(buf);
+    if (socket.get(zlink::socket_option::last_endpoint, buf, &size) != 0)
+        return std::string();
+    return std::string(buf);
+}
+
+int main(int argc, char **argv)
+{
+    const std::string mode = argc > 1 ? argv[1] : "coroutine";
+    const int sockets = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int rounds = argc > 3 ? std::atoi(argv[3]) : 2000;
+    const size_t size = argc > 4 ? static_cast<size_t>(std::atoi(argv[4])) : 64;
+
+    zlink::context_t ctx;
+    ctx.set(zlink::context_option::max_sockets, 2 * sockets + 16);
+
+    std::vector<std::unique_ptr<zlink::socket_t> > servers;
+    std::vector<std::unique_ptr<zlink::socket_t> > clients;
+    for (int i = 0; i < sockets; ++i) {
+        servers.emplace_back(new zlink::socket_t(ctx, zlink::socket_type::dealer));
+        clients.emplace_back(new zlink::socket_t(ctx, zlink::socket_type::dealer));
+        if (servers.back()->bind("tcp://127.0.0.1:*") != 0
+            || clients.back()->connect(bound_endpoint(*servers.back())) != 0)
+            return 2;
+    }
+
+    //  Rounds plus one for the warm-up.
+    std::vector<std::thread> threads;
+    zlink::executor_t executor;
+    if (mode == "thread") {
+        for (int i = 0; i < sockets; ++i)
+            threads.emplace_back(echo_blocking, std::ref(*servers[i]), rounds + 1);
+    } else {
+        for (int i = 0; i < sockets; ++i)
+            executor.spawn(echo(executor, *servers[i], rounds + 1));
+        threads.emplace_back([&executor]() { executor.run(); });
+    }
+
+    std::vector<char> buf(size, 'a');
+    std::vector<char> rbuf(size);
+    auto round = [&]() {
+        for (int i = 0; i < sockets; ++i)
+            if (clients[i]->send(buf.data(), size) < 0)
+                return false;
+        for (int i = 0; i < sockets; ++i)
+            if (clients[i]->recv(rbuf.data(), size) < 0)
+                return false;
+        return true;
+    };
+
+    if (!round())
+        return 2;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r)
+        if (!round())
+            return 2;
+    const double seconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - t0)
+                             .count()
+                           / 1e9;
+
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+
+    std::cout << "RESULT,current,COROUTINE_ECHO," << mode << "," << size
+              << ",throughput," << static_cast<double>(rounds) * sockets / seconds
+              << "\n";
+    std::cout << "RESULT,current,COROUTINE_ECHO," << mode << "," << size
+              << ",latency," << seconds * 1e6 / rounds << "\n";
+    return 0;
+}
@@ -0,0 +1,502 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+#ifndef ZLINK_CORO_HPP_INCLUDED
+#define ZLINK_CORO_HPP_INCLUDED
+
+//  C++20 coroutine support for the C++ binding. An executor_t runs
+//  coroutines on the calling thread and sleeps on the sockets' ZLINK_FD
+//  descriptors (epoll on Linux, zlink_poll elsewhere) while all of them
+//  wait; async_socket_t turns send and recv into awaitables:
+//
+//      zlink::task_t echo (zlink::executor_t &executor_, zlink::socket_t &s_)
+//      {
+//          zlink::async_socket_t socket (executor_, s_);
+//          zlink::message_t msg;
+//          while (co_await socket.recv (msg) >= 0)
+//              co_await socket.send (msg);
+//      }
+//
+//      executor.spawn (echo (executor, socket));
+//      executor.run ();
+
+#include "zlink.hpp"
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#error "zlink_coro.hpp requires C++20 coroutines"
+#endif
+
+#include <cerrno>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+namespace zlink
+{
+class executor_t;
+
+//  Coroutine type started by executor_t::spawn. It runs detached: its frame
+//  is freed once it returns. An exception escaping it terminates the
+//  program.
+class task_t
+{
+  public:
+    struct promise_type
+    {
+        promise_type () : executor (NULL) {}
+        ~promise_type ();
+
+        task_t get_return_object ()
+        {
+            return task_t (
+              std::coroutine_handle<promise_type>::from_promise (*this));
+        }
+        std::suspend_always initial_suspend () noexcept { return {}; }
+        std::suspend_never final_suspend () noexcept { return {}; }
+        void return_void () noexcept {}
+        void unhandled_exception () noexcept { std::terminate (); }
+
+        executor_t *executor;
+    };
+
+    ~task_t ()
+    {
+        if (_handle)
+            _handle.destroy ();
+    }
+
+    task_t (task_t &&other) noexcept : _handle (other._handle)
+    {
+        other._handle = nullptr;
+    }
+
+    task_t &operator= (task_t &&other) noexcept
+    {
+        if (this == &other)
+            return *this;
+        if (_handle)
+            _handle.destroy ();
+        _handle = other._handle;
+        other._handle = nullptr;
+        return *this;
+    }
+
+    task_t (const task_t &) = delete;
+    task_t &operator= (const task_t &) = delete;
+
+  private:
+    friend class executor_t;
+
+    explicit task_t (std::coroutine_handle<promise_type> handle_) :
+        _handle (handle_)
+    {
+    }
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+//  Single-threaded executor. Sockets it drives must only be used through
+//  async_socket_t while any of its coroutines is suspended, as operations
+//  done elsewhere consume the ZLINK_FD notifications the executor waits
+//  for.
+class executor_t
+{
+  public:
+    executor_t () : _tasks (0), _stopped (false)
+    {
+#if defined(__linux__)
+        _epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+#endif
+    }
+
+    //  Coroutines still suspended are destroyed.
+    ~executor_t ()
+    {
+        std::vector<std::coroutine_handle<> > handles (_ready.begin (),
+                                                        _ready.end ());
+        _ready.clear ();
+        for (entries_t::iterator it = _entries.begin (); it != _entries.end ();
+             ++it) {
+            if (it->second.in)
+                handles.push_back (it->second.in->handle);
+            if (it->second.out)
+                handles.push_back (it->second.out->handle);
+            it->second.in = NULL;
+            it->second.out = NULL;
+        }
+        for (size_t i = 0; i < handles.size (); ++i)
+            handles[i].destroy ();
+#if defined(__linux__)
+        if (_epoll_fd != -1)
+            ::close (_epoll_fd);
+#endif
+    }
+
+    executor_t (const executor_t &) = delete;
+    executor_t &operator= (const executor_t &) = delete;
+
+    //  Starts the coroutine on the next run ().
+    void spawn (task_t task_)
+    {
+        task_._handle.promise ().executor = this;
+        _tasks++;
+        _ready.push_back (task_._handle);
+        task_._handle = nullptr;
+    }
+
+    //  Runs the spawned coroutines until all of them have returned or
+    //  stop () is called. Returns 0, or -1 if waiting for the sockets
+    //  failed.
+    int run ()
+    {
+        _stopped = false;
+        while (_tasks > 0 && !_stopped) {
+            if (!_ready.empty ()) {
+                const std::coroutine_handle<> handle = _ready.front ();
+                _ready.pop_front ();
+                handle.resume ();
+                continue;
+            }
+            if (!_dirty.empty ()) {
+                check_dirty ();
+                continue;
+            }
+            if (wait_fds () == -1)
+                return -1;
+        }
+        return 0;
+    }
+
+    //  Makes run () return once the running coroutine suspends.
+    void stop () noexcept { _stopped = true; }
+
+    //  An operation suspended until its socket is ready. try_complete ()
+    //  attempts it without blocking and returns false if it would block.
+    struct waiter_t
+    {
+        virtual bool try_complete () = 0;
+
+        short events;
+        std::coroutine_handle<> handle;
+
+      protected:
+        ~waiter_t () {}
+    };
+
+    //  Suspends waiter_ until its operation has completed. There may be one
+    //  waiter for ZLINK_POLLIN and one for ZLINK_POLLOUT per socket; a
+    //  second one fails with EBUSY.
+    int wait (void *socket_, waiter_t *waiter_)
+    {
+        entries_t::iterator it = _entries.find (socket_);
+        if (it == _entries.end ()) {
+            entry_t entry;
+            size_t fd_size = sizeof (entry.fd);
+            if (zlink_getsockopt (socket_, ZLINK_FD, &entry.fd, &fd_size) != 0)
+                return -1;
+#if defined(__linux__)
+            epoll_event event;
+            event.events = EPOLLIN;
+            event.data.ptr = socket_;
+            if (epoll_ctl (_epoll_fd, EPOLL_CTL_ADD, entry.fd, &event) != 0)
+                return -1;
+#endif
+            it = _entries.insert (entries_t::value_type (socket_, entry)).first;
+        }
+
+        waiter_t *&slot = waiter_->events == ZLINK_POLLIN ? it->second.in
+                                                          : it->second.out;
+        if (slot) {
+            errno = EBUSY;
+            return -1;
+        }
+        slot = waiter_;
+
+        //  The notification for what the waiter waits for may already
+        //  have been consumed.
+        mark_dirty (it);
+        return 0;
+    }
+
+    //  Called after an operation on the socket, which may have consumed a
+    //  notification another waiter of the socket is waiting for.
+    void touch (void *socket_)
+    {
+        entries_t::iterator it = _entries.find (socket_);
+        if (it != _entries.end ())
+            mark_dirty (it);
+    }
+
+    //  Stops watching the socket, which must have no waiters left.
+    void forget (void *socket_)
+    {
+        entries_t::iterator it = _entries.find (socket_);
+        if (it == _entries.end ())
+            return;
+#if defined(__linux__)
+        epoll_ctl (_epoll_fd, EPOLL_CTL_DEL, it->second.fd, NULL);
+#endif
+        _entries.erase (it);
+        for (size_t i = 0; i < _dirty.size (); ++i)
+            if (_dirty[i] == socket_)
+                _dirty[i] = NULL;
+    }
+
+  private:
+    friend struct task_t::promise_type;
+
+    struct entry_t
+    {
+        entry_t () : fd (0), in (NULL), out (NULL), dirty (false) {}
+
+        zlink_fd_t fd;
+        waiter_t *in;
+        waiter_t *out;
+
+        //  Is the socket queued for an event check?
+        bool dirty;
+    };
+    typedef std::unordered_map<void *, entry_t> entries_t;
+
+    void mark_dirty (entries_t::iterator it_)
+    {
+        if (!it_->second.dirty) {
+            it_->second.dirty = true;
+            _dirty.push_back (it_->first);
+        }
+    }
+
+    //  Queries ZLINK_EVENTS of the sockets marked dirty and completes
+    //  their waiters where possible.
+    void check_dirty ()
+    {
+        std::vector<void *> dirty;
+        dirty.swap (_dirty);
+        for (size_t i = 0; i < dirty.size (); ++i) {
+            if (!dirty[i])
+                continue;
+            entries_t::iterator it = _entries.find (dirty[i]);
+            if (it == _entries.end ())
+                continue;
+            entry_t &entry = it->second;
+            entry.dirty = false;
+
+            //  Reading the events also drains ZLINK_FD. On failure the
+            //  waiters run into the error themselves.
+            int events = ZLINK_POLLIN | ZLINK_POLLOUT;
+            size_t events_size = sizeof (events);
+            zlink_getsockopt (it->first, ZLINK_EVENTS, &events, &events_size);
+
+            bool completed = false;
+            if (entry.in && (events & ZLINK_POLLIN)
+                && entry.in->try_complete ()) {
+                _ready.push_back (entry.in->handle);
+                entry.in = NULL;
+                completed = true;
+            }
+            if (entry.out && (events & ZLINK_POLLOUT)
+                && entry.out->try_complete ()) {
+                _ready.push_back (entry.out->handle);
+                entry.out = NULL;
+                completed = true;
+            }
+            if (completed)
+                mark_dirty (it);
+        }
+    }
+
+    //  Blocks until a watched ZLINK_FD becomes readable and marks its
+    //  socket dirty.
+    int wait_fds ()
+    {
+#if defined(__linux__)
+        epoll_event events[64];
+        int rc;
+        do
+            rc = epoll_wait (_epoll_fd, events, 64, -1);
+        while (rc == -1 && errno == EINTR);
+        if (rc == -1)
+            return -1;
+        for (int i = 0; i < rc; ++i)
+            touch (events[i].data.ptr);
+#else
+        std::vector<zlink_pollitem_t> items;
+        std::vector<void *> sockets;
+        for (entries_t::iterator it = _entries.begin (); it != _entries.end ();
+             ++it) {
+            const zlink_pollitem_t item = {NULL, it->second.fd, ZLINK_POLLIN,
+                                           0};
+            items.push_back (item);
+            sockets.push_back (it->first);
+        }
+        int rc;
+        do
+            rc = zlink_poll (items.empty () ? NULL : &items[0],
+                             static_cast<int> (items.size ()), -1);
+        while (rc == -1 && zlink_errno () == EINTR);
+        if (rc == -1)
+            return -1;
+        for (size_t i = 0; i < items.size (); ++i)
+            if (items[i].revents)
+                touch (sockets[i]);
+#endif
+        return 0;
+    }
+
+    entries_t _entries;
+    std::vector<void *> _dirty;
+    std::deque<std::coroutine_handle<> > _ready;
+
+    //  Spawned coroutines that have not returned yet.
+    size_t _tasks;
+    bool _stopped;
+
+#if defined(__linux__)
+    int _epoll_fd;
+#endif
+};
+
+inline task_t::promise_type::~promise_type ()
+{
+    if (executor)
+        executor->_tasks--;
+}
+
+//  Awaitable send and receive on a socket driven by an executor_t. An
+//  operation that can be done right away completes without suspending.
+class async_socket_t
+{
+  public:
+    async_socket_t (executor_t &executor_, socket_t &socket_) :
+        _executor (executor_), _socket (socket_)
+    {
+    }
+
+    ~async_socket_t () { _executor.forget (_socket.handle ()); }
+
+    async_socket_t (const async_socket_t &) = delete;
+    async_socket_t &operator= (const async_socket_t &) = delete;
+
+    class recv_awaiter_t;
+    class send_awaiter_t;
+
+    //  Receives the next message part into msg_. The co_await yields the
+    //  size of the part, or -1 with zlink_errno () set.
+    recv_awaiter_t recv (message_t &msg_)
+    {
+        return recv_awaiter_t (*this, msg_);
+    }
+
+    //  Sends msg_, which is emptied on success. The co_await yields the
+    //  size sent, or -1 with zlink_errno () set.
+    send_awaiter_t send (message_t &msg_, send_flag flags_ = send_flag::none)
+    {
+        return send_awaiter_t (*this, msg_, flags_);
+    }
+
+    socket_t &socket () noexcept { return _socket; }
+
+  private:
+    //  Common part of the awaiters: completing the operation, suspending
+    //  on the executor if it would block and restoring errno on resume.
+    class awaiter_base_t : public executor_t::waiter_t
+    {
+      public:
+        bool await_ready ()
+        {
+            return try_complete ();
+        }
+
+        bool await_suspend (std::coroutine_handle<> handle_)
+        {
+            handle = handle_;
+            if (_owner._executor.wait (_owner._socket.handle (), this) == 0)
+                return true;
+            _rc = -1;
+            _errno = errno;
+            return false;
+        }
+
+        int await_resume ()
+        {
+            if (_rc >= 0)
+                _owner._executor.touch (_owner._socket.handle ());
+            else
+                errno = _errno;
+            return _rc;
+        }
+
+        bool try_complete () override
+        {
+            _rc = attempt ();
+            if (_rc >= 0)
+                return true;
+            _errno = zlink_errno ();
+            return _errno != EAGAIN;
+        }
+
+      protected:
+        awaiter_base_t (async_socket_t &owner_, short events_) :
+            _owner (owner_), _rc (-1), _errno (0)
+        {
+            events = events_;
+        }
+
+        virtual int attempt () = 0;
+
+        async_socket_t &_owner;
+        int _rc;
+        int _errno;
+    };
+
+  public:
+    class recv_awaiter_t : public awaiter_base_t
+    {
+      public:
+        recv_awaiter_t (async_socket_t &owner_, message_t &msg_) :
+            awaiter_base_t (owner_, ZLINK_POLLIN), _msg (msg_)
+        {
+        }
+
+      private:
+        int attempt ()
+        {
+            return _owner._socket.recv (_msg, recv_flag::dontwait);
+        }
+
+        message_t &_msg;
+    };
+
+    class send_awaiter_t : public awaiter_base_t
+    {
+      public:
+        send_awaiter_t (async_socket_t &owner_,
+                        message_t &msg_,
+                        send_flag flags_) :
+            awaiter_base_t (owner_, ZLINK_POLLOUT), _msg (msg_), _flags (flags_)
+        {
+        }
+
+      private:
+        int attempt ()
+        {
+            return _owner._socket.send (_msg, _flags | send_flag::dontwait);
+        }
+
+        message_t &_msg;
+        send_flag _flags;
+    };
+
+  private:
+    executor_t &_executor;
+    socket_t &_socket;
+};
+
+} // namespace zlink
+
+#endif
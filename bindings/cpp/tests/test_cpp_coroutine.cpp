@@ -0,0 +1,127 @@
+#include "test_helpers.hpp"
+
+#include <zlink_coro.hpp>
+
+#include <cstring>
+
+static const int message_count = 1000;
+
+static zlink::task_t echo(zlink::executor_t &executor, zlink::socket_t &socket, int *echoed)
+{
+    zlink::async_socket_t async(executor, socket);
+    for (int i = 0; i < message_count; ++i) {
+        zlink::message_t msg;
+        if (co_await async.recv(msg) < 0)
+            co_return;
+        if (co_await async.send(msg) < 0)
+            co_return;
+        ++*echoed;
+    }
+}
+
+static zlink::task_t produce(zlink::async_socket_t &async)
+{
+    for (int i = 0; i < message_count; ++i) {
+        zlink::message_t msg(sizeof(i));
+        std::memcpy(msg.data(), &i, sizeof(i));
+        if (co_await async.send(msg) < 0)
+            co_return;
+    }
+}
+
+static zlink::task_t consume(zlink::async_socket_t &async, int *received)
+{
+    for (int i = 0; i < message_count; ++i) {
+        zlink::message_t msg;
+        if (co_await async.recv(msg) != static_cast<int>(sizeof(i)))
+            co_return;
+        int value;
+        std::memcpy(&value, msg.data(), sizeof(value));
+        if (value != i)
+            co_return;
+        ++*received;
+    }
+}
+
+static zlink::task_t recv_one(zlink::async_socket_t &async, int *rc, int *error)
+{
+    zlink::message_t msg;
+    *rc = co_await async.recv(msg);
+    *error = zlink_errno();
+}
+
+static zlink::task_t send_one(zlink::socket_t &socket)
+{
+    assert(socket.send("x", 1) == 1);
+    co_return;
+}
+
+static void test_echo(zlink::context_t &ctx, const transport_case_t &tc)
+{
+    zlink::socket_t server(ctx, zlink::socket_type::dealer);
+    zlink::socket_t client(ctx, zlink::socket_type::dealer);
+
+    //  Small queues so that senders have to wait for room as well.
+    const int hwm = 10;
+    assert(server.set(zlink::socket_option::sndhwm, hwm) == 0);
+    assert(server.set(zlink::socket_option::rcvhwm, hwm) == 0);
+    assert(client.set(zlink::socket_option::sndhwm, hwm) == 0);
+    assert(client.set(zlink::socket_option::rcvhwm, hwm) == 0);
+
+    std::string endpoint = endpoint_for(tc, "coroutine");
+    assert(server.bind(endpoint) == 0);
+    if (tc.name != "inproc")
+        endpoint = bound_endpoint(server);
+    assert(client.connect(endpoint) == 0);
+
+    int echoed = 0;
+    int received = 0;
+    zlink::executor_t executor;
+    {
+        //  One socket with a sending and a receiving coroutine.
+        zlink::async_socket_t async_client(executor, client);
+        executor.spawn(echo(executor, server, &echoed));
+        executor.spawn(produce(async_client));
+        executor.spawn(consume(async_client, &received));
+        assert(executor.run() == 0);
+    }
+    assert(echoed == message_count);
+    assert(received == message_count);
+}
+
+static void test_busy(zlink::context_t &ctx)
+{
+    zlink::socket_t server(ctx, zlink::socket_type::pair);
+    zlink::socket_t client(ctx, zlink::socket_type::pair);
+    const std::string endpoint = unique_inproc("inproc://cpp-", "coroutine-busy");
+    assert(server.bind(endpoint) == 0);
+    assert(client.connect(endpoint) == 0);
+
+    zlink::executor_t executor;
+    zlink::async_socket_t async(executor, server);
+    int first_rc = 0, first_error = 0;
+    int second_rc = 0, second_error = 0;
+    executor.spawn(recv_one(async, &first_rc, &first_error));
+    executor.spawn(recv_one(async, &second_rc, &second_error));
+    executor.spawn(send_one(client));
+    assert(executor.run() == 0);
+
+    //  Only one receive may wait per socket.
+    assert(first_rc == 1);
+    assert(second_rc == -1);
+    assert(second_error == EBUSY);
+}
+
+int main()
+{
+    zlink::context_t ctx;
+
+    const std::vector<transport_case_t> cases = transport_cases();
+    for (size_t i = 0; i < cases.size(); ++i) {
+        if (transport_supported(cases[i]))
+            test_echo(ctx, cases[i]);
+    }
+    test_busy(ctx);
+
+    return 0;
+}
@@ -22,10 +22,21 @@ void run_multi_pubsub(const std::string& transport,
     if (!ctx.valid())
         return;
 
+    // BENCH_IO_THREADS and BENCH_PUB_SHARDS trace the fan-out scaling
+    // curve: the publisher spreads its writes over up to BENCH_PUB_SHARDS
+    // I/O threads (ZLINK_XPUB_SHARDS, -1 for all of them).
+    const int io_threads = resolve_multi_int_env("BENCH_IO_THREADS", 0, 0);
+    if (io_threads > 0)
+        zlink_ctx_set(ctx.get(), ZLINK_IO_THREADS, io_threads);
+
     void *pub = zlink_socket(ctx.get(), ZLINK_PUB);
     if (!pub)
         return;
 
+    const int pub_shards = resolve_multi_int_env("BENCH_PUB_SHARDS", 0, -1);
+    if (pub_shards != 0)
+        set_sockopt_int(pub, ZLINK_XPUB_SHARDS, pub_shards, "ZLINK_XPUB_SHARDS");
+
     std::vector<void *> subs(settings.clients, NULL);
     for (size_t i = 0; i < subs.size(); ++i) {
         subs[i] = zlink_socket(ctx.get(), ZLINK_SUB);
@@ -177,11 +177,20 @@ ZLINK_EXPORT void zlink_version (int *major_, int *minor_, int *patch_);
 #define ZLINK_THREAD_AFFINITY_CPU_ADD 7
 #define ZLINK_THREAD_AFFINITY_CPU_REMOVE 8
 #define ZLINK_THREAD_NAME_PREFIX 9
+#define ZLINK_CHUNK_POOL_SIZE 10
+#define ZLINK_CHUNK_POOL_HITS 11
+#define ZLINK_CHUNK_POOL_MISSES 12
+#define ZLINK_CHUNK_POOL_DROPS 13
+#define ZLINK_CHUNK_POOL_CACHED 14
+#define ZLINK_NUMA_AWARE 15
+#define ZLINK_MAILBOX_COMMANDS 16
+#define ZLINK_MAILBOX_WAKEUPS 17
 
 #define ZLINK_IO_THREADS_DFLT 2
 #define ZLINK_MAX_SOCKETS_DFLT 1023
 #define ZLINK_THREAD_PRIORITY_DFLT -1
 #define ZLINK_THREAD_SCHED_POLICY_DFLT -1
+#define ZLINK_CHUNK_POOL_SIZE_DFLT 64
 
 /**
  * @brief Create a new zlink context.
@@ -378,6 +387,32 @@ ZLINK_EXPORT const char *zlink_msg_gets (const zlink_msg_t *msg_,
 #define ZLINK_ONLY_FIRST_SUBSCRIBE 108
 #define ZLINK_TOPICS_COUNT 116
 #define ZLINK_ZMP_METADATA 117
+#define ZLINK_TCP_ACCEPT_SHARDS 118
+#define ZLINK_TCP_ACCEPT_CPU_AFFINITY 119
+#define ZLINK_COALESCE_DELAY 120
+#define ZLINK_WS_DEFLATE 121
+#define ZLINK_WS_DEFLATE_SERVER_WINDOW_BITS 122
+#define ZLINK_WS_DEFLATE_CLIENT_WINDOW_BITS 123
+#define ZLINK_WS_DEFLATE_THRESHOLD 124
+#define ZLINK_LOW_MEMORY 125
+#define ZLINK_LOW_MEMORY_IDLE_IVL 126
+#define ZLINK_NUMA_NODE 127
+#define ZLINK_XPUB_TOPIC_CACHE 128
+#define ZLINK_XPUB_TOPIC_CACHE_HITS 129
+#define ZLINK_XPUB_TOPIC_CACHE_MISSES 130
+#define ZLINK_TOPIC_DELIMITER 131
+#define ZLINK_XPUB_LAST_VALUE_CACHE 132
+#define ZLINK_XPUB_LAST_VALUE_CACHE_SIZE 133
+#define ZLINK_XPUB_CONFLATE 134
+#define ZLINK_XPUB_CONFLATED 135
+#define ZLINK_XPUB_SLOW_POLICY 136
+#define ZLINK_XPUB_SLOW_LIMIT 137
+#define ZLINK_SUBSCRIBE_BULK 138
+#define ZLINK_UNSUBSCRIBE_BULK 139
+#define ZLINK_BLOOM_FILTER 140
+#define ZLINK_BLOOM_REJECTED 141
+#define ZLINK_BLOOM_FALSE_POSITIVES 142
+#define ZLINK_XPUB_SHARDS 143
 
 //  TLS protocol options
 #define ZLINK_TLS_CERT 95
@@ -398,6 +433,12 @@ ZLINK_EXPORT const char *zlink_msg_gets (const zlink_msg_t *msg_,
 #define ZLINK_NULL 0
 #define ZLINK_PLAIN 1
 
+//  ZLINK_XPUB_SLOW_POLICY values
+#define ZLINK_XPUB_DROP_NEWEST 0
+#define ZLINK_XPUB_DROP_OLDEST 1
+#define ZLINK_XPUB_SPILL 2
+#define ZLINK_XPUB_DISCONNECT 3
+
 /******************************************************************************/
 /*  0MQ socket events and monitoring                                          */
 /******************************************************************************/
@@ -539,6 +580,8 @@ typedef struct {
     uint64_t connected_time;
     uint64_t msgs_sent;
     uint64_t msgs_received;
+    uint64_t msgs_dropped;
+    uint64_t lag;
 } zlink_peer_info_t;
 
 /** @brief Get peer info by routing_id. */
@@ -562,6 +605,44 @@ ZLINK_EXPORT int zlink_socket_peers (void *socket_,
 /** @brief Close all parts in a multipart message array. */
 ZLINK_EXPORT void zlink_msgv_close (zlink_msg_t *parts, size_t part_count);
 
+/**
+ * @brief Callback receiving the message parts of an inline socket.
+ *
+ * Runs on the socket's I/O thread, once per part (check zlink_msg_more()).
+ * The part may be moved or sent with zlink_msg_send(); whatever is left
+ * in msg_ is closed when the callback returns.
+ *
+ * @param socket_  The inline socket.
+ * @param msg_     Received message part.
+ * @param hint_    Pointer passed to zlink_socket_set_inline().
+ */
+typedef void (zlink_inline_fn) (void *socket_, zlink_msg_t *msg_, void *hint_);
+
+/**
+ * @brief Run a socket on one of the context's I/O threads.
+ *
+ * The socket is bound to the I/O thread chosen by its ZLINK_AFFINITY and
+ * ZLINK_NUMA_NODE options, and fn_ is called on that thread for each
+ * message part it receives, without waking an application thread. Must
+ * be called before the socket is bound or connected.
+ *
+ * zlink_bind(), zlink_connect(), zlink_unbind(), zlink_disconnect(),
+ * zlink_setsockopt() and zlink_getsockopt() may still be called from any
+ * thread: they are run on the socket's I/O thread and the caller waits
+ * for them. zlink_close() may be called from any thread too. Everything
+ * else, sending and receiving in particular, is only allowed in callbacks
+ * running on the same I/O thread. Sends never block there and fail with
+ * EAGAIN instead. Sockets sharing a single-bit ZLINK_AFFINITY
+ * run on the same thread, so one callback can forward to the other.
+ * hint_ must remain valid until the socket has been closed and the
+ * context terminated.
+ *
+ * @return 0 on success, -1 on failure (errno is set; EINVAL if fn_ is
+ *         NULL or the socket is already inline, bound or connected).
+ */
+ZLINK_EXPORT int
+zlink_socket_set_inline (void *s_, zlink_inline_fn *fn_, void *hint_);
+
 /******************************************************************************/
 /*  Service Discovery API                                                     */
 /******************************************************************************/
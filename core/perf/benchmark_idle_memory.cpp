@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+//  Resident memory per idle connection, in the style of test_many_sockets:
+//  one ROUTER accepts as many DEALERs as requested, every connection
+//  carries a single round trip and then stays idle. Client and server ends
+//  live in this process, so the figure covers both ends of a connection.
+//
+//  Usage: benchmark_idle_memory [tcp|ws] [connections] [low_memory]
+
+#include <zlink.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+static long resident_bytes ()
+{
+    //  Second field of statm is the resident set in pages.
+    FILE *f = fopen ("/proc/self/statm", "r");
+    if (!f)
+        return -1;
+    long size = 0;
+    long resident = 0;
+    const int n = fscanf (f, "%ld %ld", &size, &resident);
+    fclose (f);
+    return n == 2 ? resident * sysconf (_SC_PAGESIZE) : -1;
+}
+
+static void set_int (void *socket_, int option_, int value_)
+{
+    if (zlink_setsockopt (socket_, option_, &value_, sizeof (value_)) != 0) {
+        fprintf (stderr, "setsockopt %d: %s\n", option_,
+                 zlink_strerror (zlink_errno ()));
+        exit (1);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    const std::string transport = argc > 1 ? argv[1] : "tcp";
+    int connections = argc > 2 ? atoi (argv[2]) : 1000;
+    const int low_memory = argc > 3 ? atoi (argv[3]) : 1;
+    const int idle_ivl = 200;
+
+    //  Each connection takes two descriptors in this process.
+    struct rlimit rl;
+    if (getrlimit (RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY) {
+        const int max_connections = static_cast<int> (rl.rlim_cur - 64) / 2;
+        if (connections > max_connections) {
+            fprintf (stderr, "RLIMIT_NOFILE allows %d connections\n",
+                     max_connections);
+            connections = max_connections;
+        }
+    }
+
+    void *ctx = zlink_ctx_new ();
+    zlink_ctx_set (ctx, ZLINK_MAX_SOCKETS, connections + 16);
+
+    void *router = zlink_socket (ctx, ZLINK_ROUTER);
+    set_int (router, ZLINK_LOW_MEMORY, low_memory);
+    set_int (router, ZLINK_LOW_MEMORY_IDLE_IVL, idle_ivl);
+    if (zlink_bind (router, (transport + "://127.0.0.1:*").c_str ()) != 0) {
+        fprintf (stderr, "bind: %s\n", zlink_strerror (zlink_errno ()));
+        return 1;
+    }
+    char endpoint[256];
+    size_t endpoint_len = sizeof (endpoint);
+    zlink_getsockopt (router, ZLINK_LAST_ENDPOINT, endpoint, &endpoint_len);
+
+    //  Settle the I/O threads and the allocator before the baseline.
+    usleep (100 * 1000);
+    const long before = resident_bytes ();
+
+    std::vector<void *> dealers;
+    dealers.reserve (connections);
+    for (int i = 0; i < connections; ++i) {
+        void *dealer = zlink_socket (ctx, ZLINK_DEALER);
+        if (!dealer)
+            break;
+        set_int (dealer, ZLINK_LOW_MEMORY, low_memory);
+        set_int (dealer, ZLINK_LOW_MEMORY_IDLE_IVL, idle_ivl);
+        if (zlink_connect (dealer, endpoint) != 0)
+            break;
+        dealers.push_back (dealer);
+    }
+
+    //  One round trip per connection so that both engines have carried
+    //  traffic and allocated their buffers.
+    for (size_t i = 0; i < dealers.size (); ++i)
+        zlink_send (dealers[i], "hello", 5, 0);
+    for (size_t i = 0; i < dealers.size (); ++i) {
+        char id[256];
+        char body[16];
+        const int id_size = zlink_recv (router, id, sizeof (id), 0);
+        zlink_recv (router, body, sizeof (body), 0);
+        zlink_send (router, id, id_size, ZLINK_SNDMORE);
+        zlink_send (router, "world", 5, 0);
+    }
+    for (size_t i = 0; i < dealers.size (); ++i) {
+        char body[16];
+        zlink_recv (dealers[i], body, sizeof (body), 0);
+    }
+
+    //  Give idle engines time to release their buffers.
+    usleep (idle_ivl * 3 * 1000);
+    const long after = resident_bytes ();
+
+    printf ("transport = %s  low_memory = %d  connections = %d\n",
+            transport.c_str (), low_memory,
+            static_cast<int> (dealers.size ()));
+    if (before >= 0 && after >= 0 && !dealers.empty ())
+        printf ("RSS %ld -> %ld bytes, %.0f bytes per idle connection\n",
+                before, after,
+                static_cast<double> (after - before) / dealers.size ());
+
+    const int linger = 0;
+    for (size_t i = 0; i < dealers.size (); ++i) {
+        zlink_setsockopt (dealers[i], ZLINK_LINGER, &linger, sizeof (linger));
+        zlink_close (dealers[i]);
+    }
+    zlink_setsockopt (router, ZLINK_LINGER, &linger, sizeof (linger));
+    zlink_close (router);
+    zlink_ctx_term (ctx);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+//  Round-trip latency through a ROUTER -> DEALER forwarder. A client DEALER
+//  talks to the forwarder's ROUTER, the forwarder's DEALER talks to an
+//  echoing worker ROUTER, all over loopback TCP. The forwarder either runs
+//  zlink_proxy on its own thread or is a pair of inline sockets sharing
+//  I/O thread 0 (see zlink_socket_set_inline), which saves two thread
+//  hand-offs per direction.
+//
+//  Usage: benchmark_inline_forward [proxy|inline] [roundtrips] [msg_size]
+
+#include <zlink.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static void check (int rc_, const char *what_)
+{
+    if (rc_ == -1) {
+        fprintf (stderr, "%s: %s\n", what_, zlink_strerror (zlink_errno ()));
+        exit (1);
+    }
+}
+
+static std::string last_endpoint (void *socket_)
+{
+    char endpoint[256];
+    size_t endpoint_len = sizeof (endpoint);
+    check (zlink_getsockopt (socket_, ZLINK_LAST_ENDPOINT, endpoint,
+                             &endpoint_len),
+           "getsockopt");
+    return endpoint;
+}
+
+//  Echoes every message back to where it came from until the context is
+//  terminated.
+static void worker_fn (void *worker_)
+{
+    zlink_msg_t msg;
+    zlink_msg_init (&msg);
+    while (zlink_msg_recv (&msg, worker_, 0) != -1) {
+        const int flags = zlink_msg_more (&msg) ? ZLINK_SNDMORE : 0;
+        if (zlink_msg_send (&msg, worker_, flags) == -1)
+            break;
+    }
+    zlink_msg_close (&msg);
+    zlink_close (worker_);
+}
+
+struct proxy_args_t
+{
+    void *frontend;
+    void *backend;
+};
+
+static void proxy_fn (void *args_)
+{
+    proxy_args_t *args = static_cast<proxy_args_t *> (args_);
+    zlink_proxy (args->frontend, args->backend, NULL);
+    zlink_close (args->frontend);
+    zlink_close (args->backend);
+}
+
+static void forward_fn (void *, zlink_msg_t *msg_, void *peer_)
+{
+    const int flags = zlink_msg_more (msg_) ? ZLINK_SNDMORE : 0;
+    zlink_msg_send (msg_, peer_, flags);
+}
+
+int main (int argc, char *argv[])
+{
+    const std::string mode = argc > 1 ? argv[1] : "inline";
+    const int roundtrips = argc > 2 ? atoi (argv[2]) : 100000;
+    const size_t msg_size = argc > 3 ? atoi (argv[3]) : 64;
+    const bool inline_mode = mode == "inline";
+
+    void *ctx = zlink_ctx_new ();
+
+    void *worker = zlink_socket (ctx, ZLINK_ROUTER);
+    check (zlink_bind (worker, "tcp://127.0.0.1:*"), "bind worker");
+    const std::string worker_endpoint = last_endpoint (worker);
+    void *worker_thread = zlink_threadstart (worker_fn, worker);
+
+    void *frontend = zlink_socket (ctx, ZLINK_ROUTER);
+    void *backend = zlink_socket (ctx, ZLINK_DEALER);
+    proxy_args_t proxy_args = {frontend, backend};
+    if (inline_mode) {
+        const uint64_t affinity = 1;
+        check (zlink_setsockopt (frontend, ZLINK_AFFINITY, &affinity,
+                                 sizeof (affinity)),
+               "setsockopt");
+        check (zlink_setsockopt (backend, ZLINK_AFFINITY, &affinity,
+                                 sizeof (affinity)),
+               "setsockopt");
+        check (zlink_socket_set_inline (frontend, forward_fn, backend),
+               "set_inline");
+        check (zlink_socket_set_inline (backend, forward_fn, frontend),
+               "set_inline");
+    }
+    check (zlink_bind (frontend, "tcp://127.0.0.1:*"), "bind frontend");
+    const std::string frontend_endpoint = last_endpoint (frontend);
+    check (zlink_connect (backend, worker_endpoint.c_str ()), "connect");
+    void *proxy_thread =
+      inline_mode ? NULL : zlink_threadstart (proxy_fn, &proxy_args);
+
+    void *client = zlink_socket (ctx, ZLINK_DEALER);
+    check (zlink_connect (client, frontend_endpoint.c_str ()), "connect");
+
+    std::vector<char> buf (msg_size, 'x');
+
+    //  Warm up the connections before timing.
+    for (int i = 0; i < 1000; ++i) {
+        check (zlink_send (client, &buf[0], msg_size, 0), "send");
+        check (zlink_recv (client, &buf[0], msg_size, 0), "recv");
+    }
+
+    void *watch = zlink_stopwatch_start ();
+    for (int i = 0; i < roundtrips; ++i) {
+        check (zlink_send (client, &buf[0], msg_size, 0), "send");
+        check (zlink_recv (client, &buf[0], msg_size, 0), "recv");
+    }
+    const unsigned long elapsed = zlink_stopwatch_stop (watch);
+
+    printf ("mode = %s  roundtrips = %d  msg_size = %d\n", mode.c_str (),
+            roundtrips, static_cast<int> (msg_size));
+    printf ("average round trip: %.3f us\n",
+            static_cast<double> (elapsed) / roundtrips);
+
+    const int linger = 0;
+    zlink_setsockopt (client, ZLINK_LINGER, &linger, sizeof (linger));
+    zlink_close (client);
+    if (inline_mode) {
+        zlink_close (frontend);
+        zlink_close (backend);
+    }
+    zlink_ctx_term (ctx);
+    zlink_threadclose (worker_thread);
+    if (proxy_thread)
+        zlink_threadclose (proxy_thread);
+    return 0;
+}
@@ -0,0 +1,102 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+//  Cost of zlink_poll against the number of idle sockets in the item set.
+//  One PAIR of the set carries a message per iteration while all others
+//  stay idle; each iteration sends, polls until the message is reported
+//  and receives it. Sets of 64 items and more go through the epoll backed
+//  poller where available, smaller ones through poll ().
+//
+//  Usage: benchmark_poll_idle [max_sockets] [iterations]
+
+#include <zlink.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <vector>
+
+static void check (int rc_, const char *what_)
+{
+    if (rc_ == -1) {
+        fprintf (stderr, "%s: %s\n", what_, zlink_strerror (zlink_errno ()));
+        exit (1);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+    int max_sockets = argc > 1 ? atoi (argv[1]) : 8192;
+    const int iterations = argc > 2 ? atoi (argv[2]) : 10000;
+
+    //  Every socket holds a mailbox descriptor.
+    struct rlimit rl;
+    if (getrlimit (RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur != RLIM_INFINITY) {
+        const int limit = static_cast<int> (rl.rlim_cur - 64) / 2;
+        if (max_sockets > limit) {
+            fprintf (stderr, "RLIMIT_NOFILE allows %d sockets\n", limit);
+            max_sockets = limit;
+        }
+    }
+
+    void *ctx = zlink_ctx_new ();
+    zlink_ctx_set (ctx, ZLINK_MAX_SOCKETS, 2 * max_sockets + 16);
+
+    std::vector<void *> receivers;
+    std::vector<void *> senders;
+    std::vector<zlink_pollitem_t> items;
+    char buf[16];
+
+    printf ("%10s %16s %16s\n", "sockets", "idle poll (us)", "ready poll (us)");
+    for (int size = 16; size <= max_sockets; size *= 2) {
+        while (static_cast<int> (receivers.size ()) < size) {
+            char endpoint[64];
+            snprintf (endpoint, sizeof (endpoint), "inproc://poll-idle-%d",
+                      static_cast<int> (receivers.size ()));
+            void *receiver = zlink_socket (ctx, ZLINK_PAIR);
+            void *sender = zlink_socket (ctx, ZLINK_PAIR);
+            check (zlink_bind (receiver, endpoint), "bind");
+            check (zlink_connect (sender, endpoint), "connect");
+            receivers.push_back (receiver);
+            senders.push_back (sender);
+            const zlink_pollitem_t item = {receiver, 0, ZLINK_POLLIN, 0};
+            items.push_back (item);
+        }
+
+        //  The active pair sits in the middle of the set.
+        void *sender = senders[size / 2];
+        void *receiver = receivers[size / 2];
+
+        //  Let the first call set up whatever is kept between calls.
+        check (zlink_poll (&items[0], size, 0), "poll");
+
+        void *watch = zlink_stopwatch_start ();
+        for (int i = 0; i < iterations; ++i)
+            check (zlink_poll (&items[0], size, 0), "poll");
+        const unsigned long idle = zlink_stopwatch_stop (watch);
+
+        watch = zlink_stopwatch_start ();
+        for (int i = 0; i < iterations; ++i) {
+            check (zlink_send (sender, "x", 1, 0), "send");
+            do
+                check (zlink_poll (&items[0], size, -1), "poll");
+            while (!items[size / 2].revents);
+            check (zlink_recv (receiver, buf, sizeof (buf), 0), "recv");
+        }
+        const unsigned long ready = zlink_stopwatch_stop (watch);
+
+        printf ("%10d %16.3f %16.3f\n", size,
+                static_cast<double> (idle) / iterations,
+                static_cast<double> (ready) / iterations);
+    }
+
+    const int linger = 0;
+    for (size_t i = 0; i < receivers.size (); ++i) {
+        zlink_setsockopt (senders[i], ZLINK_LINGER, &linger, sizeof (linger));
+        zlink_setsockopt (receivers[i], ZLINK_LINGER, &linger,
+                          sizeof (linger));
+        zlink_close (senders[i]);
+        zlink_close (receivers[i]);
+    }
+    zlink_ctx_term (ctx);
+    return 0;
+}
@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+//  PUB fan-out to many subscribers over loopback TCP. One thread publishes,
+//  another receives every message on every SUB in turn. Besides throughput
+//  it reports how many inter-thread commands each published message cost
+//  and how many times a thread had to be woken up for them, as counted by
+//  ZLINK_MAILBOX_COMMANDS and ZLINK_MAILBOX_WAKEUPS.
+//
+//  Usage: benchmark_pub_fanout [subscribers] [messages] [msg_size]
+
+#include <zlink.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+static void check (int rc_, const char *what_)
+{
+    if (rc_ == -1) {
+        fprintf (stderr, "%s: %s\n", what_, zlink_strerror (zlink_errno ()));
+        exit (1);
+    }
+}
+
+struct receiver_args_t
+{
+    std::vector<void *> *subs;
+    int messages;
+    size_t msg_size;
+};
+
+static void receiver_fn (void *args_)
+{
+    receiver_args_t *args = static_cast<receiver_args_t *> (args_);
+    std::vector<char> buf (args->msg_size + 1);
+    for (int i = 0; i < args->messages; ++i)
+        for (size_t s = 0; s < args->subs->size (); ++s)
+            check (zlink_recv ((*args->subs)[s], &buf[0], buf.size (), 0),
+                   "recv");
+}
+
+int main (int argc, char *argv[])
+{
+    const int subscribers = argc > 1 ? atoi (argv[1]) : 100;
+    const int messages = argc > 2 ? atoi (argv[2]) : 10000;
+    const size_t msg_size = argc > 3 ? atoi (argv[3]) : 32;
+
+    void *ctx = zlink_ctx_new ();
+    zlink_ctx_set (ctx, ZLINK_MAX_SOCKETS, subscribers + 16);
+
+    //  Nothing may be dropped, every subscriber receives every message.
+    const int hwm = 0;
+    void *pub = zlink_socket (ctx, ZLINK_PUB);
+    check (zlink_setsockopt (pub, ZLINK_SNDHWM, &hwm, sizeof (hwm)),
+           "setsockopt");
+    check (zlink_bind (pub, "tcp://127.0.0.1:*"), "bind");
+    char endpoint[256];
+    size_t endpoint_len = sizeof (endpoint);
+    check (
+      zlink_getsockopt (pub, ZLINK_LAST_ENDPOINT, endpoint, &endpoint_len),
+      "getsockopt");
+
+    std::vector<void *> subs;
+    for (int i = 0; i < subscribers; ++i) {
+        void *sub = zlink_socket (ctx, ZLINK_SUB);
+        check (zlink_setsockopt (sub, ZLINK_RCVHWM, &hwm, sizeof (hwm)),
+               "setsockopt");
+        check (zlink_setsockopt (sub, ZLINK_SUBSCRIBE, "", 0), "subscribe");
+        check (zlink_connect (sub, endpoint), "connect");
+        subs.push_back (sub);
+    }
+
+    //  Wait until every subscriber receives, so none misses the start.
+    std::vector<char> buf (msg_size, 'x');
+    for (size_t s = 0; s < subs.size ();) {
+        check (zlink_send (pub, &buf[0], msg_size, 0), "send");
+        usleep (1000);
+        while (s < subs.size ()
+               && zlink_recv (subs[s], &buf[0], msg_size, ZLINK_DONTWAIT) != -1)
+            ++s;
+    }
+    for (size_t s = 0; s < subs.size (); ++s)
+        while (zlink_recv (subs[s], &buf[0], msg_size, ZLINK_DONTWAIT) != -1)
+            ;
+
+    const int commands = zlink_ctx_get (ctx, ZLINK_MAILBOX_COMMANDS);
+    const int wakeups = zlink_ctx_get (ctx, ZLINK_MAILBOX_WAKEUPS);
+
+    receiver_args_t args = {&subs, messages, msg_size};
+    void *watch = zlink_stopwatch_start ();
+    void *receiver = zlink_threadstart (receiver_fn, &args);
+    for (int i = 0; i < messages; ++i)
+        check (zlink_send (pub, &buf[0], msg_size, 0), "send");
+    zlink_threadclose (receiver);
+    const unsigned long elapsed = zlink_stopwatch_stop (watch);
+
+    const double sent_commands =
+      zlink_ctx_get (ctx, ZLINK_MAILBOX_COMMANDS) - commands;
+    const double sent_wakeups =
+      zlink_ctx_get (ctx, ZLINK_MAILBOX_WAKEUPS) - wakeups;
+
+    printf ("subscribers = %d  messages = %d  msg_size = %d\n", subscribers,
+            messages, static_cast<int> (msg_size));
+    printf ("deliveries per second: %.0f\n",
+            static_cast<double> (messages) * subscribers * 1000000
+              / (elapsed ? elapsed : 1));
+    printf ("commands per message: %.2f\n", sent_commands / messages);
+    printf ("wake-ups per message: %.2f\n", sent_wakeups / messages);
+
+    const int linger = 0;
+    for (size_t s = 0; s < subs.size (); ++s) {
+        zlink_setsockopt (subs[s], ZLINK_LINGER, &linger, sizeof (linger));
+        zlink_close (subs[s]);
+    }
+    zlink_setsockopt (pub, ZLINK_LINGER, &linger, sizeof (linger));
+    zlink_close (pub);
+    zlink_ctx_term (ctx);
+    return 0;
+}
@@ -4,6 +4,7 @@
 
 #include "radix_tree.hpp"
 #include "trie.hpp"
+#include "topic_set.hpp"
 
 #include <chrono>
 #include <cstddef>
@@ -19,6 +20,20 @@ const std::size_t samples = 10;
 const std::size_t key_length = 20;
 const char *chars = "abcdefghijklmnopqrstuvwxyz0123456789";
 const int chars_len = 36;
+const int delimiter = '.';
+
+//  Keys as exact topics, matched the way XSUB does with a topic delimiter:
+//  find the delimiter, then one hash lookup.
+struct exact_topics_t
+{
+    bool check (const unsigned char *data_, std::size_t size_) const
+    {
+        const std::size_t topic = zlink::topic_size (data_, size_, delimiter);
+        return topic > 0 && topics.check (data_, topic);
+    }
+
+    zlink::topic_set_t topics;
+};
 
 template <class T>
 void benchmark_lookup (T &subscriptions_,
@@ -62,22 +77,25 @@ int main ()
 
     for (std::size_t i = 0; i < nkeys; ++i) {
         unsigned char *key = new unsigned char[key_length];
-        for (std::size_t j = 0; j < key_length; j++)
+        for (std::size_t j = 0; j < key_length - 1; j++)
             key[j] = static_cast<unsigned char> (chars[rng () % chars_len]);
+        key[key_length - 1] = delimiter;
         input_set.emplace_back (key);
     }
     for (std::size_t i = 0; i < nqueries; ++i)
         queries.push_back (input_set[rng () % nkeys]);
 
-    // Initialize both data structures.
+    // Initialize the data structures.
     //
     // Keeping initialization out of the benchmarking function helps
     // heaptrack detect peak memory consumption of the radix tree.
     zlink::trie_t trie;
     zlink::radix_tree_t radix_tree;
+    exact_topics_t exact_topics;
     for (auto &key : input_set) {
         trie.add (key, key_length);
         radix_tree.add (key, key_length);
+        exact_topics.topics.add (key, key_length);
     }
 
     // Create a benchmark.
@@ -91,6 +109,9 @@ int main ()
     std::puts ("[radix_tree]");
     benchmark_lookup (radix_tree, queries);
 
+    std::puts ("[exact topics]");
+    benchmark_lookup (exact_topics, queries);
+
     for (auto &op : input_set)
         delete[] op;
 }
@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+//  Time for an XPUB to learn a SUB's subscriptions over tcp://: set one by
+//  one with ZLINK_SUBSCRIBE, set at once with ZLINK_SUBSCRIBE_BULK, and
+//  replayed by the SUB when it connects, as on a reconnect. Each run ends
+//  when the XPUB has received the notification for the last subscription.
+//
+//  Usage: benchmark_resubscribe [subscriptions]
+
+#include <zlink.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+static void check (int rc_, const char *what_)
+{
+    if (rc_ == -1) {
+        fprintf (stderr, "%s: %s\n", what_, zlink_strerror (zlink_errno ()));
+        exit (1);
+    }
+}
+
+static std::string topic_name (int topic_)
+{
+    char name[32];
+    snprintf (name, sizeof name, "topic-%06d.", topic_);
+    return name;
+}
+
+enum method_t
+{
+    one_by_one,
+    bulk,
+    on_connect
+};
+
+static void subscribe (void *sub_, int subscriptions_, bool bulk_)
+{
+    if (!bulk_) {
+        for (int i = 0; i < subscriptions_; ++i) {
+            const std::string topic = topic_name (i);
+            check (zlink_setsockopt (sub_, ZLINK_SUBSCRIBE, topic.data (),
+                                     topic.size ()),
+                   "subscribe");
+        }
+        return;
+    }
+
+    //  Each topic goes as its 4-byte big-endian size and its bytes.
+    std::string list;
+    for (int i = 0; i < subscriptions_; ++i) {
+        const std::string topic = topic_name (i);
+        const size_t size = topic.size ();
+        const char prefix[4] = {static_cast<char> (size >> 24),
+                                static_cast<char> (size >> 16),
+                                static_cast<char> (size >> 8),
+                                static_cast<char> (size)};
+        list.append (prefix, 4);
+        list.append (topic);
+    }
+    check (zlink_setsockopt (sub_, ZLINK_SUBSCRIBE_BULK, list.data (),
+                             list.size ()),
+           "subscribe bulk");
+}
+
+//  Returns the milliseconds until the XPUB has all the subscriptions.
+static double run (method_t method_, int subscriptions_)
+{
+    void *ctx = zlink_ctx_new ();
+    const int hwm = 0;
+
+    void *xpub = zlink_socket (ctx, ZLINK_XPUB);
+    check (zlink_setsockopt (xpub, ZLINK_RCVHWM, &hwm, sizeof hwm), "rcvhwm");
+    check (zlink_bind (xpub, "tcp://127.0.0.1:*"), "bind");
+    char endpoint[256];
+    size_t size = sizeof endpoint;
+    check (zlink_getsockopt (xpub, ZLINK_LAST_ENDPOINT, endpoint, &size),
+           "endpoint");
+
+    //  The SUB's send high-water mark applies to subscriptions too.
+    void *sub = zlink_socket (ctx, ZLINK_SUB);
+    check (zlink_setsockopt (sub, ZLINK_SNDHWM, &hwm, sizeof hwm), "sndhwm");
+
+    void *watch;
+    if (method_ == on_connect) {
+        subscribe (sub, subscriptions_, true);
+        watch = zlink_stopwatch_start ();
+        check (zlink_connect (sub, endpoint), "connect");
+    } else {
+        //  Make sure the connection is up before timing.
+        check (zlink_connect (sub, endpoint), "connect");
+        check (zlink_setsockopt (sub, ZLINK_SUBSCRIBE, "", 0), "subscribe");
+        char buf[256];
+        check (zlink_recv (xpub, buf, sizeof buf, 0), "recv");
+        watch = zlink_stopwatch_start ();
+        subscribe (sub, subscriptions_, method_ == bulk);
+    }
+
+    char buf[256];
+    for (int i = 0; i < subscriptions_; ++i)
+        check (zlink_recv (xpub, buf, sizeof buf, 0), "recv");
+    const unsigned long elapsed = zlink_stopwatch_stop (watch);
+
+    const int linger = 0;
+    zlink_setsockopt (sub, ZLINK_LINGER, &linger, sizeof linger);
+    zlink_close (sub);
+    zlink_setsockopt (xpub, ZLINK_LINGER, &linger, sizeof linger);
+    zlink_close (xpub);
+    zlink_ctx_term (ctx);
+
+    return static_cast<double> (elapsed) / 1000;
+}
+
+int main (int argc, char *argv[])
+{
+    const int subscriptions = argc > 1 ? atoi (argv[1]) : 100000;
+
+    printf ("subscriptions = %d\n", subscriptions);
+    printf ("%20s %12s\n", "", "time (ms)");
+    printf ("%20s %12.1f\n", "ZLINK_SUBSCRIBE",
+            run (one_by_one, subscriptions));
+    printf ("%20s %12.1f\n", "ZLINK_SUBSCRIBE_BULK", run (bulk, subscriptions));
+    printf ("%20s %12.1f\n", "on connect", run (on_connect, subscriptions));
+    return 0;
+}
@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+//  Cost of arming and cancelling zlink_timers_* timers against the number
+//  of timers already armed, the way heartbeat timers of many connections
+//  are re-armed all the time. For each size the set is filled with
+//  timeouts spread over a minute, then one timer at a time is cancelled
+//  and armed again.
+//
+//  Usage: benchmark_timers [max_timers] [iterations]
+
+#include <zlink.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static void handler (int, void *)
+{
+}
+
+int main (int argc, char *argv[])
+{
+    const int max_timers = argc > 1 ? atoi (argv[1]) : 1000000;
+    const int iterations = argc > 2 ? atoi (argv[2]) : 1000000;
+
+    printf ("%10s %18s\n", "timers", "re-arm (ns)");
+    for (int size = 1000; size <= max_timers; size *= 10) {
+        void *timers = zlink_timers_new ();
+        std::vector<int> ids (size);
+        srand (1);
+        for (int i = 0; i != size; ++i)
+            ids[i] = zlink_timers_add (timers, 1000 + rand () % 60000,
+                                       handler, NULL);
+
+        void *watch = zlink_stopwatch_start ();
+        for (int i = 0; i != iterations; ++i) {
+            const int index = i % size;
+            zlink_timers_cancel (timers, ids[index]);
+            ids[index] = zlink_timers_add (timers, 1000 + rand () % 60000,
+                                           handler, NULL);
+        }
+        const unsigned long elapsed = zlink_stopwatch_stop (watch);
+
+        printf ("%10d %18.1f\n", size,
+                static_cast<double> (elapsed) * 1000 / iterations);
+        zlink_timers_destroy (&timers);
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#if __cplusplus >= 201103L
+
+#include "transports/ws/ws_frame.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+const std::size_t sizes[] = {64,        128,       256,        1024,
+                             16 * 1024, 64 * 1024, 1024 * 1024};
+const std::size_t total_bytes = 1024 * 1024 * 1024;
+const std::size_t warmup_runs = 4;
+const unsigned char key[4] = {0x37, 0xfa, 0x21, 0x3d};
+
+typedef void (*mask_fn) (unsigned char *,
+                         std::size_t,
+                         const unsigned char *,
+                         std::size_t);
+
+void bytewise_mask (unsigned char *data_,
+                    std::size_t size_,
+                    const unsigned char *key_,
+                    std::size_t offset_)
+{
+    for (std::size_t i = 0; i < size_; ++i)
+        data_[i] ^= key_[(offset_ + i) & 3];
+}
+
+//  Masks total_bytes in chunks of size_, starting one byte into the buffer
+//  so that no kernel gets an aligned pointer for free.
+void benchmark_mask (const char *name_, mask_fn mask_, std::size_t size_)
+{
+    using namespace std::chrono;
+    std::vector<unsigned char> buffer (size_ + 1);
+    std::minstd_rand rng (123456789);
+    for (auto &byte : buffer)
+        byte = static_cast<unsigned char> (rng ());
+    unsigned char *data = &buffer[1];
+    const std::size_t iterations = total_bytes / size_;
+
+    for (std::size_t run = 0; run < warmup_runs; ++run)
+        mask_ (data, size_, key, run);
+
+    const auto start = steady_clock::now ();
+    for (std::size_t i = 0; i < iterations; ++i)
+        mask_ (data, size_, key, i);
+    const auto end = steady_clock::now ();
+
+    const double seconds = duration<double> (end - start).count ();
+    std::printf ("%-8s size = %8llu  %8.2f GB/s\n", name_,
+                 static_cast<unsigned long long> (size_),
+                 static_cast<double> (iterations * size_) / seconds / 1e9);
+}
+
+int main ()
+{
+    for (const std::size_t size : sizes) {
+        benchmark_mask ("bytewise", bytewise_mask, size);
+        benchmark_mask ("scalar", zlink::ws_mask_scalar, size);
+        benchmark_mask ("ws_mask", zlink::ws_mask, size);
+    }
+}
+
+#else
+
+int main ()
+{
+}
+
+#endif
@@ -0,0 +1,168 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+//  Time for a subscriber joining late to get the current value of every
+//  topic, with ZLINK_XPUB_LAST_VALUE_CACHE against a separate snapshot
+//  service. The publisher thread keeps updating the topics; with the
+//  cache the subscriber only subscribes, without it a DEALER asks a
+//  ROUTER that mirrors every update for a snapshot. Both include the
+//  tcp:// connect.
+//
+//  Usage: benchmark_xpub_late_join [joins] [value size]
+
+#include <zlink.h>
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void check (int rc_, const char *what_)
+{
+    if (rc_ == -1) {
+        fprintf (stderr, "%s: %s\n", what_, zlink_strerror (zlink_errno ()));
+        exit (1);
+    }
+}
+
+static std::string topic_name (int topic_)
+{
+    char name[32];
+    snprintf (name, sizeof name, "topic-%05d.", topic_);
+    return name;
+}
+
+struct publisher_t
+{
+    void *xpub;
+    void *router;
+    int topics;
+    size_t value_size;
+    std::atomic<bool> stop;
+};
+
+//  Publishes one update per millisecond, round robin over the topics, and
+//  answers snapshot requests from its own copy of the values.
+static void publish (publisher_t *pub_)
+{
+    std::vector<std::string> values (pub_->topics);
+    for (int i = 0; i < pub_->topics; ++i) {
+        values[i] = topic_name (i) + std::string (pub_->value_size, 'x');
+        check (zlink_send (pub_->xpub, values[i].data (), values[i].size (), 0),
+               "send");
+    }
+
+    zlink_pollitem_t items[] = {{pub_->xpub, 0, ZLINK_POLLIN, 0},
+                                {pub_->router, 0, ZLINK_POLLIN, 0}};
+    char buf[256];
+    for (int next = 0; !pub_->stop; next = (next + 1) % pub_->topics) {
+        check (zlink_poll (items, 2, 1), "poll");
+        while (zlink_recv (pub_->xpub, buf, sizeof buf, ZLINK_DONTWAIT) != -1)
+            ;
+        if (items[1].revents & ZLINK_POLLIN) {
+            const int id_size =
+              zlink_recv (pub_->router, buf, sizeof buf, ZLINK_DONTWAIT);
+            check (id_size, "recv id");
+            char request[16];
+            check (zlink_recv (pub_->router, request, sizeof request, 0),
+                   "recv request");
+            for (int i = 0; i < pub_->topics; ++i) {
+                check (zlink_send (pub_->router, buf, id_size, ZLINK_SNDMORE),
+                       "send id");
+                check (zlink_send (pub_->router, values[i].data (),
+                                   values[i].size (), 0),
+                       "send snapshot");
+            }
+        }
+
+        //  The snapshot service sees each update too.
+        values[next][values[next].size () - 1]++;
+        check (zlink_send (pub_->xpub, values[next].data (),
+                           values[next].size (), 0),
+               "send");
+    }
+}
+
+//  Returns the average microseconds for a joining client to hold the
+//  value of every topic.
+static double run (int topics_, size_t value_size_, int joins_, bool cache_)
+{
+    void *ctx = zlink_ctx_new ();
+    publisher_t pub;
+    pub.xpub = zlink_socket (ctx, ZLINK_XPUB);
+    const int budget = cache_ ? 1 << 30 : 0;
+    check (zlink_setsockopt (pub.xpub, ZLINK_XPUB_LAST_VALUE_CACHE, &budget,
+                             sizeof budget),
+           "setsockopt");
+    const int delimiter = '.';
+    check (zlink_setsockopt (pub.xpub, ZLINK_TOPIC_DELIMITER, &delimiter,
+                             sizeof delimiter),
+           "setsockopt");
+    const int hwm = topics_ * 2 + 1000;
+    check (zlink_setsockopt (pub.xpub, ZLINK_SNDHWM, &hwm, sizeof hwm),
+           "setsockopt");
+    check (zlink_bind (pub.xpub, "tcp://127.0.0.1:5571"), "bind");
+    pub.router = zlink_socket (ctx, ZLINK_ROUTER);
+    check (zlink_setsockopt (pub.router, ZLINK_SNDHWM, &hwm, sizeof hwm),
+           "setsockopt");
+    check (zlink_bind (pub.router, "tcp://127.0.0.1:5572"), "bind");
+    pub.topics = topics_;
+    pub.value_size = value_size_;
+    pub.stop = false;
+    std::thread publisher (publish, &pub);
+
+    const int linger = 0;
+    char buf[256];
+    unsigned long elapsed = 0;
+    for (int j = 0; j < joins_; ++j) {
+        void *watch = zlink_stopwatch_start ();
+        void *client;
+        if (cache_) {
+            client = zlink_socket (ctx, ZLINK_SUB);
+            check (zlink_setsockopt (client, ZLINK_RCVHWM, &hwm, sizeof hwm),
+                   "setsockopt");
+            check (zlink_connect (client, "tcp://127.0.0.1:5571"), "connect");
+            check (zlink_setsockopt (client, ZLINK_SUBSCRIBE, "", 0),
+                   "subscribe");
+        } else {
+            client = zlink_socket (ctx, ZLINK_DEALER);
+            check (zlink_setsockopt (client, ZLINK_RCVHWM, &hwm, sizeof hwm),
+                   "setsockopt");
+            check (zlink_connect (client, "tcp://127.0.0.1:5572"), "connect");
+            check (zlink_send (client, "snapshot", 8, 0), "send");
+        }
+        for (int i = 0; i < topics_; ++i)
+            check (zlink_recv (client, buf, sizeof buf, 0), "recv");
+        elapsed += zlink_stopwatch_stop (watch);
+        zlink_setsockopt (client, ZLINK_LINGER, &linger, sizeof linger);
+        zlink_close (client);
+    }
+
+    pub.stop = true;
+    publisher.join ();
+    zlink_setsockopt (pub.xpub, ZLINK_LINGER, &linger, sizeof linger);
+    zlink_close (pub.xpub);
+    zlink_setsockopt (pub.router, ZLINK_LINGER, &linger, sizeof linger);
+    zlink_close (pub.router);
+    zlink_ctx_term (ctx);
+
+    return static_cast<double> (elapsed) / joins_;
+}
+
+int main (int argc, char *argv[])
+{
+    const int joins = argc > 1 ? atoi (argv[1]) : 20;
+    const size_t value_size = argc > 2 ? atoi (argv[2]) : 64;
+
+    printf ("joins = %d  value size = %d\n", joins,
+            static_cast<int> (value_size));
+    printf ("%8s %16s %16s\n", "topics", "snapshot (us)", "cache (us)");
+    for (int topics = 1; topics <= 10000; topics *= 10) {
+        const double snapshot = run (topics, value_size, joins, false);
+        const double cached = run (topics, value_size, joins, true);
+        printf ("%8d %16.1f %16.1f\n", topics, snapshot, cached);
+    }
+    return 0;
+}
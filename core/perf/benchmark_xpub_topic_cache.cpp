@@ -0,0 +1,140 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+//  Cost of publishing on an XPUB with and without ZLINK_XPUB_TOPIC_CACHE
+//  against the number of subscriptions per subscriber. The publisher
+//  cycles over a fixed set of topics, each message being the topic
+//  followed by a payload; every subscriber subscribes to a random subset
+//  of the topics. Only the time spent in zlink_send is counted, the
+//  subscribers are drained in between over inproc.
+//
+//  Usage: benchmark_xpub_topic_cache [subscribers] [topics] [messages]
+
+#include <zlink.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <set>
+#include <string>
+#include <vector>
+
+static void check (int rc_, const char *what_)
+{
+    if (rc_ == -1) {
+        fprintf (stderr, "%s: %s\n", what_, zlink_strerror (zlink_errno ()));
+        exit (1);
+    }
+}
+
+static std::string topic_name (int topic_)
+{
+    char name[32];
+    snprintf (name, sizeof name, "topic-%05d.", topic_);
+    return name;
+}
+
+static uint64_t get_counter (void *xpub_, int option_)
+{
+    uint64_t value = 0;
+    size_t size = sizeof value;
+    check (zlink_getsockopt (xpub_, option_, &value, &size), "getsockopt");
+    return value;
+}
+
+//  Returns the nanoseconds per message spent publishing, and the cache
+//  hit rate in *hit_rate_.
+static double run (int subscribers_,
+                   int topics_,
+                   int subscriptions_,
+                   int messages_,
+                   int cache_,
+                   double *hit_rate_)
+{
+    void *ctx = zlink_ctx_new ();
+    zlink_ctx_set (ctx, ZLINK_MAX_SOCKETS, subscribers_ + 16);
+
+    void *xpub = zlink_socket (ctx, ZLINK_XPUB);
+    check (zlink_setsockopt (xpub, ZLINK_XPUB_TOPIC_CACHE, &cache_,
+                             sizeof cache_),
+           "setsockopt");
+    check (zlink_bind (xpub, "inproc://topic_cache"), "bind");
+
+    srand (1);
+    std::set<std::string> unique;
+    std::vector<void *> subs;
+    for (int i = 0; i < subscribers_; ++i) {
+        void *sub = zlink_socket (ctx, ZLINK_SUB);
+        check (zlink_connect (sub, "inproc://topic_cache"), "connect");
+        for (int j = 0; j < subscriptions_; ++j) {
+            const std::string topic = topic_name (rand () % topics_);
+            check (zlink_setsockopt (sub, ZLINK_SUBSCRIBE, topic.data (),
+                                     topic.size ()),
+                   "subscribe");
+            unique.insert (topic);
+        }
+        subs.push_back (sub);
+    }
+
+    //  Wait for every distinct subscription to reach the publisher.
+    char buf[256];
+    for (size_t received = 0; received < unique.size (); ++received)
+        check (zlink_recv (xpub, buf, sizeof buf, 0), "recv");
+
+    std::vector<std::string> msgs (topics_);
+    for (int i = 0; i < topics_; ++i)
+        msgs[i] = topic_name (i) + std::string (48, 'x');
+
+    const int batch = 100;
+    unsigned long elapsed = 0;
+    for (int i = 0; i < messages_; i += batch) {
+        void *watch = zlink_stopwatch_start ();
+        for (int j = i; j < i + batch && j < messages_; ++j) {
+            const std::string &msg = msgs[j % topics_];
+            check (zlink_send (xpub, msg.data (), msg.size (), 0), "send");
+        }
+        elapsed += zlink_stopwatch_stop (watch);
+        for (size_t s = 0; s < subs.size (); ++s)
+            while (zlink_recv (subs[s], buf, sizeof buf, ZLINK_DONTWAIT) != -1)
+                ;
+    }
+
+    const double hits =
+      static_cast<double> (get_counter (xpub, ZLINK_XPUB_TOPIC_CACHE_HITS));
+    const double misses =
+      static_cast<double> (get_counter (xpub, ZLINK_XPUB_TOPIC_CACHE_MISSES));
+    *hit_rate_ = hits + misses > 0 ? hits / (hits + misses) : 0;
+
+    const int linger = 0;
+    for (size_t s = 0; s < subs.size (); ++s) {
+        zlink_setsockopt (subs[s], ZLINK_LINGER, &linger, sizeof linger);
+        zlink_close (subs[s]);
+    }
+    zlink_setsockopt (xpub, ZLINK_LINGER, &linger, sizeof linger);
+    zlink_close (xpub);
+    zlink_ctx_term (ctx);
+
+    return static_cast<double> (elapsed) * 1000 / messages_;
+}
+
+int main (int argc, char *argv[])
+{
+    const int subscribers = argc > 1 ? atoi (argv[1]) : 100;
+    const int topics = argc > 2 ? atoi (argv[2]) : 5000;
+    const int messages = argc > 3 ? atoi (argv[3]) : 200000;
+
+    printf ("subscribers = %d  topics = %d  messages = %d\n", subscribers,
+            topics, messages);
+    printf ("%14s %16s %16s %10s\n", "subs per pipe", "no cache (ns)",
+            "cache (ns)", "hit rate");
+    for (int subscriptions = 1; subscriptions <= topics;
+         subscriptions *= 10) {
+        double hit_rate;
+        const double plain =
+          run (subscribers, topics, subscriptions, messages, 0, &hit_rate);
+        const double cached =
+          run (subscribers, topics, subscriptions, messages, 8192, &hit_rate);
+        printf ("%14d %16.1f %16.1f %9.1f%%\n", subscriptions, plain, cached,
+                hit_rate * 100);
+    }
+    return 0;
+}
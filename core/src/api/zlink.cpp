@@ -418,6 +418,14 @@ int zlink_socket_peers (void *socket_, zlink_peer_info_t *peers_, size_t *count_
     return handle.socket->socket_peers (peers_, count_);
 }
 
+int zlink_socket_set_inline (void *s_, zlink_inline_fn *fn_, void *hint_)
+{
+    socket_handle_t handle = as_socket_handle (s_);
+    if (!handle.socket)
+        return -1;
+    return handle.socket->set_inline (fn_, hint_);
+}
+
 void zlink_msgv_close (zlink_msg_t *parts_, size_t part_count_)
 {
     if (!parts_)
@@ -1597,6 +1605,150 @@ const char *zlink_msg_gets (const zlink_msg_t *msg_, const char *property_)
 
 // Polling.
 
+#if defined ZLINK_HAVE_EPOLL
+//  zlink_poll for large sets of items. As long as the caller passes the
+//  same sockets and descriptors the items stay registered in an epoll
+//  backed socket_poller_t, so a call costs in proportion to the ready
+//  items rather than to all of them. Returns -2 for item sets this cannot
+//  handle, which are left to poll ().
+//
+//  Each thread keeps up to poll_epoll_cache_slots item sets registered,
+//  told apart by the address of the items array, and replaces the least
+//  recently used one when a new array comes along. Passing different
+//  sets in the same array in turn still registers them anew every time.
+static int poll_large (zlink_pollitem_t *items_, int nitems_, long timeout_)
+{
+    struct poll_large_cache_t
+    {
+        const zlink_pollitem_t *key;
+        uint64_t last_used;
+        zlink::socket_poller_t *poller;
+        std::vector<zlink_pollitem_t> items;
+        std::vector<int> socket_ids;
+        std::vector<zlink::socket_poller_t::event_t> events;
+        bool unsupported;
+
+        poll_large_cache_t () :
+            key (NULL), last_used (0), poller (NULL), unsupported (false)
+        {
+        }
+        ~poll_large_cache_t () { delete poller; }
+    };
+
+    static thread_local poll_large_cache_t
+      caches[zlink::poll_epoll_cache_slots];
+    static thread_local uint64_t calls = 0;
+
+    poll_large_cache_t *slot = &caches[0];
+    for (int i = 0; i != zlink::poll_epoll_cache_slots; ++i) {
+        if (caches[i].key == items_) {
+            slot = &caches[i];
+            break;
+        }
+        if (caches[i].last_used < slot->last_used)
+            slot = &caches[i];
+    }
+    poll_large_cache_t &cache = *slot;
+    cache.last_used = ++calls;
+
+    bool rebuild = cache.key != items_ || !cache.poller
+                   || static_cast<int> (cache.items.size ()) != nitems_;
+    int active = 0;
+    for (int i = 0; i != nitems_ && !rebuild; ++i) {
+        zlink_pollitem_t &cached = cache.items[i];
+        if (cached.socket != items_[i].socket
+            || (!items_[i].socket && cached.fd != items_[i].fd)) {
+            rebuild = true;
+            break;
+        }
+        if (items_[i].socket) {
+            const zlink::socket_base_t *socket =
+              static_cast<zlink::socket_base_t *> (items_[i].socket);
+            if (!socket->check_tag ()) {
+                errno = ENOTSOCK;
+                return -1;
+            }
+            //  A new socket allocated where a closed one used to be.
+            if (socket->get_socket_id () != cache.socket_ids[i]) {
+                rebuild = true;
+                break;
+            }
+        }
+        if (cached.events != items_[i].events) {
+            cached.events = items_[i].events;
+            if (!cache.unsupported) {
+                const int rc =
+                  items_[i].socket
+                    ? cache.poller->modify (
+                      static_cast<zlink::socket_base_t *> (items_[i].socket),
+                      items_[i].events)
+                    : cache.poller->modify_fd (items_[i].fd, items_[i].events);
+                errno_assert (rc == 0);
+            }
+        }
+        if (items_[i].events)
+            active++;
+    }
+
+    if (rebuild) {
+        delete cache.poller;
+        cache.key = items_;
+        cache.poller = new (std::nothrow) zlink::socket_poller_t;
+        alloc_assert (cache.poller);
+        cache.items.assign (items_, items_ + nitems_);
+        cache.socket_ids.assign (nitems_, 0);
+        cache.events.resize (nitems_);
+        cache.unsupported = false;
+        active = 0;
+
+        for (int i = 0; i != nitems_; ++i) {
+            void *user_data =
+              reinterpret_cast<void *> (static_cast<intptr_t> (i));
+            int rc;
+            if (items_[i].socket) {
+                zlink::socket_base_t *socket =
+                  static_cast<zlink::socket_base_t *> (items_[i].socket);
+                if (!socket->check_tag ()) {
+                    delete cache.poller;
+                    cache.poller = NULL;
+                    errno = ENOTSOCK;
+                    return -1;
+                }
+                cache.socket_ids[i] = socket->get_socket_id ();
+                rc = cache.poller->add (socket, user_data, items_[i].events);
+            } else
+                rc = cache.poller->add_fd (items_[i].fd, user_data,
+                                           items_[i].events);
+
+            //  The same socket or descriptor listed twice.
+            if (rc == -1) {
+                cache.unsupported = true;
+                break;
+            }
+            if (items_[i].events)
+                active++;
+        }
+    }
+
+    //  Without any events to wait for, poll () sleeps for the timeout.
+    if (cache.unsupported || !active)
+        return -2;
+
+    for (int i = 0; i != nitems_; ++i)
+        items_[i].revents = 0;
+
+    const int rc = cache.poller->wait (&cache.events[0], nitems_, timeout_);
+    if (rc == -1)
+        return errno == EAGAIN ? 0 : -1;
+    for (int i = 0; i != rc; ++i) {
+        const intptr_t index =
+          reinterpret_cast<intptr_t> (cache.events[i].user_data);
+        items_[index].revents = cache.events[i].events;
+    }
+    return rc;
+}
+#endif
+
 int zlink_poll (zlink_pollitem_t *items_, int nitems_, long timeout_)
 {
     if (unlikely (nitems_ < 0)) {
@@ -1618,6 +1770,14 @@ int zlink_poll (zlink_pollitem_t *items_, int nitems_, long timeout_)
         return -1;
     }
 
+#if defined ZLINK_HAVE_EPOLL
+    if (nitems_ >= zlink::poll_epoll_threshold) {
+        const int rc = poll_large (items_, nitems_, timeout_);
+        if (rc != -2)
+            return rc;
+    }
+#endif
+
     struct poll_cache_t
     {
         std::vector<pollfd> pollfds;
@@ -1801,6 +1961,86 @@ int zlink_poll (zlink_pollitem_t *items_, int nitems_, long timeout_)
     return nevents;
 }
 
+//  Timers
+
+static zlink::timers_t *as_timers (void *timers_)
+{
+    zlink::timers_t *timers = static_cast<zlink::timers_t *> (timers_);
+    if (!timers || !timers->check_tag ()) {
+        errno = EFAULT;
+        return NULL;
+    }
+    return timers;
+}
+
+void *zlink_timers_new (void)
+{
+    zlink::timers_t *timers = new (std::nothrow) zlink::timers_t;
+    alloc_assert (timers);
+    return timers;
+}
+
+int zlink_timers_destroy (void **timers_p_)
+{
+    zlink::timers_t *timers = as_timers (timers_p_ ? *timers_p_ : NULL);
+    if (!timers)
+        return -1;
+    delete timers;
+    *timers_p_ = NULL;
+    return 0;
+}
+
+int zlink_timers_add (void *timers_,
+                      size_t interval_,
+                      zlink_timer_fn handler_,
+                      void *arg_)
+{
+    zlink::timers_t *timers = as_timers (timers_);
+    if (!timers)
+        return -1;
+    return timers->add (interval_, handler_, arg_);
+}
+
+int zlink_timers_cancel (void *timers_, int timer_id_)
+{
+    zlink::timers_t *timers = as_timers (timers_);
+    if (!timers)
+        return -1;
+    return timers->cancel (timer_id_);
+}
+
+int zlink_timers_set_interval (void *timers_, int timer_id_, size_t interval_)
+{
+    zlink::timers_t *timers = as_timers (timers_);
+    if (!timers)
+        return -1;
+    return timers->set_interval (timer_id_, interval_);
+}
+
+int zlink_timers_reset (void *timers_, int timer_id_)
+{
+    zlink::timers_t *timers = as_timers (timers_);
+    if (!timers)
+        return -1;
+    return timers->reset (timer_id_);
+}
+
+long zlink_timers_timeout (void *timers_)
+{
+    zlink::timers_t *timers = as_timers (timers_);
+    if (!timers)
+        return -1;
+    return timers->timeout ();
+}
+
+int zlink_timers_execute (void *timers_)
+{
+    zlink::timers_t *timers = as_timers (timers_);
+    if (!timers)
+        return -1;
+    return timers->execute ();
+}
+
 int zlink_proxy (void *frontend_, void *backend_, void *capture_)
 {
     if (!frontend_ || !backend_) {
@@ -44,6 +44,7 @@ struct command_t
         reaped,
         inproc_connected,
         conn_failed,
+        fan_out,
         done
     } type;
 
@@ -157,6 +158,13 @@ struct command_t
         {
         } reaped;
 
+        //  Sent by a socket to the helpers of its distributor to have them
+        //  take part in sending the message of the given fan-out job.
+        struct
+        {
+            uint64_t job;
+        } fan_out;
+
         //  Sent by reaper thread to the term thread when all the sockets
         //  are successfully deallocated.
         struct
@@ -0,0 +1,145 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+#include "core/command_batch.hpp"
+#include "core/ctx.hpp"
+
+#include <new>
+#include <vector>
+
+namespace
+{
+struct batch_state_t
+{
+    batch_state_t () : open (false), ctx (NULL) {}
+
+    bool open;
+
+    //  Context of the queued commands. A command for another context
+    //  flushes the batch first.
+    zlink::ctx_t *ctx;
+
+    //  Queued commands with their destination threads, in send order.
+    struct entry_t
+    {
+        uint32_t tid;
+        zlink::command_t cmd;
+    };
+    std::vector<entry_t> entries;
+
+    //  Scratch space to group the commands by destination thread: the
+    //  distinct threads in order of first use, commands queued per thread
+    //  (indexed by thread ID) and the grouped commands.
+    std::vector<uint32_t> destinations;
+    std::vector<size_t> counts;
+    std::vector<zlink::command_t> grouped;
+};
+
+batch_state_t &batch_state ()
+{
+    static thread_local batch_state_t state;
+    return state;
+}
+
+bool same_activation (const zlink::command_t &a_, const zlink::command_t &b_)
+{
+    return a_.destination == b_.destination && a_.type == b_.type
+           && (a_.type == zlink::command_t::activate_read
+               || a_.type == zlink::command_t::activate_write);
+}
+}
+
+zlink::command_batch_t::command_batch_t ()
+{
+    batch_state_t &state = batch_state ();
+    _outermost = !state.open;
+    state.open = true;
+}
+
+zlink::command_batch_t::~command_batch_t ()
+{
+    if (!_outermost)
+        return;
+    flush ();
+    batch_state ().open = false;
+}
+
+bool zlink::command_batch_t::add (ctx_t *ctx_,
+                                  uint32_t tid_,
+                                  const command_t &cmd_)
+{
+    batch_state_t &state = batch_state ();
+    if (!state.open)
+        return false;
+
+    if (state.ctx != ctx_) {
+        flush ();
+        state.ctx = ctx_;
+    }
+
+    if (!state.entries.empty ()) {
+        command_t &last = state.entries.back ().cmd;
+        if (same_activation (last, cmd_)) {
+            last = cmd_;
+            return true;
+        }
+    }
+
+    //  Everything flush () needs is allocated here, it runs in a
+    //  destructor.
+    try {
+        if (state.counts.size () <= tid_)
+            state.counts.resize (tid_ + 1, 0);
+        const size_t size = state.entries.size () + 1;
+        if (state.grouped.capacity () < size)
+            state.grouped.reserve (2 * size);
+        if (state.destinations.capacity () < state.counts.size ())
+            state.destinations.reserve (state.counts.size ());
+        const batch_state_t::entry_t entry = {tid_, cmd_};
+        state.entries.push_back (entry);
+    }
+    catch (const std::bad_alloc &) {
+        //  Send what is queued so far, and this one directly.
+        flush ();
+        return false;
+    }
+    return true;
+}
+
+void zlink::command_batch_t::flush ()
+{
+    batch_state_t &state = batch_state ();
+    const size_t size = state.entries.size ();
+    if (size == 0)
+        return;
+    ctx_t *ctx = state.ctx;
+    const batch_state_t::entry_t *entries = &state.entries[0];
+
+    //  Count the commands per destination, then lay them out grouped by
+    //  destination, keeping the send order within each group. Mostly all
+    //  of them go to one or two I/O threads.
+    state.destinations.clear ();
+    for (size_t i = 0; i != size; i++)
+        if (state.counts[entries[i].tid]++ == 0)
+            state.destinations.push_back (entries[i].tid);
+    size_t offset = 0;
+    for (size_t i = 0, n = state.destinations.size (); i != n; i++) {
+        const uint32_t tid = state.destinations[i];
+        const size_t count = state.counts[tid];
+        state.counts[tid] = offset;
+        offset += count;
+    }
+    state.grouped.resize (size);
+    for (size_t i = 0; i != size; i++)
+        state.grouped[state.counts[entries[i].tid]++] = entries[i].cmd;
+
+    offset = 0;
+    for (size_t i = 0, n = state.destinations.size (); i != n; i++) {
+        const uint32_t tid = state.destinations[i];
+        const size_t end = state.counts[tid];
+        ctx->send_commands (tid, &state.grouped[offset], end - offset);
+        offset = end;
+        state.counts[tid] = 0;
+    }
+    state.entries.clear ();
+}
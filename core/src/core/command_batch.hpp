@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_COMMAND_BATCH_HPP_INCLUDED__
+#define __ZLINK_COMMAND_BATCH_HPP_INCLUDED__
+
+#include "core/command.hpp"
+#include "utils/macros.hpp"
+#include "utils/stdint.hpp"
+
+namespace zlink
+{
+class ctx_t;
+
+//  While a batch is in scope, commands the calling thread sends are held
+//  back and delivered when it goes out of scope, grouped by destination
+//  thread, so that each mailbox is locked once and its receiver woken up
+//  at most once for the whole batch. Meant for calls that fan out to many
+//  pipes at once, such as dist_t::distribute. Batches nest, only the
+//  outermost one delivers.
+//
+//  An activate_read or activate_write following the same command for the
+//  same object is dropped; for activate_write the newer count is kept.
+
+class command_batch_t
+{
+  public:
+    command_batch_t ();
+    ~command_batch_t ();
+
+    //  Queues the command if the calling thread has a batch open. Returns
+    //  false if it has none, in which case the caller sends it right away.
+    static bool add (ctx_t *ctx_, uint32_t tid_, const command_t &cmd_);
+
+  private:
+    //  Delivers the queued commands of the calling thread.
+    static void flush ();
+
+    //  True for the batch that opened the thread's batching scope.
+    bool _outermost;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (command_batch_t)
+};
+}
+
+#endif
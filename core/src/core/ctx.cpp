@@ -6,6 +6,8 @@
 #include <unistd.h>
 #endif
 
+#include <algorithm>
+#include <iterator>
 #include <limits>
 #include <climits>
 #include <new>
@@ -13,6 +15,7 @@
 #include <string.h>
 
 #include "core/ctx.hpp"
+#include "core/command_batch.hpp"
 #include "sockets/socket_base.hpp"
 #include "core/io_thread.hpp"
 #include "core/reaper.hpp"
@@ -20,6 +23,8 @@
 #include "utils/err.hpp"
 #include "core/msg.hpp"
 #include "utils/random.hpp"
+#include "utils/chunk_pool.hpp"
+#include "utils/numa.hpp"
 
 #ifdef ZLINK_USE_NSS
 #include <nss.h>
@@ -51,7 +56,11 @@ zlink::ctx_t::ctx_t () :
     _max_msgsz (INT_MAX),
     _io_thread_count (ZLINK_IO_THREADS_DFLT),
     _blocky (true),
-    _ipv6 (false)
+    _ipv6 (false),
+    _chunk_pool_size (ZLINK_CHUNK_POOL_SIZE_DFLT),
+    _numa_aware (false),
+    _retired_commands (0),
+    _retired_wakeups (0)
 {
 #ifdef HAVE_FORK
     _pid = getpid ();
@@ -86,6 +95,11 @@ zlink::ctx_t::~ctx_t ()
     //  Deallocate the reaper thread object.
     LIBZLINK_DELETE (_reaper);
 
+    //  All pipes are gone with the threads that owned them.
+    for (chunk_pools_t::size_type i = 0, size = _chunk_pools.size ();
+         i != size; i++)
+        LIBZLINK_DELETE (_chunk_pools[i]);
+
     //  The mailboxes in _slots themselves were deallocated with their
     //  corresponding io_thread/socket objects.
 
@@ -242,6 +256,22 @@ int zlink::ctx_t::set (int option_, const void *optval_, size_t optvallen_)
             }
             break;
 
+        case ZLINK_CHUNK_POOL_SIZE:
+            if (is_int && value >= 0) {
+                scoped_lock_t locker (_opt_sync);
+                _chunk_pool_size = value;
+                return 0;
+            }
+            break;
+
+        case ZLINK_NUMA_AWARE:
+            if (is_int && value >= 0) {
+                scoped_lock_t locker (_opt_sync);
+                _numa_aware = (value != 0);
+                return 0;
+            }
+            break;
+
         default: {
             return thread_ctx_t::set (option_, optval_, optvallen_);
         }
@@ -312,6 +342,69 @@ int zlink::ctx_t::get (int option_, void *optval_, const size_t *optvallen_)
             }
             break;
 
+        case ZLINK_CHUNK_POOL_SIZE:
+            if (is_int) {
+                scoped_lock_t locker (_opt_sync);
+                *value = _chunk_pool_size;
+                return 0;
+            }
+            break;
+
+        case ZLINK_CHUNK_POOL_HITS:
+        case ZLINK_CHUNK_POOL_MISSES:
+        case ZLINK_CHUNK_POOL_DROPS:
+        case ZLINK_CHUNK_POOL_CACHED:
+            if (is_int) {
+                uint64_t count = 0;
+                for (chunk_pools_t::size_type i = 0,
+                                              size = _chunk_pools.size ();
+                     i != size; i++) {
+                    const chunk_pool_t *pool = _chunk_pools[i];
+                    if (option_ == ZLINK_CHUNK_POOL_HITS)
+                        count += pool->hits ();
+                    else if (option_ == ZLINK_CHUNK_POOL_MISSES)
+                        count += pool->misses ();
+                    else if (option_ == ZLINK_CHUNK_POOL_DROPS)
+                        count += pool->drops ();
+                    else
+                        count += pool->cached ();
+                }
+                *value = count < INT_MAX ? static_cast<int> (count) : INT_MAX;
+                return 0;
+            }
+            break;
+
+        case ZLINK_MAILBOX_COMMANDS:
+        case ZLINK_MAILBOX_WAKEUPS:
+            if (is_int) {
+                scoped_lock_t locker (_slot_sync);
+                uint64_t commands = _retired_commands;
+                uint64_t wakeups = _retired_wakeups;
+                for (std::vector<i_mailbox *>::size_type i = 0,
+                                                         size = _slots.size ();
+                     i != size; i++) {
+                    if (!_slots[i])
+                        continue;
+                    uint64_t slot_commands, slot_wakeups;
+                    _slots[i]->get_counters (&slot_commands, &slot_wakeups);
+                    commands += slot_commands;
+                    wakeups += slot_wakeups;
+                }
+                const uint64_t count =
+                  option_ == ZLINK_MAILBOX_COMMANDS ? commands : wakeups;
+                *value = count < INT_MAX ? static_cast<int> (count) : INT_MAX;
+                return 0;
+            }
+            break;
+
+        case ZLINK_NUMA_AWARE:
+            if (is_int) {
+                scoped_lock_t locker (_opt_sync);
+                *value = _numa_aware;
+                return 0;
+            }
+            break;
+
         default: {
             return thread_ctx_t::get (option_, optval_, optvallen_);
         }
@@ -341,7 +434,10 @@ bool zlink::ctx_t::start ()
     const int term_and_reaper_threads_count = 2;
     const int mazlink = _max_sockets;
     const int ios = _io_thread_count;
+    const int chunk_pool_size = _chunk_pool_size;
+    const bool numa_aware = _numa_aware;
     _opt_sync.unlock ();
+    const std::vector<numa_node_t> &numa_nodes = zlink::numa_nodes ();
     const int slot_count = mazlink + ios + term_and_reaper_threads_count;
     try {
         _slots.reserve (slot_count);
@@ -353,6 +449,21 @@ bool zlink::ctx_t::start ()
     }
     _slots.resize (term_and_reaper_threads_count);
 
+    //  With NUMA awareness every node gets its own pool, so that chunks
+    //  touched by threads of one node are not handed to another.
+    if (chunk_pool_size > 0) {
+        const size_t pool_count = numa_aware ? numa_nodes.size () : 1;
+        for (size_t i = 0; i != pool_count; i++) {
+            chunk_pool_t *pool = new (std::nothrow)
+              chunk_pool_t (message_pipe_chunk_size (), chunk_pool_size);
+            if (!pool) {
+                errno = ENOMEM;
+                goto fail_cleanup_slots;
+            }
+            _chunk_pools.push_back (pool);
+        }
+    }
+
     //  Initialise the infrastructure for zlink_ctx_term thread.
     _slots[term_tid] = &_term_mailbox;
 
@@ -381,6 +492,11 @@ bool zlink::ctx_t::start ()
             delete io_thread;
             goto fail_cleanup_reaper;
         }
+        //  Deal the threads out to the nodes in turn.
+        if (numa_aware)
+            io_thread->set_numa_node (
+              numa_nodes[(i - term_and_reaper_threads_count)
+                         % numa_nodes.size ()]);
         _io_threads.push_back (io_thread);
         _slots[i] = io_thread->get_mailbox ();
         io_thread->start ();
@@ -401,6 +517,10 @@ fail_cleanup_reaper:
     _reaper = NULL;
 
 fail_cleanup_slots:
+    for (chunk_pools_t::size_type i = 0, size = _chunk_pools.size ();
+         i != size; i++)
+        LIBZLINK_DELETE (_chunk_pools[i]);
+    _chunk_pools.clear ();
     _slots.clear ();
     return false;
 }
@@ -450,8 +570,12 @@ void zlink::ctx_t::destroy_socket (class socket_base_t *socket_)
 {
     scoped_lock_t locker (_slot_sync);
 
-    //  Free the associated thread slot.
+    //  Free the associated thread slot, keeping its mailbox counters.
     const uint32_t tid = socket_->get_tid ();
+    uint64_t commands, wakeups;
+    _slots[tid]->get_counters (&commands, &wakeups);
+    _retired_commands += commands;
+    _retired_wakeups += wakeups;
     _empty_slots.push_back (tid);
     _slots[tid] = NULL;
 
@@ -464,6 +588,19 @@ void zlink::ctx_t::destroy_socket (class socket_base_t *socket_)
         _reaper->stop ();
 }
 
+zlink::chunk_pool_t *zlink::ctx_t::get_chunk_pool () const
+{
+    if (_chunk_pools.size () <= 1)
+        return _chunk_pools.empty () ? NULL : _chunk_pools[0];
+
+    const std::vector<numa_node_t> &nodes = numa_nodes ();
+    const int node = numa_current_node ();
+    for (size_t i = 0, size = nodes.size (); i != size; i++)
+        if (nodes[i].id == node)
+            return _chunk_pools[i];
+    return _chunk_pools[0];
+}
+
 zlink::object_t *zlink::ctx_t::get_reaper () const
 {
     return _reaper;
@@ -478,10 +615,21 @@ zlink::thread_ctx_t::thread_ctx_t () :
 void zlink::thread_ctx_t::start_thread (thread_t &thread_,
                                       thread_fn *tfn_,
                                       void *arg_,
-                                      const char *name_) const
+                                      const char *name_,
+                                      const std::set<int> &cpus_) const
 {
+    //  Keep the CPUs both sets agree on. If they have none in common the
+    //  narrower request wins.
+    std::set<int> affinity_cpus = _thread_affinity_cpus;
+    if (!cpus_.empty ()) {
+        std::set<int> common;
+        std::set_intersection (cpus_.begin (), cpus_.end (),
+                               affinity_cpus.begin (), affinity_cpus.end (),
+                               std::inserter (common, common.begin ()));
+        affinity_cpus = common.empty () ? cpus_ : common;
+    }
     thread_.setSchedulingParameters (_thread_priority, _thread_sched_policy,
-                                     _thread_affinity_cpus);
+                                     affinity_cpus);
 
     char namebuf[16] = "";
     snprintf (namebuf, sizeof (namebuf), "%s%sZLINKbg%s%s",
@@ -591,28 +739,119 @@ int zlink::thread_ctx_t::get (int option_,
 
 void zlink::ctx_t::send_command (uint32_t tid_, const command_t &command_)
 {
-    _slots[tid_]->send (command_);
+    if (!command_batch_t::add (this, tid_, command_))
+        _slots[tid_]->send (command_);
+}
+
+void zlink::ctx_t::send_commands (uint32_t tid_,
+                                  const command_t *commands_,
+                                  size_t count_)
+{
+    _slots[tid_]->send (commands_, count_);
+}
+
+double zlink::ctx_t::busyness (const io_thread_t *io_thread_,
+                               uint64_t traffic_total_,
+                               int load_total_)
+{
+    //  Traffic is only known for the last complete window. The load term
+    //  also counts the objects placed during the current one, which may
+    //  not be registered yet. Weighing both keeps a burst of new sessions
+    //  from all landing on the thread that was quiet last window, and a
+    //  thread with few but heavy sessions from being picked over one with
+    //  many idle ones.
+    const double traffic =
+      traffic_total_ ? static_cast<double> (io_thread_->get_traffic ())
+                         / static_cast<double> (traffic_total_)
+                     : 0;
+    const double load =
+      load_total_ ? static_cast<double> (io_thread_->get_load ()
+                                         + io_thread_->get_placements ())
+                      / load_total_
+                  : 0;
+    return traffic + load;
 }
 
-zlink::io_thread_t *zlink::ctx_t::choose_io_thread (uint64_t affinity_)
+zlink::io_thread_t *zlink::ctx_t::choose_io_thread (uint64_t affinity_,
+                                                   int numa_node_)
 {
     if (_io_threads.empty ())
         return NULL;
 
-    //  Find the I/O thread with minimum load.
-    int min_load = -1;
+    //  Threads are only bound to nodes with NUMA awareness.
+    const bool numa_aware = _io_threads[0]->get_numa_node () >= 0;
+    const int node = !numa_aware       ? -1
+                     : numa_node_ >= 0 ? numa_node_
+                                       : numa_current_node ();
+
+    //  Find the least busy I/O thread. The second pass ignores the node
+    //  if no eligible thread is on it.
     io_thread_t *selected_io_thread = NULL;
+    for (int pass = node >= 0 ? 0 : 1; pass != 2 && !selected_io_thread;
+         pass++) {
+        std::vector<io_thread_t *> candidates;
+        uint64_t traffic_total = 0;
+        int load_total = 0;
+        for (io_threads_t::size_type i = 0, size = _io_threads.size ();
+             i != size; i++) {
+            if (affinity_ && !(affinity_ & (uint64_t (1) << i)))
+                continue;
+            if (pass == 0 && _io_threads[i]->get_numa_node () != node)
+                continue;
+            candidates.push_back (_io_threads[i]);
+            traffic_total += _io_threads[i]->get_traffic ();
+            load_total += _io_threads[i]->get_load ()
+                          + _io_threads[i]->get_placements ();
+        }
+
+        double min_busyness = 0;
+        for (size_t i = 0; i != candidates.size (); i++) {
+            const double b =
+              busyness (candidates[i], traffic_total, load_total);
+            if (selected_io_thread == NULL || b < min_busyness) {
+                selected_io_thread = candidates[i];
+                min_busyness = b;
+            }
+        }
+    }
+    if (selected_io_thread)
+        selected_io_thread->add_placement ();
+    return selected_io_thread;
+}
+
+void zlink::ctx_t::choose_io_threads (uint64_t affinity_,
+                                     int count_,
+                                     std::vector<io_thread_t *> &io_threads_)
+{
+    io_threads_.clear ();
+    uint64_t traffic_total = 0;
+    int load_total = 0;
     for (io_threads_t::size_type i = 0, size = _io_threads.size (); i != size;
          i++) {
         if (!affinity_ || (affinity_ & (uint64_t (1) << i))) {
-            const int load = _io_threads[i]->get_load ();
-            if (selected_io_thread == NULL || load < min_load) {
-                min_load = load;
-                selected_io_thread = _io_threads[i];
-            }
+            io_threads_.push_back (_io_threads[i]);
+            traffic_total += _io_threads[i]->get_traffic ();
+            load_total += _io_threads[i]->get_load ()
+                          + _io_threads[i]->get_placements ();
         }
     }
-    return selected_io_thread;
+
+    //  Keep the least busy threads when only a subset was requested.
+    if (count_ >= 0 && io_threads_.size () > static_cast<size_t> (count_)) {
+        std::vector<std::pair<double, io_thread_t *> > ranked;
+        for (size_t i = 0; i != io_threads_.size (); i++)
+            ranked.push_back (std::make_pair (
+              busyness (io_threads_[i], traffic_total, load_total),
+              io_threads_[i]));
+        std::stable_sort (ranked.begin (), ranked.end (),
+                          [] (const std::pair<double, io_thread_t *> &a_,
+                              const std::pair<double, io_thread_t *> &b_) {
+                              return a_.first < b_.first;
+                          });
+        io_threads_.resize (count_);
+        for (int i = 0; i != count_; i++)
+            io_threads_[i] = ranked[i].second;
+    }
 }
 
 int zlink::ctx_t::register_endpoint (const char *addr_,
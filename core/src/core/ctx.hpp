@@ -24,6 +24,7 @@ class io_thread_t;
 class socket_base_t;
 class reaper_t;
 class pipe_t;
+class chunk_pool_t;
 
 //  Information associated with inproc endpoint. Note that endpoint options
 //  are registered as well so that the peer can access them without a need
@@ -39,11 +40,13 @@ class thread_ctx_t
   public:
     thread_ctx_t ();
 
-    //  Start a new thread with proper scheduling parameters.
+    //  Start a new thread with proper scheduling parameters. A non-empty
+    //  cpus_ narrows the thread's CPU affinity to those CPUs.
     void start_thread (thread_t &thread_,
                        thread_fn *tfn_,
                        void *arg_,
-                       const char *name_ = NULL) const;
+                       const char *name_ = NULL,
+                       const std::set<int> &cpus_ = std::set<int> ()) const;
 
     int set (int option_, const void *optval_, size_t optvallen_);
     int get (int option_, void *optval_, const size_t *optvallen_);
@@ -99,14 +102,35 @@ class ctx_t ZLINK_FINAL : public thread_ctx_t
     //  Send command to the destination thread.
     void send_command (uint32_t tid_, const command_t &command_);
 
-    //  Returns the I/O thread that is the least busy at the moment.
-    //  Affinity specifies which I/O threads are eligible (0 = all).
+    //  Send count_ commands to the destination thread at once.
+    void send_commands (uint32_t tid_,
+                        const command_t *commands_,
+                        size_t count_);
+
+    //  Returns the I/O thread that is the least busy at the moment, going
+    //  by both the message bytes it carried over the last traffic window
+    //  and the number of objects registered with it. Affinity
+    //  specifies which I/O threads are eligible (0 = all). With NUMA
+    //  awareness, threads on numa_node_ (-1 = the caller's node) are
+    //  preferred over the others.
     //  Returns NULL if no I/O thread is available.
-    zlink::io_thread_t *choose_io_thread (uint64_t affinity_);
+    zlink::io_thread_t *choose_io_thread (uint64_t affinity_,
+                                          int numa_node_ = -1);
+
+    //  Fills io_threads_ with up to count_ I/O threads eligible under
+    //  affinity_, least busy first. Negative count_ means all of them.
+    void choose_io_threads (uint64_t affinity_,
+                            int count_,
+                            std::vector<zlink::io_thread_t *> &io_threads_);
 
     //  Returns reaper thread object.
     zlink::object_t *get_reaper () const;
 
+    //  Returns the chunk pool shared by the context's message pipes, or
+    //  NULL if it is disabled (ZLINK_CHUNK_POOL_SIZE of 0). With NUMA
+    //  awareness this is the pool of the caller's node.
+    zlink::chunk_pool_t *get_chunk_pool () const;
+
     //  Management of inproc endpoints.
     int register_endpoint (const char *addr_, const endpoint_t &endpoint_);
     int unregister_endpoint (const std::string &addr_,
@@ -208,6 +232,23 @@ class ctx_t ZLINK_FINAL : public thread_ctx_t
     //  Is IPv6 enabled on this context?
     bool _ipv6;
 
+    //  Number of message pipe chunks the chunk pool may cache.
+    int _chunk_pool_size;
+
+    //  Created on start so that they outlive every pipe of the context.
+    //  One per NUMA node, in the order of numa_nodes (), with NUMA
+    //  awareness and a single one otherwise.
+    typedef std::vector<zlink::chunk_pool_t *> chunk_pools_t;
+    chunk_pools_t _chunk_pools;
+
+    //  Are I/O threads grouped by NUMA node?
+    bool _numa_aware;
+
+    //  Mailbox counters of the sockets destroyed so far. Protected by
+    //  _slot_sync.
+    uint64_t _retired_commands;
+    uint64_t _retired_wakeups;
+
     ZLINK_NON_COPYABLE_NOR_MOVABLE (ctx_t)
 
 #ifdef HAVE_FORK
@@ -226,6 +267,11 @@ class ctx_t ZLINK_FINAL : public thread_ctx_t
                             const pending_connection_t &pending_connection_,
                             side side_);
 
+    //  How busy an I/O thread is compared to the others it competes with:
+    //  its share of their recent traffic plus its share of their load.
+    static double busyness (const zlink::io_thread_t *io_thread_,
+                            uint64_t traffic_total_,
+                            int load_total_);
 };
 }
 
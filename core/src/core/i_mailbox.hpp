@@ -3,6 +3,8 @@
 #ifndef __ZLINK_I_MAILBOX_HPP_INCLUDED__
 #define __ZLINK_I_MAILBOX_HPP_INCLUDED__
 
+#include <stddef.h>
+
 #include "utils/macros.hpp"
 #include "utils/stdint.hpp"
 
@@ -18,6 +20,13 @@ class i_mailbox
     virtual void send (const command_t &cmd_) = 0;
     virtual int recv (command_t *cmd_, int timeout_) = 0;
 
+    //  Sends count_ commands at once, waking the receiver at most once.
+    virtual void send (const command_t *cmds_, size_t count_) = 0;
+
+    //  Returns the number of commands sent to the mailbox so far and how
+    //  many times the receiver had to be woken up for them.
+    virtual void get_counters (uint64_t *commands_, uint64_t *wakeups_) = 0;
+
 
 #ifdef HAVE_FORK
     // close the file descriptors in the signaller. This is used in a forked
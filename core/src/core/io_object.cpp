@@ -73,6 +73,11 @@ void zlink::io_object_t::cancel_timer (int id_)
     _poller->cancel_timer (this, id_);
 }
 
+void zlink::io_object_t::add_traffic (size_t bytes_)
+{
+    _poller->add_traffic (bytes_);
+}
+
 void zlink::io_object_t::in_event ()
 {
     zlink_assert (false);
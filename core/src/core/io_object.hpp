@@ -42,6 +42,9 @@ class io_object_t : public i_poll_events
     void add_timer (int timeout_, int id_);
     void cancel_timer (int id_);
 
+    //  Accounts message bytes to the I/O thread's traffic.
+    void add_traffic (size_t bytes_);
+
     //  i_poll_events interface implementation.
     void in_event () ZLINK_OVERRIDE;
     void out_event () ZLINK_OVERRIDE;
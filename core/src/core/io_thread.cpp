@@ -10,7 +10,7 @@
 #include "core/ctx.hpp"
 
 zlink::io_thread_t::io_thread_t (ctx_t *ctx_, uint32_t tid_) :
-    object_t (ctx_, tid_)
+    object_t (ctx_, tid_), _numa_node (-1)
 {
     _poller = new (std::nothrow) poller_t (*ctx_);
     alloc_assert (_poller);
@@ -33,6 +33,12 @@ void zlink::io_thread_t::start ()
     _poller->start (name);
 }
 
+void zlink::io_thread_t::set_numa_node (const numa_node_t &node_)
+{
+    _numa_node = node_.id;
+    _poller->set_affinity_cpus (node_.cpus);
+}
+
 void zlink::io_thread_t::stop ()
 {
     send_stop ();
@@ -48,6 +54,21 @@ int zlink::io_thread_t::get_load () const
     return _poller->get_load ();
 }
 
+uint64_t zlink::io_thread_t::get_traffic () const
+{
+    return _poller->get_traffic ();
+}
+
+int zlink::io_thread_t::get_placements () const
+{
+    return _poller->get_placements ();
+}
+
+void zlink::io_thread_t::add_placement ()
+{
+    _poller->add_placement ();
+}
+
 void zlink::io_thread_t::in_event ()
 {
     process_mailbox ();
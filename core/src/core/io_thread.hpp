@@ -8,6 +8,7 @@
 #include "core/poller.hpp"
 #include "core/i_poll_events.hpp"
 #include "core/mailbox.hpp"
+#include "utils/numa.hpp"
 
 #include <boost/asio.hpp>
 
@@ -27,6 +28,13 @@ class io_thread_t ZLINK_FINAL : public object_t, public i_poll_events
     //  before invoking destructor. Otherwise the destructor would hang up.
     ~io_thread_t ();
 
+    //  Binds the thread to the CPUs of a NUMA node. Must be called
+    //  before start.
+    void set_numa_node (const numa_node_t &node_);
+
+    //  Returns the NUMA node the thread is bound to, or -1 if none.
+    int get_numa_node () const { return _numa_node; }
+
     //  Launch the physical thread.
     void start ();
 
@@ -53,6 +61,15 @@ class io_thread_t ZLINK_FINAL : public object_t, public i_poll_events
     //  Returns load experienced by the I/O thread.
     int get_load () const;
 
+    //  Returns message bytes carried by the I/O thread's sessions over
+    //  the last traffic window.
+    uint64_t get_traffic () const;
+
+    //  Returns how many objects were placed on the I/O thread during the
+    //  current traffic window, and counts one more.
+    int get_placements () const;
+    void add_placement ();
+
   private:
     //  I/O thread accesses incoming commands via this mailbox.
     mailbox_t _mailbox;
@@ -60,6 +77,9 @@ class io_thread_t ZLINK_FINAL : public object_t, public i_poll_events
     //  I/O multiplexing is performed using a poller object.
     poller_t *_poller;
 
+    //  NUMA node the thread is bound to, -1 if it is not bound.
+    int _numa_node;
+
     static void mailbox_handler (void *arg_);
     void process_mailbox ();
 
@@ -18,6 +18,8 @@ zlink::mailbox_t::mailbox_t ()
     _handler_arg = NULL;
     _pre_post = NULL;
     _scheduled.store (false, std::memory_order_release);
+    _commands = 0;
+    _wakeups = 0;
 }
 
 zlink::mailbox_t::~mailbox_t ()
@@ -36,11 +38,19 @@ zlink::fd_t zlink::mailbox_t::get_fd () const
 }
 
 void zlink::mailbox_t::send (const command_t &cmd_)
+{
+    send (&cmd_, 1);
+}
+
+void zlink::mailbox_t::send (const command_t *cmds_, size_t count_)
 {
     _sync.lock ();
-    _cpipe.write (cmd_, false);
+    for (size_t i = 0; i != count_; ++i)
+        _cpipe.write (cmds_[i], false);
     const bool ok = _cpipe.flush ();
+    _commands += count_;
     if (!ok) {
+        _wakeups++;
         // Signal all registered signalers for ZLINK_FD support
         for (std::vector<signaler_t *>::iterator it = _signalers.begin (),
                                                  end = _signalers.end ();
@@ -50,16 +60,25 @@ void zlink::mailbox_t::send (const command_t &cmd_)
     }
     _sync.unlock ();
 
-    if (!ok) {
+    if (!ok)
+        wake ();
+}
+
+void zlink::mailbox_t::wake ()
+{
+    //  A mailbox driven by an I/O thread is drained by the posted handler
+    //  alone, there's no one waiting on the signaler.
+    if (!_io_context)
         _signaler.send ();
-        schedule_if_needed ();
-    }
+    schedule_if_needed ();
 }
 
 int zlink::mailbox_t::recv (command_t *cmd_, int timeout_)
 {
     if (!_active) {
-        if (timeout_ == 0) {
+        if (_io_context) {
+            //  Woken up by the posted handler, see wake ().
+        } else if (timeout_ == 0) {
             // Avoid poll syscall on non-blocking checks.
             const int rc = _signaler.recv_failable ();
             if (rc == -1) {
@@ -85,6 +104,15 @@ int zlink::mailbox_t::recv (command_t *cmd_, int timeout_)
     return -1;
 }
 
+void zlink::mailbox_t::get_counters (uint64_t *commands_,
+                                     uint64_t *wakeups_)
+{
+    _sync.lock ();
+    *commands_ = _commands;
+    *wakeups_ = _wakeups;
+    _sync.unlock ();
+}
+
 bool zlink::mailbox_t::valid () const
 {
     return _signaler.valid ();
@@ -35,7 +35,9 @@ class mailbox_t ZLINK_FINAL : public i_mailbox
 
     fd_t get_fd () const;
     void send (const command_t &cmd_);
+    void send (const command_t *cmds_, size_t count_);
     int recv (command_t *cmd_, int timeout_);
+    void get_counters (uint64_t *commands_, uint64_t *wakeups_);
 
     bool valid () const;
 
@@ -64,6 +66,9 @@ class mailbox_t ZLINK_FINAL : public i_mailbox
 #endif
 
   private:
+    //  Wakes up the receiver after the pipe went from empty to non-empty.
+    void wake ();
+
     //  The pipe to store actual commands.
     typedef ypipe_t<command_t, command_pipe_granularity> cpipe_t;
     cpipe_t _cpipe;
@@ -78,6 +83,11 @@ class mailbox_t ZLINK_FINAL : public i_mailbox
     //  the sending side.
     mutex_t _sync;
 
+    //  Commands sent to the mailbox and the number of times the receiver
+    //  had to be woken up for them. Protected by _sync.
+    uint64_t _commands;
+    uint64_t _wakeups;
+
     boost::asio::io_context *_io_context;
     mailbox_handler_t _handler;
     void *_handler_arg;
@@ -239,6 +239,30 @@ int zlink::msg_t::init_cancel (const size_t size_, const unsigned char *topic_)
     return rc;
 }
 
+int zlink::msg_t::init_subscribe_bulk (const size_t size_,
+                                       const unsigned char *topics_)
+{
+    int rc = init_size (size_);
+    if (rc == 0) {
+        set_flags (zlink::msg_t::subscribe_bulk);
+        if (size_)
+            memcpy (data (), topics_, size_);
+    }
+    return rc;
+}
+
+int zlink::msg_t::init_cancel_bulk (const size_t size_,
+                                    const unsigned char *topics_)
+{
+    int rc = init_size (size_);
+    if (rc == 0) {
+        set_flags (zlink::msg_t::cancel_bulk);
+        if (size_)
+            memcpy (data (), topics_, size_);
+    }
+    return rc;
+}
+
 int zlink::msg_t::close ()
 {
     //  Check the validity of the message.
@@ -64,6 +64,8 @@ class msg_t
         subscribe = 12,
         cancel = 16,
         close_cmd = 20,
+        subscribe_bulk = 24,
+        cancel_bulk = 28,
         credential = 32,
         routing_id = 64,
         shared = 128
@@ -91,6 +93,10 @@ class msg_t
     int init_leave ();
     int init_subscribe (const size_t size_, const unsigned char *topic);
     int init_cancel (const size_t size_, const unsigned char *topic);
+    //  Bulk subscribe/cancel messages carry a packed topic list (see
+    //  utils/topic_list.hpp).
+    int init_subscribe_bulk (const size_t size_, const unsigned char *topics_);
+    int init_cancel_bulk (const size_t size_, const unsigned char *topics_);
     int close ();
     int move (msg_t &src_);
     int copy (msg_t &src_);
@@ -123,6 +129,16 @@ class msg_t
         return (_u.base.flags & CMD_TYPE_MASK) == cancel;
     }
 
+    bool is_subscribe_bulk () const
+    {
+        return (_u.base.flags & CMD_TYPE_MASK) == subscribe_bulk;
+    }
+
+    bool is_cancel_bulk () const
+    {
+        return (_u.base.flags & CMD_TYPE_MASK) == cancel_bulk;
+    }
+
     size_t command_body_size () const;
     void *command_body ();
     bool is_vsm () const;
@@ -124,6 +124,10 @@ void zlink::object_t::process_command (const command_t &cmd_)
             process_conn_failed ();
             break;
 
+        case command_t::fan_out:
+            process_fan_out (cmd_.args.fan_out.job);
+            break;
+
         case command_t::done:
         default:
             zlink_assert (false);
@@ -170,9 +174,16 @@ void zlink::object_t::destroy_socket (socket_base_t *socket_)
     _ctx->destroy_socket (socket_);
 }
 
-zlink::io_thread_t *zlink::object_t::choose_io_thread (uint64_t affinity_) const
+zlink::io_thread_t *zlink::object_t::choose_io_thread (uint64_t affinity_,
+                                                      int numa_node_) const
+{
+    return _ctx->choose_io_thread (affinity_, numa_node_);
+}
+
+void zlink::object_t::choose_io_threads (
+  uint64_t affinity_, int count_, std::vector<io_thread_t *> &io_threads_) const
 {
-    return _ctx->choose_io_thread (affinity_);
+    _ctx->choose_io_threads (affinity_, count_, io_threads_);
 }
 
 void zlink::object_t::send_stop ()
@@ -228,6 +239,15 @@ void zlink::object_t::send_conn_failed (session_base_t *destination_)
     send_command (cmd);
 }
 
+void zlink::object_t::send_fan_out (object_t *destination_, uint64_t job_)
+{
+    command_t cmd;
+    cmd.destination = destination_;
+    cmd.type = command_t::fan_out;
+    cmd.args.fan_out.job = job_;
+    send_command (cmd);
+}
+
 void zlink::object_t::send_bind (own_t *destination_,
                                pipe_t *pipe_,
                                bool inc_seqnum_)
@@ -461,6 +481,11 @@ void zlink::object_t::process_conn_failed ()
     zlink_assert (false);
 }
 
+void zlink::object_t::process_fan_out (uint64_t)
+{
+    zlink_assert (false);
+}
+
 void zlink::object_t::send_command (const command_t &cmd_)
 {
     _ctx->send_command (cmd_.destination->get_tid (), cmd_);
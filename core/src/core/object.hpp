@@ -4,6 +4,7 @@
 #define __ZLINK_OBJECT_HPP_INCLUDED__
 
 #include <string>
+#include <vector>
 
 #include "core/endpoint.hpp"
 #include "utils/macros.hpp"
@@ -59,7 +60,13 @@ class object_t
     void log (const char *format_, ...);
 
     //  Chooses least loaded I/O thread.
-    zlink::io_thread_t *choose_io_thread (uint64_t affinity_) const;
+    zlink::io_thread_t *choose_io_thread (uint64_t affinity_,
+                                          int numa_node_ = -1) const;
+
+    //  Chooses up to count_ I/O threads, least loaded first.
+    void choose_io_threads (uint64_t affinity_,
+                            int count_,
+                            std::vector<zlink::io_thread_t *> &io_threads_) const;
 
     //  Derived object can use these functions to send commands
     //  to other objects.
@@ -83,6 +90,7 @@ class object_t
     void send_reaped ();
     void send_done ();
     void send_conn_failed (zlink::session_base_t *destination_);
+    void send_fan_out (zlink::object_t *destination_, uint64_t job_);
 
 
     //  These handlers can be overridden by the derived objects. They are
@@ -105,6 +113,7 @@ class object_t
     virtual void process_reap (zlink::socket_base_t *socket_);
     virtual void process_reaped ();
     virtual void process_conn_failed ();
+    virtual void process_fan_out (uint64_t job_);
 
 
     //  Special handler called after a command that requires a seqnum
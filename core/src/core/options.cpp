@@ -156,6 +156,8 @@ zlink::options_t::options_t () :
     reconnect_ivl (100),
     reconnect_ivl_max (0),
     backlog (100),
+    tcp_accept_shards (0),
+    tcp_accept_cpu_affinity (false),
     maxmsgsize (-1),
     rcvtimeo (-1),
     sndtimeo (-1),
@@ -180,10 +182,18 @@ zlink::options_t::options_t () :
     use_fd (-1),
     in_batch_size (8192),
     out_batch_size (8192),
+    coalesce_delay (0),
     zero_copy (true),
     monitor_event_version (1),
     busy_poll (0),
-    zmp_metadata (false)
+    zmp_metadata (false),
+    ws_deflate (false),
+    ws_deflate_server_window_bits (15),
+    ws_deflate_client_window_bits (15),
+    ws_deflate_threshold (0),
+    low_memory (false),
+    low_memory_idle_ivl (1000),
+    numa_node (-1)
 #ifdef ZLINK_HAVE_TLS
     ,
     tls_verify (1),
@@ -286,6 +296,67 @@ int zlink::options_t::setsockopt (int option_,
             }
             break;
 
+        case ZLINK_TCP_ACCEPT_SHARDS:
+            if (is_int && value >= -1) {
+                tcp_accept_shards = value;
+                return 0;
+            }
+            break;
+
+        case ZLINK_TCP_ACCEPT_CPU_AFFINITY:
+            return do_setsockopt_int_as_bool_strict (optval_, optvallen_,
+                                                     &tcp_accept_cpu_affinity);
+
+        case ZLINK_COALESCE_DELAY:
+            if (is_int && value >= 0) {
+                coalesce_delay = value;
+                return 0;
+            }
+            break;
+
+        case ZLINK_WS_DEFLATE:
+            return do_setsockopt_int_as_bool_strict (optval_, optvallen_,
+                                                     &ws_deflate);
+
+        case ZLINK_WS_DEFLATE_SERVER_WINDOW_BITS:
+            if (is_int && value >= 9 && value <= 15) {
+                ws_deflate_server_window_bits = value;
+                return 0;
+            }
+            break;
+
+        case ZLINK_WS_DEFLATE_CLIENT_WINDOW_BITS:
+            if (is_int && value >= 9 && value <= 15) {
+                ws_deflate_client_window_bits = value;
+                return 0;
+            }
+            break;
+
+        case ZLINK_WS_DEFLATE_THRESHOLD:
+            if (is_int && value >= 0) {
+                ws_deflate_threshold = value;
+                return 0;
+            }
+            break;
+
+        case ZLINK_LOW_MEMORY:
+            return do_setsockopt_int_as_bool_strict (optval_, optvallen_,
+                                                     &low_memory);
+
+        case ZLINK_LOW_MEMORY_IDLE_IVL:
+            if (is_int && value > 0) {
+                low_memory_idle_ivl = value;
+                return 0;
+            }
+            break;
+
+        case ZLINK_NUMA_NODE:
+            if (is_int && value >= -1) {
+                numa_node = value;
+                return 0;
+            }
+            break;
+
         case ZLINK_RECONNECT_IVL:
             if (is_int && value >= -1) {
                 reconnect_ivl = value;
@@ -587,6 +658,76 @@ int zlink::options_t::getsockopt (int option_,
             }
             break;
 
+        case ZLINK_TCP_ACCEPT_SHARDS:
+            if (is_int) {
+                *value = tcp_accept_shards;
+                return 0;
+            }
+            break;
+
+        case ZLINK_TCP_ACCEPT_CPU_AFFINITY:
+            if (is_int) {
+                *value = tcp_accept_cpu_affinity ? 1 : 0;
+                return 0;
+            }
+            break;
+
+        case ZLINK_COALESCE_DELAY:
+            if (is_int) {
+                *value = coalesce_delay;
+                return 0;
+            }
+            break;
+
+        case ZLINK_WS_DEFLATE:
+            if (is_int) {
+                *value = ws_deflate ? 1 : 0;
+                return 0;
+            }
+            break;
+
+        case ZLINK_WS_DEFLATE_SERVER_WINDOW_BITS:
+            if (is_int) {
+                *value = ws_deflate_server_window_bits;
+                return 0;
+            }
+            break;
+
+        case ZLINK_WS_DEFLATE_CLIENT_WINDOW_BITS:
+            if (is_int) {
+                *value = ws_deflate_client_window_bits;
+                return 0;
+            }
+            break;
+
+        case ZLINK_WS_DEFLATE_THRESHOLD:
+            if (is_int) {
+                *value = ws_deflate_threshold;
+                return 0;
+            }
+            break;
+
+        case ZLINK_LOW_MEMORY:
+            if (is_int) {
+                *value = low_memory ? 1 : 0;
+                return 0;
+            }
+            break;
+
+        case ZLINK_LOW_MEMORY_IDLE_IVL:
+            if (is_int) {
+                *value = low_memory_idle_ivl;
+                return 0;
+            }
+            break;
+
+        case ZLINK_NUMA_NODE:
+            if (is_int) {
+                *value = numa_node;
+                return 0;
+            }
+            break;
+
         case ZLINK_RECONNECT_IVL:
             if (is_int) {
                 *value = reconnect_ivl;
@@ -94,6 +94,15 @@ struct options_t
     //  Maximum backlog for pending connections.
     int backlog;
 
+    //  Number of SO_REUSEPORT acceptors a tcp:// bind spreads over the
+    //  I/O threads; each one serves the connections it accepts.
+    //  Default 0 (single acceptor), -1 means one per eligible I/O thread.
+    int tcp_accept_shards;
+
+    //  If true, a reuseport BPF program steers each new connection to the
+    //  acceptor whose index matches the CPU that received it.
+    bool tcp_accept_cpu_affinity;
+
     //  Maximal size of message to handle.
     int64_t maxmsgsize;
 
@@ -193,6 +202,11 @@ struct options_t
     //  unnecessary network stack traversals.
     int out_batch_size;
 
+    //  Longest time, in microseconds, an engine may hold back output
+    //  smaller than out_batch_size waiting for more messages to coalesce
+    //  into the same write. Default 0 (write immediately).
+    int coalesce_delay;
+
     // Use zero copy strategy for storing message content when decoding.
     bool zero_copy;
 
@@ -214,6 +228,25 @@ struct options_t
     //  This option removes several delays caused by scheduling, interrupts and context switching.
     int busy_poll;
 
+    //  WebSocket permessage-deflate (RFC 7692). Off by default.
+    bool ws_deflate;
+    //  LZ77 window sizes (9..15) negotiated for each direction.
+    int ws_deflate_server_window_bits;
+    int ws_deflate_client_window_bits;
+    //  Messages smaller than this many bytes are sent uncompressed.
+    int ws_deflate_threshold;
+
+    //  Low-footprint mode for mostly idle connections: pipes start with
+    //  small chunks and engines give their buffers back to a shared pool
+    //  after low_memory_idle_ivl milliseconds without traffic.
+    bool low_memory;
+    int low_memory_idle_ivl;
+
+    //  NUMA node whose I/O threads should carry the socket's sessions
+    //  when the context is NUMA aware; -1 for the node of the thread
+    //  that binds or connects.
+    int numa_node;
+
 #ifdef ZLINK_HAVE_TLS
     //  TLS protocol options
     std::string tls_cert;              // Server certificate file path
@@ -11,11 +11,13 @@
 
 #include "core/ypipe.hpp"
 #include "core/ypipe_conflate.hpp"
+#include "core/ctx.hpp"
 
 int zlink::pipepair (object_t *parents_[2],
                    pipe_t *pipes_[2],
                    const int hwms_[2],
-                   const bool conflate_[2])
+                   const bool conflate_[2],
+                   const bool low_memory_[2])
 {
     //   Creates two pipe objects. These objects are connected by two ypipes,
     //   each to pass messages in one direction.
@@ -23,25 +25,35 @@ int zlink::pipepair (object_t *parents_[2],
     typedef ypipe_t<msg_t, message_pipe_granularity> upipe_normal_t;
     typedef ypipe_conflate_t<msg_t> upipe_conflate_t;
 
+    chunk_pool_t *const pool = parents_[0]->get_ctx ()->get_chunk_pool ();
+
     pipe_t::upipe_t *upipe1;
     if (conflate_[0])
         upipe1 = new (std::nothrow) upipe_conflate_t ();
     else
-        upipe1 = new (std::nothrow) upipe_normal_t ();
+        upipe1 = new (std::nothrow) upipe_normal_t (
+          low_memory_[0] ? message_pipe_low_memory_granularity
+                         : message_pipe_granularity,
+          pool);
     alloc_assert (upipe1);
 
     pipe_t::upipe_t *upipe2;
     if (conflate_[1])
         upipe2 = new (std::nothrow) upipe_conflate_t ();
     else
-        upipe2 = new (std::nothrow) upipe_normal_t ();
+        upipe2 = new (std::nothrow) upipe_normal_t (
+          low_memory_[1] ? message_pipe_low_memory_granularity
+                         : message_pipe_granularity,
+          pool);
     alloc_assert (upipe2);
 
     pipes_[0] = new (std::nothrow)
-      pipe_t (parents_[0], upipe1, upipe2, hwms_[1], hwms_[0], conflate_[0]);
+      pipe_t (parents_[0], upipe1, upipe2, hwms_[1], hwms_[0], conflate_[0],
+              low_memory_[0]);
     alloc_assert (pipes_[0]);
     pipes_[1] = new (std::nothrow)
-      pipe_t (parents_[1], upipe2, upipe1, hwms_[0], hwms_[1], conflate_[1]);
+      pipe_t (parents_[1], upipe2, upipe1, hwms_[0], hwms_[1], conflate_[1],
+              low_memory_[1]);
     alloc_assert (pipes_[1]);
 
     pipes_[0]->set_peer (pipes_[1]);
@@ -50,6 +62,12 @@ int zlink::pipepair (object_t *parents_[2],
     return 0;
 }
 
+size_t zlink::message_pipe_chunk_size ()
+{
+    return yqueue_t<msg_t, message_pipe_granularity>::chunk_bytes (
+      message_pipe_granularity);
+}
+
 void zlink::send_routing_id (pipe_t *pipe_, const options_t &options_)
 {
     zlink::msg_t id;
@@ -78,7 +96,8 @@ zlink::pipe_t::pipe_t (object_t *parent_,
                      upipe_t *outpipe_,
                      int inhwm_,
                      int outhwm_,
-                     bool conflate_) :
+                     bool conflate_,
+                     bool low_memory_) :
     object_t (parent_),
     _in_pipe (inpipe_),
     _out_pipe (outpipe_),
@@ -90,6 +109,7 @@ zlink::pipe_t::pipe_t (object_t *parent_,
     _out_hwm_boost (-1),
     _msgs_read (0),
     _msgs_written (0),
+    _msgs_dropped (0),
     _connected_time (0),
     _peers_msgs_read (0),
     _peer (NULL),
@@ -97,7 +117,8 @@ zlink::pipe_t::pipe_t (object_t *parent_,
     _state (active),
     _delay (true),
     _server_socket_routing_id (0),
-    _conflate (conflate_)
+    _conflate (conflate_),
+    _low_memory (low_memory_)
 {
     _disconnect_msg.init ();
 }
@@ -168,6 +189,21 @@ uint64_t zlink::pipe_t::get_connected_time () const
     return _connected_time;
 }
 
+void zlink::pipe_t::count_dropped ()
+{
+    _msgs_dropped++;
+}
+
+uint64_t zlink::pipe_t::get_msgs_dropped () const
+{
+    return _msgs_dropped;
+}
+
+uint64_t zlink::pipe_t::get_lag () const
+{
+    return _msgs_written - _peers_msgs_read;
+}
+
 bool zlink::pipe_t::check_read ()
 {
     if (unlikely (!_in_active))
@@ -527,7 +563,10 @@ void zlink::pipe_t::hiccup ()
     _in_pipe =
       _conflate
         ? static_cast<upipe_t *> (new (std::nothrow) ypipe_conflate_t<msg_t> ())
-        : new (std::nothrow) ypipe_t<msg_t, message_pipe_granularity> ();
+        : new (std::nothrow) ypipe_t<msg_t, message_pipe_granularity> (
+          _low_memory ? message_pipe_low_memory_granularity
+                      : message_pipe_granularity,
+          get_ctx ()->get_chunk_pool ());
 
     alloc_assert (_in_pipe);
     _in_active = true;
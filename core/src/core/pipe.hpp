@@ -25,10 +25,17 @@ class pipe_t;
 //  terminates straight away.
 //  If conflate is true, only the most recently arrived message could be
 //  read (older messages are discarded)
+//  If low_memory is true, the ypipe read by the corresponding pipe starts
+//  with small chunks (see message_pipe_low_memory_granularity).
 int pipepair (zlink::object_t *parents_[2],
               zlink::pipe_t *pipes_[2],
               const int hwms_[2],
-              const bool conflate_[2]);
+              const bool conflate_[2],
+              const bool low_memory_[2]);
+
+//  Size in bytes of a full message pipe chunk; the blocks of the context's
+//  chunk pool have this size.
+size_t message_pipe_chunk_size ();
 
 struct i_pipe_events
 {
@@ -53,7 +60,8 @@ class pipe_t ZLINK_FINAL : public object_t,
     friend int pipepair (zlink::object_t *parents_[2],
                          zlink::pipe_t *pipes_[2],
                          const int hwms_[2],
-                         const bool conflate_[2]);
+                         const bool conflate_[2],
+                         const bool low_memory_[2]);
 
   public:
     //  Specifies the object to send events to.
@@ -71,6 +79,14 @@ class pipe_t ZLINK_FINAL : public object_t,
     uint64_t get_msgs_read () const;
     uint64_t get_connected_time () const;
 
+    //  Messages the socket dropped instead of writing them to the pipe.
+    void count_dropped ();
+    uint64_t get_msgs_dropped () const;
+
+    //  Messages written that the peer has not reported as read yet. The
+    //  peer reports every low-water mark, so this may run a little high.
+    uint64_t get_lag () const;
+
     //  Returns true if there is at least one message to read in the pipe.
     bool check_read ();
 
@@ -149,7 +165,8 @@ class pipe_t ZLINK_FINAL : public object_t,
             upipe_t *outpipe_,
             int inhwm_,
             int outhwm_,
-            bool conflate_);
+            bool conflate_,
+            bool low_memory_);
 
     //  Pipepair uses this function to let us know about
     //  the peer pipe object.
@@ -179,6 +196,7 @@ class pipe_t ZLINK_FINAL : public object_t,
     //  Number of messages read and written so far.
     uint64_t _msgs_read;
     uint64_t _msgs_written;
+    uint64_t _msgs_dropped;
     uint64_t _connected_time;
 
     //  Last received peer's msgs_read. The actual number in the peer
@@ -231,6 +249,9 @@ class pipe_t ZLINK_FINAL : public object_t,
 
     const bool _conflate;
 
+    //  If true, inpipes created on hiccup start with small chunks.
+    const bool _low_memory;
+
     // The endpoints of this pipe.
     endpoint_uri_pair_t _endpoint_pair;
 
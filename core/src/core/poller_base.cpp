@@ -3,8 +3,17 @@
 #include "utils/precompiled.hpp"
 #include "core/poller_base.hpp"
 #include "core/i_poll_events.hpp"
+#include "utils/config.hpp"
 #include "utils/err.hpp"
 
+zlink::poller_base_t::poller_base_t () :
+    _traffic_current (0),
+    _traffic_window_start (0),
+    _traffic (0),
+    _placements (0)
+{
+}
+
 zlink::poller_base_t::~poller_base_t ()
 {
     //  Make sure there is no more load on the shutdown.
@@ -24,31 +33,63 @@ void zlink::poller_base_t::adjust_load (int amount_)
         _load.sub (-amount_);
 }
 
+uint64_t zlink::poller_base_t::get_traffic () const
+{
+    return _traffic.load (std::memory_order_relaxed);
+}
+
+void zlink::poller_base_t::add_traffic (size_t bytes_)
+{
+    _traffic_current += bytes_;
+}
+
+int zlink::poller_base_t::get_placements () const
+{
+    return _placements.load (std::memory_order_relaxed);
+}
+
+void zlink::poller_base_t::add_placement ()
+{
+    _placements.fetch_add (1, std::memory_order_relaxed);
+}
+
+void zlink::poller_base_t::update_traffic ()
+{
+    const uint64_t now = _clock.now_ms ();
+    if (_traffic_window_start == 0) {
+        _traffic_window_start = now;
+        return;
+    }
+    const uint64_t elapsed = now - _traffic_window_start;
+    if (elapsed < traffic_window_ms)
+        return;
+
+    _placements.store (0, std::memory_order_relaxed);
+
+    //  Scale to the nominal window length, as a loop stuck in a long
+    //  handler may close the window late.
+    _traffic.store (_traffic_current * traffic_window_ms / elapsed,
+                    std::memory_order_relaxed);
+    _traffic_current = 0;
+    _traffic_window_start = now;
+}
+
 void zlink::poller_base_t::add_timer (int timeout_, i_poll_events *sink_, int id_)
 {
-    uint64_t expiration = _clock.now_ms () + timeout_;
-    timer_info_t info = {sink_, id_};
-    _timers.insert (timers_t::value_type (expiration, info));
+    _timers.add (_clock.now_ms (), timeout_, sink_, id_);
 }
 
 void zlink::poller_base_t::cancel_timer (i_poll_events *sink_, int id_)
 {
-    //  Complexity of this operation is O(n). We assume it is rarely used.
-    for (timers_t::iterator it = _timers.begin (), end = _timers.end ();
-         it != end; ++it)
-        if (it->second.sink == sink_ && it->second.id == id_) {
-            _timers.erase (it);
-            return;
-        }
-
-    //  We should generally never get here. Calling 'cancel_timer ()' on
-    //  an already expired or canceled timer (or even worse - on a timer which
-    //  never existed, supplying bad sink_ and/or id_ values) does not make any
-    //  sense.
+    _timers.cancel (sink_, id_);
+
+    //  Calling 'cancel_timer ()' on an already expired or canceled timer
+    //  (or even worse - on a timer which never existed, supplying bad
+    //  sink_ and/or id_ values) does not make any sense.
     //  But in some edge cases this might happen. As described in issue #3645
     //  `timer_event ()` call from `execute_timers ()` might call `cancel_timer ()`
     //  on already canceled (deleted) timer.
-    //  As soon as that is resolved an 'assert (false)' should be put here.
+    //  As soon as that is resolved this should assert the timer was found.
 }
 
 uint64_t zlink::poller_base_t::execute_timers ()
@@ -60,35 +101,20 @@ uint64_t zlink::poller_base_t::execute_timers ()
     //  Get the current time.
     const uint64_t current = _clock.now_ms ();
 
-    //  Execute the timers that are already due.
-    uint64_t res = 0;
-    timer_info_t timer_temp;
-    timers_t::iterator it;
-
-    do {
-        it = _timers.begin ();
-
-        //  If we have to wait to execute the item, same will be true for
-        //  all the following items because multimap is sorted. Thus we can
-        //  stop checking the subsequent timers.
-        if (it->first > current) {
-            res = it->first - current;
-            break;
-        }
-
-        //  Save and remove the timer because timer_event() call might delete
-        //  exactly this timer and then the iterator will be invalid.
-        timer_temp = it->second;
-        _timers.erase (it);
-
-        //  Trigger the timer.
-        timer_temp.sink->timer_event (timer_temp.id);
-
-    } while (!_timers.empty ());
+    //  Execute the timers that are already due. Each one is taken off the
+    //  wheel before its timer_event () call, which may arm or cancel
+    //  timers, this one included.
+    void *sink;
+    int id;
+    while (_timers.pop (current, &sink, &id))
+        static_cast<i_poll_events *> (sink)->timer_event (id);
 
     //  Return the time to wait for the next timer (at least 1ms), or 0, if
     //  there are no more timers.
-    return res;
+    if (_timers.empty ())
+        return 0;
+    const uint64_t next = _timers.next_expiry ();
+    return next > current ? next - current : 1;
 }
 
 zlink::worker_poller_base_t::worker_poller_base_t (const thread_ctx_t &ctx_) :
@@ -103,7 +129,13 @@ void zlink::worker_poller_base_t::stop_worker ()
 
 void zlink::worker_poller_base_t::start (const char *name_)
 {
-    _ctx.start_thread (_worker, worker_routine, this, name_);
+    _ctx.start_thread (_worker, worker_routine, this, name_, _affinity_cpus);
+}
+
+void zlink::worker_poller_base_t::set_affinity_cpus (const std::set<int> &cpus_)
+{
+    zlink_assert (!_worker.get_started ());
+    _affinity_cpus = cpus_;
 }
 
 void zlink::worker_poller_base_t::check_thread () const
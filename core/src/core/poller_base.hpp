@@ -3,10 +3,12 @@
 #ifndef __ZLINK_POLLER_BASE_HPP_INCLUDED__
 #define __ZLINK_POLLER_BASE_HPP_INCLUDED__
 
-#include <map>
+#include <atomic>
+#include <set>
 
 #include "utils/clock.hpp"
 #include "utils/atomic_counter.hpp"
+#include "utils/timer_wheel.hpp"
 #include "core/ctx.hpp"
 
 namespace zlink
@@ -25,6 +27,19 @@ struct i_poll_events;
 //   Returns load of the poller.
 // int get_load() const;
 //
+//   Returns the message bytes carried by the poller's objects during the
+//   last complete traffic window.
+// uint64_t get_traffic() const;
+//
+//   Accounts bytes_ of message data to the current traffic window.
+// void add_traffic(size_t bytes_);
+//
+//   Returns the number of objects placed on the poller's thread since the
+//   current traffic window opened, and counts one more. Both may be called
+//   from any thread.
+// int get_placements() const;
+// void add_placement();
+//
 //   Add a timeout to expire in timeout_ milliseconds. After the
 //   expiration, timer_event on sink_ object will be called with
 //   argument set to id_.
@@ -67,7 +82,7 @@ struct i_poll_events;
 // Most of the methods may only be called from a zlink::i_poll_events callback
 // function when invoked by the poller (and, therefore, typically from the
 // poller's worker thread), with the following exceptions:
-// - get_load may be called from outside
+// - get_load and get_traffic may be called from outside
 // - add_fd and add_timer may be called from outside before start
 // - start may be called from outside once
 //
@@ -95,11 +110,15 @@ struct i_poll_events;
 class poller_base_t
 {
   public:
-    poller_base_t () ZLINK_DEFAULT;
+    poller_base_t ();
     virtual ~poller_base_t ();
 
     // Methods from the poller concept.
     int get_load () const;
+    uint64_t get_traffic () const;
+    void add_traffic (size_t bytes_);
+    int get_placements () const;
+    void add_placement ();
     void add_timer (int timeout_, zlink::i_poll_events *sink_, int id_);
     void cancel_timer (zlink::i_poll_events *sink_, int id_);
 
@@ -111,23 +130,33 @@ class poller_base_t
     //  to wait to match the next timer or 0 meaning "no timers".
     uint64_t execute_timers ();
 
+    //  Closes the current traffic window once it is traffic_window_ms
+    //  old. Should be called by the worker loop at least every 100 ms.
+    void update_traffic ();
+
   private:
     //  Clock instance private to this I/O thread.
     clock_t _clock;
 
-    //  List of active timers.
-    struct timer_info_t
-    {
-        zlink::i_poll_events *sink;
-        int id;
-    };
-    typedef std::multimap<uint64_t, timer_info_t> timers_t;
-    timers_t _timers;
+    //  Active timers of all objects living in this I/O thread, keyed by
+    //  their sink and id.
+    timer_wheel_t _timers;
 
     //  Load of the poller. Currently the number of file descriptors
     //  registered.
     atomic_counter_t _load;
 
+    //  Message bytes accounted to the open traffic window, the time the
+    //  window was opened at and the bytes of the last complete window.
+    //  Only the last one is read by other threads.
+    uint64_t _traffic_current;
+    uint64_t _traffic_window_start;
+    std::atomic<uint64_t> _traffic;
+
+    //  Objects placed on this thread since the window opened. They may
+    //  not have registered anything yet, so the load doesn't show them.
+    std::atomic<int> _placements;
+
     ZLINK_NON_COPYABLE_NOR_MOVABLE (poller_base_t)
 };
 
@@ -140,6 +169,9 @@ class worker_poller_base_t : public poller_base_t
     // Methods from the poller concept.
     void start (const char *name = NULL);
 
+    //  Restricts the worker thread to cpus_. Must be called before start.
+    void set_affinity_cpus (const std::set<int> &cpus_);
+
   protected:
     //  Checks whether the currently executing thread is the worker thread
     //  via an assertion.
@@ -162,6 +194,10 @@ class worker_poller_base_t : public poller_base_t
 
     //  Handle of the physical thread doing the I/O work.
     thread_t _worker;
+
+    //  CPUs the worker thread is restricted to, on top of the context's
+    //  thread affinity. Empty means no restriction.
+    std::set<int> _affinity_cpus;
 };
 }
 
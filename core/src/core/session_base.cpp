@@ -140,6 +140,7 @@ int zlink::session_base_t::pull_msg (msg_t *msg_)
     }
 
     _incomplete_in = (msg_->flags () & msg_t::more) != 0;
+    add_traffic (msg_->size ());
 
     return 0;
 }
@@ -150,7 +151,9 @@ int zlink::session_base_t::push_msg (msg_t *msg_)
     if ((msg_->flags () & msg_t::command) && !msg_->is_subscribe ()
         && !msg_->is_cancel ())
         return 0;
+    const size_t size = msg_->size ();
     if (_pipe && _pipe->write (msg_)) {
+        add_traffic (size);
         const int rc = msg_->init ();
         errno_assert (rc == 0);
         return 0;
@@ -296,7 +299,8 @@ void zlink::session_base_t::engine_ready ()
         int hwms[2] = {conflate ? -1 : options.rcvhwm,
                        conflate ? -1 : options.sndhwm};
         bool conflates[2] = {conflate, conflate};
-        const int rc = pipepair (parents, pipes, hwms, conflates);
+        bool low_memory[2] = {options.low_memory, options.low_memory};
+        const int rc = pipepair (parents, pipes, hwms, conflates, low_memory);
         errno_assert (rc == 0);
 
         //  Plug the local end of the pipe.
@@ -472,7 +476,8 @@ void zlink::session_base_t::start_connecting (bool wait_)
 
     //  Choose I/O thread to run connecter in. Given that we are already
     //  running in an I/O thread, there must be at least one available.
-    io_thread_t *io_thread = choose_io_thread (options.affinity);
+    io_thread_t *io_thread =
+      choose_io_thread (options.affinity, options.numa_node);
     zlink_assert (io_thread);
 
     //  Create the connecter object.
@@ -7,6 +7,7 @@
 #include "utils/macros.hpp"
 
 #include <limits.h>
+#include <string.h>
 
 // compare elements to value
 template <class It, class T, class Pred>
@@ -22,7 +23,10 @@ static It find_if2 (It b_, It e_, const T &value, Pred pred)
 
 zlink::socket_poller_t::socket_poller_t () :
     _tag (0xCAFEBABE)
-#if defined ZLINK_POLL_BASED_ON_POLL
+#if defined ZLINK_HAVE_EPOLL
+    ,
+    _epoll_fd (retired_fd)
+#elif defined ZLINK_POLL_BASED_ON_POLL
     ,
     _pollfds (NULL)
 #elif defined ZLINK_POLL_BASED_ON_SELECT
@@ -38,7 +42,10 @@ zlink::socket_poller_t::~socket_poller_t ()
     //  Mark the socket_poller as dead
     _tag = 0xdeadbeef;
 
-#if defined ZLINK_POLL_BASED_ON_POLL
+#if defined ZLINK_HAVE_EPOLL
+    if (_epoll_fd != retired_fd)
+        close (_epoll_fd);
+#elif defined ZLINK_POLL_BASED_ON_POLL
     if (_pollfds) {
         free (_pollfds);
         _pollfds = NULL;
@@ -73,7 +80,12 @@ int zlink::socket_poller_t::add (socket_base_t *socket_,
         0,
         user_data_,
         events_
-#if defined ZLINK_POLL_BASED_ON_POLL
+#if defined ZLINK_HAVE_EPOLL
+        ,
+        0,
+        false,
+        0
+#elif defined ZLINK_POLL_BASED_ON_POLL
         ,
         -1
 #endif
@@ -103,7 +115,12 @@ int zlink::socket_poller_t::add_fd (fd_t fd_, void *user_data_, short events_)
         fd_,
         user_data_,
         events_
-#if defined ZLINK_POLL_BASED_ON_POLL
+#if defined ZLINK_HAVE_EPOLL
+        ,
+        0,
+        false,
+        0
+#elif defined ZLINK_POLL_BASED_ON_POLL
         ,
         -1
 #endif
@@ -130,6 +147,12 @@ int zlink::socket_poller_t::modify (const socket_base_t *socket_, short events_)
         return -1;
     }
 
+#if defined ZLINK_HAVE_EPOLL
+    if (!_need_rebuild) {
+        update_item (it - _items.begin (), events_);
+        return 0;
+    }
+#endif
     it->events = events_;
     _need_rebuild = true;
 
@@ -147,6 +170,12 @@ int zlink::socket_poller_t::modify_fd (fd_t fd_, short events_)
         return -1;
     }
 
+#if defined ZLINK_HAVE_EPOLL
+    if (!_need_rebuild) {
+        update_item (it - _items.begin (), events_);
+        return 0;
+    }
+#endif
     it->events = events_;
     _need_rebuild = true;
 
@@ -191,7 +220,47 @@ int zlink::socket_poller_t::rebuild ()
     _pollset_size = 0;
     _need_rebuild = false;
 
-#if defined ZLINK_POLL_BASED_ON_POLL
+#if defined ZLINK_HAVE_EPOLL
+
+    //  Start over with a fresh epoll set as item indices have moved.
+    if (_epoll_fd != retired_fd)
+        close (_epoll_fd);
+    _epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+    if (_epoll_fd == retired_fd) {
+        _need_rebuild = true;
+        return -1;
+    }
+    _pending.clear ();
+
+    for (size_t i = 0, size = _items.size (); i != size; ++i) {
+        item_t &item = _items[i];
+        item.pending = false;
+        item.revents = 0;
+        if (!item.events)
+            continue;
+        if (register_item (i, EPOLL_CTL_ADD) == -1) {
+            _need_rebuild = true;
+            return -1;
+        }
+        _pollset_size++;
+
+        //  Nothing is known about the sockets yet.
+        if (item.socket) {
+            item.pending = true;
+            _pending.push_back (i);
+        }
+    }
+
+    try {
+        _epoll_events.resize (_pollset_size > 0 ? _pollset_size : 1);
+    }
+    catch (const std::bad_alloc &) {
+        errno = ENOMEM;
+        _need_rebuild = true;
+        return -1;
+    }
+
+#elif defined ZLINK_POLL_BASED_ON_POLL
 
     if (_pollfds) {
         free (_pollfds);
@@ -308,6 +377,120 @@ void zlink::socket_poller_t::zero_trail_events (
     }
 }
 
+#if defined ZLINK_HAVE_EPOLL
+int zlink::socket_poller_t::register_item (size_t index_, int op_)
+{
+    const item_t &item = _items[index_];
+    fd_t fd = item.fd;
+    epoll_event ev;
+    memset (&ev, 0, sizeof (ev));
+    ev.data.u64 = index_;
+    if (item.socket) {
+        size_t fd_size = sizeof (zlink::fd_t);
+        const int rc = item.socket->getsockopt (ZLINK_FD, &fd, &fd_size);
+        zlink_assert (rc == 0);
+        ev.events = EPOLLIN;
+    } else {
+        if (item.events & ZLINK_POLLIN)
+            ev.events |= EPOLLIN;
+        if (item.events & ZLINK_POLLOUT)
+            ev.events |= EPOLLOUT;
+        if (item.events & ZLINK_POLLPRI)
+            ev.events |= EPOLLPRI;
+    }
+    return epoll_ctl (_epoll_fd, op_, fd, &ev);
+}
+
+void zlink::socket_poller_t::update_item (size_t index_, short events_)
+{
+    item_t &item = _items[index_];
+    const short old_events = item.events;
+    item.events = events_;
+
+    //  A socket's descriptor is watched for input whatever it is polled
+    //  for, so it only needs to be touched when polling starts or stops.
+    int op = -1;
+    if (!old_events && events_)
+        op = EPOLL_CTL_ADD;
+    else if (old_events && !events_)
+        op = EPOLL_CTL_DEL;
+    else if (events_ && !item.socket)
+        op = EPOLL_CTL_MOD;
+
+    //  Leave failures to be reported by the next wait.
+    if (op != -1 && register_item (index_, op) == -1) {
+        _need_rebuild = true;
+        return;
+    }
+    if (op == EPOLL_CTL_ADD)
+        _pollset_size++;
+    else if (op == EPOLL_CTL_DEL)
+        _pollset_size--;
+
+    //  The socket may be ready for the new events already.
+    if (item.socket && events_ && !item.pending) {
+        item.pending = true;
+        _pending.push_back (index_);
+    }
+}
+
+int zlink::socket_poller_t::check_events (zlink::socket_poller_t::event_t *events_,
+                                        int n_events_)
+{
+    int found = 0;
+    size_t kept = 0;
+    const size_t size = _pending.size ();
+    size_t i = 0;
+    for (; i != size; ++i) {
+        const size_t index = _pending[i];
+        item_t &item = _items[index];
+        if (found == n_events_) {
+            _pending[kept++] = index;
+            continue;
+        }
+
+        short events = 0;
+        if (item.socket) {
+            if (item.events) {
+                uint32_t socket_events;
+                if (item.socket->get_events (item.events, &socket_events)
+                    == -1)
+                    break;
+                item.command_batches = item.socket->command_batches ();
+                events = static_cast<short> (item.events & socket_events);
+            }
+        } else {
+            events = item.revents;
+            item.revents = 0;
+        }
+
+        if (!events) {
+            item.pending = false;
+            continue;
+        }
+
+        events_[found].socket = item.socket;
+        events_[found].fd = item.socket ? zlink::retired_fd : item.fd;
+        events_[found].user_data = item.user_data;
+        events_[found].events = events;
+        ++found;
+
+        //  Nothing signals a socket that stops being ready, so it is
+        //  checked again next time. Descriptors are level-triggered.
+        if (item.socket)
+            _pending[kept++] = index;
+        else
+            item.pending = false;
+    }
+
+    //  On failure keep whatever has not been checked yet.
+    const bool failed = i != size;
+    for (; i != size; ++i)
+        _pending[kept++] = _pending[i];
+    _pending.resize (kept);
+    return failed ? -1 : found;
+}
+#else
 #if defined ZLINK_POLL_BASED_ON_POLL
 int zlink::socket_poller_t::check_events (zlink::socket_poller_t::event_t *events_,
                                         int n_events_)
@@ -381,6 +564,7 @@ int zlink::socket_poller_t::check_events (zlink::socket_poller_t::event_t *event
 
     return found;
 }
+#endif
 
 //Return 0 if timeout is expired otherwise 1
 int zlink::socket_poller_t::adjust_timeout (zlink::clock_t &clock_,
@@ -470,7 +654,78 @@ int zlink::socket_poller_t::wait (zlink::socket_poller_t::event_t *events_,
 #endif
     }
 
-#if defined ZLINK_POLL_BASED_ON_POLL
+#if defined ZLINK_HAVE_EPOLL
+    zlink::clock_t clock;
+    uint64_t now = 0;
+    uint64_t end = 0;
+
+    bool first_pass = true;
+
+    //  Sends and receives since the last wait may have consumed the
+    //  ZLINK_FD signal of sockets that are ready now.
+    for (size_t i = 0, size = _items.size (); i != size; ++i) {
+        item_t &item = _items[i];
+        if (item.socket && item.events && !item.pending
+            && item.socket->command_batches () != item.command_batches) {
+            item.pending = true;
+            _pending.push_back (i);
+        }
+    }
+
+    while (true) {
+        //  Compute the timeout for the subsequent poll.
+        int timeout;
+        if (first_pass)
+            timeout = 0;
+        else if (timeout_ < 0)
+            timeout = -1;
+        else
+            timeout =
+              static_cast<int> (std::min<uint64_t> (end - now, INT_MAX));
+
+        //  Wait for events.
+        const int rc =
+          epoll_wait (_epoll_fd, &_epoll_events[0],
+                      static_cast<int> (_epoll_events.size ()), timeout);
+        if (rc == -1 && errno == EINTR) {
+            return -1;
+        }
+        errno_assert (rc >= 0);
+
+        for (int i = 0; i != rc; ++i) {
+            const size_t index = static_cast<size_t> (_epoll_events[i].data.u64);
+            item_t &item = _items[index];
+            if (!item.socket) {
+                const uint32_t revents = _epoll_events[i].events;
+                item.revents = static_cast<short> (
+                  (revents & EPOLLIN ? ZLINK_POLLIN : 0)
+                  | (revents & EPOLLOUT ? ZLINK_POLLOUT : 0)
+                  | (revents & EPOLLPRI ? ZLINK_POLLPRI : 0)
+                  | (revents & ~(EPOLLIN | EPOLLOUT | EPOLLPRI) ? ZLINK_POLLERR
+                                                               : 0));
+            }
+            if (!item.pending) {
+                item.pending = true;
+                _pending.push_back (index);
+            }
+        }
+
+        //  Check for the events.
+        const int found = check_events (events_, n_events_);
+        if (found) {
+            if (found > 0)
+                zero_trail_events (events_, n_events_, found);
+            return found;
+        }
+
+        //  Adjust timeout or break
+        if (adjust_timeout (clock, timeout_, now, end, first_pass) == 0)
+            break;
+    }
+    errno = EAGAIN;
+    return -1;
+
+#elif defined ZLINK_POLL_BASED_ON_POLL
     zlink::clock_t clock;
     uint64_t now = 0;
     uint64_t end = 0;
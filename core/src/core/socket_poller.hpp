@@ -5,7 +5,9 @@
 
 #include "core/poller.hpp"
 
-#if defined ZLINK_POLL_BASED_ON_POLL && !defined ZLINK_HAVE_WINDOWS
+#if defined ZLINK_HAVE_EPOLL
+#include <sys/epoll.h>
+#elif defined ZLINK_POLL_BASED_ON_POLL && !defined ZLINK_HAVE_WINDOWS
 #include <poll.h>
 #endif
 
@@ -35,6 +37,11 @@ typedef struct zlink_poller_event_t
 
 namespace zlink
 {
+//  Where epoll is available the pollset is kept registered with the kernel
+//  between waits and only sockets whose ZLINK_FD fired, whose commands
+//  were processed elsewhere, or that were ready last time are asked for
+//  their events, so a wait costs little more than the ready items.
+
 class socket_poller_t
 {
   public:
@@ -67,7 +74,14 @@ class socket_poller_t
         fd_t fd;
         void *user_data;
         short events;
-#if defined ZLINK_POLL_BASED_ON_POLL
+#if defined ZLINK_HAVE_EPOLL
+        //  The socket's command_batches () when its events were last
+        //  checked, whether the item is in _pending, and for descriptors
+        //  the events reported by epoll_wait.
+        uint64_t command_batches;
+        bool pending;
+        short revents;
+#elif defined ZLINK_POLL_BASED_ON_POLL
         int pollfd_index;
 #endif
     } item_t;
@@ -75,7 +89,11 @@ class socket_poller_t
     static void zero_trail_events (zlink::socket_poller_t::event_t *events_,
                                    int n_events_,
                                    int found_);
-#if defined ZLINK_POLL_BASED_ON_POLL
+#if defined ZLINK_HAVE_EPOLL
+    int check_events (zlink::socket_poller_t::event_t *events_, int n_events_);
+    int register_item (size_t index_, int op_);
+    void update_item (size_t index_, short events_);
+#elif defined ZLINK_POLL_BASED_ON_POLL
     int check_events (zlink::socket_poller_t::event_t *events_, int n_events_);
 #elif defined ZLINK_POLL_BASED_ON_SELECT
     int check_events (zlink::socket_poller_t::event_t *events_,
@@ -113,7 +131,13 @@ class socket_poller_t
     //  Size of the pollset
     int _pollset_size;
 
-#if defined ZLINK_POLL_BASED_ON_POLL
+#if defined ZLINK_HAVE_EPOLL
+    fd_t _epoll_fd;
+    std::vector<epoll_event> _epoll_events;
+
+    //  Indices of the items to be checked by the next wait.
+    std::vector<size_t> _pending;
+#elif defined ZLINK_POLL_BASED_ON_POLL
     pollfd *_pollfds;
 #elif defined ZLINK_POLL_BASED_ON_SELECT
     resizable_optimized_fd_set_t _pollset_in;
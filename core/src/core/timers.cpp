@@ -4,8 +4,6 @@
 #include "core/timers.hpp"
 #include "utils/err.hpp"
 
-#include <algorithm>
-
 zlink::timers_t::timers_t () : _tag (0xCAFEDADA), _next_timer_id (0)
 {
 }
@@ -28,58 +26,42 @@ int zlink::timers_t::add (size_t interval_, timers_timer_fn handler_, void *arg_
         return -1;
     }
 
-    uint64_t when = _clock.now_ms () + interval_;
-    timer_t timer = {++_next_timer_id, interval_, handler_, arg_};
-    _timers.insert (timersmap_t::value_type (when, timer));
+    const int timer_id = ++_next_timer_id;
+    timer_t timer = {interval_, handler_, arg_, false};
+    arm (_clock.now_ms (), timer_id, _timers[timer_id] = timer);
 
-    return timer.timer_id;
+    return timer_id;
 }
 
-struct zlink::timers_t::match_by_id
+void zlink::timers_t::arm (uint64_t now_, int timer_id_, timer_t &timer_)
 {
-    match_by_id (int timer_id_) : _timer_id (timer_id_) {}
-
-    bool operator() (timersmap_t::value_type const &entry_) const
-    {
-        return entry_.second.timer_id == _timer_id;
-    }
-
-  private:
-    int _timer_id;
-};
+    if (timer_.armed)
+        _wheel.cancel (NULL, timer_id_);
+    _wheel.add (now_, timer_.interval, NULL, timer_id_);
+    timer_.armed = true;
+}
 
 int zlink::timers_t::cancel (int timer_id_)
 {
-    // check first if timer exists at all
-    if (_timers.end ()
-        == std::find_if (_timers.begin (), _timers.end (),
-                         match_by_id (timer_id_))) {
+    const timersmap_t::iterator it = _timers.find (timer_id_);
+    if (it == _timers.end ()) {
         errno = EINVAL;
         return -1;
     }
 
-    // check if timer was already canceled
-    if (_cancelled_timers.count (timer_id_)) {
-        errno = EINVAL;
-        return -1;
-    }
-
-    _cancelled_timers.insert (timer_id_);
+    if (it->second.armed)
+        _wheel.cancel (NULL, timer_id_);
+    _timers.erase (it);
 
     return 0;
 }
 
 int zlink::timers_t::set_interval (int timer_id_, size_t interval_)
 {
-    const timersmap_t::iterator end = _timers.end ();
-    const timersmap_t::iterator it =
-      std::find_if (_timers.begin (), end, match_by_id (timer_id_));
-    if (it != end) {
-        timer_t timer = it->second;
-        timer.interval = interval_;
-        uint64_t when = _clock.now_ms () + interval_;
-        _timers.erase (it);
-        _timers.insert (timersmap_t::value_type (when, timer));
+    const timersmap_t::iterator it = _timers.find (timer_id_);
+    if (it != _timers.end ()) {
+        it->second.interval = interval_;
+        arm (_clock.now_ms (), timer_id_, it->second);
 
         return 0;
     }
@@ -90,14 +72,9 @@ int zlink::timers_t::set_interval (int timer_id_, size_t interval_)
 
 int zlink::timers_t::reset (int timer_id_)
 {
-    const timersmap_t::iterator end = _timers.end ();
-    const timersmap_t::iterator it =
-      std::find_if (_timers.begin (), end, match_by_id (timer_id_));
-    if (it != end) {
-        timer_t timer = it->second;
-        uint64_t when = _clock.now_ms () + timer.interval;
-        _timers.erase (it);
-        _timers.insert (timersmap_t::value_type (when, timer));
+    const timersmap_t::iterator it = _timers.find (timer_id_);
+    if (it != _timers.end ()) {
+        arm (_clock.now_ms (), timer_id_, it->second);
 
         return 0;
     }
@@ -109,49 +86,42 @@ int zlink::timers_t::reset (int timer_id_)
 long zlink::timers_t::timeout ()
 {
     const uint64_t now = _clock.now_ms ();
-    long res = -1;
-
-    const timersmap_t::iterator begin = _timers.begin ();
-    const timersmap_t::iterator end = _timers.end ();
-    timersmap_t::iterator it = begin;
-    for (; it != end; ++it) {
-        if (0 == _cancelled_timers.erase (it->second.timer_id)) {
-            //  Live timer, lets return the timeout
-            res = std::max (static_cast<long> (it->first - now), 0l);
-            break;
-        }
-    }
 
-    //  Remove timed-out timers
-    _timers.erase (begin, it);
+    _wheel.advance (now);
+    if (_wheel.empty ())
+        return -1;
 
-    return res;
+    //  Timers beyond the wheel's first level report the time they move
+    //  down a level, so the caller may come back early but not late.
+    const uint64_t next = _wheel.next_expiry ();
+    return next > now ? static_cast<long> (next - now) : 0l;
 }
 
 int zlink::timers_t::execute ()
 {
     const uint64_t now = _clock.now_ms ();
 
-    const timersmap_t::iterator begin = _timers.begin ();
-    const timersmap_t::iterator end = _timers.end ();
-    timersmap_t::iterator it = _timers.begin ();
-    for (; it != end; ++it) {
-        if (0 == _cancelled_timers.erase (it->second.timer_id)) {
-            //  Timer is not cancelled
-
-            //  Map is ordered, if we have to wait for current timer we can stop.
-            if (it->first > now)
-                break;
-
-            const timer_t &timer = it->second;
-
-            timer.handler (timer.timer_id, timer.arg);
+    void *sink;
+    int timer_id;
+    while (_wheel.pop (now, &sink, &timer_id)) {
+        timersmap_t::iterator it = _timers.find (timer_id);
+        zlink_assert (it != _timers.end ());
+        it->second.armed = false;
+        _fired.push_back (timer_id);
+
+        //  The handler may add, cancel or reset any timer.
+        const timer_t timer = it->second;
+        timer.handler (timer_id, timer.arg);
+    }
 
-            _timers.insert (
-              timersmap_t::value_type (now + timer.interval, timer));
-        }
+    //  Re-armed once all due timers ran, so that a zero interval does not
+    //  keep this call going.
+    for (size_t i = 0, n = _fired.size (); i != n; ++i) {
+        const timersmap_t::iterator it = _timers.find (_fired[i]);
+        if (it != _timers.end () && !it->second.armed)
+            arm (now, _fired[i], it->second);
     }
-    _timers.erase (begin, it);
+    _fired.clear ();
 
     return 0;
 }
@@ -4,10 +4,11 @@
 #define __ZLINK_TIMERS_HPP_INCLUDED__
 
 #include <stddef.h>
-#include <map>
-#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "utils/clock.hpp"
+#include "utils/timer_wheel.hpp"
 
 namespace zlink
 {
@@ -25,12 +26,10 @@ class timers_t
     int add (size_t interval_, timers_timer_fn handler_, void *arg_);
 
     //  Set the interval of the timer.
-    //  This method is slow, cancelling exsting and adding a new timer yield better performance.
     //  Returns 0 on success and -1 on error.
     int set_interval (int timer_id_, size_t interval_);
 
     //  Reset the timer.
-    //  This method is slow, cancelling exsting and adding a new timer yield better performance.
     //  Returns 0 on success and -1 on error.
     int reset (int timer_id_);
 
@@ -60,19 +59,27 @@ class timers_t
 
     typedef struct timer_t
     {
-        int timer_id;
         size_t interval;
         timers_timer_fn *handler;
         void *arg;
+
+        //  False while the handler runs; execute re-arms the timer
+        //  afterwards unless it has been cancelled, reset or given a new
+        //  interval meanwhile.
+        bool armed;
     } timer_t;
 
-    typedef std::multimap<uint64_t, timer_t> timersmap_t;
-    timersmap_t _timers;
+    //  Arms timer_id_ to expire its interval after now_.
+    void arm (uint64_t now_, int timer_id_, timer_t &timer_);
 
-    typedef std::set<int> cancelled_timers_t;
-    cancelled_timers_t _cancelled_timers;
+    //  Timers by id. The wheel holds an entry with a NULL sink for each
+    //  armed one.
+    typedef std::unordered_map<int, timer_t> timersmap_t;
+    timersmap_t _timers;
+    timer_wheel_t _wheel;
 
-    struct match_by_id;
+    //  Timers fired by the current execute () call.
+    std::vector<int> _fired;
 
     ZLINK_NON_COPYABLE_NOR_MOVABLE (timers_t)
 };
@@ -14,13 +14,15 @@ namespace zlink
 //  Only a single thread can write to the pipe at any specific moment.
 //  T is the type of the object in the queue.
 //  N is granularity of the pipe, i.e. how many items are needed to
-//  perform next memory allocation.
+//  perform next memory allocation. A smaller initial granularity and a
+//  shared chunk pool can be given to the constructor; see yqueue_t.
 
 template <typename T, int N> class ypipe_t ZLINK_FINAL : public ypipe_base_t<T>
 {
   public:
     //  Initialises the pipe.
-    ypipe_t ()
+    explicit ypipe_t (int initial_size_ = N, chunk_pool_t *pool_ = NULL) :
+        _queue (initial_size_, pool_)
     {
         //  Insert terminator element into the queue.
         _queue.push ();
@@ -88,6 +90,10 @@ template <typename T, int N> class ypipe_t ZLINK_FINAL : public ypipe_base_t<T>
             //  that reader is sleeping.
             _c.set (_f);
             _w = _f;
+
+            //  The reader has drained the queue, so any growth of the
+            //  queue was transient.
+            _queue.shrink ();
             return false;
         }
 
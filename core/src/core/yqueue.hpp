@@ -8,6 +8,7 @@
 
 #include "utils/err.hpp"
 #include "utils/atomic_ptr.hpp"
+#include "utils/chunk_pool.hpp"
 #include "platform.hpp"
 
 namespace zlink
@@ -24,6 +25,15 @@ namespace zlink
 //  T is the type of the object in the queue.
 //  N is granularity of the queue (how many pushes have to be done till
 //  actual memory allocation is required).
+//
+//  The queue can also start with chunks smaller than N. Each further
+//  chunk is then twice the size of the previous one, up to N, and
+//  shrink () makes growth start over from the initial size. This keeps
+//  queues that carry little traffic small.
+//
+//  Chunks of the full size N can be drawn from and returned to a
+//  chunk_pool_t shared with other queues. The pool's blocks must be
+//  chunk_bytes (N) long.
 #if defined HAVE_POSIX_MEMALIGN
 // ALIGN is the memory alignment size to use in the case where we have
 // posix_memalign available. Default value is 64, this alignment will
@@ -37,10 +47,17 @@ template <typename T, int N> class yqueue_t
 #endif
 {
   public:
-    //  Create the queue.
-    inline yqueue_t ()
+    //  Create the queue. initial_size_ is the number of elements in the
+    //  first chunk, between 1 and N. pool_ may be NULL.
+    inline explicit yqueue_t (int initial_size_ = N,
+                              chunk_pool_t *pool_ = NULL) :
+        _initial_size (initial_size_),
+        _next_size (initial_size_),
+        _pool (pool_)
     {
-        _begin_chunk = allocate_chunk ();
+        zlink_assert (initial_size_ > 0 && initial_size_ <= N);
+        zlink_assert (!_pool || _pool->block_size () == chunk_bytes (N));
+        _begin_chunk = allocate_chunk (next_chunk_size ());
         alloc_assert (_begin_chunk);
         _begin_pos = 0;
         _back_chunk = NULL;
@@ -54,25 +71,32 @@ template <typename T, int N> class yqueue_t
     {
         while (true) {
             if (_begin_chunk == _end_chunk) {
-                free (_begin_chunk);
+                free_chunk (_begin_chunk);
                 break;
             }
             chunk_t *o = _begin_chunk;
             _begin_chunk = _begin_chunk->next;
-            free (o);
+            free_chunk (o);
         }
 
         chunk_t *sc = _spare_chunk.xchg (NULL);
-        free (sc);
+        if (sc)
+            free_chunk (sc);
+    }
+
+    //  Number of bytes taken by a chunk of size_ elements.
+    static size_t chunk_bytes (int size_)
+    {
+        return values_offset + size_ * sizeof (T);
     }
 
     //  Returns reference to the front element of the queue.
     //  If the queue is empty, behaviour is undefined.
-    inline T &front () { return _begin_chunk->values[_begin_pos]; }
+    inline T &front () { return values (_begin_chunk)[_begin_pos]; }
 
     //  Returns reference to the back element of the queue.
     //  If the queue is empty, behaviour is undefined.
-    inline T &back () { return _back_chunk->values[_back_pos]; }
+    inline T &back () { return values (_back_chunk)[_back_pos]; }
 
     //  Adds an element to the back end of the queue.
     inline void push ()
@@ -80,15 +104,18 @@ template <typename T, int N> class yqueue_t
         _back_chunk = _end_chunk;
         _back_pos = _end_pos;
 
-        if (++_end_pos != N)
+        if (++_end_pos != _end_chunk->size)
             return;
 
-        chunk_t *sc = _spare_chunk.xchg (NULL);
+        //  Spare chunks always have the initial size, so one is only
+        //  useful while growth is at its start.
+        chunk_t *sc =
+          _next_size == _initial_size ? _spare_chunk.xchg (NULL) : NULL;
         if (sc) {
             _end_chunk->next = sc;
             sc->prev = _end_chunk;
         } else {
-            _end_chunk->next = allocate_chunk ();
+            _end_chunk->next = allocate_chunk (next_chunk_size ());
             alloc_assert (_end_chunk->next);
             _end_chunk->next->prev = _end_chunk;
         }
@@ -109,8 +136,8 @@ template <typename T, int N> class yqueue_t
         if (_back_pos)
             --_back_pos;
         else {
-            _back_pos = N - 1;
             _back_chunk = _back_chunk->prev;
+            _back_pos = _back_chunk->size - 1;
         }
 
         //  Now, move 'end' position backwards. Note that obsolete end chunk
@@ -120,9 +147,9 @@ template <typename T, int N> class yqueue_t
         if (_end_pos)
             --_end_pos;
         else {
-            _end_pos = N - 1;
             _end_chunk = _end_chunk->prev;
-            free (_end_chunk->next);
+            _end_pos = _end_chunk->size - 1;
+            free_chunk (_end_chunk->next);
             _end_chunk->next = NULL;
         }
     }
@@ -130,39 +157,91 @@ template <typename T, int N> class yqueue_t
     //  Removes an element from the front end of the queue.
     inline void pop ()
     {
-        if (++_begin_pos == N) {
+        if (++_begin_pos == _begin_chunk->size) {
             chunk_t *o = _begin_chunk;
             _begin_chunk = _begin_chunk->next;
             _begin_chunk->prev = NULL;
             _begin_pos = 0;
 
+            //  Chunks grown past the initial size are released straight
+            //  away so that the queue shrinks back once it is drained.
+            if (o->size != _initial_size) {
+                free_chunk (o);
+                return;
+            }
+
             //  'o' has been more recently used than _spare_chunk,
             //  so for cache reasons we'll get rid of the spare and
             //  use 'o' as the spare.
             chunk_t *cs = _spare_chunk.xchg (o);
-            free (cs);
+            if (cs)
+                free_chunk (cs);
         }
     }
 
+    //  Makes the next chunk allocated by the writer have the initial size
+    //  again. Called by the writer once it knows the reader has caught up.
+    inline void shrink () { _next_size = _initial_size; }
+
   private:
-    //  Individual memory chunk to hold N elements.
+    //  Individual memory chunk to hold 'size' elements. The elements
+    //  follow the header at values_offset, which is a multiple of
+    //  sizeof (T) and hence suitably aligned for T.
     struct chunk_t
     {
-        T values[N];
         chunk_t *prev;
         chunk_t *next;
+        int size;
     };
 
-    static inline chunk_t *allocate_chunk ()
+    static const size_t values_offset =
+      (sizeof (chunk_t) + sizeof (T) - 1) / sizeof (T) * sizeof (T);
+
+    static inline T *values (chunk_t *chunk_)
     {
+        return reinterpret_cast<T *> (reinterpret_cast<char *> (chunk_)
+                                      + values_offset);
+    }
+
+    //  Returns the size for the next chunk and advances the growth.
+    inline int next_chunk_size ()
+    {
+        const int size = _next_size;
+        if (_next_size < N)
+            _next_size = _next_size * 2 < N ? _next_size * 2 : N;
+        return size;
+    }
+
+    inline chunk_t *allocate_chunk (int size_)
+    {
+        if (_pool && size_ == N) {
+            chunk_t *chunk = static_cast<chunk_t *> (_pool->allocate ());
+            if (chunk)
+                chunk->size = size_;
+            return chunk;
+        }
+
+        const size_t bytes = chunk_bytes (size_);
 #if defined HAVE_POSIX_MEMALIGN
         void *pv;
-        if (posix_memalign (&pv, ALIGN, sizeof (chunk_t)) == 0)
-            return (chunk_t *) pv;
-        return NULL;
+        if (posix_memalign (&pv, ALIGN, bytes) != 0)
+            return NULL;
+        chunk_t *chunk = static_cast<chunk_t *> (pv);
 #else
-        return static_cast<chunk_t *> (malloc (sizeof (chunk_t)));
+        chunk_t *chunk = static_cast<chunk_t *> (malloc (bytes));
+        if (!chunk)
+            return NULL;
 #endif
+        chunk->size = size_;
+        return chunk;
+    }
+
+    inline void free_chunk (chunk_t *chunk_)
+    {
+        if (_pool && chunk_->size == N)
+            _pool->release (chunk_);
+        else
+            free (chunk_);
     }
 
     //  Back position may point to invalid memory if the queue is empty,
@@ -176,6 +255,14 @@ template <typename T, int N> class yqueue_t
     chunk_t *_end_chunk;
     int _end_pos;
 
+    //  Size of the first chunk and of spare chunks, and the size the
+    //  writer will use for the next chunk it allocates.
+    const int _initial_size;
+    int _next_size;
+
+    //  Shared cache for full size chunks, or NULL.
+    chunk_pool_t *const _pool;
+
     //  People are likely to produce and consume at similar rates.  In
     //  this scenario holding onto the most recently freed chunk saves
     //  us from having to call malloc/free.
@@ -154,8 +154,13 @@ zlink::asio_engine_t::asio_engine_t (
     _has_handshake_stage (true),
     _io_context (NULL),
     _transport (std::move (transport_)),
-    _current_timer_id (-1),
-    _read_buffer (read_buffer_size),
+    _poller (NULL),
+    _coalesce_pending (false),
+    _coalesce_flushing (false),
+    _idle_timer_pending (false),
+    _idle_active (false),
+    _read_waiting (false),
+    _read_buffer (options_.low_memory ? 0 : read_buffer_size),
     _total_pending_bytes (0),
     _fd (fd_),
     _plugged (false),
@@ -252,13 +257,16 @@ void zlink::asio_engine_t::plug (io_thread_t *io_thread_,
     _socket = _session->get_socket ();
 
     //  Get reference to io_context from the io_thread's poller
-    asio_poller_t *poller =
-      static_cast<asio_poller_t *> (io_thread_->get_poller ());
-    _io_context = &poller->get_io_context ();
+    _poller = static_cast<asio_poller_t *> (io_thread_->get_poller ());
+    _io_context = &_poller->get_io_context ();
 
-    //  Allocate timer with correct io_context
-    _timer = std::unique_ptr<boost::asio::steady_timer> (
-      new boost::asio::steady_timer (*_io_context));
+    //  Allocate timers with correct io_context
+    if (_options.coalesce_delay > 0)
+        _coalesce_timer = std::unique_ptr<boost::asio::steady_timer> (
+          new boost::asio::steady_timer (*_io_context));
+    if (_options.low_memory)
+        _idle_timer = std::unique_ptr<boost::asio::steady_timer> (
+          new boost::asio::steady_timer (*_io_context));
 
     _io_error = false;
 
@@ -368,8 +376,12 @@ void zlink::asio_engine_t::unplug ()
     //  Cancel pending async operations by closing the transport
     if (_transport)
         _transport->close ();
-    if (_timer)
-        _timer->cancel ();
+    if (_coalesce_timer)
+        _coalesce_timer->cancel ();
+    _coalesce_pending = false;
+    if (_idle_timer)
+        _idle_timer->cancel ();
+    _idle_timer_pending = false;
 
     //  Clear pending buffers (True Proactor Pattern)
     _pending_buffers.clear ();
@@ -422,6 +434,20 @@ void zlink::asio_engine_t::start_async_read ()
 
     ENGINE_DBG ("start_async_read: insize=%zu", _insize);
 
+    //  Low-memory mode: with no partial input to complete, wait for the
+    //  socket to become readable instead of posting a read into the
+    //  decoder buffer, so that the buffer can go while the peer is idle.
+    if (_idle_timer && _decoder && !_input_stopped && _insize == 0
+        && _transport && _transport->supports_async_wait ()) {
+        _read_pending = true;
+        _read_waiting = true;
+        _transport->async_wait_readable (
+          [this] (const boost::system::error_code &ec, std::size_t) {
+              on_readable (ec);
+          });
+        return;
+    }
+
     _read_pending = true;
     _read_from_pending_pool = false;
 
@@ -459,6 +485,8 @@ void zlink::asio_engine_t::start_async_read ()
         }
     } else {
         //  During handshake, use internal buffer
+        if (_read_buffer.empty ())
+            _read_buffer.resize (read_buffer_size);
         _read_buffer_ptr = _read_buffer.data ();
         read_size = _read_buffer.size ();
     }
@@ -498,6 +526,8 @@ bool zlink::asio_engine_t::speculative_read ()
             read_size -= _insize;
         }
     } else {
+        if (_read_buffer.empty ())
+            _read_buffer.resize (read_buffer_size);
         _read_buffer_ptr = _read_buffer.data ();
         read_size = _read_buffer.size ();
     }
@@ -588,6 +618,10 @@ bool zlink::asio_engine_t::prepare_gather_output ()
     if (_encoder == NULL || _handshaking)
         return false;
 
+    //  Bytes held back for coalescing must leave before a gathered message.
+    if (_outsize > 0)
+        return false;
+
     //  Ensure encoder has no in-progress message before loading a new one.
     unsigned char *pending_buf = NULL;
     const size_t pending =
@@ -681,10 +715,13 @@ void zlink::asio_engine_t::on_read_complete (const boost::system::error_code &ec
         return;
     }
 
+    if (_idle_timer)
+        note_activity ();
+
     //  True Proactor Pattern: If backpressure is active, buffer the data
     //  instead of processing it. This keeps async_read always pending,
     //  eliminating unnecessary recvfrom() EAGAIN calls when backpressure clears.
-    if (_input_stopped) {
+    if (_input_stopped || _read_from_pending_pool) {
         if (_read_from_pending_pool) {
             const size_t total_pending = _total_pending_bytes + _insize;
 
@@ -705,6 +742,15 @@ void zlink::asio_engine_t::on_read_complete (const boost::system::error_code &ec
             ENGINE_DBG ("on_read_complete: buffered %zu bytes (total pending: %zu)",
                         bytes_transferred, _total_pending_bytes);
 
+            //  Input was restarted while this read was outstanding. The
+            //  data is not in the decoder buffer and the next read into
+            //  the pool would overwrite it, so decode it from the queue.
+            if (!_input_stopped) {
+                _input_stopped = true;
+                drain_pending_input ();
+                return;
+            }
+
             start_async_read ();
             return;
         }
@@ -930,9 +976,26 @@ bool zlink::asio_engine_t::prepare_output_buffer ()
 {
     ENGINE_DBG ("prepare_output_buffer: outsize=%zu", _outsize);
 
-    //  If we already have data prepared, return true.
-    if (_outsize > 0)
+    //  If we already have data prepared, return true. A batch held back
+    //  for coalescing is topped up first; the encoder is idle or holds a
+    //  loaded message then, and the batch lives in its own buffer.
+    if (_outsize > 0) {
+        const size_t max_out_batch =
+          static_cast<size_t> (_options.out_batch_size);
+        while (_coalesce_pending && _outsize < max_out_batch) {
+            unsigned char *bufptr = _outpos + _outsize;
+            const size_t n =
+              _encoder->encode (&bufptr, max_out_batch - _outsize);
+            if (n > 0) {
+                _outsize += n;
+                continue;
+            }
+            if ((this->*_next_msg) (&_tx_msg) == -1)
+                break;
+            _encoder->load_msg (&_tx_msg);
+        }
         return true;
+    }
 
     //  Even when we stop as soon as there is no data to send,
     //  there may be a pending async_write.
@@ -994,6 +1057,9 @@ void zlink::asio_engine_t::speculative_write ()
         return;
     }
 
+    if (hold_output ())
+        return;
+
     const bool use_speculative_write =
       _options.type == ZLINK_STREAM || _transport->supports_speculative_write ();
     if (!use_speculative_write) {
@@ -1056,6 +1122,9 @@ void zlink::asio_engine_t::speculative_write ()
         //  Try to prepare and write more data speculatively.
         //  This loop enables efficient burst writes without async overhead.
         while (prepare_output_buffer ()) {
+            if (hold_output ())
+                return;
+
             const std::size_t more_bytes = _transport->write_some (
               reinterpret_cast<const std::uint8_t *> (_outpos), _outsize);
 
@@ -1089,6 +1158,133 @@ void zlink::asio_engine_t::speculative_write ()
     }
 }
 
+bool zlink::asio_engine_t::hold_output ()
+{
+    if (!_coalesce_timer || _coalesce_flushing || _handshaking)
+        return false;
+
+    //  A full batch goes out right away; the timer keeps running for
+    //  whatever is held after it.
+    if (_outsize >= static_cast<size_t> (_options.out_batch_size))
+        return false;
+
+    if (!_coalesce_pending) {
+        _coalesce_pending = true;
+        _coalesce_timer->expires_after (
+          std::chrono::microseconds (_options.coalesce_delay));
+        _coalesce_timer->async_wait (
+          [this] (const boost::system::error_code &ec) {
+              on_coalesce_timer (ec);
+          });
+    }
+    ENGINE_DBG ("hold_output: holding %zu bytes", _outsize);
+    return true;
+}
+
+void zlink::asio_engine_t::on_coalesce_timer (
+  const boost::system::error_code &ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    //  If terminating, just return - terminate() is draining handlers
+    if (_terminating || !_plugged)
+        return;
+
+    _coalesce_pending = false;
+    if (_write_pending || _io_error)
+        return;
+
+    ENGINE_DBG ("on_coalesce_timer: flushing %zu bytes", _outsize);
+    _coalesce_flushing = true;
+    _output_stopped = false;
+    speculative_write ();
+    _coalesce_flushing = false;
+}
+
+void zlink::asio_engine_t::on_readable (const boost::system::error_code &ec)
+{
+    _read_pending = false;
+    _read_waiting = false;
+
+    //  If terminating, just return - terminate() is draining handlers
+    if (_terminating || !_plugged)
+        return;
+
+    if (ec) {
+        if (ec == boost::asio::error::operation_aborted)
+            return;
+        error (connection_error);
+        return;
+    }
+
+    //  The read completes synchronously and re-arms the wait; on a
+    //  spurious wakeup just wait again.
+    if (!speculative_read ())
+        start_async_read ();
+}
+
+void zlink::asio_engine_t::note_activity ()
+{
+    _idle_active = true;
+    if (!_idle_timer_pending)
+        arm_idle_timer ();
+}
+
+void zlink::asio_engine_t::arm_idle_timer ()
+{
+    _idle_timer_pending = true;
+    _idle_timer->expires_after (
+      std::chrono::milliseconds (_options.low_memory_idle_ivl));
+    _idle_timer->async_wait (
+      [this] (const boost::system::error_code &ec) { on_idle_timer (ec); });
+}
+
+void zlink::asio_engine_t::on_idle_timer (const boost::system::error_code &ec)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+
+    //  If terminating, just return - terminate() is draining handlers
+    if (_terminating || !_plugged)
+        return;
+
+    _idle_timer_pending = false;
+
+    //  Traffic during the last interval; look again after the next one.
+    if (_idle_active) {
+        _idle_active = false;
+        arm_idle_timer ();
+        return;
+    }
+
+    release_idle_buffers ();
+}
+
+void zlink::asio_engine_t::release_idle_buffers ()
+{
+    if (_handshaking)
+        return;
+
+    ENGINE_DBG ("release_idle_buffers: read_waiting=%d, write_pending=%d",
+                _read_waiting, _write_pending);
+
+    //  Input buffers can only go if no read is posted into one of them
+    //  and no partial or held back input is left.
+    const bool input_idle = (!_read_pending || _read_waiting) && _insize == 0
+                            && !_input_stopped && _pending_buffers.empty ();
+    if (input_idle) {
+        if (_decoder)
+            _decoder->release_buffer ();
+        std::vector<unsigned char> ().swap (_read_buffer);
+        std::vector<unsigned char> ().swap (_pending_read_buffer);
+        std::vector<std::vector<unsigned char> > ().swap (_pending_buffer_pool);
+    }
+
+    if (_encoder && !_write_pending && _outsize == 0 && !_coalesce_pending)
+        _encoder->release_buffer ();
+}
+
 void zlink::asio_engine_t::process_output ()
 {
     ENGINE_DBG ("process_output: outsize=%zu", _outsize);
@@ -1142,6 +1338,9 @@ void zlink::asio_engine_t::restart_output ()
         _output_stopped = false;
     }
 
+    if (_idle_timer)
+        note_activity ();
+
     //  Use speculative write for immediate transmission.
     //  This tries synchronous write first, falling back to async if needed.
     speculative_write ();
@@ -1192,8 +1391,12 @@ bool zlink::asio_engine_t::restart_input_internal ()
         zlink_assert (processed <= _insize);
         _inpos += processed;
         _insize -= processed;
-        if (rc == 0 || rc == -1)
+        //  Input copied into the decoder buffer may need several rounds;
+        //  pending buffers must not be decoded ahead of what is left.
+        if (rc == -1)
             break;
+        if (rc == 0)
+            continue;
         rc = (this->*_process_msg) (_decoder->msg ());
         if (rc == -1)
             break;
@@ -1212,6 +1415,15 @@ bool zlink::asio_engine_t::restart_input_internal ()
         return false;
     }
 
+    return drain_pending_input ();
+}
+
+bool zlink::asio_engine_t::drain_pending_input ()
+{
+    zlink_assert (_input_stopped);
+
+    int rc = 0;
+
     //  Process any buffered data from _pending_buffers (if present).
     while (!_pending_buffers.empty ()) {
         std::vector<unsigned char> &buffer = _pending_buffers.front ();
@@ -1258,9 +1470,19 @@ bool zlink::asio_engine_t::restart_input_internal ()
                 break;
         }
 
-        //  If backpressure occurred, keep remaining data in buffer
+        //  If backpressure occurred, keep remaining data in buffer. The
+        //  message that could not be pushed is held by the decoder, so a
+        //  buffer it was the last one of is done with; keeping it would
+        //  decode its messages again on restart.
         if (rc == -1 && errno == EAGAIN) {
-            if (buffer_remaining > 0 && buffer_pos > 0) {
+            if (buffer_remaining == 0) {
+                _total_pending_bytes -= original_buffer_size;
+                if (_pending_buffer_pool.size () < pending_buffer_pool_max) {
+                    buffer.clear ();
+                    _pending_buffer_pool.push_back (std::move (buffer));
+                }
+                _pending_buffers.pop_front ();
+            } else if (buffer_pos > 0) {
                 //  Trim processed data from buffer and update tracking
                 const size_t bytes_consumed = buffer_pos;
                 buffer.erase (buffer.begin (),
@@ -1324,10 +1546,11 @@ bool zlink::asio_engine_t::restart_input_internal ()
     if (!_pending_buffers.empty()) {
         ENGINE_DBG ("restart_input: race detected AFTER flush, %zu buffers accumulated, re-entering stopped mode",
                     _pending_buffers.size());
-        //  Re-enter stopped mode and recursively drain.
-        //  Call restart_input_internal() directly to keep state local.
+        //  Re-enter stopped mode and drain again. The decoder's message
+        //  has been pushed already, so restart_input_internal() must not
+        //  run here: it would push it a second time.
         _input_stopped = true;
-        return restart_input_internal();
+        return drain_pending_input ();
     }
 
     //  Speculative read (libzlink pattern): drain immediately available data
@@ -1475,32 +1698,32 @@ void zlink::asio_engine_t::add_timer (int timeout_, int id_)
 {
     ENGINE_DBG ("add_timer: timeout=%d, id=%d", timeout_, id_);
 
-    zlink_assert (_timer);
-    _current_timer_id = id_;
-    _timer->expires_after (std::chrono::milliseconds (timeout_));
-    _timer->async_wait (
-      [this, id_] (const boost::system::error_code &ec) {
-          on_timer (id_, ec);
-      });
+    zlink_assert (_poller);
+    _poller->add_timer (timeout_, this, id_);
 }
 
 void zlink::asio_engine_t::cancel_timer (int id_)
 {
     ENGINE_DBG ("cancel_timer: id=%d", id_);
 
-    if (_current_timer_id == id_ && _timer) {
-        _timer->cancel ();
-        _current_timer_id = -1;
-    }
+    if (_poller)
+        _poller->cancel_timer (this, id_);
 }
 
-void zlink::asio_engine_t::on_timer (int id_, const boost::system::error_code &ec)
+void zlink::asio_engine_t::in_event ()
 {
-    ENGINE_DBG ("on_timer: id=%d, ec=%s, terminating=%d", id_,
-                ec.message ().c_str (), _terminating);
+    //  The engine does not register file descriptors with the poller.
+    zlink_assert (false);
+}
 
-    if (ec == boost::asio::error::operation_aborted)
-        return;
+void zlink::asio_engine_t::out_event ()
+{
+    zlink_assert (false);
+}
+
+void zlink::asio_engine_t::timer_event (int id_)
+{
+    ENGINE_DBG ("timer_event: id=%d, terminating=%d", id_, _terminating);
 
     //  If terminating, just return - terminate() is draining handlers
     if (_terminating)
@@ -1514,9 +1737,11 @@ void zlink::asio_engine_t::on_timer (int id_, const boost::system::error_code &e
         //  handshake timer expired before handshake completed, so engine fail
         error (timeout_error);
     } else if (id_ == heartbeat_ivl_timer_id) {
+        //  Re-armed first: producing the ping may fail the engine, which
+        //  then cancels the timer with the others.
+        add_timer (_options.heartbeat_interval, heartbeat_ivl_timer_id);
         _next_msg = &asio_engine_t::produce_ping_message;
         restart_output ();
-        add_timer (_options.heartbeat_interval, heartbeat_ivl_timer_id);
     } else if (id_ == heartbeat_ttl_timer_id) {
         _has_ttl_timer = false;
         error (timeout_error);
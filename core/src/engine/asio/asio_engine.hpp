@@ -14,6 +14,7 @@
 
 #include "utils/fd.hpp"
 #include "engine/i_engine.hpp"
+#include "core/i_poll_events.hpp"
 #include "core/options.hpp"
 #include "core/endpoint.hpp"
 #include "protocol/i_encoder.hpp"
@@ -27,6 +28,7 @@ namespace zlink
 class io_thread_t;
 class session_base_t;
 class i_asio_transport;
+class asio_poller_t;
 
 //  True Proactor Mode ASIO Engine
 //
@@ -35,9 +37,10 @@ class i_asio_transport;
 //  (async_wait for readiness) used by asio_poller.
 //
 //  The engine manages read/write buffers internally and handles
-//  completion callbacks to drive the ZMP protocol.
+//  completion callbacks to drive the ZMP protocol. Handshake and heartbeat
+//  timers live on the I/O thread's timer wheel, which calls timer_event.
 
-class asio_engine_t : public i_engine
+class asio_engine_t : public i_engine, public i_poll_events
 {
   public:
     asio_engine_t (fd_t fd_,
@@ -56,6 +59,11 @@ class asio_engine_t : public i_engine
     void restart_output () ZLINK_OVERRIDE;
     const endpoint_uri_pair_t &get_endpoint () const ZLINK_OVERRIDE;
 
+    //  i_poll_events interface implementation. Only timers are used.
+    void in_event () ZLINK_OVERRIDE;
+    void out_event () ZLINK_OVERRIDE;
+    void timer_event (int id_) ZLINK_OVERRIDE;
+
   protected:
     typedef metadata_t::dict_t properties_t;
     bool init_properties (properties_t &properties_);
@@ -125,9 +133,6 @@ class asio_engine_t : public i_engine
     //  Cancel handshake timer
     void cancel_handshake_timer ();
 
-    //  Timer callback
-    void on_timer (int id_, const boost::system::error_code &ec);
-
     //  Access to session and socket
     session_base_t *session () { return _session; }
     socket_base_t *socket () { return _socket; }
@@ -187,7 +192,7 @@ class asio_engine_t : public i_engine
     //  Indicate if engine has a handshake stage
     bool _has_handshake_stage;
 
-    //  Add a timer using ASIO
+    //  Add a timer on the I/O thread's timer wheel
     void add_timer (int timeout_, int id_);
 
     //  Cancel a timer
@@ -212,6 +217,10 @@ class asio_engine_t : public i_engine
     //  Internal implementation of restart_input
     bool restart_input_internal ();
 
+    //  Decode the data buffered in _pending_buffers while input was
+    //  stopped, then resume reading. Input must be stopped on entry.
+    bool drain_pending_input ();
+
     //  Attempt a synchronous read to drain immediately available data.
     //  Returns true if a read was attempted or an error occurred.
     bool speculative_read ();
@@ -227,6 +236,30 @@ class asio_engine_t : public i_engine
     //  Finalize message state after gather write completion.
     void finish_gather_output ();
 
+    //  Returns true if the prepared output should be held back until more
+    //  messages arrive or the coalescing delay expires. Arms the
+    //  coalescing timer on the first hold.
+    bool hold_output ();
+
+    //  Coalescing timer callback; flushes whatever has been held back.
+    void on_coalesce_timer (const boost::system::error_code &ec);
+
+    //  Low-memory mode: completion of the readiness wait that stands in
+    //  for a posted read while the connection is idle.
+    void on_readable (const boost::system::error_code &ec);
+
+    //  Low-memory mode: records traffic and makes sure the idle timer runs.
+    void note_activity ();
+    void arm_idle_timer ();
+
+    //  Idle timer callback; releases the buffers if there was no traffic
+    //  during a whole interval.
+    void on_idle_timer (const boost::system::error_code &ec);
+
+    //  Hands the decoder and encoder buffers back to the buffer pool and
+    //  frees the engine's own read buffers, as far as they are unused.
+    void release_idle_buffers ();
+
     //  Unplug the engine from the session.
     void unplug ();
 
@@ -236,13 +269,34 @@ class asio_engine_t : public i_engine
     //  Transport abstraction (TCP/SSL/etc)
     std::unique_ptr<i_asio_transport> _transport;
 
-    //  Timers for handshake and heartbeat (allocated during plug())
-    std::unique_ptr<boost::asio::steady_timer> _timer;
+    //  Poller of the I/O thread the engine is plugged into (set during
+    //  plug()), holding the handshake and heartbeat timers.
+    asio_poller_t *_poller;
+
+    //  Timer bounding how long small writes are held back for coalescing
+    //  (allocated during plug() only if options.coalesce_delay is set).
+    std::unique_ptr<boost::asio::steady_timer> _coalesce_timer;
+
+    //  True while prepared output is held back waiting for _coalesce_timer.
+    bool _coalesce_pending;
+
+    //  True while the held output is being flushed after the delay expired.
+    bool _coalesce_flushing;
+
+    //  Timer releasing buffers of an idle connection (allocated during
+    //  plug() only if options.low_memory is set). It runs only while there
+    //  is traffic and stops once the buffers have been released.
+    std::unique_ptr<boost::asio::steady_timer> _idle_timer;
+    bool _idle_timer_pending;
+
+    //  True if there was traffic since the idle timer was last armed.
+    bool _idle_active;
 
-    //  Current timer ID
-    int _current_timer_id;
+    //  True while the pending read is a readiness wait (no buffer posted).
+    bool _read_waiting;
 
-    //  Internal read buffer for async operations
+    //  Internal read buffer for async operations, used until the handshake
+    //  is done. In low-memory mode it is allocated on first use.
     static const size_t read_buffer_size = 8192;
     std::vector<unsigned char> _read_buffer;
 
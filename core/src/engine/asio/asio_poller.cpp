@@ -449,6 +449,7 @@ void zlink::asio_poller_t::loop ()
     while (!_stopping) {
         //  Execute any due timers.
         uint64_t timeout = execute_timers ();
+        update_traffic ();
 
         //  Reset the io_context if it's stopped (e.g., after previous run completion)
         if (_io_context.stopped ()) {
@@ -480,8 +481,11 @@ void zlink::asio_poller_t::loop ()
                 poll_timeout_ms = max_poll_timeout_ms;
             }
 
-            ASIO_DBG ("loop: run_for %d ms (no ready events)", poll_timeout_ms);
-            _io_context.run_for (
+            //  Return after the first handler, as it may arm a timer that
+            //  is due before poll_timeout_ms is up.
+            ASIO_DBG ("loop: run_one_for %d ms (no ready events)",
+                      poll_timeout_ms);
+            _io_context.run_one_for (
               std::chrono::milliseconds (poll_timeout_ms));
         }
         //  else: Events were processed, continue loop immediately to check
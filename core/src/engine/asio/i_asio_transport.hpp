@@ -129,6 +129,22 @@ class i_asio_transport
         }
     }
 
+    //  Indicates whether async_wait_readable is available. Engines in
+    //  low-memory mode use it so that idle connections hold no read buffer.
+    //  Default: false (unsupported).
+    virtual bool supports_async_wait () const { return false; }
+
+    //  Wait until read_some can make progress, without reading anything.
+    //  The handler is called with 0 bytes; an error is reported if the
+    //  peer closed the connection.
+    //  Default: not supported; handler receives operation_not_supported.
+    virtual void async_wait_readable (completion_handler_t handler)
+    {
+        if (handler) {
+            handler (boost::asio::error::operation_not_supported, 0);
+        }
+    }
+
     //  Check if this transport requires a handshake phase.
     //  TCP: false, SSL: true, WebSocket: true
     virtual bool requires_handshake () const { return false; }
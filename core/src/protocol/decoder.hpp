@@ -30,10 +30,14 @@ template <typename T, typename A = c_single_allocator>
 class decoder_base_t : public i_decoder
 {
   public:
+    //  The buffer itself is allocated by the first get_buffer call.
     explicit decoder_base_t (const size_t buf_size_) :
-        _next (NULL), _read_pos (NULL), _to_read (0), _allocator (buf_size_)
+        _next (NULL),
+        _read_pos (NULL),
+        _to_read (0),
+        _allocator (buf_size_),
+        _buf (NULL)
     {
-        _buf = _allocator.allocate ();
     }
 
     ~decoder_base_t () ZLINK_OVERRIDE { _allocator.deallocate (); }
@@ -122,6 +126,12 @@ class decoder_base_t : public i_decoder
         _allocator.resize (new_size_);
     }
 
+    void release_buffer () ZLINK_FINAL
+    {
+        _allocator.shrink ();
+        _buf = NULL;
+    }
+
   protected:
     //  Prototype of state machine action. Action should return false if
     //  it is unable to push the data to the system.
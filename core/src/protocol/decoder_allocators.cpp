@@ -4,12 +4,14 @@
 #include "protocol/decoder_allocators.hpp"
 
 #include "core/msg.hpp"
+#include "utils/buffer_pool.hpp"
 
 zlink::shared_message_memory_allocator::shared_message_memory_allocator (
   std::size_t bufsize_) :
     _buf (NULL),
     _buf_size (0),
     _max_size (bufsize_),
+    _pooled (false),
     _msg_content (NULL),
     _max_counters ((_max_size + msg_t::max_vsm_size - 1) / msg_t::max_vsm_size)
 {
@@ -20,6 +22,7 @@ zlink::shared_message_memory_allocator::shared_message_memory_allocator (
     _buf (NULL),
     _buf_size (0),
     _max_size (bufsize_),
+    _pooled (false),
     _msg_content (NULL),
     _max_counters (max_messages_)
 {
@@ -50,11 +53,9 @@ unsigned char *zlink::shared_message_memory_allocator::allocate ()
     // if buf != NULL it is not used by any message so we can re-use it for the next run
     if (!_buf) {
         // allocate memory for reference counters together with reception buffer
-        std::size_t const allocationsize =
-          _max_size + sizeof (zlink::atomic_counter_t)
-          + _max_counters * sizeof (zlink::msg_t::content_t);
-
-        _buf = static_cast<unsigned char *> (std::malloc (allocationsize));
+        _buf = static_cast<unsigned char *> (
+          _pooled ? buffer_pool_allocate (allocation_size ())
+                  : std::malloc (allocation_size ()));
         alloc_assert (_buf);
 
         new (_buf) atomic_counter_t (1);
@@ -81,6 +82,17 @@ void zlink::shared_message_memory_allocator::deallocate ()
     clear ();
 }
 
+void zlink::shared_message_memory_allocator::shrink ()
+{
+    zlink::atomic_counter_t *c = reinterpret_cast<zlink::atomic_counter_t *> (_buf);
+    if (_buf && !c->sub (1)) {
+        c->~atomic_counter_t ();
+        buffer_pool_release (_buf, allocation_size ());
+    }
+    _pooled = true;
+    clear ();
+}
+
 unsigned char *zlink::shared_message_memory_allocator::release ()
 {
     unsigned char *b = _buf;
@@ -95,6 +107,13 @@ void zlink::shared_message_memory_allocator::clear ()
     _msg_content = NULL;
 }
 
+std::size_t zlink::shared_message_memory_allocator::allocation_size () const
+{
+    // memory for reference counters together with reception buffer
+    return _max_size + sizeof (zlink::atomic_counter_t)
+           + _max_counters * sizeof (zlink::msg_t::content_t);
+}
+
 void zlink::shared_message_memory_allocator::inc_ref ()
 {
     (reinterpret_cast<zlink::atomic_counter_t *> (_buf))->add (1);
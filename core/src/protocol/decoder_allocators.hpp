@@ -29,6 +29,9 @@ class c_single_allocator
 
     void deallocate () {}
 
+    //  The buffer is owned for the allocator's whole lifetime.
+    void shrink () {}
+
     std::size_t size () const { return _buf_size; }
 
     //  This buffer is fixed, size must not be changed
@@ -70,6 +73,11 @@ class shared_message_memory_allocator
     // force deallocation of buffer.
     void deallocate ();
 
+    // Drop the buffer while the decoder is idle. If no message uses it any
+    // more it is handed to the buffer pool. From then on allocate () looks
+    // in the pool first; allocators never shrunk go straight to malloc.
+    void shrink ();
+
     // Give up ownership of the buffer. The buffer's lifetime is now coupled to
     // the messages constructed on top of it.
     unsigned char *release ();
@@ -95,9 +103,12 @@ class shared_message_memory_allocator
   private:
     void clear ();
 
+    std::size_t allocation_size () const;
+
     unsigned char *_buf;
     std::size_t _buf_size;
     const std::size_t _max_size;
+    bool _pooled;
     zlink::msg_t::content_t *_msg_content;
     std::size_t _max_counters;
 };
@@ -15,6 +15,7 @@
 #include <algorithm>
 
 #include "utils/err.hpp"
+#include "utils/buffer_pool.hpp"
 #include "protocol/i_encoder.hpp"
 #include "core/msg.hpp"
 
@@ -33,10 +34,10 @@ template <typename T> class encoder_base_t : public i_encoder
         _next (NULL),
         _new_msg_flag (false),
         _buf_size (bufsize_),
-        _buf (static_cast<unsigned char *> (malloc (bufsize_))),
+        _buf (NULL),
+        _pooled (false),
         _in_progress (NULL)
     {
-        alloc_assert (_buf);
     }
 
     ~encoder_base_t () ZLINK_OVERRIDE { free (_buf); }
@@ -46,12 +47,21 @@ template <typename T> class encoder_base_t : public i_encoder
     //  points to NULL) decoder object will provide buffer of its own.
     size_t encode (unsigned char **data_, size_t size_) ZLINK_FINAL
     {
-        unsigned char *buffer = !*data_ ? _buf : *data_;
-        const size_t buffersize = !*data_ ? _buf_size : size_;
-
         if (in_progress () == NULL)
             return 0;
 
+        //  The own buffer is allocated on first use, and again after
+        //  release_buffer. Only encoders that gave a buffer back look in
+        //  the pool, so the others never touch its lock.
+        if (!*data_ && !_buf) {
+            _buf = static_cast<unsigned char *> (
+              _pooled ? buffer_pool_allocate (_buf_size) : malloc (_buf_size));
+            alloc_assert (_buf);
+        }
+
+        unsigned char *buffer = !*data_ ? _buf : *data_;
+        const size_t buffersize = !*data_ ? _buf_size : size_;
+
         size_t pos = 0;
         while (pos < buffersize) {
             //  If there are no more data to return, run the state machine.
@@ -106,6 +116,13 @@ template <typename T> class encoder_base_t : public i_encoder
         (static_cast<T *> (this)->*_next) ();
     }
 
+    void release_buffer () ZLINK_FINAL
+    {
+        buffer_pool_release (_buf, _buf_size);
+        _buf = NULL;
+        _pooled = true;
+    }
+
   protected:
     //  Prototype of state machine action.
     typedef void (T::*step_t) ();
@@ -140,7 +157,11 @@ template <typename T> class encoder_base_t : public i_encoder
 
     //  The buffer for encoded data.
     const size_t _buf_size;
-    unsigned char *const _buf;
+    unsigned char *_buf;
+
+    //  Set once release_buffer has been called, which only engines in
+    //  low-memory mode do.
+    bool _pooled;
 
     msg_t *_in_progress;
 
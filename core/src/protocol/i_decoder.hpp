@@ -20,6 +20,12 @@ class i_decoder
     virtual void get_buffer (unsigned char **data_, size_t *size_) = 0;
 
     virtual void resize_buffer (size_t) = 0;
+
+    //  Gives up the buffer returned by get_buffer while the connection is
+    //  idle. Must only be called when no undecoded input is left in it;
+    //  the next get_buffer call allocates a new one.
+    virtual void release_buffer () = 0;
+
     //  Decodes data pointed to by data_.
     //  When a message is decoded, 1 is returned.
     //  When the decoder needs more data, 0 is returned.
@@ -25,6 +25,11 @@ struct i_encoder
 
     //  Load a new message into encoder.
     virtual void load_msg (msg_t *msg_) = 0;
+
+    //  Frees the encoder's own buffer while the connection is idle. Must
+    //  only be called when no encoded data is waiting in it; the next
+    //  encode call allocates a new one.
+    virtual void release_buffer () = 0;
 };
 }
 
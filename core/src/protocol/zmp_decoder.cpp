@@ -86,13 +86,20 @@ int zlink::zmp_decoder_t::header_ready (unsigned char const *read_from_)
             errno = EPROTO;
             return -1;
         }
-        if (flags & ~(zmp_flag_sub_or_cancel)) {
+        if (flags & ~(zmp_flag_sub_or_cancel | zmp_flag_bulk)) {
             _error_code = zmp_error_flags_invalid;
             errno = EPROTO;
             return -1;
         }
     }
 
+    //  A bulk frame is a subscribe or cancel carrying a topic list.
+    if ((flags & zmp_flag_bulk) && !(flags & zmp_flag_sub_or_cancel)) {
+        _error_code = zmp_error_flags_invalid;
+        errno = EPROTO;
+        return -1;
+    }
+
     _msg_flags = 0;
     if (flags & zmp_flag_more)
         _msg_flags |= msg_t::more;
@@ -101,9 +108,11 @@ int zlink::zmp_decoder_t::header_ready (unsigned char const *read_from_)
     if (flags & zmp_flag_identity)
         _msg_flags |= msg_t::routing_id;
     if (flags & zmp_flag_subscribe)
-        _msg_flags |= msg_t::subscribe;
+        _msg_flags |= flags & zmp_flag_bulk ? msg_t::subscribe_bulk
+                                            : msg_t::subscribe;
     else if (flags & zmp_flag_cancel)
-        _msg_flags |= msg_t::cancel;
+        _msg_flags |= flags & zmp_flag_bulk ? msg_t::cancel_bulk
+                                            : msg_t::cancel;
 
     const uint32_t msg_size = get_uint32 (_tmpbuf + 4);
 
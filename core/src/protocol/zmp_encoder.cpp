@@ -35,6 +35,10 @@ void zlink::zmp_encoder_t::header_ready ()
             flags |= zmp_flag_subscribe;
         else if (cmd_type == msg_t::cancel)
             flags |= zmp_flag_cancel;
+        else if (cmd_type == msg_t::subscribe_bulk)
+            flags |= zmp_flag_subscribe | zmp_flag_bulk;
+        else if (cmd_type == msg_t::cancel_bulk)
+            flags |= zmp_flag_cancel | zmp_flag_bulk;
     }
 
     _tmp_buf[0] = zmp_magic;
@@ -20,7 +20,8 @@ const unsigned char zmp_flag_control = 0x02;
 const unsigned char zmp_flag_identity = 0x04;
 const unsigned char zmp_flag_subscribe = 0x08;
 const unsigned char zmp_flag_cancel = 0x10;
-const unsigned char zmp_flag_mask = 0x1f;
+const unsigned char zmp_flag_bulk = 0x20;
+const unsigned char zmp_flag_mask = 0x3f;
 
 //  Control Frame Types
 const unsigned char zmp_control_hello = 0x01;
@@ -0,0 +1,97 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+
+#include "sockets/backlog.hpp"
+#include "core/pipe.hpp"
+#include "utils/err.hpp"
+
+zlink::backlog_t::backlog_t ()
+{
+}
+
+zlink::backlog_t::~backlog_t ()
+{
+    while (!_entries.empty ())
+        erase (_entries.begin ());
+}
+
+static void close_frames (std::vector<zlink::msg_t> &frames_)
+{
+    for (std::vector<zlink::msg_t>::size_type i = 0, n = frames_.size ();
+         i != n; ++i) {
+        const int rc = frames_[i].close ();
+        errno_assert (rc == 0);
+    }
+    frames_.clear ();
+}
+
+bool zlink::backlog_t::push (const unsigned char *topic_,
+                             size_t size_,
+                             std::vector<msg_t> &frames_)
+{
+    const index_t::iterator it = _index.find (
+      blob_t (const_cast<unsigned char *> (topic_), size_, reference_tag_t ()));
+    if (it != _index.end ()) {
+        std::vector<msg_t> &frames = it->second->frames;
+        close_frames (frames);
+        frames.swap (frames_);
+        return true;
+    }
+
+    _entries.push_back (entry_t ());
+    entry_t &entry = _entries.back ();
+    entry.topic.set (topic_, size_);
+    entry.indexed = true;
+    entry.frames.swap (frames_);
+    _index.ZLINK_MAP_INSERT_OR_EMPLACE (blob_t (topic_, size_),
+                                        --_entries.end ());
+    return false;
+}
+
+void zlink::backlog_t::push_back (std::vector<msg_t> &frames_)
+{
+    _entries.push_back (entry_t ());
+    entry_t &entry = _entries.back ();
+    entry.indexed = false;
+    entry.frames.swap (frames_);
+}
+
+void zlink::backlog_t::pop_front ()
+{
+    zlink_assert (!_entries.empty ());
+    erase (_entries.begin ());
+}
+
+bool zlink::backlog_t::write (pipe_t *pipe_)
+{
+    bool written = false;
+    while (!_entries.empty ()) {
+        //  Once the first frame is in, the pipe takes the rest of the
+        //  message regardless of the high-water mark.
+        if (!pipe_->check_write ())
+            break;
+        std::vector<msg_t> &frames = _entries.front ().frames;
+        for (std::vector<msg_t>::size_type i = 0, n = frames.size (); i != n;
+             ++i) {
+            const bool ok = pipe_->write (&frames[i]);
+            zlink_assert (ok);
+        }
+        //  The pipe owns the frames now.
+        frames.clear ();
+        erase (_entries.begin ());
+        written = true;
+    }
+    if (written)
+        pipe_->flush ();
+    return _entries.empty ();
+}
+
+void zlink::backlog_t::erase (entries_t::iterator it_)
+{
+    close_frames (it_->frames);
+    if (it_->indexed)
+        _index.erase (
+          blob_t (it_->topic.data (), it_->topic.size (), reference_tag_t ()));
+    _entries.erase (it_);
+}
@@ -0,0 +1,72 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_BACKLOG_HPP_INCLUDED__
+#define __ZLINK_BACKLOG_HPP_INCLUDED__
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "core/msg.hpp"
+#include "utils/blob.hpp"
+#include "utils/blob_hash.hpp"
+#include "utils/macros.hpp"
+
+namespace zlink
+{
+class pipe_t;
+
+//  Messages held back for a subscriber until its pipe drains. Messages
+//  pushed under a topic are conflated (ZLINK_XPUB_CONFLATE): a newer
+//  message on the topic replaces the queued one and takes over its place
+//  in the queue. Messages appended without a topic simply queue up
+//  (ZLINK_XPUB_SLOW_POLICY).
+class backlog_t
+{
+  public:
+    backlog_t ();
+    ~backlog_t ();
+
+    //  Queues frames_ under the topic; the frames are taken over and
+    //  frames_ is left empty. Returns true if an older message on the
+    //  topic was replaced.
+    bool
+    push (const unsigned char *topic_, size_t size_, std::vector<msg_t> &frames_);
+
+    //  Queues frames_ at the end, taking them over.
+    void push_back (std::vector<msg_t> &frames_);
+
+    //  Drops the oldest message.
+    void pop_front ();
+
+    //  Writes queued messages to the pipe, oldest first, for as long as
+    //  it takes them, and flushes it. Returns true if the queue is empty.
+    bool write (pipe_t *pipe_);
+
+    bool empty () const { return _entries.empty (); }
+    size_t size () const { return _entries.size (); }
+
+  private:
+    struct entry_t
+    {
+        blob_t topic;
+        bool indexed;
+        std::vector<msg_t> frames;
+    };
+
+    //  Oldest first.
+    typedef std::list<entry_t> entries_t;
+
+    void erase (entries_t::iterator it_);
+
+    entries_t _entries;
+    typedef std::
+      unordered_map<blob_t, entries_t::iterator, blob_hash, blob_equal>
+        index_t;
+    index_t _index;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (backlog_t)
+};
+}
+
+#endif
@@ -1,20 +1,88 @@
 /* SPDX-License-Identifier: MPL-2.0 */
 
 #include "utils/precompiled.hpp"
+#include <algorithm>
+#include <new>
+#include <thread>
+
 #include "sockets/dist.hpp"
 #include "core/pipe.hpp"
+#include "core/command_batch.hpp"
+#include "core/io_thread.hpp"
 #include "utils/err.hpp"
 #include "core/msg.hpp"
 #include "utils/likely.hpp"
 
+namespace zlink
+{
+//  Stands for the distributor in one of the I/O threads helping it.
+class dist_shard_t ZLINK_FINAL : public object_t
+{
+  public:
+    dist_shard_t (io_thread_t *io_thread_, dist_t *dist_) :
+        object_t (io_thread_), _dist (dist_)
+    {
+    }
+
+    //  Asks the I/O thread to take part in the job.
+    void start (uint64_t job_) { send_fan_out (this, job_); }
+
+  private:
+    void process_fan_out (uint64_t job_) ZLINK_OVERRIDE
+    {
+        _dist->help (job_);
+    }
+
+    dist_t *const _dist;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (dist_shard_t)
+};
+}
+
+//  Pipes written to per chunk of a job, and the number of matching pipes
+//  from which the shards are asked to help. Below that, waking them up
+//  costs more than it saves.
+static const size_t chunk_size = 64;
+static const size_t min_sharded_pipes = 4 * chunk_size;
+
 zlink::dist_t::dist_t () :
-    _matching (0), _active (0), _eligible (0), _more (false)
+    _matching (0),
+    _active (0),
+    _eligible (0),
+    _more (false),
+    _job_msg (NULL),
+    _job_pipes (0),
+    _job_chunks (0),
+    _job (0),
+    _last_job (0),
+    _next_chunk (0),
+    _helpers (0),
+    _pending (0)
 {
 }
 
 zlink::dist_t::~dist_t ()
 {
     zlink_assert (_pipes.empty ());
+    set_shards (std::vector<io_thread_t *> ());
+}
+
+void zlink::dist_t::set_shards (const std::vector<io_thread_t *> &io_threads_)
+{
+    //  A shard may still have a request to handle, from a job finished
+    //  without it.
+    while (_pending.load () != 0)
+        std::this_thread::yield ();
+    for (size_t i = 0, n = _shards.size (); i != n; ++i)
+        LIBZLINK_DELETE (_shards[i]);
+    _shards.clear ();
+
+    for (size_t i = 0, n = io_threads_.size (); i != n; ++i) {
+        dist_shard_t *shard =
+          new (std::nothrow) dist_shard_t (io_threads_[i], this);
+        alloc_assert (shard);
+        _shards.push_back (shard);
+    }
 }
 
 void zlink::dist_t::attach (pipe_t *pipe_)
@@ -46,15 +114,36 @@ bool zlink::dist_t::has_pipe (pipe_t *pipe_)
     return _pipes[claimed_index] == pipe_;
 }
 
+bool zlink::dist_t::writable (pipe_t *pipe_)
+{
+    const pipes_t::size_type index = _pipes.index (pipe_);
+    if (index < _matching)
+        return true;
+    if (index >= _eligible)
+        return false;
+    if (pipe_->check_write ())
+        return true;
+
+    if (index < _active) {
+        _pipes.swap (index, _active - 1);
+        _active--;
+    }
+    _pipes.swap (_pipes.index (pipe_), _eligible - 1);
+    _eligible--;
+    return false;
+}
+
 void zlink::dist_t::match (pipe_t *pipe_)
 {
     //  If pipe is already matching do nothing.
     if (_pipes.index (pipe_) < _matching)
         return;
 
-    //  If the pipe isn't eligible, ignore it.
-    if (_pipes.index (pipe_) >= _eligible)
+    //  If the pipe isn't eligible, the message is dropped for it.
+    if (_pipes.index (pipe_) >= _eligible) {
+        pipe_->count_dropped ();
         return;
+    }
 
     //  Mark the pipe as matching.
     _pipes.swap (_pipes.index (pipe_), _matching);
@@ -152,6 +241,15 @@ void zlink::dist_t::distribute (msg_t *msg_)
         return;
     }
 
+    if (!_shards.empty () && _matching >= min_sharded_pipes) {
+        distribute_sharded (msg_);
+        return;
+    }
+
+    //  Wake up each peer's thread once for the whole fan-out rather than
+    //  once per pipe.
+    command_batch_t batch;
+
     if (msg_->is_vsm ()) {
         for (pipes_t::size_type i = 0; i < _matching;) {
             if (!write (_pipes[i], msg_)) {
@@ -188,6 +286,86 @@ void zlink::dist_t::distribute (msg_t *msg_)
     errno_assert (rc == 0);
 }
 
+void zlink::dist_t::distribute_sharded (msg_t *msg_)
+{
+    //  As in distribute, each pipe gets a reference to the message; a very
+    //  small message is copied into each pipe.
+    if (!msg_->is_vsm ())
+        msg_->add_refs (static_cast<int> (_matching) - 1);
+
+    _job_msg = msg_;
+    _job_pipes = _matching;
+    _job_chunks = (_matching + chunk_size - 1) / chunk_size;
+    _failed.assign (_matching, 0);
+    _next_chunk.store (0);
+    _job.store (++_last_job);
+
+    //  The requests must not wait in a batch until this thread is done.
+    const size_t helpers = std::min (_shards.size (), _job_chunks - 1);
+    for (size_t i = 0; i != helpers; ++i) {
+        _pending++;
+        _shards[i]->start (_last_job);
+    }
+
+    //  This thread takes chunks as well, so that the message goes out
+    //  even if the I/O threads are busy. Once none are left, wait for the
+    //  shards still writing theirs.
+    {
+        command_batch_t batch;
+        write_chunks ();
+    }
+    _job.store (0);
+    while (_helpers.load () != 0)
+        std::this_thread::yield ();
+
+    //  Going down the array, a pipe is only ever swapped with one further
+    //  up, so those still to check stay where they were.
+    int failed = 0;
+    for (size_t i = _job_pipes; i-- != 0;) {
+        if (_failed[i]) {
+            _pipes[i]->count_dropped ();
+            deactivate (_pipes[i]);
+            ++failed;
+        }
+    }
+    if (unlikely (failed) && !msg_->is_vsm ())
+        msg_->rm_refs (failed);
+
+    const int rc = msg_->init ();
+    errno_assert (rc == 0);
+}
+
+void zlink::dist_t::write_chunks ()
+{
+    const bool more = (_job_msg->flags () & msg_t::more) != 0;
+    for (size_t chunk = _next_chunk++; chunk < _job_chunks;
+         chunk = _next_chunk++) {
+        //  Wake up each peer's thread once per chunk.
+        command_batch_t batch;
+        const size_t end = std::min ((chunk + 1) * chunk_size, _job_pipes);
+        for (size_t i = chunk * chunk_size; i != end; ++i) {
+            pipe_t *pipe = _pipes[i];
+            if (!pipe->write (_job_msg))
+                _failed[i] = 1;
+            else if (!more)
+                pipe->flush ();
+        }
+    }
+}
+
+void zlink::dist_t::help (uint64_t job_)
+{
+    //  Announce the help before checking the job, so that the thread
+    //  ending the job either waits for it or it sees the job is over.
+    _helpers++;
+    if (_job.load () == job_)
+        write_chunks ();
+    _helpers--;
+
+    //  The distributor may be gone right after.
+    _pending--;
+}
+
 bool zlink::dist_t::has_out ()
 {
     return true;
@@ -196,12 +374,8 @@ bool zlink::dist_t::has_out ()
 bool zlink::dist_t::write (pipe_t *pipe_, msg_t *msg_)
 {
     if (!pipe_->write (msg_)) {
-        _pipes.swap (_pipes.index (pipe_), _matching - 1);
-        _matching--;
-        _pipes.swap (_pipes.index (pipe_), _active - 1);
-        _active--;
-        _pipes.swap (_active, _eligible - 1);
-        _eligible--;
+        pipe_->count_dropped ();
+        deactivate (pipe_);
         return false;
     }
     if (!(msg_->flags () & msg_t::more))
@@ -209,6 +383,16 @@ bool zlink::dist_t::write (pipe_t *pipe_, msg_t *msg_)
     return true;
 }
 
+void zlink::dist_t::deactivate (pipe_t *pipe_)
+{
+    _pipes.swap (_pipes.index (pipe_), _matching - 1);
+    _matching--;
+    _pipes.swap (_pipes.index (pipe_), _active - 1);
+    _active--;
+    _pipes.swap (_active, _eligible - 1);
+    _eligible--;
+}
+
 bool zlink::dist_t::check_hwm ()
 {
     for (pipes_t::size_type i = 0; i < _matching; ++i)
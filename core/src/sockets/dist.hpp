@@ -3,15 +3,19 @@
 #ifndef __ZLINK_DIST_HPP_INCLUDED__
 #define __ZLINK_DIST_HPP_INCLUDED__
 
+#include <atomic>
 #include <vector>
 
 #include "utils/array.hpp"
 #include "utils/macros.hpp"
+#include "utils/stdint.hpp"
 
 namespace zlink
 {
 class pipe_t;
 class msg_t;
+class io_thread_t;
+class dist_shard_t;
 
 //  Class manages a set of outbound pipes. It sends each messages to
 //  each of them.
@@ -27,11 +31,17 @@ class dist_t
     //  Checks if this pipe is present in the distributor.
     bool has_pipe (zlink::pipe_t *pipe_);
 
+    //  Checks whether the next message can be sent to the pipe. A pipe
+    //  found full is made passive until it is activated again, as if
+    //  writing to it had failed.
+    bool writable (zlink::pipe_t *pipe_);
+
     //  Activates pipe that have previously reached high watermark.
     void activated (zlink::pipe_t *pipe_);
 
     //  Mark the pipe as matching. Subsequent call to send_to_matching
-    //  will send message also to this pipe.
+    //  will send message also to this pipe. A pipe that can't take the
+    //  message has it counted as dropped.
     void match (zlink::pipe_t *pipe_);
 
     //  Marks all pipes that are not matched as matched and vice-versa.
@@ -54,14 +64,37 @@ class dist_t
     // check HWM of all pipes matching
     bool check_hwm ();
 
+    //  Has the given I/O threads help with writing messages that go to
+    //  many pipes, replacing those set before. The calling thread keeps
+    //  taking part. An empty list turns the help off.
+    void set_shards (const std::vector<zlink::io_thread_t *> &io_threads_);
+
   private:
-    //  Write the message to the pipe. Make the pipe inactive if writing
-    //  fails. In such a case false is returned.
+    friend class dist_shard_t;
+
+    //  Write the message to the pipe. Make the pipe inactive and count the
+    //  message as dropped if writing fails. In such a case false is
+    //  returned.
     bool write (zlink::pipe_t *pipe_, zlink::msg_t *msg_);
 
+    //  Make a pipe that failed to take the message inactive.
+    void deactivate (zlink::pipe_t *pipe_);
+
     //  Put the message to all active pipes.
     void distribute (zlink::msg_t *msg_);
 
+    //  Same as distribute, with the shards writing to part of the pipes.
+    void distribute_sharded (zlink::msg_t *msg_);
+
+    //  Writes the current job's message to chunks of its pipes as long
+    //  as there are chunks nobody took yet. Pipes that fail are only
+    //  flagged in _failed, the array must not change until all are done.
+    void write_chunks ();
+
+    //  Run by a shard on its I/O thread: takes part in the job unless it
+    //  is over already.
+    void help (uint64_t job_);
+
     //  List of outbound pipes.
     typedef array_t<zlink::pipe_t, 2> pipes_t;
     pipes_t _pipes;
@@ -84,6 +117,30 @@ class dist_t
     //  True if last we are in the middle of a multipart message.
     bool _more;
 
+    //  One object in each of the I/O threads helping with the writes,
+    //  the one a fan_out command for the thread is sent to.
+    std::vector<dist_shard_t *> _shards;
+
+    //  The message being written with the help of the shards, the
+    //  number of pipes and chunks of pipes it goes to, and the pipes
+    //  it could not be written to.
+    zlink::msg_t *_job_msg;
+    size_t _job_pipes;
+    size_t _job_chunks;
+    std::vector<unsigned char> _failed;
+
+    //  ID of the job in progress, 0 if none, and of the last one.
+    std::atomic<uint64_t> _job;
+    uint64_t _last_job;
+
+    //  Next chunk of the job to write.
+    std::atomic<size_t> _next_chunk;
+
+    //  Number of shards taking part in a job right now, and of requests
+    //  to the shards they have not handled yet.
+    std::atomic<int> _helpers;
+    std::atomic<int> _pending;
+
     ZLINK_NON_COPYABLE_NOR_MOVABLE (dist_t)
 };
 }
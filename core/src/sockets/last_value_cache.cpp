@@ -0,0 +1,106 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+#include <string.h>
+
+#include "sockets/last_value_cache.hpp"
+#include "core/pipe.hpp"
+#include "utils/err.hpp"
+
+zlink::last_value_cache_t::last_value_cache_t () : _budget (0), _bytes (0)
+{
+}
+
+zlink::last_value_cache_t::~last_value_cache_t ()
+{
+    while (!_entries.empty ())
+        erase (--_entries.end ());
+}
+
+void zlink::last_value_cache_t::set_budget (size_t budget_)
+{
+    _budget = budget_;
+    while (_bytes > _budget)
+        erase (--_entries.end ());
+}
+
+void zlink::last_value_cache_t::store (const unsigned char *topic_,
+                                       size_t size_,
+                                       std::vector<msg_t> &frames_)
+{
+    const index_t::iterator it = _index.find (
+      blob_t (const_cast<unsigned char *> (topic_), size_, reference_tag_t ()));
+    if (it != _index.end ())
+        erase (it->second);
+
+    size_t bytes = size_;
+    for (std::vector<msg_t>::size_type i = 0, n = frames_.size (); i != n; ++i)
+        bytes += frames_[i].size ();
+
+    //  A value that can never fit only drops the stale one.
+    if (_budget == 0 || bytes > _budget) {
+        for (std::vector<msg_t>::size_type i = 0, n = frames_.size (); i != n;
+             ++i) {
+            const int rc = frames_[i].close ();
+            errno_assert (rc == 0);
+        }
+        frames_.clear ();
+        return;
+    }
+
+    _entries.push_front (entry_t ());
+    entry_t &entry = _entries.front ();
+    entry.topic.set (topic_, size_);
+    entry.frames.swap (frames_);
+    entry.bytes = bytes;
+    _index.ZLINK_MAP_INSERT_OR_EMPLACE (blob_t (topic_, size_),
+                                        _entries.begin ());
+    _bytes += bytes;
+
+    while (_bytes > _budget)
+        erase (--_entries.end ());
+}
+
+size_t zlink::last_value_cache_t::replay (const unsigned char *prefix_,
+                                          size_t size_,
+                                          pipe_t *pipe_)
+{
+    size_t written = 0;
+    for (entries_t::reverse_iterator it = _entries.rbegin (),
+                                     end = _entries.rend ();
+         it != end; ++it) {
+        msg_t &first = it->frames.front ();
+        if (first.size () < size_ || memcmp (first.data (), prefix_, size_) != 0)
+            continue;
+
+        //  Once the first frame is in, the pipe takes the rest of the
+        //  message regardless of the high-water mark.
+        if (!pipe_->check_write ())
+            break;
+        for (std::vector<msg_t>::size_type i = 0, n = it->frames.size ();
+             i != n; ++i) {
+            msg_t copy;
+            int rc = copy.init ();
+            errno_assert (rc == 0);
+            rc = copy.copy (it->frames[i]);
+            errno_assert (rc == 0);
+            const bool ok = pipe_->write (&copy);
+            zlink_assert (ok);
+        }
+        ++written;
+    }
+    return written;
+}
+
+void zlink::last_value_cache_t::erase (entries_t::iterator it_)
+{
+    for (std::vector<msg_t>::size_type i = 0, n = it_->frames.size (); i != n;
+         ++i) {
+        const int rc = it_->frames[i].close ();
+        errno_assert (rc == 0);
+    }
+    _index.erase (
+      blob_t (it_->topic.data (), it_->topic.size (), reference_tag_t ()));
+    _bytes -= it_->bytes;
+    _entries.erase (it_);
+}
@@ -0,0 +1,77 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_LAST_VALUE_CACHE_HPP_INCLUDED__
+#define __ZLINK_LAST_VALUE_CACHE_HPP_INCLUDED__
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "core/msg.hpp"
+#include "utils/blob.hpp"
+#include "utils/blob_hash.hpp"
+#include "utils/macros.hpp"
+#include "utils/stdint.hpp"
+
+namespace zlink
+{
+class pipe_t;
+
+//  Latest message published on each topic, replayed to subscribers that
+//  join later (ZLINK_XPUB_LAST_VALUE_CACHE). The frames are copies that
+//  share the content of the published ones. Once the held bytes exceed
+//  the budget, the topics published least recently are dropped.
+class last_value_cache_t
+{
+  public:
+    last_value_cache_t ();
+    ~last_value_cache_t ();
+
+    //  Sets the budget in bytes, dropping entries to fit. 0 empties the
+    //  cache and keeps it empty.
+    void set_budget (size_t budget_);
+    size_t budget () const { return _budget; }
+
+    //  Makes frames_ the value of the topic. The frames are taken over
+    //  and frames_ is left empty.
+    void
+    store (const unsigned char *topic_, size_t size_, std::vector<msg_t> &frames_);
+
+    //  Writes the values whose first frame starts with prefix_ to the
+    //  pipe, oldest first, without flushing it. Returns the number of
+    //  messages written.
+    size_t replay (const unsigned char *prefix_, size_t size_, pipe_t *pipe_);
+
+    //  Bytes of topics and message data held.
+    uint64_t bytes () const { return _bytes; }
+
+    //  Number of topics held.
+    size_t size () const { return _index.size (); }
+
+  private:
+    struct entry_t
+    {
+        blob_t topic;
+        std::vector<msg_t> frames;
+        size_t bytes;
+    };
+
+    //  Most recently published first.
+    typedef std::list<entry_t> entries_t;
+
+    void erase (entries_t::iterator it_);
+
+    entries_t _entries;
+    typedef std::
+      unordered_map<blob_t, entries_t::iterator, blob_hash, blob_equal>
+        index_t;
+    index_t _index;
+
+    size_t _budget;
+    uint64_t _bytes;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (last_value_cache_t)
+};
+}
+
+#endif
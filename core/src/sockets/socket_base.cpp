@@ -53,6 +53,7 @@
 #include "transports/pgm/pgm_socket.hpp"
 #endif
 #include "core/mailbox.hpp"
+#include "utils/condition_variable.hpp"
 
 #include <boost/asio.hpp>
 
@@ -185,8 +186,12 @@ zlink::socket_base_t::socket_base_t (ctx_t *parent_,
     _ctx_terminated (false),
     _destroyed (false),
     _poller (NULL),
+    _inline_fn (NULL),
+    _inline_hint (NULL),
+    _inline_poller (NULL),
     _last_tsc (0),
     _ticks (0),
+    _command_batches (0),
     _rcvmore (false),
     _monitor_socket (NULL),
     _monitor_events (0),
@@ -273,6 +278,8 @@ int zlink::socket_base_t::socket_peer_info (const zlink_routing_id_t *routing_id
             info_->connected_time = pipe->get_connected_time ();
             info_->msgs_sent = pipe->get_msgs_written ();
             info_->msgs_received = pipe->get_msgs_read ();
+            info_->msgs_dropped = pipe->get_msgs_dropped ();
+            info_->lag = pipe->get_lag () + xmsgs_held (pipe);
             return 0;
         }
     }
@@ -340,6 +347,8 @@ int zlink::socket_base_t::socket_peers (zlink_peer_info_t *peers_,
         info->connected_time = pipe->get_connected_time ();
         info->msgs_sent = pipe->get_msgs_written ();
         info->msgs_received = pipe->get_msgs_read ();
+        info->msgs_dropped = pipe->get_msgs_dropped ();
+        info->lag = pipe->get_lag () + xmsgs_held (pipe);
     }
 
     *count_ = to_copy;
@@ -457,6 +466,11 @@ int zlink::socket_base_t::setsockopt (int option_,
                                     const void *optval_,
                                     size_t optvallen_)
 {
+    if (unlikely (off_inline_thread ()))
+        return run_on_inline_thread ([=] () {
+            return setsockopt (option_, optval_, optvallen_);
+        });
+
     if (unlikely (_ctx_terminated)) {
         errno = ETERM;
         return -1;
@@ -480,6 +494,11 @@ int zlink::socket_base_t::getsockopt (int option_,
                                     void *optval_,
                                     size_t *optvallen_)
 {
+    if (unlikely (off_inline_thread ()))
+        return run_on_inline_thread ([=] () {
+            return getsockopt (option_, optval_, optvallen_);
+        });
+
     if (unlikely (_ctx_terminated)) {
         errno = ETERM;
         return -1;
@@ -558,6 +577,9 @@ int zlink::socket_base_t::leave (const char *group_)
 
 int zlink::socket_base_t::bind (const char *endpoint_uri_)
 {
+    if (unlikely (off_inline_thread ()))
+        return run_on_inline_thread (
+          [=] () { return bind (endpoint_uri_); });
 
     if (unlikely (_ctx_terminated)) {
         errno = ETERM;
@@ -602,13 +624,24 @@ int zlink::socket_base_t::bind (const char *endpoint_uri_)
 
     //  Remaining transports require to be run in an I/O thread, so at this
     //  point we'll choose one.
-    io_thread_t *io_thread = choose_io_thread (options.affinity);
+    io_thread_t *io_thread =
+      choose_io_thread (options.affinity, options.numa_node);
     if (!io_thread) {
         errno = EMTHREAD;
         return -1;
     }
 
     if (protocol == protocol_name::tcp) {
+        //  With accept sharding the first listener goes to the least
+        //  loaded of the shard threads, the rest join its port below.
+        std::vector<io_thread_t *> shard_threads;
+        if (options.tcp_accept_shards != 0) {
+            choose_io_threads (options.affinity, options.tcp_accept_shards,
+                               shard_threads);
+            if (shard_threads.size () > 1)
+                io_thread = shard_threads[0];
+        }
+
         //  Use ASIO-based listener for async_accept
         asio_tcp_listener_t *listener =
           new (std::nothrow) asio_tcp_listener_t (io_thread, this, options);
@@ -624,6 +657,9 @@ int zlink::socket_base_t::bind (const char *endpoint_uri_)
         // Save last endpoint URI
         listener->get_local_address (_last_endpoint);
 
+        if (shard_threads.size () > 1)
+            add_tcp_accept_shards (listener, shard_threads);
+
         add_endpoint (make_unconnected_bind_endpoint_pair (_last_endpoint),
                       static_cast<own_t *> (listener), NULL);
         options.connected = true;
@@ -735,6 +771,10 @@ int zlink::socket_base_t::bind (const char *endpoint_uri_)
 
 int zlink::socket_base_t::connect (const char *endpoint_uri_)
 {
+    if (unlikely (off_inline_thread ()))
+        return run_on_inline_thread (
+          [=] () { return connect_internal (endpoint_uri_); });
+
     return connect_internal (endpoint_uri_);
 }
 
@@ -792,7 +832,10 @@ int zlink::socket_base_t::connect_internal (const char *endpoint_uri_)
 
         int hwms[2] = {conflate ? -1 : sndhwm, conflate ? -1 : rcvhwm};
         bool conflates[2] = {conflate, conflate};
-        rc = pipepair (parents, new_pipes, hwms, conflates);
+        bool low_memory[2] = {options.low_memory,
+                              peer.socket == NULL ? options.low_memory
+                                                  : peer.options.low_memory};
+        rc = pipepair (parents, new_pipes, hwms, conflates, low_memory);
         if (!conflate) {
             new_pipes[0]->set_hwms_boost (peer.options.sndhwm,
                                           peer.options.rcvhwm);
@@ -850,7 +893,8 @@ int zlink::socket_base_t::connect_internal (const char *endpoint_uri_)
     }
 
     //  Choose the I/O thread to run the session in.
-    io_thread_t *io_thread = choose_io_thread (options.affinity);
+    io_thread_t *io_thread =
+      choose_io_thread (options.affinity, options.numa_node);
     if (!io_thread) {
         errno = EMTHREAD;
         return -1;
@@ -984,7 +1028,8 @@ int zlink::socket_base_t::connect_internal (const char *endpoint_uri_)
         int hwms[2] = {conflate ? -1 : options.sndhwm,
                        conflate ? -1 : options.rcvhwm};
         bool conflates[2] = {conflate, conflate};
-        rc = pipepair (parents, new_pipes, hwms, conflates);
+        bool low_memory[2] = {options.low_memory, options.low_memory};
+        rc = pipepair (parents, new_pipes, hwms, conflates, low_memory);
         errno_assert (rc == 0);
 
         //  Attach local end of the pipe to the socket object.
@@ -1003,6 +1048,43 @@ int zlink::socket_base_t::connect_internal (const char *endpoint_uri_)
     return 0;
 }
 
+void zlink::socket_base_t::add_tcp_accept_shards (
+  asio_tcp_listener_t *listener_, const std::vector<io_thread_t *> &io_threads_)
+{
+    //  Rebind to the resolved address so that a wildcard port is shared.
+    const std::string prefix = std::string (protocol_name::tcp) + "://";
+    zlink_assert (_last_endpoint.compare (0, prefix.size (), prefix) == 0);
+    const std::string address = _last_endpoint.substr (prefix.size ());
+
+    std::vector<asio_tcp_listener_t *> shards;
+    for (size_t i = 1, size = io_threads_.size (); i != size; ++i) {
+        asio_tcp_listener_t *shard = new (std::nothrow)
+          asio_tcp_listener_t (io_threads_[i], this, options);
+        alloc_assert (shard);
+        if (shard->set_local_address (address.c_str ()) != 0) {
+            //  The kernel refused to share the port (e.g. SO_REUSEPORT is
+            //  not available); keep the acceptors created so far.
+            LIBZLINK_DELETE (shard);
+            break;
+        }
+        shards.push_back (shard);
+    }
+    if (shards.empty ())
+        return;
+
+    //  Flags must be in place before the listeners get plugged.
+    listener_->set_accept_sharded ();
+    for (size_t i = 0, size = shards.size (); i != size; ++i)
+        shards[i]->set_accept_sharded ();
+    if (options.tcp_accept_cpu_affinity)
+        listener_->attach_cpu_affinity_filter (
+          static_cast<int> (shards.size () + 1));
+
+    for (size_t i = 0, size = shards.size (); i != size; ++i)
+        add_endpoint (make_unconnected_bind_endpoint_pair (_last_endpoint),
+                      static_cast<own_t *> (shards[i]), NULL);
+}
+
 std::string
 zlink::socket_base_t::resolve_tcp_addr (std::string endpoint_uri_pair_,
                                       const char *tcp_address_)
@@ -1045,6 +1127,9 @@ void zlink::socket_base_t::add_endpoint (
 
 int zlink::socket_base_t::term_endpoint (const char *endpoint_uri_)
 {
+    if (unlikely (off_inline_thread ()))
+        return run_on_inline_thread (
+          [=] () { return term_endpoint (endpoint_uri_); });
 
     //  Check whether the context hasn't been shut down yet.
     if (unlikely (_ctx_terminated)) {
@@ -1149,7 +1234,8 @@ int zlink::socket_base_t::send (msg_t *msg_, int flags_)
     //  multi-part send is in progress and can't be recovered, so drop
     //  silently when in blocking mode to keep backward compatibility.
     if (unlikely (rc == -2)) {
-        if (!((flags_ & ZLINK_DONTWAIT) || options.sndtimeo == 0)) {
+        if (!((flags_ & ZLINK_DONTWAIT) || options.sndtimeo == 0
+              || _inline_fn)) {
             rc = msg_->close ();
             errno_assert (rc == 0);
             rc = msg_->init ();
@@ -1162,8 +1248,9 @@ int zlink::socket_base_t::send (msg_t *msg_, int flags_)
     }
 
     //  In case of non-blocking send we'll simply propagate
-    //  the error - including EAGAIN - up the stack.
-    if ((flags_ & ZLINK_DONTWAIT) || options.sndtimeo == 0) {
+    //  the error - including EAGAIN - up the stack. Inline sockets never
+    //  block as that would stall their I/O thread.
+    if ((flags_ & ZLINK_DONTWAIT) || options.sndtimeo == 0 || _inline_fn) {
         return -1;
     }
 
@@ -1244,7 +1331,7 @@ int zlink::socket_base_t::recv (msg_t *msg_, int flags_)
     //  For non-blocking recv, commands are processed in case there's an
     //  activate_reader command already waiting in a command pipe.
     //  If it's not, return EAGAIN.
-    if ((flags_ & ZLINK_DONTWAIT) || options.rcvtimeo == 0) {
+    if ((flags_ & ZLINK_DONTWAIT) || options.rcvtimeo == 0 || _inline_fn) {
         if (unlikely (process_commands (0, false) != 0)) {
             return -1;
         }
@@ -1310,6 +1397,38 @@ int zlink::socket_base_t::close ()
     return 0;
 }
 
+int zlink::socket_base_t::set_inline (zlink_inline_fn *fn_, void *hint_)
+{
+    if (unlikely (_ctx_terminated)) {
+        errno = ETERM;
+        return -1;
+    }
+    if (!fn_ || _inline_fn || !_endpoints.empty () || !_pipes.empty ()) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    io_thread_t *io_thread =
+      choose_io_thread (options.affinity, options.numa_node);
+    if (!io_thread) {
+        errno = EMTHREAD;
+        return -1;
+    }
+
+    _inline_fn = fn_;
+    _inline_hint = hint_;
+    _inline_poller = io_thread->get_poller ();
+
+    //  From now on commands for the socket are processed on the I/O
+    //  thread, the same way the reaper does once the socket is closed.
+    mailbox_t *mailbox = static_cast<mailbox_t *> (_mailbox);
+    mailbox->set_io_context (&_inline_poller->get_io_context (),
+                             &socket_base_t::inline_mailbox_handler, this,
+                             &socket_base_t::reaper_mailbox_pre_post);
+    mailbox->schedule_if_needed ();
+    return 0;
+}
+
 bool zlink::socket_base_t::has_in ()
 {
     return xhas_in ();
@@ -1333,8 +1452,104 @@ void zlink::socket_base_t::reaper_mailbox_pre_post (void *arg_)
     self->inc_mailbox_ref ();
 }
 
+void zlink::socket_base_t::inline_mailbox_handler (void *arg_)
+{
+    socket_base_t *self = static_cast<socket_base_t *> (arg_);
+    self->inline_event ();
+    self->dec_mailbox_ref ();
+}
+
+void zlink::socket_base_t::inline_event ()
+{
+    //  Runs left over from before the socket was closed.
+    if (!_inline_fn) {
+        in_event ();
+        return;
+    }
+
+    mailbox_t *mailbox = static_cast<mailbox_t *> (_mailbox);
+    do {
+        //  Nothing is delivered any more once the context is terminated.
+        if (process_commands (0, false) != 0)
+            continue;
+
+        //  Hand over what the pipes hold, but give the rest of the I/O
+        //  thread a turn after inbound_poll_rate parts. No activate_read
+        //  will come for pipes that still hold messages, so a follow-up
+        //  run picks them up; it also takes over rescheduling.
+        msg_t msg;
+        int rc = msg.init ();
+        errno_assert (rc == 0);
+        for (int count = 0; _inline_fn && xrecv (&msg) == 0;) {
+            extract_flags (&msg);
+            _inline_fn (this, reinterpret_cast<zlink_msg_t *> (&msg),
+                        _inline_hint);
+            rc = msg.close ();
+            errno_assert (rc == 0);
+            rc = msg.init ();
+            errno_assert (rc == 0);
+            if (++count == inbound_poll_rate) {
+                inc_mailbox_ref ();
+                boost::asio::post (_inline_poller->get_io_context (),
+                                   [this] () {
+                                       this->inline_event ();
+                                       this->dec_mailbox_ref ();
+                                   });
+                return;
+            }
+        }
+    } while (mailbox->reschedule_if_needed ());
+}
+
+bool zlink::socket_base_t::off_inline_thread () const
+{
+    return _inline_poller
+           && !_inline_poller->get_io_context ()
+                 .get_executor ()
+                 .running_in_this_thread ();
+}
+
+int zlink::socket_base_t::run_on_inline_thread (
+  const std::function<int ()> &fn_)
+{
+    mutex_t sync;
+    condition_variable_t cond;
+    bool done = false;
+    int rc = 0;
+    int err = 0;
+
+    boost::asio::post (_inline_poller->get_io_context (), [&] () {
+        rc = fn_ ();
+        err = errno;
+        scoped_lock_t lock (sync);
+        done = true;
+        cond.broadcast ();
+    });
+
+    {
+        scoped_lock_t lock (sync);
+        while (!done)
+            cond.wait (&sync, -1);
+    }
+    errno = err;
+    return rc;
+}
+
 void zlink::socket_base_t::start_reaping (poller_t *poller_)
 {
+    //  An inline socket goes on running on its I/O thread until the
+    //  reaper's poller has taken over, so that it is never driven by two
+    //  threads at once.
+    if (_inline_poller && poller_ != _inline_poller) {
+        inc_mailbox_ref ();
+        boost::asio::post (_inline_poller->get_io_context (), [this] () {
+            _inline_fn = NULL;
+            this->start_reaping (_inline_poller);
+            this->dec_mailbox_ref ();
+        });
+        return;
+    }
+
     //  Plug the socket to the reaper thread.
     _poller = poller_;
 
@@ -1381,6 +1596,8 @@ int zlink::socket_base_t::process_commands (int timeout_, bool throttle_)
 
     if (rc != 0 && errno == EINTR)
         return -1;
+    if (rc == 0)
+        _command_batches++;
 
     //  Process all available commands.
     while (rc == 0 || errno == EINTR) {
@@ -1520,6 +1737,11 @@ void zlink::socket_base_t::xhiccuped (pipe_t *)
     zlink_assert (false);
 }
 
+uint64_t zlink::socket_base_t::xmsgs_held (pipe_t *)
+{
+    return 0;
+}
+
 void zlink::socket_base_t::in_event ()
 {
     do {
@@ -3,8 +3,10 @@
 #ifndef __ZLINK_SOCKET_BASE_HPP_INCLUDED__
 #define __ZLINK_SOCKET_BASE_HPP_INCLUDED__
 
+#include <functional>
 #include <string>
 #include <map>
+#include <vector>
 #include <stdarg.h>
 
 #include "core/own.hpp"
@@ -29,6 +31,8 @@ namespace zlink
 class ctx_t;
 class msg_t;
 class pipe_t;
+class io_thread_t;
+class asio_tcp_listener_t;
 class socket_base_t : public own_t,
                       public array_item_t<>,
                       public i_poll_events,
@@ -55,6 +59,14 @@ class socket_base_t : public own_t,
     int setsockopt (int option_, const void *optval_, size_t optvallen_);
     int getsockopt (int option_, void *optval_, size_t *optvallen_);
     int get_events (int events_, uint32_t *out_);
+
+    //  Number of times commands were found in the mailbox. Whenever it
+    //  moves on, the ZLINK_FD signal may have been consumed, so pollers
+    //  that wait on the descriptor have to ask for the events again.
+    uint64_t command_batches () const { return _command_batches; }
+
+    //  Process-wide unique id, unlike the address of the socket.
+    int get_socket_id () const { return options.socket_id; }
     int bind (const char *endpoint_uri_);
     int connect (const char *endpoint_uri_);
     int term_endpoint (const char *endpoint_uri_);
@@ -62,6 +74,10 @@ class socket_base_t : public own_t,
     int recv (zlink::msg_t *msg_, int flags_);
     int close ();
 
+    //  Moves the socket onto an I/O thread where fn_ is called for every
+    //  message part received (see zlink_socket_set_inline).
+    int set_inline (zlink_inline_fn *fn_, void *hint_);
+
     //  These functions are used by the polling mechanism to determine
     //  which events are to be reported from this socket.
     bool has_in ();
@@ -175,6 +191,10 @@ class socket_base_t : public own_t,
     virtual void xhiccuped (pipe_t *pipe_);
     virtual void xpipe_terminated (pipe_t *pipe_) = 0;
 
+    //  Number of messages the socket holds back for the pipe's peer on top
+    //  of those in the pipe. The default implementation holds none.
+    virtual uint64_t xmsgs_held (pipe_t *pipe_);
+
     //  the default implementation assumes that joub and leave are not supported.
     virtual int xjoin (const char *group_);
     virtual int xleave (const char *group_);
@@ -271,6 +291,20 @@ class socket_base_t : public own_t,
     static void reaper_mailbox_handler (void *arg_);
     static void reaper_mailbox_pre_post (void *arg_);
 
+    //  Inline mode: commands are processed and received messages handed
+    //  to the callback on the inline I/O thread.
+    static void inline_mailbox_handler (void *arg_);
+    void inline_event ();
+
+    //  True for an inline socket when called from any thread other than
+    //  its I/O thread.
+    bool off_inline_thread () const;
+
+    //  Runs fn_ on the inline socket's I/O thread, where it can't race
+    //  with the callbacks, waits for it and returns its result with the
+    //  errno it set.
+    int run_on_inline_thread (const std::function<int ()> &fn_);
+
     //  Handlers for incoming commands.
     void process_stop () ZLINK_FINAL;
     void process_bind (zlink::pipe_t *pipe_) ZLINK_FINAL;
@@ -282,6 +316,11 @@ class socket_base_t : public own_t,
     std::string resolve_tcp_addr (std::string endpoint_uri_,
                                   const char *tcp_address_);
 
+    //  Adds acceptors on the remaining I/O threads to the SO_REUSEPORT
+    //  group of an already bound tcp listener.
+    void add_tcp_accept_shards (asio_tcp_listener_t *listener_,
+                                const std::vector<io_thread_t *> &io_threads_);
+
     //  Socket's mailbox object.
     i_mailbox *_mailbox;
 
@@ -292,12 +331,21 @@ class socket_base_t : public own_t,
     //  Reaper's poller.
     poller_t *_poller;
 
+    //  Callback and poller of the I/O thread the socket runs on in inline
+    //  mode, NULL otherwise. The callback is dropped once the socket is
+    //  being closed.
+    zlink_inline_fn *_inline_fn;
+    void *_inline_hint;
+    poller_t *_inline_poller;
+
     //  Timestamp of when commands were processed the last time.
     uint64_t _last_tsc;
 
     //  Number of messages received since last command processing.
     int _ticks;
 
+    uint64_t _command_batches;
+
     //  True if the last message received had MORE flag set.
     bool _rcvmore;
 
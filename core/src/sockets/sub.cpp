@@ -3,6 +3,7 @@
 #include "utils/precompiled.hpp"
 #include "sockets/sub.hpp"
 #include "core/msg.hpp"
+#include "utils/topic_list.hpp"
 
 zlink::sub_t::sub_t (class ctx_t *parent_, uint32_t tid_, int sid_) :
     xsub_t (parent_, tid_, sid_)
@@ -22,7 +23,11 @@ int zlink::sub_t::xsetsockopt (int option_,
                              const void *optval_,
                              size_t optvallen_)
 {
-    if (option_ != ZLINK_SUBSCRIBE && option_ != ZLINK_UNSUBSCRIBE) {
+    if (option_ == ZLINK_TOPIC_DELIMITER || option_ == ZLINK_BLOOM_FILTER)
+        return xsub_t::xsetsockopt (option_, optval_, optvallen_);
+
+    if (option_ != ZLINK_SUBSCRIBE && option_ != ZLINK_UNSUBSCRIBE
+        && option_ != ZLINK_SUBSCRIBE_BULK && option_ != ZLINK_UNSUBSCRIBE_BULK) {
         errno = EINVAL;
         return -1;
     }
@@ -33,8 +38,18 @@ int zlink::sub_t::xsetsockopt (int option_,
     const unsigned char *data = static_cast<const unsigned char *> (optval_);
     if (option_ == ZLINK_SUBSCRIBE) {
         rc = msg.init_subscribe (optvallen_, data);
-    } else {
+    } else if (option_ == ZLINK_UNSUBSCRIBE) {
         rc = msg.init_cancel (optvallen_, data);
+    } else {
+        //  The whole list goes upstream as a single message.
+        if (!is_topic_list (data, optvallen_)) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (option_ == ZLINK_SUBSCRIBE_BULK)
+            rc = msg.init_subscribe_bulk (optvallen_, data);
+        else
+            rc = msg.init_cancel_bulk (optvallen_, data);
     }
     errno_assert (rc == 0);
 
@@ -2,6 +2,8 @@
 
 #include "utils/precompiled.hpp"
 #include <string.h>
+#include <algorithm>
+#include <new>
 
 #include "sockets/xpub.hpp"
 #include "core/pipe.hpp"
@@ -9,9 +11,29 @@
 #include "core/msg.hpp"
 #include "utils/macros.hpp"
 #include "utils/generic_mtrie_impl.hpp"
+#include "utils/topic_list.hpp"
 
 zlink::xpub_t::xpub_t (class ctx_t *parent_, uint32_t tid_, int sid_) :
     socket_base_t (parent_, tid_, sid_),
+    _topic_delimiter (-1),
+    _subscriptions_generation (0),
+    _max_topic_size (0),
+    _cache_generation (0),
+    _topic_cache_max (0),
+    _topic_cache_hits (0),
+    _topic_cache_misses (0),
+    _bloom_size (0),
+    _bloom_stale (false),
+    _bloom_rejected (0),
+    _bloom_false_positives (0),
+    _matched (false),
+    _keep_frames (false),
+    _conflate (-1),
+    _slow_policy (ZLINK_XPUB_DROP_NEWEST),
+    _slow_limit (1000),
+    _holding (false),
+    _conflated (0),
+    _shards (0),
     _verbose_subs (false),
     _verbose_unsubs (false),
     _more_send (false),
@@ -32,6 +54,12 @@ zlink::xpub_t::xpub_t (class ctx_t *parent_, uint32_t tid_, int sid_) :
 zlink::xpub_t::~xpub_t ()
 {
     _welcome_msg.close ();
+    for (std::vector<msg_t>::size_type i = 0, n = _sent_frames.size ();
+         i != n; ++i)
+        _sent_frames[i].close ();
+    for (backlogs_t::iterator it = _backlogs.begin (), end = _backlogs.end ();
+         it != end; ++it)
+        LIBZLINK_DELETE (it->second);
     for (std::deque<metadata_t *>::iterator it = _pending_metadata.begin (),
                                             end = _pending_metadata.end ();
          it != end; ++it)
@@ -50,8 +78,11 @@ void zlink::xpub_t::xattach_pipe (pipe_t *pipe_,
 
     //  If subscribe_to_all_ is specified, the caller would like to subscribe
     //  to all data on this pipe, implicitly.
-    if (subscribe_to_all_)
-        _subscriptions.add (NULL, 0, pipe_);
+    if (subscribe_to_all_) {
+        if (_subscriptions.add (NULL, 0, pipe_))
+            _bloom.add (NULL, 0);
+        subscriptions_changed ();
+    }
 
     // if welcome message exists, send a copy of it
     if (_welcome_msg.size () > 0) {
@@ -80,7 +111,7 @@ void zlink::xpub_t::xread_activated (pipe_t *pipe_)
         size_t size = 0;
         bool subscribe = false;
         bool is_subscribe_or_cancel = false;
-        bool notify = false;
+        bool bulk = false;
 
         const bool first_part = !_more_recv;
         _more_recv = (msg.flags () & msg_t::more) != 0;
@@ -92,6 +123,10 @@ void zlink::xpub_t::xread_activated (pipe_t *pipe_)
                 size = msg.command_body_size ();
                 subscribe = msg.is_subscribe ();
                 is_subscribe_or_cancel = true;
+            } else if (msg.is_subscribe_bulk () || msg.is_cancel_bulk ()) {
+                subscribe = msg.is_subscribe_bulk ();
+                is_subscribe_or_cancel = true;
+                bulk = true;
             } else if (msg.size () > 0 && (*msg_data == 0 || *msg_data == 1)) {
                 data = msg_data + 1;
                 size = msg.size () - 1;
@@ -105,54 +140,18 @@ void zlink::xpub_t::xread_activated (pipe_t *pipe_)
               !_only_first_subscribe || is_subscribe_or_cancel;
 
         if (is_subscribe_or_cancel) {
-            if (_manual) {
-                // Store manual subscription to use on termination
-                if (!subscribe)
-                    _manual_subscriptions.rm (data, size, pipe_);
-                else
-                    _manual_subscriptions.add (data, size, pipe_);
-
-                _pending_pipes.push_back (pipe_);
-            } else {
-                if (!subscribe) {
-                    const mtrie_t::rm_result rm_result =
-                      _subscriptions.rm (data, size, pipe_);
-                    //  TODO reconsider what to do if rm_result == mtrie_t::not_found
-                    notify =
-                      rm_result != mtrie_t::values_remain || _verbose_unsubs;
-                } else {
-                    const bool first_added =
-                      _subscriptions.add (data, size, pipe_);
-                    notify = first_added || _verbose_subs;
-                }
-            }
-
-            //  If the request was a new subscription, or the subscription
-            //  was removed, or verbose mode or manual mode are enabled, store it
-            //  so that it can be passed to the user on next recv call.
-            if (_manual || (options.type == ZLINK_XPUB && notify)) {
-                //  ZMTP 3.1 hack: we need to support sub/cancel commands, but
-                //  we can't give them back to userspace as it would be an API
-                //  breakage since the payload of the message is completely
-                //  different. Manually craft an old-style message instead.
-                //  Although with other transports it would be possible to simply
-                //  reuse the same buffer and prefix a 0/1 byte to the topic, with
-                //  inproc the subscribe/cancel command string is not present in
-                //  the message, so this optimization is not possible.
-                //  The pushback makes a copy of the data array anyway, so the
-                //  number of buffer copies does not change.
-                blob_t notification (size + 1);
-                if (subscribe)
-                    *notification.data () = 1;
-                else
-                    *notification.data () = 0;
-                memcpy (notification.data () + 1, data, size);
-
-                _pending_data.push_back (ZLINK_MOVE (notification));
-                if (metadata)
-                    metadata->add_ref ();
-                _pending_metadata.push_back (metadata);
-                _pending_flags.push_back (0);
+            if (!bulk)
+                apply_subscription (pipe_, data, size, subscribe, metadata);
+            else {
+                //  Each topic of the list is taken as if sent on its own.
+                const unsigned char *pos = msg_data;
+                const unsigned char *end = msg_data + msg.size ();
+                const unsigned char *topic;
+                size_t topic_size;
+                while (next_topic (&pos, end, &topic, &topic_size))
+                    apply_subscription (pipe_,
+                                        const_cast<unsigned char *> (topic),
+                                        topic_size, subscribe, metadata);
             }
         } else if (options.type != ZLINK_PUB) {
             //  Process user message coming upstream from xsub socket,
@@ -169,9 +168,95 @@ void zlink::xpub_t::xread_activated (pipe_t *pipe_)
     }
 }
 
+void zlink::xpub_t::apply_subscription (pipe_t *pipe_,
+                                        unsigned char *data_,
+                                        size_t size_,
+                                        bool subscribe_,
+                                        metadata_t *metadata_)
+{
+    bool notify = false;
+    if (_manual) {
+        // Store manual subscription to use on termination
+        if (!subscribe_)
+            _manual_subscriptions.rm (data_, size_, pipe_);
+        else
+            _manual_subscriptions.add (data_, size_, pipe_);
+
+        _pending_pipes.push_back (pipe_);
+    } else {
+        const bool exact = is_exact_topic (data_, size_, _topic_delimiter);
+        if (!subscribe_) {
+            //  TODO reconsider what to do if the subscription was
+            //  not found
+            bool values_remain;
+            bool removed;
+            if (exact) {
+                const topic_map_t::rm_result rc =
+                  _topics.rm (data_, size_, pipe_);
+                values_remain = rc == topic_map_t::values_remain;
+                removed = rc == topic_map_t::last_value_removed;
+            } else {
+                const mtrie_t::rm_result rc =
+                  _subscriptions.rm (data_, size_, pipe_);
+                values_remain = rc == mtrie_t::values_remain;
+                removed = rc == mtrie_t::last_value_removed;
+            }
+            if (removed)
+                _bloom.rm (data_, size_);
+            notify = !values_remain || _verbose_unsubs;
+            subscriptions_changed ();
+        } else {
+            const bool first_added = exact
+                                       ? _topics.add (data_, size_, pipe_)
+                                       : _subscriptions.add (data_, size_, pipe_);
+            if (first_added)
+                _bloom.add (data_, size_);
+            notify = first_added || _verbose_subs;
+            subscriptions_changed (size_);
+            if (_last_values.budget () > 0)
+                replay_last_values (pipe_, data_, size_);
+        }
+    }
+
+    //  If the request was a new subscription, or the subscription
+    //  was removed, or verbose mode or manual mode are enabled, store it
+    //  so that it can be passed to the user on next recv call.
+    if (_manual || (options.type == ZLINK_XPUB && notify)) {
+        //  ZMTP 3.1 hack: we need to support sub/cancel commands, but
+        //  we can't give them back to userspace as it would be an API
+        //  breakage since the payload of the message is completely
+        //  different. Manually craft an old-style message instead.
+        //  Although with other transports it would be possible to simply
+        //  reuse the same buffer and prefix a 0/1 byte to the topic, with
+        //  inproc the subscribe/cancel command string is not present in
+        //  the message, so this optimization is not possible.
+        //  The pushback makes a copy of the data array anyway, so the
+        //  number of buffer copies does not change.
+        blob_t notification (size_ + 1);
+        if (subscribe_)
+            *notification.data () = 1;
+        else
+            *notification.data () = 0;
+        memcpy (notification.data () + 1, data_, size_);
+
+        _pending_data.push_back (ZLINK_MOVE (notification));
+        if (metadata_)
+            metadata_->add_ref ();
+        _pending_metadata.push_back (metadata_);
+        _pending_flags.push_back (0);
+    }
+}
+
 void zlink::xpub_t::xwrite_activated (pipe_t *pipe_)
 {
     _dist.activated (pipe_);
+
+    //  Messages held back for the pipe go first.
+    const backlogs_t::iterator it = _backlogs.find (pipe_);
+    if (it != _backlogs.end () && it->second->write (pipe_)) {
+        LIBZLINK_DELETE (it->second);
+        _backlogs.erase (it);
+    }
 }
 
 int zlink::xpub_t::xsetsockopt (int option_,
@@ -202,13 +287,84 @@ int zlink::xpub_t::xsetsockopt (int option_,
         else if (option_ == ZLINK_ONLY_FIRST_SUBSCRIBE)
             _only_first_subscribe = (*static_cast<const int *> (optval_) != 0);
     } else if (option_ == ZLINK_SUBSCRIBE && _manual) {
-        if (_last_pipe != NULL)
-            _subscriptions.add ((unsigned char *) optval_, optvallen_,
-                                _last_pipe);
+        if (_last_pipe != NULL) {
+            if (_subscriptions.add ((unsigned char *) optval_, optvallen_,
+                                    _last_pipe))
+                _bloom.add ((unsigned char *) optval_, optvallen_);
+            subscriptions_changed (optvallen_);
+        }
     } else if (option_ == ZLINK_UNSUBSCRIBE && _manual) {
-        if (_last_pipe != NULL)
-            _subscriptions.rm ((unsigned char *) optval_, optvallen_,
-                               _last_pipe);
+        if (_last_pipe != NULL) {
+            if (_subscriptions.rm ((unsigned char *) optval_, optvallen_,
+                                   _last_pipe)
+                == mtrie_t::last_value_removed)
+                _bloom.rm ((unsigned char *) optval_, optvallen_);
+            subscriptions_changed ();
+        }
+    } else if (option_ == ZLINK_XPUB_TOPIC_CACHE) {
+        if (optvallen_ != sizeof (int)
+            || *static_cast<const int *> (optval_) < 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        _topic_cache_max = *static_cast<const int *> (optval_);
+        _topic_cache.clear ();
+    } else if (option_ == ZLINK_BLOOM_FILTER) {
+        if (optvallen_ != sizeof (int)
+            || *static_cast<const int *> (optval_) < 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        _bloom_size = *static_cast<const int *> (optval_);
+        rebuild_bloom ();
+    } else if (option_ == ZLINK_XPUB_LAST_VALUE_CACHE) {
+        if (optvallen_ != sizeof (int)
+            || *static_cast<const int *> (optval_) < 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        _last_values.set_budget (*static_cast<const int *> (optval_));
+    } else if (option_ == ZLINK_XPUB_CONFLATE) {
+        if (optvallen_ != sizeof (int)
+            || *static_cast<const int *> (optval_) < -1) {
+            errno = EINVAL;
+            return -1;
+        }
+        _conflate = *static_cast<const int *> (optval_);
+    } else if (option_ == ZLINK_XPUB_SLOW_POLICY) {
+        if (optvallen_ != sizeof (int)
+            || *static_cast<const int *> (optval_) < ZLINK_XPUB_DROP_NEWEST
+            || *static_cast<const int *> (optval_) > ZLINK_XPUB_DISCONNECT) {
+            errno = EINVAL;
+            return -1;
+        }
+        _slow_policy = *static_cast<const int *> (optval_);
+    } else if (option_ == ZLINK_XPUB_SLOW_LIMIT) {
+        if (optvallen_ != sizeof (int)
+            || *static_cast<const int *> (optval_) < 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        _slow_limit = *static_cast<const int *> (optval_);
+    } else if (option_ == ZLINK_XPUB_SHARDS) {
+        if (optvallen_ != sizeof (int)
+            || *static_cast<const int *> (optval_) < -1) {
+            errno = EINVAL;
+            return -1;
+        }
+        _shards = *static_cast<const int *> (optval_);
+        std::vector<io_thread_t *> io_threads;
+        if (_shards != 0)
+            choose_io_threads (options.affinity, _shards, io_threads);
+        _dist.set_shards (io_threads);
+    } else if (option_ == ZLINK_TOPIC_DELIMITER) {
+        //  Exact topics already indexed were split on the old delimiter.
+        if (optvallen_ != sizeof (int) || *static_cast<const int *> (optval_) < -1
+            || *static_cast<const int *> (optval_) > 255 || !_topics.empty ()) {
+            errno = EINVAL;
+            return -1;
+        }
+        _topic_delimiter = *static_cast<const int *> (optval_);
     } else if (option_ == ZLINK_XPUB_WELCOME_MSG) {
         _welcome_msg.close ();
 
@@ -234,8 +390,35 @@ int zlink::xpub_t::xgetsockopt (int option_, void *optval_, size_t *optvallen_)
         // make sure to use a multi-thread safe function to avoid race conditions with I/O threads
         // where subscriptions are processed:
         return do_getsockopt<int> (optval_, optvallen_,
-                                   (int) _subscriptions.num_prefixes ());
+                                   (int) (_subscriptions.num_prefixes ()
+                                          + _topics.num_prefixes ()));
     }
+    if (option_ == ZLINK_TOPIC_DELIMITER)
+        return do_getsockopt<int> (optval_, optvallen_, _topic_delimiter);
+    if (option_ == ZLINK_XPUB_SLOW_POLICY)
+        return do_getsockopt<int> (optval_, optvallen_, _slow_policy);
+    if (option_ == ZLINK_XPUB_SLOW_LIMIT)
+        return do_getsockopt<int> (optval_, optvallen_,
+                                   static_cast<int> (_slow_limit));
+    if (option_ == ZLINK_XPUB_CONFLATED)
+        return do_getsockopt<uint64_t> (optval_, optvallen_, _conflated);
+    if (option_ == ZLINK_XPUB_SHARDS)
+        return do_getsockopt<int> (optval_, optvallen_, _shards);
+    if (option_ == ZLINK_XPUB_LAST_VALUE_CACHE_SIZE)
+        return do_getsockopt<uint64_t> (optval_, optvallen_,
+                                        _last_values.bytes ());
+    if (option_ == ZLINK_XPUB_TOPIC_CACHE_HITS)
+        return do_getsockopt<uint64_t> (optval_, optvallen_, _topic_cache_hits);
+    if (option_ == ZLINK_XPUB_TOPIC_CACHE_MISSES)
+        return do_getsockopt<uint64_t> (optval_, optvallen_,
+                                        _topic_cache_misses);
+    if (option_ == ZLINK_BLOOM_FILTER)
+        return do_getsockopt<int> (optval_, optvallen_, _bloom_size);
+    if (option_ == ZLINK_BLOOM_REJECTED)
+        return do_getsockopt<uint64_t> (optval_, optvallen_, _bloom_rejected);
+    if (option_ == ZLINK_BLOOM_FALSE_POSITIVES)
+        return do_getsockopt<uint64_t> (optval_, optvallen_,
+                                        _bloom_false_positives);
 
     // room for future options here
 
@@ -260,6 +443,7 @@ void zlink::xpub_t::xpipe_terminated (pipe_t *pipe_)
         //  care of by the manual call above. subscriptions is the real mtrie,
         //  so the pipe must be removed from there or it will be left over.
         _subscriptions.rm (pipe_, stub, static_cast<void *> (NULL), false);
+        _topics.rm (pipe_, stub, static_cast<void *> (NULL), false);
 
         // In case the pipe is currently set as last we must clear it to prevent
         // subscriptions from being re-added.
@@ -271,16 +455,242 @@ void zlink::xpub_t::xpipe_terminated (pipe_t *pipe_)
         //  is interested in anymore, send corresponding unsubscriptions
         //  upstream.
         _subscriptions.rm (pipe_, send_unsubscription, this, !_verbose_unsubs);
+        _topics.rm (pipe_, send_unsubscription, this, !_verbose_unsubs);
+    }
+    subscriptions_changed ();
+    _bloom_stale = _bloom.enabled ();
+
+    for (std::deque<pipe_t *>::iterator it = _replay_pipes.begin (),
+                                        end = _replay_pipes.end ();
+         it != end; ++it)
+        if (*it == pipe_)
+            *it = NULL;
+
+    const backlogs_t::iterator backlog = _backlogs.find (pipe_);
+    if (backlog != _backlogs.end ()) {
+        LIBZLINK_DELETE (backlog->second);
+        _backlogs.erase (backlog);
     }
+    _held_pipes.erase (
+      std::remove (_held_pipes.begin (), _held_pipes.end (), pipe_),
+      _held_pipes.end ());
 
     _dist.pipe_terminated (pipe_);
 }
 
 void zlink::xpub_t::mark_as_matching (pipe_t *pipe_, xpub_t *self_)
 {
+    self_->_matched = true;
+
+    //  A pipe that can't take the message, or still has older ones held
+    //  back, is dealt with once the whole message is in.
+    if (unlikely (self_->_holding)
+        && (self_->_backlogs.count (pipe_) || !self_->_dist.writable (pipe_))) {
+        self_->_held_pipes.push_back (pipe_);
+        return;
+    }
     self_->_dist.match (pipe_);
 }
 
+void zlink::xpub_t::add_to_entry (pipe_t *pipe_, std::vector<pipe_t *> *pipes_)
+{
+    pipes_->push_back (pipe_);
+}
+
+void zlink::xpub_t::subscriptions_changed (size_t added_size_)
+{
+    ++_subscriptions_generation;
+    if (added_size_ > _max_topic_size)
+        _max_topic_size = added_size_;
+}
+
+void zlink::xpub_t::rebuild_bloom ()
+{
+    _bloom.reset (_bloom_size);
+    if (_bloom.enabled ()) {
+        _subscriptions.apply (add_to_bloom, &_bloom);
+        _topics.apply (add_to_bloom, &_bloom);
+    }
+    _bloom_stale = false;
+}
+
+void zlink::xpub_t::add_to_bloom (mtrie_t::prefix_t data_,
+                                  size_t size_,
+                                  bloom_filter_t *bloom_)
+{
+    bloom_->add (data_, size_);
+}
+
+void zlink::xpub_t::match_subscriptions (msg_t *msg_)
+{
+    if (_topic_cache_max > 0)
+        match_cached (msg_);
+    else {
+        const unsigned char *data = static_cast<unsigned char *> (msg_->data ());
+        _subscriptions.match (data, msg_->size (), mark_as_matching, this);
+        match_topic (data, msg_->size (), mark_as_matching, this);
+    }
+}
+
+void zlink::xpub_t::match_filtered (msg_t *msg_)
+{
+    if (unlikely (_bloom_stale))
+        rebuild_bloom ();
+    if (!_bloom.check (static_cast<unsigned char *> (msg_->data ()),
+                       msg_->size ())) {
+        ++_bloom_rejected;
+        return;
+    }
+    _matched = false;
+    match_subscriptions (msg_);
+    if (!_matched)
+        ++_bloom_false_positives;
+}
+
+void zlink::xpub_t::match_cached (msg_t *msg_)
+{
+    if (_cache_generation != _subscriptions_generation) {
+        _topic_cache.clear ();
+        _cache_generation = _subscriptions_generation;
+    }
+
+    //  Bytes past the longest subscription cannot change what matches.
+    unsigned char *data = static_cast<unsigned char *> (msg_->data ());
+    const size_t size = std::min (msg_->size (), _max_topic_size);
+
+    topic_cache_t::iterator it =
+      _topic_cache.find (blob_t (data, size, reference_tag_t ()));
+    if (it == _topic_cache.end ()) {
+        ++_topic_cache_misses;
+        if (_topic_cache.size () >= _topic_cache_max)
+            _topic_cache.clear ();
+        it = _topic_cache
+               .ZLINK_MAP_INSERT_OR_EMPLACE (blob_t (data, size),
+                                             std::vector<pipe_t *> ())
+               .first;
+        _subscriptions.match (data, size, add_to_entry, &it->second);
+        match_topic (data, size, add_to_entry, &it->second);
+    } else
+        ++_topic_cache_hits;
+
+    const std::vector<pipe_t *> &pipes = it->second;
+    for (std::vector<pipe_t *>::size_type i = 0, n = pipes.size (); i != n;
+         ++i)
+        mark_as_matching (pipes[i], this);
+}
+
+void zlink::xpub_t::replay_last_values (pipe_t *pipe_,
+                                        const unsigned char *data_,
+                                        size_t size_)
+{
+    //  The values are what the subscriber would have matched.
+    if (options.invert_matching)
+        return;
+
+    //  The pipe may be in the middle of receiving a multi-part message.
+    if (_more_send) {
+        _replay_pipes.push_back (pipe_);
+        _replay_prefixes.push_back (blob_t (data_, size_));
+        return;
+    }
+    if (_last_values.replay (data_, size_, pipe_) > 0)
+        pipe_->flush ();
+}
+
+void zlink::xpub_t::frames_sent ()
+{
+    msg_t &first = _sent_frames.front ();
+    const unsigned char *data = static_cast<unsigned char *> (first.data ());
+    const size_t size = first.size ();
+
+    if (!_held_pipes.empty ())
+        hold_back (data, size);
+
+    if (_last_values.budget () > 0) {
+        const size_t topic =
+          _topic_delimiter >= 0 ? topic_size (data, size, _topic_delimiter)
+                                : size;
+        //  Without a topic there's nothing to file the message under.
+        if (topic > 0 || _topic_delimiter < 0)
+            _last_values.store (data, topic, _sent_frames);
+    }
+    for (std::vector<msg_t>::size_type i = 0, n = _sent_frames.size ();
+         i != n; ++i)
+        _sent_frames[i].close ();
+    _sent_frames.clear ();
+
+    while (!_replay_pipes.empty ()) {
+        if (_replay_pipes.front ()
+            && _last_values.replay (_replay_prefixes.front ().data (),
+                                    _replay_prefixes.front ().size (),
+                                    _replay_pipes.front ())
+                 > 0)
+            _replay_pipes.front ()->flush ();
+        _replay_pipes.pop_front ();
+        _replay_prefixes.pop_front ();
+    }
+}
+
+void zlink::xpub_t::hold_back (const unsigned char *data_, size_t size_)
+{
+    std::sort (_held_pipes.begin (), _held_pipes.end ());
+    _held_pipes.erase (std::unique (_held_pipes.begin (), _held_pipes.end ()),
+                       _held_pipes.end ());
+
+    const size_t topic =
+      _conflate > 0 ? std::min (size_, static_cast<size_t> (_conflate)) : size_;
+
+    for (std::vector<pipe_t *>::size_type i = 0, n = _held_pipes.size ();
+         i != n; ++i) {
+        pipe_t *pipe = _held_pipes[i];
+        backlogs_t::iterator it = _backlogs.find (pipe);
+        if (_conflate < 0) {
+            //  Nothing is held back; a subscriber that has dropped its
+            //  limit is cut off.
+            if (_slow_policy == ZLINK_XPUB_DISCONNECT) {
+                pipe->count_dropped ();
+                if (pipe->get_msgs_dropped () >= _slow_limit)
+                    pipe->terminate (false);
+                continue;
+            }
+            const size_t held = it != _backlogs.end () ? it->second->size () : 0;
+            //  With the backlog full, the newest message is dropped, or
+            //  the oldest one if there is one to make room.
+            if (held >= _slow_limit) {
+                pipe->count_dropped ();
+                if (_slow_policy == ZLINK_XPUB_SPILL || held == 0)
+                    continue;
+                it->second->pop_front ();
+            }
+        }
+
+        std::vector<msg_t> frames (_sent_frames.size ());
+        for (std::vector<msg_t>::size_type j = 0; j != frames.size (); ++j) {
+            int rc = frames[j].init ();
+            errno_assert (rc == 0);
+            rc = frames[j].copy (_sent_frames[j]);
+            errno_assert (rc == 0);
+        }
+
+        if (it == _backlogs.end ()) {
+            backlog_t *backlog = new (std::nothrow) backlog_t;
+            alloc_assert (backlog);
+            it = _backlogs.ZLINK_MAP_INSERT_OR_EMPLACE (pipe, backlog).first;
+        }
+        if (_conflate < 0)
+            it->second->push_back (frames);
+        else if (it->second->push (data_, topic, frames))
+            ++_conflated;
+    }
+    _held_pipes.clear ();
+}
+
+uint64_t zlink::xpub_t::xmsgs_held (pipe_t *pipe_)
+{
+    const backlogs_t::const_iterator it = _backlogs.find (pipe_);
+    return it != _backlogs.end () ? it->second->size () : 0;
+}
+
 void zlink::xpub_t::mark_last_pipe_as_matching (pipe_t *pipe_, xpub_t *self_)
 {
     if (self_->_last_pipe == pipe_)
@@ -295,21 +705,38 @@ int zlink::xpub_t::xsend (msg_t *msg_)
     if (!_more_send) {
         // Ensure nothing from previous failed attempt to send is left matched
         _dist.unmatch ();
+        _held_pipes.clear ();
+        _holding = !options.invert_matching
+                   && (_conflate >= 0
+                       || _slow_policy != ZLINK_XPUB_DROP_NEWEST);
 
         if (unlikely (_manual && _last_pipe && _send_last_pipe)) {
             _subscriptions.match (static_cast<unsigned char *> (msg_->data ()),
                                   msg_->size (), mark_last_pipe_as_matching,
                                   this);
             _last_pipe = NULL;
-        } else
-            _subscriptions.match (static_cast<unsigned char *> (msg_->data ()),
-                                  msg_->size (), mark_as_matching, this);
+        } else if (_bloom.enabled ())
+            match_filtered (msg_);
+        else
+            match_subscriptions (msg_);
         // If inverted matching is used, reverse the selection now
         if (options.invert_matching) {
             _dist.reverse_match ();
         }
     }
 
+    if (!_more_send)
+        _keep_frames = _last_values.budget () > 0 || !_held_pipes.empty ();
+
+    //  The kept copy shares the content with the message sent.
+    msg_t copy;
+    if (_keep_frames) {
+        int rc = copy.init ();
+        errno_assert (rc == 0);
+        rc = copy.copy (*msg_);
+        errno_assert (rc == 0);
+    }
+
     int rc = -1; //  Assume we fail
     if (_lossy || _dist.check_hwm ()) {
         if (_dist.send_to_matching (msg_) == 0) {
@@ -322,6 +749,15 @@ int zlink::xpub_t::xsend (msg_t *msg_)
         }
     } else
         errno = EAGAIN;
+
+    if (_keep_frames) {
+        if (rc == 0) {
+            _sent_frames.push_back (copy);
+            if (!msg_more)
+                frames_sent ();
+        } else
+            copy.close ();
+    }
     return rc;
 }
 
@@ -4,11 +4,18 @@
 #define __ZLINK_XPUB_HPP_INCLUDED__
 
 #include <deque>
+#include <unordered_map>
+#include <vector>
 
 #include "sockets/socket_base.hpp"
 #include "core/session_base.hpp"
 #include "utils/mtrie.hpp"
+#include "utils/topic_set.hpp"
+#include "utils/bloom_filter.hpp"
 #include "sockets/dist.hpp"
+#include "sockets/last_value_cache.hpp"
+#include "sockets/backlog.hpp"
+#include "utils/blob_hash.hpp"
 
 namespace zlink
 {
@@ -39,6 +46,7 @@ class xpub_t : public socket_base_t
     xsetsockopt (int option_, const void *optval_, size_t optvallen_) ZLINK_FINAL;
     int xgetsockopt (int option_, void *optval_, size_t *optvallen_) ZLINK_FINAL;
     void xpipe_terminated (zlink::pipe_t *pipe_) ZLINK_FINAL;
+    uint64_t xmsgs_held (zlink::pipe_t *pipe_) ZLINK_FINAL;
 
   private:
     //  Function to be applied to the trie to send all the subscriptions
@@ -47,18 +55,164 @@ class xpub_t : public socket_base_t
                                      size_t size_,
                                      xpub_t *self_);
 
+    //  Applies a subscription or cancel received from the pipe and queues
+    //  the notification for the user.
+    void apply_subscription (zlink::pipe_t *pipe_,
+                             unsigned char *data_,
+                             size_t size_,
+                             bool subscribe_,
+                             metadata_t *metadata_);
+
     //  Function to be applied to each matching pipes.
     static void mark_as_matching (zlink::pipe_t *pipe_, xpub_t *self_);
 
+    //  Finds the pipes matching msg_, through the topic cache if enabled.
+    void match_subscriptions (zlink::msg_t *msg_);
+
+    //  Finds the pipes matching msg_ unless the filter rules out a match.
+    void match_filtered (zlink::msg_t *msg_);
+
+    //  Finds the pipes matching msg_ through the topic cache, walking the
+    //  trie only for topics not seen since the subscriptions last changed.
+    void match_cached (zlink::msg_t *msg_);
+
+    //  Function to be applied to each matching pipe when filling an entry
+    //  of the topic cache.
+    static void add_to_entry (zlink::pipe_t *pipe_,
+                              std::vector<pipe_t *> *pipes_);
+
+    //  Marks the pipes subscribed to the exact topic of data_ using func_.
+    template <typename Arg>
+    void match_topic (const unsigned char *data_,
+                      size_t size_,
+                      void (*func_) (zlink::pipe_t *pipe_, Arg arg_),
+                      Arg arg_)
+    {
+        if (_topics.empty ())
+            return;
+        const size_t topic = topic_size (data_, size_, _topic_delimiter);
+        if (topic > 0)
+            _topics.match (data_, topic, func_, arg_);
+    }
+
+    //  Called whenever _subscriptions changes, with the size of the
+    //  prefix if one was added.
+    void subscriptions_changed (size_t added_size_ = 0);
+
+    //  Refills the filter from _subscriptions and _topics.
+    void rebuild_bloom ();
+
+    //  Function to be applied to the trie to add each subscription to
+    //  the filter.
+    static void add_to_bloom (zlink::mtrie_t::prefix_t data_,
+                              size_t size_,
+                              bloom_filter_t *bloom_);
+
     //  List of all subscriptions mapped to corresponding pipes.
     mtrie_t _subscriptions;
 
+    //  Subscriptions that are exact topics for _topic_delimiter, kept out
+    //  of _subscriptions (ZLINK_TOPIC_DELIMITER, -1 if unset).
+    topic_map_t _topics;
+    int _topic_delimiter;
+
+    //  Bumped on every change to _subscriptions or to the set of pipes.
+    uint64_t _subscriptions_generation;
+
+    //  Longest prefix ever added to _subscriptions. Messages that agree on
+    //  that many leading bytes match the same pipes.
+    size_t _max_topic_size;
+
+    //  Pipes matched by each topic, i.e. the first _max_topic_size bytes
+    //  of a message, as of _cache_generation. At most _topic_cache_max
+    //  topics are kept (ZLINK_XPUB_TOPIC_CACHE); 0 disables the cache.
+    typedef std::unordered_map<blob_t,
+                               std::vector<pipe_t *>,
+                               blob_hash,
+                               blob_equal>
+      topic_cache_t;
+    topic_cache_t _topic_cache;
+    uint64_t _cache_generation;
+    size_t _topic_cache_max;
+    uint64_t _topic_cache_hits;
+    uint64_t _topic_cache_misses;
+
+    //  Pre-check on the subscriptions rejecting most messages that match
+    //  none of them (ZLINK_BLOOM_FILTER, 0 if off). Subscriptions removed
+    //  along with a pipe can't be told apart from those other pipes still
+    //  hold, so the filter is then rebuilt before the next message.
+    bloom_filter_t _bloom;
+    int _bloom_size;
+    bool _bloom_stale;
+
+    //  Number of messages the filter rejected, and of those it let through
+    //  that matched no pipe. _matched tells whether the current message
+    //  matched any.
+    uint64_t _bloom_rejected;
+    uint64_t _bloom_false_positives;
+    bool _matched;
+
+    //  Replays the cached last values matching a new subscription to the
+    //  pipe, or queues the replay while a multi-part message is being sent.
+    void replay_last_values (zlink::pipe_t *pipe_,
+                             const unsigned char *data_,
+                             size_t size_);
+
+    //  Hands the message whose frames were collected while sending it to
+    //  the backlogs and the last value cache.
+    void frames_sent ();
+
+    //  Holds the message back for the pipes in _held_pipes, or drops it
+    //  for them, as ZLINK_XPUB_CONFLATE and ZLINK_XPUB_SLOW_POLICY say.
+    void hold_back (const unsigned char *data_, size_t size_);
+
+    //  Latest message per topic (ZLINK_XPUB_LAST_VALUE_CACHE). The topic
+    //  is the first frame, or its part up to _topic_delimiter if set.
+    last_value_cache_t _last_values;
+
+    //  Copies of the frames sent so far of the current message, if it is
+    //  to be cached or held back.
+    std::vector<msg_t> _sent_frames;
+    bool _keep_frames;
+
+    //  Number of leading bytes of the first frame that make the topic for
+    //  conflation, 0 for the whole frame, -1 if off (ZLINK_XPUB_CONFLATE).
+    int _conflate;
+
+    //  What to do with messages for a pipe that is full when conflation
+    //  is off (ZLINK_XPUB_SLOW_POLICY), and the number of messages held
+    //  back per pipe or dropped before disconnecting (ZLINK_XPUB_SLOW_LIMIT).
+    int _slow_policy;
+    uint64_t _slow_limit;
+
+    //  True if the current message is held back for the pipes that can't
+    //  take it right now, which are collected in _held_pipes, rather than
+    //  just dropped for them. A pipe may be collected more than once.
+    bool _holding;
+    std::vector<pipe_t *> _held_pipes;
+
+    //  Messages waiting for each pipe that could not take them.
+    typedef std::unordered_map<pipe_t *, backlog_t *> backlogs_t;
+    backlogs_t _backlogs;
+
+    //  Number of queued messages replaced by newer ones.
+    uint64_t _conflated;
+
+    //  Replays to do once the current multi-part message is sent. Pipes
+    //  terminated in the meantime are replaced by NULL.
+    std::deque<pipe_t *> _replay_pipes;
+    std::deque<blob_t> _replay_prefixes;
+
     //  List of manual subscriptions mapped to corresponding pipes.
     mtrie_t _manual_subscriptions;
 
     //  Distributor of messages holding the list of outbound pipes.
     dist_t _dist;
 
+    //  Number of I/O threads helping the distributor write messages going
+    //  to many pipes, 0 for none, -1 for all eligible (ZLINK_XPUB_SHARDS).
+    int _shards;
+
     // If true, send all subscription messages upstream, not just
     // unique ones
     bool _verbose_subs;
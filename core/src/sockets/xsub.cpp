@@ -6,9 +6,19 @@
 #include "utils/macros.hpp"
 #include "sockets/xsub.hpp"
 #include "utils/err.hpp"
+#include "utils/topic_list.hpp"
+
+//  Large enough to carry hundreds of typical topics, small enough to stay
+//  below any sensible ZLINK_MAXMSGSIZE of the publisher.
+static const size_t bulk_size = 8192;
 
 zlink::xsub_t::xsub_t (class ctx_t *parent_, uint32_t tid_, int sid_) :
     socket_base_t (parent_, tid_, sid_),
+    _bulk_pipe (NULL),
+    _topic_delimiter (-1),
+    _bloom_size (0),
+    _bloom_rejected (0),
+    _bloom_false_positives (0),
     _verbose_unsubs (false),
     _has_message (false),
     _more_send (false),
@@ -44,8 +54,7 @@ void zlink::xsub_t::xattach_pipe (pipe_t *pipe_,
     _dist.attach (pipe_);
 
     //  Send all the cached subscriptions to the new upstream peer.
-    _subscriptions.apply (send_subscription, pipe_);
-    pipe_->flush ();
+    send_subscriptions (pipe_);
 }
 
 void zlink::xsub_t::xread_activated (pipe_t *pipe_)
@@ -67,8 +76,7 @@ void zlink::xsub_t::xpipe_terminated (pipe_t *pipe_)
 void zlink::xsub_t::xhiccuped (pipe_t *pipe_)
 {
     //  Send all the cached subscriptions to the hiccuped pipe.
-    _subscriptions.apply (send_subscription, pipe_);
-    pipe_->flush ();
+    send_subscriptions (pipe_);
 }
 
 int zlink::xsub_t::xsetsockopt (int option_,
@@ -84,6 +92,30 @@ int zlink::xsub_t::xsetsockopt (int option_,
         _only_first_subscribe = (*static_cast<const int *> (optval_) != 0);
         return 0;
     }
+    if (option_ == ZLINK_TOPIC_DELIMITER) {
+        //  Exact topics already indexed were split on the old delimiter.
+        if (optvallen_ != sizeof (int) || *static_cast<const int *> (optval_) < -1
+            || *static_cast<const int *> (optval_) > 255 || !_topics.empty ()) {
+            errno = EINVAL;
+            return -1;
+        }
+        _topic_delimiter = *static_cast<const int *> (optval_);
+        return 0;
+    }
+    if (option_ == ZLINK_BLOOM_FILTER) {
+        if (optvallen_ != sizeof (int)
+            || *static_cast<const int *> (optval_) < 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        _bloom_size = *static_cast<const int *> (optval_);
+        _bloom.reset (_bloom_size);
+        if (_bloom.enabled ()) {
+            _subscriptions.apply (add_to_bloom, &_bloom);
+            _topics.apply (add_to_bloom, &_bloom);
+        }
+        return 0;
+    }
     errno = EINVAL;
     return -1;
 }
@@ -99,9 +131,20 @@ int zlink::xsub_t::xgetsockopt (int option_, void *optval_, size_t *optvallen_)
         uint64_t num_subscriptions = _subscriptions.num_prefixes ();
 #endif
 
+        num_subscriptions += _topics.num_prefixes ();
+
         return do_getsockopt<int> (optval_, optvallen_,
                                    (int) num_subscriptions);
     }
+    if (option_ == ZLINK_TOPIC_DELIMITER)
+        return do_getsockopt<int> (optval_, optvallen_, _topic_delimiter);
+    if (option_ == ZLINK_BLOOM_FILTER)
+        return do_getsockopt<int> (optval_, optvallen_, _bloom_size);
+    if (option_ == ZLINK_BLOOM_REJECTED)
+        return do_getsockopt<uint64_t> (optval_, optvallen_, _bloom_rejected);
+    if (option_ == ZLINK_BLOOM_FALSE_POSITIVES)
+        return do_getsockopt<uint64_t> (optval_, optvallen_,
+                                        _bloom_false_positives);
 
     // room for future options here
 
@@ -124,6 +167,10 @@ int zlink::xsub_t::xsend (msg_t *msg_)
         return _dist.send_to_all (msg_);
     }
 
+    if (msg_->is_subscribe_bulk () || msg_->is_cancel_bulk ()) {
+        _process_subscribe = true;
+        return send_bulk (msg_);
+    }
     if (msg_->is_subscribe () || (size > 0 && *data == 1)) {
         //  Process subscribe message
         //  This used to filter out duplicate subscriptions,
@@ -134,7 +181,7 @@ int zlink::xsub_t::xsend (msg_t *msg_)
             data = data + 1;
             size = size - 1;
         }
-        _subscriptions.add (data, size);
+        add_subscription (data, size);
         _process_subscribe = true;
         return _dist.send_to_all (msg_);
     }
@@ -145,7 +192,7 @@ int zlink::xsub_t::xsend (msg_t *msg_)
             size = size - 1;
         }
         _process_subscribe = true;
-        const bool rm_result = _subscriptions.rm (data, size);
+        const bool rm_result = rm_subscription (data, size);
         if (rm_result || _verbose_unsubs)
             return _dist.send_to_all (msg_);
     } else
@@ -245,29 +292,127 @@ bool zlink::xsub_t::xhas_in ()
     }
 }
 
+void zlink::xsub_t::add_subscription (unsigned char *data_, size_t size_)
+{
+    const bool added = is_exact_topic (data_, size_, _topic_delimiter)
+                         ? _topics.add (data_, size_)
+                         : _subscriptions.add (data_, size_);
+    if (added)
+        _bloom.add (data_, size_);
+}
+
+bool zlink::xsub_t::rm_subscription (unsigned char *data_, size_t size_)
+{
+    const bool removed = is_exact_topic (data_, size_, _topic_delimiter)
+                           ? _topics.rm (data_, size_)
+                           : _subscriptions.rm (data_, size_);
+    if (removed)
+        _bloom.rm (data_, size_);
+    return removed;
+}
+
+void zlink::xsub_t::add_to_bloom (unsigned char *data_,
+                                  size_t size_,
+                                  void *arg_)
+{
+    static_cast<bloom_filter_t *> (arg_)->add (data_, size_);
+}
+
 bool zlink::xsub_t::match (msg_t *msg_)
 {
-    const bool matching = _subscriptions.check (
-      static_cast<unsigned char *> (msg_->data ()), msg_->size ());
+    const unsigned char *data = static_cast<unsigned char *> (msg_->data ());
+    const size_t size = msg_->size ();
+
+    bool matching = false;
+    if (_bloom.enabled () && !_bloom.check (data, size))
+        ++_bloom_rejected;
+    else {
+        matching = _subscriptions.check (data, size);
+        if (!matching && !_topics.empty ()) {
+            const size_t topic = topic_size (data, size, _topic_delimiter);
+            matching = topic > 0 && _topics.check (data, topic);
+        }
+        if (!matching && _bloom.enabled ())
+            ++_bloom_false_positives;
+    }
 
     return matching ^ options.invert_matching;
 }
 
-void zlink::xsub_t::send_subscription (unsigned char *data_,
-                                     size_t size_,
-                                     void *arg_)
+int zlink::xsub_t::send_bulk (msg_t *msg_)
+{
+    const unsigned char *data = static_cast<unsigned char *> (msg_->data ());
+    const unsigned char *end = data + msg_->size ();
+    const unsigned char *topic;
+    size_t size;
+
+    if (msg_->is_subscribe_bulk ()) {
+        while (next_topic (&data, end, &topic, &size))
+            add_subscription (const_cast<unsigned char *> (topic), size);
+        return _dist.send_to_all (msg_);
+    }
+
+    //  As with single cancels, only the subscriptions actually removed are
+    //  passed on.
+    std::vector<unsigned char> removed;
+    bool all_removed = true;
+    while (next_topic (&data, end, &topic, &size)) {
+        if (rm_subscription (const_cast<unsigned char *> (topic), size)
+            || _verbose_unsubs)
+            add_topic (removed, topic, size);
+        else
+            all_removed = false;
+    }
+    if (all_removed)
+        return _dist.send_to_all (msg_);
+
+    int rc = msg_->close ();
+    errno_assert (rc == 0);
+    if (removed.empty ()) {
+        rc = msg_->init ();
+        errno_assert (rc == 0);
+        return 0;
+    }
+    rc = msg_->init_cancel_bulk (removed.size (), &removed[0]);
+    errno_assert (rc == 0);
+    return _dist.send_to_all (msg_);
+}
+
+void zlink::xsub_t::send_subscriptions (pipe_t *pipe_)
+{
+    _bulk_pipe = pipe_;
+    _subscriptions.apply (add_to_bulk, this);
+    _topics.apply (add_to_bulk, this);
+    write_bulk ();
+    _bulk_pipe = NULL;
+    pipe_->flush ();
+}
+
+void zlink::xsub_t::add_to_bulk (unsigned char *data_,
+                                 size_t size_,
+                                 void *arg_)
+{
+    xsub_t *self = static_cast<xsub_t *> (arg_);
+    if (!self->_bulk.empty () && self->_bulk.size () + 4 + size_ > bulk_size)
+        self->write_bulk ();
+    add_topic (self->_bulk, data_, size_);
+}
+
+void zlink::xsub_t::write_bulk ()
 {
-    pipe_t *pipe = static_cast<pipe_t *> (arg_);
+    if (_bulk.empty ())
+        return;
 
     //  Create the subscription message.
     msg_t msg;
-    const int rc = msg.init_subscribe (size_, data_);
+    const int rc = msg.init_subscribe_bulk (_bulk.size (), &_bulk[0]);
     errno_assert (rc == 0);
+    _bulk.clear ();
 
     //  Send it to the pipe.
-    const bool sent = pipe->write (&msg);
-    //  If we reached the SNDHWM, and thus cannot send the subscription, drop
-    //  the subscription message instead. This matches the behaviour of
+    const bool sent = _bulk_pipe->write (&msg);
+    //  If we reached the SNDHWM, and thus cannot send the subscriptions,
+    //  drop them instead. This matches the behaviour of
     //  zlink_setsockopt(ZLINK_SUBSCRIBE, ...), which also drops subscriptions
     //  when the SNDHWM is reached.
     if (!sent)
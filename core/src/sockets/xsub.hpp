@@ -3,10 +3,14 @@
 #ifndef __ZLINK_XSUB_HPP_INCLUDED__
 #define __ZLINK_XSUB_HPP_INCLUDED__
 
+#include <vector>
+
 #include "sockets/socket_base.hpp"
 #include "core/session_base.hpp"
 #include "sockets/dist.hpp"
 #include "sockets/fq.hpp"
+#include "utils/topic_set.hpp"
+#include "utils/bloom_filter.hpp"
 #ifdef ZLINK_USE_RADIX_TREE
 #include "utils/radix_tree.hpp"
 #else
@@ -49,10 +53,29 @@ class xsub_t : public socket_base_t
     //  Check whether the message matches at least one subscription.
     bool match (zlink::msg_t *msg_);
 
-    //  Function to be applied to the trie to send all the subsciptions
-    //  upstream.
-    static void
-    send_subscription (unsigned char *data_, size_t size_, void *arg_);
+    //  Add or remove a subscription from whichever of _subscriptions and
+    //  _topics holds it.
+    void add_subscription (unsigned char *data_, size_t size_);
+    bool rm_subscription (unsigned char *data_, size_t size_);
+
+    //  Function to be applied to the trie to add each subscription to
+    //  the filter.
+    static void add_to_bloom (unsigned char *data_, size_t size_, void *arg_);
+
+    //  Applies a bulk subscribe or cancel message and passes it upstream.
+    int send_bulk (zlink::msg_t *msg_);
+
+    //  Sends all the subscriptions to the pipe, packed into bulk subscribe
+    //  messages of up to bulk_size bytes.
+    void send_subscriptions (zlink::pipe_t *pipe_);
+
+    //  Function to be applied to the trie to add each subscription to
+    //  _bulk, which is written to _bulk_pipe whenever it fills up.
+    static void add_to_bulk (unsigned char *data_, size_t size_, void *arg_);
+    void write_bulk ();
+
+    std::vector<unsigned char> _bulk;
+    pipe_t *_bulk_pipe;
 
     //  Fair queueing object for inbound pipes.
     fq_t _fq;
@@ -67,6 +90,19 @@ class xsub_t : public socket_base_t
     trie_with_size_t _subscriptions;
 #endif
 
+    //  Subscriptions that are exact topics for _topic_delimiter, kept out
+    //  of _subscriptions (ZLINK_TOPIC_DELIMITER, -1 if unset).
+    topic_set_t _topics;
+    int _topic_delimiter;
+
+    //  Pre-check on the subscriptions rejecting most messages that match
+    //  none of them (ZLINK_BLOOM_FILTER, 0 if off), with the number of
+    //  messages it rejected and of those it let through to match nothing.
+    bloom_filter_t _bloom;
+    int _bloom_size;
+    uint64_t _bloom_rejected;
+    uint64_t _bloom_false_positives;
+
     // If true, send all unsubscription messages upstream, not just
     // unique ones
     bool _verbose_unsubs;
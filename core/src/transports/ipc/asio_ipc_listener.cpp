@@ -294,7 +294,8 @@ void zlink::asio_ipc_listener_t::create_engine (fd_t fd_)
     }
     alloc_assert (engine);
 
-    io_thread_t *io_thread = choose_io_thread (options.affinity);
+    io_thread_t *io_thread =
+      choose_io_thread (options.affinity, options.numa_node);
     zlink_assert (io_thread);
 
     session_base_t *session =
@@ -46,6 +46,8 @@ class ipc_transport_t ZLINK_FINAL : public i_asio_transport
 
     bool supports_speculative_write () const ZLINK_OVERRIDE;
     bool supports_gather_write () const ZLINK_OVERRIDE { return true; }
+    bool supports_async_wait () const ZLINK_OVERRIDE { return true; }
+    void async_wait_readable (completion_handler_t handler) ZLINK_OVERRIDE;
 
     const char *name () const ZLINK_OVERRIDE { return "ipc_transport"; }
 
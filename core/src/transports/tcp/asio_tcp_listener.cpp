@@ -26,6 +26,10 @@
 #include <fcntl.h>
 #endif
 
+#if defined ZLINK_HAVE_LINUX && defined SO_ATTACH_REUSEPORT_CBPF
+#include <linux/filter.h>
+#endif
+
 // Debug logging for ASIO TCP listener - set to 1 to enable
 #define ASIO_LISTENER_DEBUG 0
 
@@ -45,7 +49,9 @@ zlink::asio_tcp_listener_t::asio_tcp_listener_t (io_thread_t *io_thread_,
     _io_context (io_thread_->get_io_context ()),
     _acceptor (_io_context),
     _accept_socket (_io_context),
+    _io_thread (io_thread_),
     _socket (socket_),
+    _accept_sharded (false),
     _accepting (false),
     _terminating (false),
     _linger (0)
@@ -178,6 +184,40 @@ int zlink::asio_tcp_listener_t::get_local_address (std::string &addr_) const
     return addr_.empty () ? -1 : 0;
 }
 
+void zlink::asio_tcp_listener_t::set_accept_sharded ()
+{
+    _accept_sharded = true;
+}
+
+void zlink::asio_tcp_listener_t::attach_cpu_affinity_filter (int group_size_)
+{
+    zlink_assert (group_size_ > 0);
+#if defined ZLINK_HAVE_LINUX && defined SO_ATTACH_REUSEPORT_CBPF
+    //  A = current CPU; A %= group size; return A. The kernel uses the
+    //  returned value as an index into the reuseport group, which is
+    //  ordered by the time each acceptor started listening.
+    struct sock_filter code[] = {
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0,
+       static_cast<uint32_t> (SKF_AD_OFF + SKF_AD_CPU)},
+      {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t> (group_size_)},
+      {BPF_RET | BPF_A, 0, 0, 0},
+    };
+    struct sock_fprog prog;
+    prog.len = sizeof (code) / sizeof (code[0]);
+    prog.filter = code;
+
+    const int rc =
+      setsockopt (_acceptor.native_handle (), SOL_SOCKET,
+                  SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof (prog));
+    if (rc != 0) {
+        //  Non-fatal: the kernel falls back to hashing the 4-tuple.
+        LISTENER_DBG ("Failed to attach reuseport filter: errno=%d", errno);
+    }
+#else
+    LIBZLINK_UNUSED (group_size_);
+#endif
+}
+
 std::string
 zlink::asio_tcp_listener_t::get_socket_name (fd_t fd_,
                                            socket_end_t socket_end_) const
@@ -356,7 +396,10 @@ void zlink::asio_tcp_listener_t::create_engine (fd_t fd_)
 
     //  Choose I/O thread to run engine in. Given that we are already
     //  running in an I/O thread, there must be at least one available.
-    io_thread_t *io_thread = choose_io_thread (options.affinity);
+    //  Sharded acceptors keep the session on the thread that accepted it.
+    io_thread_t *io_thread =
+      _accept_sharded ? _io_thread
+                      : choose_io_thread (options.affinity, options.numa_node);
     zlink_assert (io_thread);
 
     //  Create and launch a session object.
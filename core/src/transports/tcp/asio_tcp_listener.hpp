@@ -37,6 +37,17 @@ class asio_tcp_listener_t ZLINK_FINAL : public own_t, public io_object_t
     //  Get the bound address for use with wildcards
     int get_local_address (std::string &addr_) const;
 
+    //  Serve accepted connections on this listener's own I/O thread
+    //  instead of handing them to the least loaded one. Used when the
+    //  listener is one of several acceptors sharing a SO_REUSEPORT group.
+    //  Must be called before the listener is plugged.
+    void set_accept_sharded ();
+
+    //  Attach a reuseport BPF program to the group this listener belongs
+    //  to, so that connections are dispatched to acceptor number
+    //  (receiving CPU % group_size_). Non-fatal where unsupported.
+    void attach_cpu_affinity_filter (int group_size_);
+
   protected:
     std::string get_socket_name (fd_t fd_, socket_end_t socket_end_) const;
 
@@ -74,6 +85,9 @@ class asio_tcp_listener_t ZLINK_FINAL : public own_t, public io_object_t
     //  Socket for the next accepted connection
     boost::asio::ip::tcp::socket _accept_socket;
 
+    //  I/O thread the listener runs in.
+    zlink::io_thread_t *_io_thread;
+
     //  Socket the listener belongs to.
     zlink::socket_base_t *_socket;
 
@@ -83,6 +97,9 @@ class asio_tcp_listener_t ZLINK_FINAL : public own_t, public io_object_t
     //  String representation of endpoint to bind to
     std::string _endpoint;
 
+    //  True if accepted sessions stay on _io_thread
+    bool _accept_sharded;
+
     //  True if the acceptor is open and accepting
     bool _accepting;
 
@@ -124,9 +124,11 @@ bool tcp_transport_t::open (boost::asio::io_context &io_context, fd_t fd)
         return false;
     }
 
-    //  The fd is already set to non-blocking; inform Asio to avoid blocking
-    //  synchronous write_some/read_some paths.
-    _socket->native_non_blocking (true, ec);
+    //  The fd is already set to non-blocking, but Asio's synchronous
+    //  write_some/read_some wait in poll () on would_block unless the
+    //  socket is non-blocking at the Asio level too. A speculative read
+    //  would then block the I/O thread until the peer sends more.
+    _socket->non_blocking (true, ec);
     if (ec) {
         ASIO_GLOBAL_ERROR ("tcp_transport non-blocking failed: %s",
                            ec.message ().c_str ());
@@ -183,6 +185,20 @@ void tcp_transport_t::async_read_some (unsigned char *buffer,
     }
 }
 
+void tcp_transport_t::async_wait_readable (completion_handler_t handler)
+{
+    if (_socket) {
+        _socket->async_wait (
+          boost::asio::socket_base::wait_read,
+          [handler] (const boost::system::error_code &ec) {
+              if (handler)
+                  handler (ec, 0);
+          });
+    } else if (handler) {
+        handler (boost::asio::error::bad_descriptor, 0);
+    }
+}
+
 std::size_t tcp_transport_t::read_some (std::uint8_t *buffer, std::size_t len)
 {
     if (len == 0) {
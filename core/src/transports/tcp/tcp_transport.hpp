@@ -52,6 +52,8 @@ class tcp_transport_t : public i_asio_transport
 
     bool supports_speculative_write () const ZLINK_OVERRIDE;
     bool supports_gather_write () const ZLINK_OVERRIDE { return true; }
+    bool supports_async_wait () const ZLINK_OVERRIDE { return true; }
+    void async_wait_readable (completion_handler_t handler) ZLINK_OVERRIDE;
 
     const char *name () const ZLINK_OVERRIDE { return "tcp"; }
 
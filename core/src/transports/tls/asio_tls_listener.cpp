@@ -458,7 +458,8 @@ void zlink::asio_tls_listener_t::create_engine (
     alloc_assert (engine);
 
     //  Choose I/O thread to run engine in
-    io_thread_t *io_thread = choose_io_thread (options.affinity);
+    io_thread_t *io_thread =
+      choose_io_thread (options.affinity, options.numa_node);
     zlink_assert (io_thread);
 
     //  Create and launch a session
@@ -119,9 +119,16 @@ std::size_t ssl_transport_t::read_some (std::uint8_t *buffer, std::size_t len)
         return 0;
     }
 
+    //  The synchronous SSL read waits for a whole record, which would block
+    //  the I/O thread; anything OpenSSL has buffered is picked up by the
+    //  async read the engine falls back to.
     boost::system::error_code ec;
-    const std::size_t bytes_read =
-      _ssl_stream->read_some (boost::asio::buffer (buffer, len), ec);
+    std::size_t bytes_read = 0;
+    if (_ssl_stream->lowest_layer ().available (ec) == 0 && !ec)
+        ec = boost::asio::error::would_block;
+    else if (!ec)
+        bytes_read =
+          _ssl_stream->read_some (boost::asio::buffer (buffer, len), ec);
 
     if (ec) {
         if (ec == boost::asio::error::would_block
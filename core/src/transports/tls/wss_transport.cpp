@@ -67,7 +67,9 @@ wss_transport_t::wss_transport_t (boost::asio::ssl::context &ssl_ctx,
     _host (host),
     _ssl_handshake_complete (false),
     _ws_handshake_complete (false),
-    _handshake_type (client)
+    _handshake_type (client),
+    _stats (NULL),
+    _framing (_wss_stream)
 {
 }
 
@@ -112,8 +114,14 @@ bool wss_transport_t::open (boost::asio::io_context &io_context, fd_t fd)
     _wss_stream->write_buffer_bytes (wss_write_buffer_bytes ());
     _wss_stream->read_message_max (wss_read_message_max ());
 
+    //  Offer permessage-deflate; counters only cover deflate connections
+    ws_apply_deflate (*_wss_stream, _deflate);
+    _stats = _deflate.enabled ? ws_deflate_stats () : NULL;
+    _wss_stream->next_layer ().set_stats (_stats);
+
     _ssl_handshake_complete = false;
     _ws_handshake_complete = false;
+    _framing.reset ();
 
     ASIO_DBG_WSS ("opened with path=%s, host=%s", _path.c_str (), _host.c_str ());
     return true;
@@ -121,7 +129,7 @@ bool wss_transport_t::open (boost::asio::io_context &io_context, fd_t fd)
 
 bool wss_transport_t::is_open () const
 {
-    return _wss_stream && _wss_stream->next_layer ().next_layer ().is_open ();
+    return _wss_stream && boost::beast::get_lowest_layer (*_wss_stream).is_open ();
 }
 
 void wss_transport_t::close ()
@@ -130,9 +138,9 @@ void wss_transport_t::close ()
         boost::system::error_code ec;
 
         //  Avoid blocking WebSocket/SSL shutdown; just close the TCP layer.
-        _wss_stream->next_layer ().next_layer ().shutdown (
+        boost::beast::get_lowest_layer (*_wss_stream).shutdown (
           boost::asio::ip::tcp::socket::shutdown_both, ec);
-        _wss_stream->next_layer ().next_layer ().close (ec);
+        boost::beast::get_lowest_layer (*_wss_stream).close (ec);
 
         _wss_stream.reset ();
     }
@@ -162,13 +170,21 @@ void wss_transport_t::async_read_some (unsigned char *buffer,
         return;
     }
 
+    if (_framing.active ()) {
+        _framing.async_read (buffer, buffer_size, handler);
+        return;
+    }
+
+    ws_deflate_stats_t *const stats = _stats;
     _wss_stream->async_read_some (
       boost::asio::buffer (buffer, buffer_size),
-      [handler] (const boost::system::error_code &ec,
-                 std::size_t bytes_transferred) {
+      [handler, stats] (const boost::system::error_code &ec,
+                        std::size_t bytes_transferred) {
           if (ec) {
               ASIO_DBG_WSS ("read failed: %s", ec.message ().c_str ());
           }
+          if (stats)
+              stats->rx_payload_bytes += bytes_transferred;
           if (handler) {
               handler (ec, bytes_transferred);
           }
@@ -188,8 +204,19 @@ std::size_t wss_transport_t::read_some (std::uint8_t *buffer, std::size_t len)
     }
 
     boost::system::error_code ec;
-    const std::size_t bytes_read =
-      _wss_stream->read_some (boost::asio::buffer (buffer, len), ec);
+    std::size_t bytes_read = 0;
+    if (_framing.active ())
+        bytes_read = _framing.read (buffer, len, ec);
+    else if (boost::beast::get_lowest_layer (*_wss_stream).available (ec) == 0
+             && !ec) {
+        //  See ws_transport_t::read_some.
+        ec = boost::asio::error::would_block;
+    } else if (!ec) {
+        bytes_read =
+          _wss_stream->read_some (boost::asio::buffer (buffer, len), ec);
+        if (_stats)
+            _stats->rx_payload_bytes += bytes_read;
+    }
 
     if (ec) {
         if (ec == boost::asio::error::would_block
@@ -234,12 +261,20 @@ void wss_transport_t::async_write_some (const unsigned char *buffer,
     }
 
     //  WebSocket writes are frame-based
+    if (_framing.active ()) {
+        _framing.async_write (NULL, 0, buffer, buffer_size, handler);
+        return;
+    }
+
+    ws_deflate_stats_t *const stats = _stats;
     _wss_stream->async_write (
       boost::asio::buffer (buffer, buffer_size),
-      [handler] (const boost::system::error_code &ec,
-                 std::size_t bytes_transferred) {
+      [handler, stats] (const boost::system::error_code &ec,
+                        std::size_t bytes_transferred) {
           ASIO_DBG ("WSS", "write complete: ec=%s, bytes=%zu",
                     ec.message ().c_str (), bytes_transferred);
+          if (stats)
+              stats->tx_payload_bytes += bytes_transferred;
           if (handler) {
               handler (ec, bytes_transferred);
           }
@@ -259,16 +294,24 @@ void wss_transport_t::async_writev (const unsigned char *header,
         return;
     }
 
+    if (_framing.active ()) {
+        _framing.async_write (header, header_size, body, body_size, handler);
+        return;
+    }
+
     std::array<boost::asio::const_buffer, 2> buffers = {
       boost::asio::buffer (header, header_size),
       boost::asio::buffer (body, body_size)};
 
+    ws_deflate_stats_t *const stats = _stats;
     _wss_stream->async_write (
       buffers,
-      [handler] (const boost::system::error_code &ec,
-                 std::size_t bytes_transferred) {
+      [handler, stats] (const boost::system::error_code &ec,
+                        std::size_t bytes_transferred) {
           ASIO_DBG ("WSS", "writev complete: ec=%s, bytes=%zu",
                     ec.message ().c_str (), bytes_transferred);
+          if (stats)
+              stats->tx_payload_bytes += bytes_transferred;
           if (handler) {
               handler (ec, bytes_transferred);
           }
@@ -288,7 +331,7 @@ std::size_t wss_transport_t::write_some (const std::uint8_t *data,
         return 0;
     }
 
-    if (!_wss_stream->next_layer ().next_layer ().is_open ()) {
+    if (!boost::beast::get_lowest_layer (*_wss_stream).is_open ()) {
         errno = EBADF;
         return 0;
     }
@@ -312,8 +355,14 @@ std::size_t wss_transport_t::write_some (const std::uint8_t *data,
 
     //  Use write() to send complete frame (not write_some which is not
     //  available for WebSocket in Beast)
-    bytes_written =
-      _wss_stream->write (boost::asio::buffer (data, len), ec);
+    if (_framing.active ())
+        bytes_written = _framing.write (data, len, ec);
+    else {
+        bytes_written =
+          _wss_stream->write (boost::asio::buffer (data, len), ec);
+        if (_stats)
+            _stats->tx_payload_bytes += bytes_written;
+    }
 
     if (ec) {
         //  Handle would_block case
@@ -375,8 +424,9 @@ void wss_transport_t::async_handshake (int handshake_type,
                          : boost::asio::ssl::stream_base::server;
 
     if (handshake_type == client && !_tls_hostname.empty ()) {
-        if (!SSL_set_tlsext_host_name (_wss_stream->next_layer ().native_handle (),
-                                       _tls_hostname.c_str ())) {
+        if (!SSL_set_tlsext_host_name (
+              _wss_stream->next_layer ().next_layer ().native_handle (),
+              _tls_hostname.c_str ())) {
             if (handler) {
                 handler (boost::asio::error::invalid_argument, 0);
             }
@@ -384,7 +434,7 @@ void wss_transport_t::async_handshake (int handshake_type,
         }
     }
 
-    _wss_stream->next_layer ().async_handshake (
+    _wss_stream->next_layer ().next_layer ().async_handshake (
       ssl_hs_type, [this, handler] (const boost::system::error_code &ec) {
           if (ec) {
               ASIO_DBG_WSS ("SSL handshake failed: %s", ec.message ().c_str ());
@@ -420,6 +470,18 @@ void wss_transport_t::continue_ws_handshake (completion_handler_t handler)
                   handler (ec, 0);
               }
           });
+    } else if (!_deflate.enabled && !ws_beast_framing ()) {
+        _framing.async_accept (
+          [this, handler] (const boost::system::error_code &ec, std::size_t) {
+              if (!ec) {
+                  _ws_handshake_complete = true;
+                  ASIO_DBG_WSS (
+                    "WebSocket server handshake complete (fast framing)");
+              }
+              if (handler) {
+                  handler (ec, 0);
+              }
+          });
     } else {
         //  Server-side WebSocket handshake
         _wss_stream->async_accept (
@@ -10,14 +10,19 @@
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
 #include <boost/beast/ssl.hpp>
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/websocket/ssl.hpp>
 #include <array>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "engine/asio/i_asio_transport.hpp"
+#include "transports/ws/ws_deflate.hpp"
+#include "transports/ws/ws_server_framing.hpp"
 
 namespace zlink
 {
@@ -32,6 +37,8 @@ namespace zlink
 //  - Then performs WebSocket HTTP upgrade handshake
 //  - Uses binary frames for ZLINK messages
 //  - Encrypted transport (is_encrypted() returns true)
+//  - On the server side without deflate, frames are parsed and written
+//    directly on the SSL stream after the upgrade, as in ws_transport_t
 //
 //  Usage:
 //    1. Create wss_transport_t with SSL context and optional path/host
@@ -102,12 +109,16 @@ class wss_transport_t : public i_asio_transport
     //  Set the path for WebSocket endpoint
     void set_path (const std::string &path) { _path = path; }
 
+    //  Set permessage-deflate parameters (applied on open)
+    void set_deflate (const ws_deflate_config_t &config_) { _deflate = config_; }
+
   private:
     //  SSL stream type
     typedef boost::asio::ssl::stream<boost::asio::ip::tcp::socket> ssl_stream_t;
 
-    //  WebSocket stream over SSL
-    typedef boost::beast::websocket::stream<ssl_stream_t> wss_stream_t;
+    //  WebSocket stream over SSL, counting wire bytes above TLS
+    typedef boost::beast::websocket::stream<ws_counting_stream_t<ssl_stream_t> >
+      wss_stream_t;
 
     boost::asio::ssl::context &_ssl_ctx;
     std::string _path;
@@ -117,10 +128,17 @@ class wss_transport_t : public i_asio_transport
     bool _ws_handshake_complete;
     int _handshake_type;
     std::string _tls_hostname;
+    ws_deflate_config_t _deflate;
+
+    //  Compression counters; NULL unless deflate and stats are enabled
+    ws_deflate_stats_t *_stats;
 
     //  Internal handshake continuation
     void continue_ws_handshake (completion_handler_t handler);
 
+    //  Framing fast path, used on the server side without deflate.
+    ws_server_framing_t<wss_stream_t> _framing;
+
     ZLINK_NON_COPYABLE_NOR_MOVABLE (wss_transport_t)
 };
 
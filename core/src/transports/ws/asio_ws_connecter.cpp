@@ -520,6 +520,7 @@ void zlink::asio_ws_connecter_t::create_engine (
           new (std::nothrow)
             wss_transport_t (*ssl_context, _path, _host));
         alloc_assert (wss_transport);
+        wss_transport->set_deflate (ws_deflate_config_t (options));
         if (!_tls_hostname.empty ())
             wss_transport->set_tls_hostname (_tls_hostname);
         transport.reset (wss_transport.release ());
@@ -529,6 +530,7 @@ void zlink::asio_ws_connecter_t::create_engine (
         std::unique_ptr<ws_transport_t> ws_transport (
           new (std::nothrow) ws_transport_t (_path, _host));
         alloc_assert (ws_transport);
+        ws_transport->set_deflate (ws_deflate_config_t (options));
         transport.reset (ws_transport.release ());
     }
 
@@ -141,7 +141,7 @@ zlink::asio_ws_engine_t::asio_ws_engine_t (
     _peer_routing_id_size (0),
     _subscription_required (false),
     _heartbeat_timeout (0),
-    _current_timer_id (-1),
+    _poller (NULL),
     _has_handshake_timer (false),
     _has_ttl_timer (false),
     _has_timeout_timer (false),
@@ -229,7 +229,7 @@ zlink::asio_ws_engine_t::asio_ws_engine_t (
     _peer_routing_id_size (0),
     _subscription_required (false),
     _heartbeat_timeout (0),
-    _current_timer_id (-1),
+    _poller (NULL),
     _has_handshake_timer (false),
     _has_ttl_timer (false),
     _has_timeout_timer (false),
@@ -325,12 +325,8 @@ void zlink::asio_ws_engine_t::plug (io_thread_t *io_thread_,
     _socket = _session->get_socket ();
 
     //  Get reference to io_context
-    asio_poller_t *poller =
-      static_cast<asio_poller_t *> (io_thread_->get_poller ());
-    _io_context = &poller->get_io_context ();
-
-    //  Create timer
-    _timer.reset (new boost::asio::steady_timer (*_io_context));
+    _poller = static_cast<asio_poller_t *> (io_thread_->get_poller ());
+    _io_context = &_poller->get_io_context ();
 
     //  Initialize WebSocket transport with the socket
     if (!_transport->open (*_io_context, _fd)) {
@@ -1559,43 +1555,47 @@ void zlink::asio_ws_engine_t::cancel_handshake_timer ()
 
 void zlink::asio_ws_engine_t::add_timer (int timeout_, int id_)
 {
-    if (!_timer)
+    if (!_poller)
         return;
 
-    _current_timer_id = id_;
-
-    _timer->expires_after (std::chrono::milliseconds (timeout_));
-    _timer->async_wait ([this, id_] (const boost::system::error_code &ec) {
-        on_timer (id_, ec);
-    });
+    _poller->add_timer (timeout_, this, id_);
 }
 
 void zlink::asio_ws_engine_t::cancel_timer (int id_)
 {
-    if (!_timer)
+    if (!_poller)
         return;
 
-    if (_current_timer_id == id_) {
-        _timer->cancel ();
-        _current_timer_id = -1;
-    }
+    _poller->cancel_timer (this, id_);
+}
+
+void zlink::asio_ws_engine_t::in_event ()
+{
+    //  The engine does not register file descriptors with the poller.
+    zlink_assert (false);
 }
 
-void zlink::asio_ws_engine_t::on_timer (int id_,
-                                       const boost::system::error_code &ec)
+void zlink::asio_ws_engine_t::out_event ()
 {
-    if (_terminating || ec == boost::asio::error::operation_aborted)
+    zlink_assert (false);
+}
+
+void zlink::asio_ws_engine_t::timer_event (int id_)
+{
+    if (_terminating)
         return;
 
-    WS_ENGINE_DBG ("on_timer: id=%d", id_);
+    WS_ENGINE_DBG ("timer_event: id=%d", id_);
 
     if (id_ == handshake_timer_id) {
         _has_handshake_timer = false;
         error (timeout_error);
     } else if (id_ == heartbeat_ivl_timer_id) {
+        //  Re-armed first: producing the ping may terminate the engine,
+        //  which then cancels the timer with the others.
+        add_timer (_options.heartbeat_interval, heartbeat_ivl_timer_id);
         _next_msg = &asio_ws_engine_t::produce_ping_message;
         restart_output ();
-        add_timer (_options.heartbeat_interval, heartbeat_ivl_timer_id);
     } else if (id_ == heartbeat_ttl_timer_id) {
         _has_ttl_timer = false;
         error (timeout_error);
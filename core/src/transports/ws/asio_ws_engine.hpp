@@ -13,6 +13,7 @@
 
 #include "utils/fd.hpp"
 #include "engine/i_engine.hpp"
+#include "core/i_poll_events.hpp"
 #include "core/options.hpp"
 #include "core/endpoint.hpp"
 #include "protocol/i_encoder.hpp"
@@ -40,6 +41,7 @@ namespace zlink
 
 class io_thread_t;
 class session_base_t;
+class asio_poller_t;
 
 //  WebSocket ZMP Engine
 //
@@ -47,7 +49,7 @@ class session_base_t;
 //  It uses ws_transport_t for WebSocket framing and Beast I/O,
 //  while implementing the ZMP handshake and message protocol.
 
-class asio_ws_engine_t ZLINK_FINAL : public i_engine
+class asio_ws_engine_t ZLINK_FINAL : public i_engine, public i_poll_events
 {
   public:
     //  Create WebSocket engine for an already-connected socket
@@ -82,6 +84,11 @@ class asio_ws_engine_t ZLINK_FINAL : public i_engine
     void restart_output () ZLINK_OVERRIDE;
     const endpoint_uri_pair_t &get_endpoint () const ZLINK_OVERRIDE;
 
+    //  i_poll_events interface implementation. Only timers are used.
+    void in_event () ZLINK_OVERRIDE;
+    void out_event () ZLINK_OVERRIDE;
+    void timer_event (int id_) ZLINK_OVERRIDE;
+
   protected:
     typedef metadata_t::dict_t properties_t;
     bool init_properties (properties_t &properties_);
@@ -158,7 +165,6 @@ class asio_ws_engine_t ZLINK_FINAL : public i_engine
     void cancel_timer (int id_);
     void set_handshake_timer ();
     void cancel_handshake_timer ();
-    void on_timer (int id_, const boost::system::error_code &ec);
 
     //  WebSocket transport layer
     std::unique_ptr<i_asio_transport> _transport;
@@ -261,9 +267,8 @@ class asio_ws_engine_t ZLINK_FINAL : public i_engine
     std::unique_ptr<boost::asio::ssl::context> _ssl_context;
 #endif
 
-    //  Timer
-    std::unique_ptr<boost::asio::steady_timer> _timer;
-    int _current_timer_id;
+    //  Poller of the I/O thread, holding the engine's timers
+    asio_poller_t *_poller;
 
     //  Timer IDs
     enum
@@ -505,6 +505,7 @@ void zlink::asio_ws_listener_t::create_engine (fd_t fd_)
           new (std::nothrow)
             wss_transport_t (*ssl_context, _path, _host));
         alloc_assert (wss_transport);
+        wss_transport->set_deflate (ws_deflate_config_t (options));
         transport.reset (wss_transport.release ());
     } else
 #endif
@@ -512,6 +513,7 @@ void zlink::asio_ws_listener_t::create_engine (fd_t fd_)
         std::unique_ptr<ws_transport_t> ws_transport (
           new (std::nothrow) ws_transport_t (_path, _host));
         alloc_assert (ws_transport);
+        ws_transport->set_deflate (ws_deflate_config_t (options));
         transport.reset (ws_transport.release ());
     }
 
@@ -541,7 +543,8 @@ void zlink::asio_ws_listener_t::create_engine (fd_t fd_)
     alloc_assert (engine);
 
     //  Choose I/O thread for engine
-    io_thread_t *io_thread = choose_io_thread (options.affinity);
+    io_thread_t *io_thread =
+      choose_io_thread (options.affinity, options.numa_node);
     zlink_assert (io_thread);
 
     //  Create and launch session
@@ -0,0 +1,244 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_WS_DEFLATE_HPP_INCLUDED__
+#define __ZLINK_WS_DEFLATE_HPP_INCLUDED__
+
+#include "core/poller.hpp"
+#if defined ZLINK_IOTHREAD_POLLER_USE_ASIO && defined ZLINK_HAVE_ASIO_WS
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace zlink
+{
+struct options_t;
+
+//  permessage-deflate (RFC 7692) settings for ws/wss transports.
+//  Filled from the ZLINK_WS_DEFLATE* socket options.
+struct ws_deflate_config_t
+{
+    ws_deflate_config_t ();
+    explicit ws_deflate_config_t (const options_t &options_);
+
+    bool enabled;
+    int server_max_window_bits;
+    int client_max_window_bits;
+    //  Messages smaller than this many bytes are sent uncompressed
+    int threshold;
+};
+
+//  Offers/accepts permessage-deflate on a Beast websocket stream.
+//  Must be called before the handshake.
+template <typename Stream>
+void ws_apply_deflate (Stream &stream_, const ws_deflate_config_t &config_)
+{
+    if (!config_.enabled)
+        return;
+
+    boost::beast::websocket::permessage_deflate pmd;
+    pmd.server_enable = true;
+    pmd.client_enable = true;
+    pmd.server_max_window_bits = config_.server_max_window_bits;
+    pmd.client_max_window_bits = config_.client_max_window_bits;
+    pmd.msg_size_threshold = static_cast<std::size_t> (config_.threshold);
+    stream_.set_option (pmd);
+}
+
+//  Process-wide compression counters, enabled by ZLINK_WS_DEFLATE_STATS and
+//  dumped to stderr at exit. Payload bytes are counted above the deflate
+//  layer, wire bytes below it (frame headers included).
+struct ws_deflate_stats_t
+{
+    std::atomic<uint64_t> tx_payload_bytes;
+    std::atomic<uint64_t> tx_wire_bytes;
+    std::atomic<uint64_t> rx_payload_bytes;
+    std::atomic<uint64_t> rx_wire_bytes;
+};
+
+//  Returns the counters, or NULL when stats are disabled.
+ws_deflate_stats_t *ws_deflate_stats ();
+
+//  Pass-through stream placed between the websocket stream and its
+//  transport so that wire bytes can be counted. Without counters attached
+//  every call is forwarded unchanged.
+template <typename NextLayer> class ws_counting_stream_t
+{
+  public:
+    typedef NextLayer next_layer_type;
+    typedef typename NextLayer::executor_type executor_type;
+
+    template <typename... Args>
+    explicit ws_counting_stream_t (Args &&...args_) :
+        _next (std::forward<Args> (args_)...), _stats (NULL)
+    {
+    }
+
+    executor_type get_executor () noexcept { return _next.get_executor (); }
+
+    NextLayer &next_layer () { return _next; }
+    const NextLayer &next_layer () const { return _next; }
+
+    void set_stats (ws_deflate_stats_t *stats_) { _stats = stats_; }
+
+    template <typename MutableBufferSequence>
+    std::size_t read_some (const MutableBufferSequence &buffers_)
+    {
+        const std::size_t n = _next.read_some (buffers_);
+        if (_stats)
+            _stats->rx_wire_bytes += n;
+        return n;
+    }
+
+    template <typename MutableBufferSequence>
+    std::size_t read_some (const MutableBufferSequence &buffers_,
+                           boost::system::error_code &ec_)
+    {
+        const std::size_t n = _next.read_some (buffers_, ec_);
+        if (_stats)
+            _stats->rx_wire_bytes += n;
+        return n;
+    }
+
+    template <typename ConstBufferSequence>
+    std::size_t write_some (const ConstBufferSequence &buffers_)
+    {
+        const std::size_t n = _next.write_some (buffers_);
+        if (_stats)
+            _stats->tx_wire_bytes += n;
+        return n;
+    }
+
+    template <typename ConstBufferSequence>
+    std::size_t write_some (const ConstBufferSequence &buffers_,
+                            boost::system::error_code &ec_)
+    {
+        const std::size_t n = _next.write_some (buffers_, ec_);
+        if (_stats)
+            _stats->tx_wire_bytes += n;
+        return n;
+    }
+
+    template <typename MutableBufferSequence, typename ReadHandler>
+    auto async_read_some (const MutableBufferSequence &buffers_,
+                          ReadHandler &&handler_)
+    {
+        if (!_stats)
+            return _next.async_read_some (
+              buffers_, std::forward<ReadHandler> (handler_));
+        return boost::asio::async_compose<ReadHandler,
+                                          void (boost::system::error_code,
+                                                std::size_t)> (
+          read_op<MutableBufferSequence> (_next, buffers_,
+                                          _stats->rx_wire_bytes),
+          handler_, _next);
+    }
+
+    template <typename ConstBufferSequence, typename WriteHandler>
+    auto async_write_some (const ConstBufferSequence &buffers_,
+                           WriteHandler &&handler_)
+    {
+        if (!_stats)
+            return _next.async_write_some (
+              buffers_, std::forward<WriteHandler> (handler_));
+        return boost::asio::async_compose<WriteHandler,
+                                          void (boost::system::error_code,
+                                                std::size_t)> (
+          write_op<ConstBufferSequence> (_next, buffers_,
+                                         _stats->tx_wire_bytes),
+          handler_, _next);
+    }
+
+  private:
+    template <typename Buffers> struct read_op
+    {
+        read_op (NextLayer &next_,
+                 const Buffers &buffers_,
+                 std::atomic<uint64_t> &counter_) :
+            next (next_), buffers (buffers_), counter (counter_), started (false)
+        {
+        }
+
+        template <typename Self>
+        void operator() (Self &self_,
+                         boost::system::error_code ec_ = {},
+                         std::size_t n_ = 0)
+        {
+            if (!started) {
+                started = true;
+                next.async_read_some (buffers, std::move (self_));
+                return;
+            }
+            counter += n_;
+            self_.complete (ec_, n_);
+        }
+
+        NextLayer &next;
+        Buffers buffers;
+        std::atomic<uint64_t> &counter;
+        bool started;
+    };
+
+    template <typename Buffers> struct write_op
+    {
+        write_op (NextLayer &next_,
+                  const Buffers &buffers_,
+                  std::atomic<uint64_t> &counter_) :
+            next (next_), buffers (buffers_), counter (counter_), started (false)
+        {
+        }
+
+        template <typename Self>
+        void operator() (Self &self_,
+                         boost::system::error_code ec_ = {},
+                         std::size_t n_ = 0)
+        {
+            if (!started) {
+                started = true;
+                next.async_write_some (buffers, std::move (self_));
+                return;
+            }
+            counter += n_;
+            self_.complete (ec_, n_);
+        }
+
+        NextLayer &next;
+        Buffers buffers;
+        std::atomic<uint64_t> &counter;
+        bool started;
+    };
+
+    NextLayer _next;
+    ws_deflate_stats_t *_stats;
+};
+
+//  Websocket close handshake customization points; the counting layer is
+//  transparent, so teardown is delegated to the wrapped stream.
+template <typename NextLayer>
+void teardown (boost::beast::role_type role_,
+               ws_counting_stream_t<NextLayer> &stream_,
+               boost::system::error_code &ec_)
+{
+    using boost::beast::websocket::teardown;
+    teardown (role_, stream_.next_layer (), ec_);
+}
+
+template <typename NextLayer, typename TeardownHandler>
+void async_teardown (boost::beast::role_type role_,
+                     ws_counting_stream_t<NextLayer> &stream_,
+                     TeardownHandler &&handler_)
+{
+    using boost::beast::websocket::async_teardown;
+    async_teardown (role_, stream_.next_layer (),
+                    std::forward<TeardownHandler> (handler_));
+}
+
+}  // namespace zlink
+
+#endif  // ZLINK_IOTHREAD_POLLER_USE_ASIO && ZLINK_HAVE_ASIO_WS
+
+#endif  // __ZLINK_WS_DEFLATE_HPP_INCLUDED__
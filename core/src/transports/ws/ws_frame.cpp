@@ -0,0 +1,349 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+#include "transports/ws/ws_frame.hpp"
+#include "protocol/wire.hpp"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+//  Vector masking kernels are built with per-function target attributes
+//  and chosen at run time, so the library itself needs no -mavx2.
+#if (defined __x86_64__ || defined __i386__) \
+  && (defined __GNUC__ || defined __clang__)
+#define ZLINK_WS_MASK_X86
+#define ZLINK_WS_MASK_TARGET(isa_) __attribute__ ((target (isa_)))
+#include <immintrin.h>
+#endif
+
+void zlink::ws_mask_scalar (unsigned char *data_,
+                            size_t size_,
+                            const unsigned char *key_,
+                            size_t offset_)
+{
+    //  Rotate the key to the current offset and widen it to a word so the
+    //  bulk of the payload is XORed eight bytes at a time.
+    unsigned char key[8];
+    for (size_t i = 0; i < sizeof key; ++i)
+        key[i] = key_[(offset_ + i) & 3];
+    uint64_t key64;
+    memcpy (&key64, key, sizeof key64);
+
+    size_t pos = 0;
+    for (; pos + sizeof key64 <= size_; pos += sizeof key64) {
+        uint64_t word;
+        memcpy (&word, data_ + pos, sizeof word);
+        word ^= key64;
+        memcpy (data_ + pos, &word, sizeof word);
+    }
+    for (; pos < size_; ++pos)
+        data_[pos] ^= key[pos & 7];
+}
+
+#if defined ZLINK_WS_MASK_X86
+
+namespace
+{
+//  The key is rotated to offset_ and replicated across the register. Every
+//  vector width is a multiple of 4, so the rotation still holds for the
+//  scalar tail after the vector loop.
+
+ZLINK_WS_MASK_TARGET ("sse2")
+void ws_mask_sse2 (unsigned char *data_,
+                   size_t size_,
+                   const unsigned char *key_,
+                   size_t offset_)
+{
+    uint32_t key32;
+    unsigned char key[4];
+    for (size_t i = 0; i < sizeof key; ++i)
+        key[i] = key_[(offset_ + i) & 3];
+    memcpy (&key32, key, sizeof key32);
+    const __m128i key128 = _mm_set1_epi32 (static_cast<int> (key32));
+
+    size_t pos = 0;
+    for (; pos + 16 <= size_; pos += 16) {
+        __m128i *p = reinterpret_cast<__m128i *> (data_ + pos);
+        _mm_storeu_si128 (p, _mm_xor_si128 (_mm_loadu_si128 (p), key128));
+    }
+    zlink::ws_mask_scalar (data_ + pos, size_ - pos, key, 0);
+}
+
+ZLINK_WS_MASK_TARGET ("avx2")
+void ws_mask_avx2 (unsigned char *data_,
+                   size_t size_,
+                   const unsigned char *key_,
+                   size_t offset_)
+{
+    uint32_t key32;
+    unsigned char key[4];
+    for (size_t i = 0; i < sizeof key; ++i)
+        key[i] = key_[(offset_ + i) & 3];
+    memcpy (&key32, key, sizeof key32);
+    const __m256i key256 = _mm256_set1_epi32 (static_cast<int> (key32));
+
+    size_t pos = 0;
+    for (; pos + 64 <= size_; pos += 64) {
+        __m256i *p = reinterpret_cast<__m256i *> (data_ + pos);
+        const __m256i a = _mm256_loadu_si256 (p);
+        const __m256i b = _mm256_loadu_si256 (p + 1);
+        _mm256_storeu_si256 (p, _mm256_xor_si256 (a, key256));
+        _mm256_storeu_si256 (p + 1, _mm256_xor_si256 (b, key256));
+    }
+    for (; pos + 32 <= size_; pos += 32) {
+        __m256i *p = reinterpret_cast<__m256i *> (data_ + pos);
+        _mm256_storeu_si256 (p,
+                             _mm256_xor_si256 (_mm256_loadu_si256 (p), key256));
+    }
+    zlink::ws_mask_scalar (data_ + pos, size_ - pos, key, 0);
+}
+
+zlink::ws_mask_fn select_ws_mask ()
+{
+    zlink::ws_mask_fn fn = zlink::ws_mask_kernel (zlink::ws_mask_kernel_avx2);
+    if (!fn)
+        fn = zlink::ws_mask_kernel (zlink::ws_mask_kernel_sse2);
+    return fn ? fn : zlink::ws_mask_scalar;
+}
+}
+
+zlink::ws_mask_fn zlink::ws_mask_kernel (ws_mask_kernel_t kernel_)
+{
+    __builtin_cpu_init ();
+    switch (kernel_) {
+        case ws_mask_kernel_scalar:
+            return ws_mask_scalar;
+        case ws_mask_kernel_sse2:
+            return __builtin_cpu_supports ("sse2") ? ws_mask_sse2 : NULL;
+        case ws_mask_kernel_avx2:
+            return __builtin_cpu_supports ("avx2") ? ws_mask_avx2 : NULL;
+    }
+    return NULL;
+}
+
+void zlink::ws_mask (unsigned char *data_,
+                     size_t size_,
+                     const unsigned char *key_,
+                     size_t offset_)
+{
+    //  Short payloads are not worth the dispatch and vector setup.
+    if (size_ < 128) {
+        ws_mask_scalar (data_, size_, key_, offset_);
+        return;
+    }
+    static const ws_mask_fn fn = select_ws_mask ();
+    fn (data_, size_, key_, offset_);
+}
+
+#else
+
+zlink::ws_mask_fn zlink::ws_mask_kernel (ws_mask_kernel_t kernel_)
+{
+    return kernel_ == ws_mask_kernel_scalar ? ws_mask_scalar : NULL;
+}
+
+void zlink::ws_mask (unsigned char *data_,
+                     size_t size_,
+                     const unsigned char *key_,
+                     size_t offset_)
+{
+    ws_mask_scalar (data_, size_, key_, offset_);
+}
+
+#endif
+
+bool zlink::ws_beast_framing ()
+{
+    static const char *const env = getenv ("ZLINK_WS_BEAST_FRAMING");
+    static const bool value = env && *env && *env != '0';
+    return value;
+}
+
+size_t zlink::ws_encode_frame_header (unsigned char *buffer_,
+                                      unsigned char opcode_,
+                                      uint64_t payload_size_,
+                                      const unsigned char *key_)
+{
+    const unsigned char mask_bit = key_ ? 0x80 : 0x00;
+    size_t size = 2;
+
+    buffer_[0] = 0x80 | opcode_;
+    if (payload_size_ < 126) {
+        buffer_[1] = mask_bit | static_cast<unsigned char> (payload_size_);
+    } else if (payload_size_ <= 0xffff) {
+        buffer_[1] = mask_bit | 126;
+        put_uint16 (buffer_ + 2, static_cast<uint16_t> (payload_size_));
+        size += 2;
+    } else {
+        buffer_[1] = mask_bit | 127;
+        put_uint64 (buffer_ + 2, payload_size_);
+        size += 8;
+    }
+    if (key_) {
+        memcpy (buffer_ + size, key_, 4);
+        size += 4;
+    }
+    return size;
+}
+
+zlink::ws_frame_decoder_t::ws_frame_decoder_t (bool require_mask_) :
+    _require_mask (require_mask_),
+    _header_size (0),
+    _header_needed (2),
+    _opcode (0),
+    _masked (false),
+    _key_offset (0),
+    _remaining (0),
+    _in_payload (false),
+    _close_received (false)
+{
+    memset (_header, 0, sizeof _header);
+    memset (_key, 0, sizeof _key);
+}
+
+int zlink::ws_frame_decoder_t::decode (unsigned char *data_,
+                                       size_t size_,
+                                       size_t *payload_size_)
+{
+    size_t in = 0;
+    size_t out = 0;
+
+    while (in < size_ && !_close_received) {
+        if (!_in_payload) {
+            //  Collect the header; its full size is known once the
+            //  second byte has been seen.
+            while (in < size_ && _header_size < _header_needed) {
+                _header[_header_size++] = data_[in++];
+                if (_header_size == 2) {
+                    const unsigned char len = _header[1] & 0x7f;
+                    _header_needed = 2 + (len == 126 ? 2 : 0)
+                                     + (len == 127 ? 8 : 0)
+                                     + ((_header[1] & 0x80) ? 4 : 0);
+                }
+            }
+            if (_header_size < _header_needed)
+                break;
+            if (parse_header () != 0) {
+                errno = EPROTO;
+                return -1;
+            }
+            _header_size = 0;
+            _header_needed = 2;
+            _in_payload = true;
+        }
+
+        const size_t available = size_ - in;
+        const size_t chunk = _remaining < available
+                               ? static_cast<size_t> (_remaining)
+                               : available;
+
+        if (_opcode < ws_opcode_close) {
+            //  Data frame payload goes straight back into the caller's
+            //  buffer, overwriting the headers in front of it.
+            if (out != in)
+                memmove (data_ + out, data_ + in, chunk);
+            if (_masked)
+                ws_mask (data_ + out, chunk, _key, _key_offset);
+            out += chunk;
+        } else {
+            const size_t start = _control.size ();
+            _control.insert (_control.end (), data_ + in, data_ + in + chunk);
+            if (_masked && chunk > 0)
+                ws_mask (&_control[start], chunk, _key, _key_offset);
+        }
+        in += chunk;
+        _key_offset = (_key_offset + chunk) & 3;
+        _remaining -= chunk;
+
+        if (_remaining == 0) {
+            if (_opcode >= ws_opcode_close)
+                process_control ();
+            _in_payload = false;
+        }
+    }
+
+    *payload_size_ = out;
+    return 0;
+}
+
+int zlink::ws_frame_decoder_t::parse_header ()
+{
+    const bool fin = (_header[0] & 0x80) != 0;
+    _opcode = _header[0] & 0x0f;
+    _masked = (_header[1] & 0x80) != 0;
+
+    //  No extensions are negotiated on this path, so RSV bits must be clear.
+    if (_header[0] & 0x70)
+        return -1;
+    if (_require_mask && !_masked)
+        return -1;
+
+    switch (_opcode) {
+        case ws_opcode_continuation:
+        case ws_opcode_text:
+        case ws_opcode_binary:
+            break;
+        case ws_opcode_close:
+        case ws_opcode_ping:
+        case ws_opcode_pong:
+            if (!fin || (_header[1] & 0x7f) > 125)
+                return -1;
+            break;
+        default:
+            return -1;
+    }
+
+    size_t pos = 2;
+    const unsigned char len = _header[1] & 0x7f;
+    if (len == 126) {
+        _remaining = get_uint16 (_header + pos);
+        pos += 2;
+    } else if (len == 127) {
+        _remaining = get_uint64 (_header + pos);
+        if (_remaining >> 63)
+            return -1;
+        pos += 8;
+    } else
+        _remaining = len;
+
+    if (_masked)
+        memcpy (_key, _header + pos, sizeof _key);
+    _key_offset = 0;
+    _control.clear ();
+    return 0;
+}
+
+void zlink::ws_frame_decoder_t::process_control ()
+{
+    unsigned char header[ws_max_frame_header_size];
+    size_t header_size;
+
+    switch (_opcode) {
+        case ws_opcode_ping:
+            header_size = ws_encode_frame_header (header, ws_opcode_pong,
+                                                  _control.size (), NULL);
+            _reply.insert (_reply.end (), header, header + header_size);
+            _reply.insert (_reply.end (), _control.begin (), _control.end ());
+            break;
+        case ws_opcode_close:
+            //  Echo the status code, if any, and stop decoding.
+            if (_control.size () > 2)
+                _control.resize (2);
+            header_size = ws_encode_frame_header (header, ws_opcode_close,
+                                                  _control.size (), NULL);
+            _reply.insert (_reply.end (), header, header + header_size);
+            _reply.insert (_reply.end (), _control.begin (), _control.end ());
+            _close_received = true;
+            break;
+        default:
+            break;
+    }
+    _control.clear ();
+}
+
+void zlink::ws_frame_decoder_t::take_reply (std::vector<unsigned char> &reply_)
+{
+    reply_.swap (_reply);
+    _reply.clear ();
+}
@@ -0,0 +1,138 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_WS_FRAME_HPP_INCLUDED__
+#define __ZLINK_WS_FRAME_HPP_INCLUDED__
+
+#include "utils/macros.hpp"
+#include "utils/stdint.hpp"
+
+#include <stddef.h>
+#include <vector>
+
+namespace zlink
+{
+//  RFC 6455 opcodes used by the framing fast path.
+enum
+{
+    ws_opcode_continuation = 0x0,
+    ws_opcode_text = 0x1,
+    ws_opcode_binary = 0x2,
+    ws_opcode_close = 0x8,
+    ws_opcode_ping = 0x9,
+    ws_opcode_pong = 0xa
+};
+
+//  Largest frame header: 2 bytes, 8 bytes of extended length, 4 bytes
+//  of masking key.
+static const size_t ws_max_frame_header_size = 14;
+
+//  XORs size_ bytes at data_ with the 4-byte masking key key_, starting at
+//  byte offset_ of the key. Masking and unmasking are the same operation.
+//  Uses AVX2 or SSE2 when the CPU has them, picked once at first call.
+void ws_mask (unsigned char *data_,
+              size_t size_,
+              const unsigned char *key_,
+              size_t offset_);
+
+//  Portable version of ws_mask, eight bytes at a time. Exposed so tests
+//  and benchmarks can compare it against the vector kernels.
+void ws_mask_scalar (unsigned char *data_,
+                     size_t size_,
+                     const unsigned char *key_,
+                     size_t offset_);
+
+//  Kernels ws_mask chooses from.
+enum ws_mask_kernel_t
+{
+    ws_mask_kernel_scalar,
+    ws_mask_kernel_sse2,
+    ws_mask_kernel_avx2
+};
+
+typedef void (*ws_mask_fn) (unsigned char *data_,
+                            size_t size_,
+                            const unsigned char *key_,
+                            size_t offset_);
+
+//  Returns the given kernel, or NULL if it is not built in or the CPU
+//  lacks the instructions it needs. Lets tests run every kernel the host
+//  supports, not just the one ws_mask picks.
+ws_mask_fn ws_mask_kernel (ws_mask_kernel_t kernel_);
+
+//  Writes the header of a single final frame carrying payload_size_ bytes
+//  into buffer_ (at least ws_max_frame_header_size bytes) and returns its
+//  size. A masking key is included if key_ is not NULL.
+size_t ws_encode_frame_header (unsigned char *buffer_,
+                               unsigned char opcode_,
+                               uint64_t payload_size_,
+                               const unsigned char *key_);
+
+//  True if ZLINK_WS_BEAST_FRAMING is set, which keeps Beast framing on
+//  connections that would otherwise use the fast path (for comparison).
+bool ws_beast_framing ();
+
+//  Incremental frame decoder used by ws_transport_t once the HTTP upgrade
+//  is done. Raw bytes are decoded in place: frame headers are dropped and
+//  data frame payloads are unmasked and packed at the start of the buffer,
+//  so the engine sees the same byte stream Beast's read_some would give.
+//  Headers split across reads are carried over between calls.
+//
+//  Control frames are consumed here. Pings are answered with pongs and a
+//  close frame is echoed back; the replies are queued until the transport
+//  picks them up with take_reply ().
+
+class ws_frame_decoder_t
+{
+  public:
+    //  require_mask_ is set on the server side, where RFC 6455 requires
+    //  every client frame to be masked.
+    explicit ws_frame_decoder_t (bool require_mask_);
+
+    //  Decodes size_ raw bytes at data_. On success returns 0 and stores
+    //  the number of payload bytes now at the start of data_. Returns -1
+    //  with errno set to EPROTO on a framing violation.
+    int decode (unsigned char *data_, size_t size_, size_t *payload_size_);
+
+    //  True once a close frame has been received; later input is ignored.
+    bool close_received () const { return _close_received; }
+
+    //  True if control replies are waiting to be sent.
+    bool has_reply () const { return !_reply.empty (); }
+
+    //  Moves the queued control replies (complete frames) into reply_.
+    void take_reply (std::vector<unsigned char> &reply_);
+
+  private:
+    //  Parses a complete header in _header; returns -1 on violation.
+    int parse_header ();
+
+    //  Handles a complete control frame in _control.
+    void process_control ();
+
+    const bool _require_mask;
+
+    //  Header bytes collected so far and the size the header will have
+    //  (2 until the length byte has been seen).
+    unsigned char _header[ws_max_frame_header_size];
+    size_t _header_size;
+    size_t _header_needed;
+
+    //  Current frame.
+    unsigned char _opcode;
+    bool _masked;
+    unsigned char _key[4];
+    size_t _key_offset;
+    uint64_t _remaining;
+    bool _in_payload;
+
+    //  Payload of the current control frame (at most 125 bytes).
+    std::vector<unsigned char> _control;
+
+    std::vector<unsigned char> _reply;
+    bool _close_received;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (ws_frame_decoder_t)
+};
+}
+
+#endif
@@ -0,0 +1,424 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_WS_SERVER_FRAMING_HPP_INCLUDED__
+#define __ZLINK_WS_SERVER_FRAMING_HPP_INCLUDED__
+
+#include "core/poller.hpp"
+#if defined ZLINK_IOTHREAD_POLLER_USE_ASIO && defined ZLINK_HAVE_ASIO_WS
+
+#include <boost/asio.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "engine/asio/asio_debug.hpp"
+#include "engine/asio/i_asio_transport.hpp"
+#include "transports/ws/ws_frame.hpp"
+
+namespace zlink
+{
+//  Whether a data frame is written as separate buffers (frame header,
+//  engine header, body) or assembled in one piece first. Plain sockets
+//  gather; each buffer handed to an SSL stream becomes a TLS record of
+//  its own, so there the frame is copied together.
+template <typename Stream> struct ws_gather_writes
+{
+    static const bool value = false;
+};
+
+template <> struct ws_gather_writes<boost::asio::ip::tcp::socket>
+{
+    static const bool value = true;
+};
+
+//  Reads what the stream already holds without blocking. Records already
+//  decrypted inside an SSL stream cannot be probed, so streams other than
+//  a plain socket report would_block and leave reading to the async path.
+template <typename Stream>
+std::size_t ws_read_available (Stream &,
+                               unsigned char *,
+                               std::size_t,
+                               boost::system::error_code &ec_)
+{
+    ec_ = boost::asio::error::would_block;
+    return 0;
+}
+
+inline std::size_t ws_read_available (boost::asio::ip::tcp::socket &socket_,
+                                      unsigned char *buffer_,
+                                      std::size_t len_,
+                                      boost::system::error_code &ec_)
+{
+    const std::size_t available = socket_.available (ec_);
+    if (ec_)
+        return 0;
+    if (available == 0) {
+        ec_ = boost::asio::error::would_block;
+        return 0;
+    }
+    const std::size_t n = socket_.read_some (
+      boost::asio::buffer (buffer_, std::min (len_, available)), ec_);
+    return ec_ ? 0 : n;
+}
+
+//  Server-side framing fast path shared by ws_transport_t and
+//  wss_transport_t. Beast answers the upgrade request; after that frames
+//  are parsed with ws_frame_decoder_t and written directly on the stream
+//  under the websocket layer (the TCP socket for ws, the SSL stream for
+//  wss).
+//
+//  The transport keeps owning the websocket stream; the framing refers to
+//  the transport's pointer to it, which close () may reset while reads
+//  are still chained, and fails the I/O with operation_aborted then.
+
+template <typename WsStream> class ws_server_framing_t
+{
+  public:
+    typedef typename WsStream::next_layer_type::next_layer_type raw_stream_t;
+    typedef i_asio_transport::completion_handler_t completion_handler_t;
+
+    explicit ws_server_framing_t (std::unique_ptr<WsStream> &stream_) :
+        _stream (stream_), _frame_write_pending (false)
+    {
+    }
+
+    //  Drops all state; called when the transport opens a new stream.
+    void reset ()
+    {
+        _decoder.reset ();
+        _upgrade_parser.reset ();
+        _upgrade_buffer.clear ();
+        _control_out.clear ();
+        _frame_write_pending = false;
+        _deferred_write = NULL;
+    }
+
+    //  True once the upgrade went through and the fast path owns the
+    //  stream; while false, Beast frames.
+    bool active () const { return _decoder != NULL; }
+
+    //  True if a read can complete without waiting for the peer.
+    bool read_ready () const
+    {
+        return _upgrade_buffer.size () > 0 || _decoder->close_received ();
+    }
+
+    //  Reads the upgrade request here rather than in async_accept so that
+    //  frames pipelined behind it end up in _upgrade_buffer, not in
+    //  Beast's internal buffer where the fast path could not reach them.
+    void async_accept (completion_handler_t handler_)
+    {
+        _upgrade_parser.reset (new (std::nothrow) upgrade_parser_t);
+        if (!_upgrade_parser) {
+            if (handler_)
+                handler_ (boost::asio::error::no_memory, 0);
+            return;
+        }
+
+        boost::beast::http::async_read (
+          raw (), _upgrade_buffer, *_upgrade_parser,
+          [this, handler_] (const boost::system::error_code &ec_,
+                            std::size_t) {
+              if (ec_ || !_stream) {
+                  ASIO_DBG ("WS", "server handshake failed: %s",
+                            ec_.message ().c_str ());
+                  if (handler_)
+                      handler_ (ec_ ? ec_
+                                    : boost::system::error_code (
+                                      boost::asio::error::operation_aborted),
+                                0);
+                  return;
+              }
+              _stream->async_accept (
+                _upgrade_parser->get (),
+                [this, handler_] (const boost::system::error_code &ec_) {
+                    _upgrade_parser.reset ();
+                    if (!ec_) {
+                        _decoder.reset (new (std::nothrow)
+                                          ws_frame_decoder_t (true));
+                        if (!_decoder) {
+                            if (handler_)
+                                handler_ (boost::asio::error::no_memory, 0);
+                            return;
+                        }
+                    }
+                    if (handler_)
+                        handler_ (ec_, 0);
+                });
+          });
+    }
+
+    //  Reads at least one payload byte into buffer_. Frames carrying no
+    //  payload are consumed without completing, since the engine treats
+    //  an empty read as an error.
+    void async_read (unsigned char *buffer_,
+                     std::size_t buffer_size_,
+                     completion_handler_t handler_)
+    {
+        if (!_stream) {
+            if (handler_)
+                handler_ (boost::asio::error::operation_aborted, 0);
+            return;
+        }
+
+        if (_decoder->close_received ()) {
+            boost::asio::post (_stream->get_executor (), [handler_] () {
+                if (handler_)
+                    handler_ (boost::beast::websocket::error::closed, 0);
+            });
+            return;
+        }
+
+        //  Bytes left over from the upgrade request are decoded first.
+        if (_upgrade_buffer.size () > 0) {
+            const std::size_t n = boost::asio::buffer_copy (
+              boost::asio::buffer (buffer_, buffer_size_),
+              _upgrade_buffer.data ());
+            _upgrade_buffer.consume (n);
+            boost::asio::post (_stream->get_executor (),
+                               [this, buffer_, buffer_size_, n, handler_] () {
+                                   on_read (buffer_, buffer_size_,
+                                            boost::system::error_code (), n,
+                                            handler_);
+                               });
+            return;
+        }
+
+        raw ().async_read_some (
+          boost::asio::buffer (buffer_, buffer_size_),
+          [this, buffer_, buffer_size_, handler_] (
+            const boost::system::error_code &ec_, std::size_t bytes_) {
+              on_read (buffer_, buffer_size_, ec_, bytes_, handler_);
+          });
+    }
+
+    //  Non-blocking read; sets ec_ to would_block if no payload is ready.
+    std::size_t read (unsigned char *buffer_,
+                      std::size_t len_,
+                      boost::system::error_code &ec_)
+    {
+        if (_decoder->close_received ()) {
+            ec_ = boost::beast::websocket::error::closed;
+            return 0;
+        }
+
+        std::size_t bytes_read = 0;
+        if (_upgrade_buffer.size () > 0) {
+            bytes_read = boost::asio::buffer_copy (
+              boost::asio::buffer (buffer_, len_), _upgrade_buffer.data ());
+            _upgrade_buffer.consume (bytes_read);
+        } else {
+            bytes_read = ws_read_available (raw (), buffer_, len_, ec_);
+            if (ec_)
+                return 0;
+        }
+
+        std::size_t payload_size = 0;
+        if (_decoder->decode (buffer_, bytes_read, &payload_size) != 0) {
+            ec_ = boost::system::errc::make_error_code (
+              boost::system::errc::protocol_error);
+            return 0;
+        }
+        flush_control_replies ();
+
+        if (payload_size == 0)
+            ec_ =
+              _decoder->close_received ()
+                ? boost::system::error_code (
+                    boost::beast::websocket::error::closed)
+                : boost::system::error_code (boost::asio::error::would_block);
+        return payload_size;
+    }
+
+    //  Writes header_ and body_ as the payload of one binary frame.
+    void async_write (const unsigned char *header_,
+                      std::size_t header_size_,
+                      const unsigned char *body_,
+                      std::size_t body_size_,
+                      completion_handler_t handler_)
+    {
+        if (!_stream) {
+            if (handler_)
+                handler_ (boost::asio::error::operation_aborted, 0);
+            return;
+        }
+
+        //  A control reply is on the wire; follow it once it is done.
+        if (_frame_write_pending) {
+            _deferred_write = [this, header_, header_size_, body_,
+                               body_size_, handler_] () {
+                async_write (header_, header_size_, body_, body_size_,
+                             handler_);
+            };
+            return;
+        }
+
+        const std::size_t payload_size = header_size_ + body_size_;
+        const std::size_t frame_header_size = ws_encode_frame_header (
+          _frame_header, ws_opcode_binary, payload_size, NULL);
+
+        const auto on_written = [this, payload_size, handler_] (
+                                  const boost::system::error_code &ec_,
+                                  std::size_t) {
+            ASIO_DBG ("WS", "frame write complete: ec=%s, bytes=%zu",
+                      ec_.message ().c_str (), payload_size);
+            _frame_write_pending = false;
+            if (!ec_)
+                flush_control_replies ();
+            if (handler_)
+                handler_ (ec_, ec_ ? 0 : payload_size);
+        };
+
+        _frame_write_pending = true;
+        if (ws_gather_writes<raw_stream_t>::value) {
+            const std::array<boost::asio::const_buffer, 3> buffers = {
+              boost::asio::buffer (_frame_header, frame_header_size),
+              boost::asio::buffer (header_, header_size_),
+              boost::asio::buffer (body_, body_size_)};
+            boost::asio::async_write (raw (), buffers, on_written);
+        } else {
+            assemble (frame_header_size, header_, header_size_, body_,
+                      body_size_);
+            boost::asio::async_write (raw (), boost::asio::buffer (_frame_out),
+                                      on_written);
+        }
+    }
+
+    //  Writes data_ as one binary frame, blocking until it is out.
+    std::size_t write (const unsigned char *data_,
+                       std::size_t len_,
+                       boost::system::error_code &ec_)
+    {
+        if (_frame_write_pending) {
+            ec_ = boost::asio::error::would_block;
+            return 0;
+        }
+
+        const std::size_t frame_header_size =
+          ws_encode_frame_header (_frame_header, ws_opcode_binary, len_, NULL);
+        if (ws_gather_writes<raw_stream_t>::value) {
+            const std::array<boost::asio::const_buffer, 2> buffers = {
+              boost::asio::buffer (_frame_header, frame_header_size),
+              boost::asio::buffer (data_, len_)};
+            boost::asio::write (raw (), buffers, ec_);
+        } else {
+            assemble (frame_header_size, data_, len_, NULL, 0);
+            boost::asio::write (raw (), boost::asio::buffer (_frame_out), ec_);
+        }
+        return ec_ ? 0 : len_;
+    }
+
+  private:
+    typedef boost::beast::http::request_parser<boost::beast::http::empty_body>
+      upgrade_parser_t;
+
+    raw_stream_t &raw () { return _stream->next_layer ().next_layer (); }
+
+    void on_read (unsigned char *buffer_,
+                  std::size_t buffer_size_,
+                  const boost::system::error_code &ec_,
+                  std::size_t bytes_read_,
+                  completion_handler_t handler_)
+    {
+        if (ec_) {
+            ASIO_DBG ("WS", "read failed: %s", ec_.message ().c_str ());
+            if (handler_)
+                handler_ (ec_, 0);
+            return;
+        }
+
+        std::size_t payload_size = 0;
+        if (_decoder->decode (buffer_, bytes_read_, &payload_size) != 0) {
+            ASIO_DBG ("WS", "read failed: malformed frame");
+            if (handler_)
+                handler_ (boost::system::errc::make_error_code (
+                            boost::system::errc::protocol_error),
+                          0);
+            return;
+        }
+        flush_control_replies ();
+
+        if (payload_size > 0) {
+            if (handler_)
+                handler_ (ec_, payload_size);
+            return;
+        }
+        async_read (buffer_, buffer_size_, handler_);
+    }
+
+    //  Copies the frame header in _frame_header and the payload pieces
+    //  into _frame_out.
+    void assemble (std::size_t frame_header_size_,
+                   const unsigned char *first_,
+                   std::size_t first_size_,
+                   const unsigned char *second_,
+                   std::size_t second_size_)
+    {
+        _frame_out.resize (frame_header_size_ + first_size_ + second_size_);
+        memcpy (&_frame_out[0], _frame_header, frame_header_size_);
+        if (first_size_ > 0)
+            memcpy (&_frame_out[frame_header_size_], first_, first_size_);
+        if (second_size_ > 0)
+            memcpy (&_frame_out[frame_header_size_ + first_size_], second_,
+                    second_size_);
+    }
+
+    //  Sends the pongs and close echo the decoder queued, between data
+    //  frames.
+    void flush_control_replies ()
+    {
+        if (_frame_write_pending || !_stream || !_decoder
+            || !_decoder->has_reply ())
+            return;
+
+        _decoder->take_reply (_control_out);
+        _frame_write_pending = true;
+        boost::asio::async_write (
+          raw (), boost::asio::buffer (_control_out),
+          [this] (const boost::system::error_code &ec_, std::size_t) {
+              _frame_write_pending = false;
+              _control_out.clear ();
+              if (_deferred_write) {
+                  std::function<void ()> write;
+                  write.swap (_deferred_write);
+                  write ();
+              } else if (!ec_)
+                  flush_control_replies ();
+          });
+    }
+
+    //  The owning transport's stream.
+    std::unique_ptr<WsStream> &_stream;
+
+    //  Set once the fast path owns the stream.
+    std::unique_ptr<ws_frame_decoder_t> _decoder;
+
+    //  Upgrade request parser and its buffer. Bytes the client sent
+    //  right after the request stay in the buffer until the first read.
+    std::unique_ptr<upgrade_parser_t> _upgrade_parser;
+    boost::beast::flat_buffer _upgrade_buffer;
+
+    //  Header of the data frame being written, and the whole frame when
+    //  it can't be gathered.
+    unsigned char _frame_header[ws_max_frame_header_size];
+    std::vector<unsigned char> _frame_out;
+
+    //  Control replies (pong, close) go out between data frames; a data
+    //  write issued while one is on the wire waits in _deferred_write.
+    std::vector<unsigned char> _control_out;
+    bool _frame_write_pending;
+    std::function<void ()> _deferred_write;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (ws_server_framing_t)
+};
+}
+
+#endif  // ZLINK_IOTHREAD_POLLER_USE_ASIO && ZLINK_HAVE_ASIO_WS
+
+#endif  // __ZLINK_WS_SERVER_FRAMING_HPP_INCLUDED__
@@ -7,8 +7,11 @@
 
 #include "engine/asio/asio_debug.hpp"
 #include "core/address.hpp"
+#include "core/options.hpp"
 
+#include <atomic>
 #include <cerrno>
+#include <cstdio>
 #include <cstdlib>
 
 //  Debug logging for WebSocket transport
@@ -55,13 +58,69 @@ size_t ws_read_message_max ()
         value = parse_size_env ("ZLINK_WS_READ_MESSAGE_MAX", 64 * 1024 * 1024);
     return value;
 }
+
+bool env_flag_enabled (const char *name_)
+{
+    const char *env = std::getenv (name_);
+    return env && *env && *env != '0';
+}
+
+ws_deflate_stats_t ws_deflate_counters;
+std::atomic<bool> ws_deflate_stats_registered (false);
+
+void ws_deflate_stats_dump ()
+{
+    const uint64_t tx_payload = ws_deflate_counters.tx_payload_bytes.load ();
+    const uint64_t tx_wire = ws_deflate_counters.tx_wire_bytes.load ();
+    const uint64_t rx_payload = ws_deflate_counters.rx_payload_bytes.load ();
+    const uint64_t rx_wire = ws_deflate_counters.rx_wire_bytes.load ();
+    std::fprintf (
+      stderr,
+      "[WS_DEFLATE_STATS] tx payload=%llu wire=%llu ratio=%.3f\n"
+      "[WS_DEFLATE_STATS] rx payload=%llu wire=%llu ratio=%.3f\n",
+      static_cast<unsigned long long> (tx_payload),
+      static_cast<unsigned long long> (tx_wire),
+      tx_wire ? static_cast<double> (tx_payload) / tx_wire : 0.0,
+      static_cast<unsigned long long> (rx_payload),
+      static_cast<unsigned long long> (rx_wire),
+      rx_wire ? static_cast<double> (rx_payload) / rx_wire : 0.0);
+}
+}
+
+ws_deflate_config_t::ws_deflate_config_t () :
+    enabled (false),
+    server_max_window_bits (15),
+    client_max_window_bits (15),
+    threshold (0)
+{
+}
+
+ws_deflate_config_t::ws_deflate_config_t (const options_t &options_) :
+    enabled (options_.ws_deflate),
+    server_max_window_bits (options_.ws_deflate_server_window_bits),
+    client_max_window_bits (options_.ws_deflate_client_window_bits),
+    threshold (options_.ws_deflate_threshold)
+{
+}
+
+ws_deflate_stats_t *ws_deflate_stats ()
+{
+    static const bool stats_on = env_flag_enabled ("ZLINK_WS_DEFLATE_STATS");
+    if (!stats_on)
+        return NULL;
+    bool expected = false;
+    if (ws_deflate_stats_registered.compare_exchange_strong (expected, true))
+        std::atexit (ws_deflate_stats_dump);
+    return &ws_deflate_counters;
 }
 
 ws_transport_t::ws_transport_t (const std::string &path,
                                 const std::string &host) :
     _path (path),
     _host (host),
-    _handshake_complete (false)
+    _handshake_complete (false),
+    _stats (NULL),
+    _framing (_ws_stream)
 {
 }
 
@@ -103,7 +162,13 @@ bool ws_transport_t::open (boost::asio::io_context &io_context, fd_t fd)
     _ws_stream->write_buffer_bytes (ws_write_buffer_bytes ());
     _ws_stream->read_message_max (ws_read_message_max ());
 
+    //  Offer permessage-deflate; counters only cover deflate connections
+    ws_apply_deflate (*_ws_stream, _deflate);
+    _stats = _deflate.enabled ? ws_deflate_stats () : NULL;
+    _ws_stream->next_layer ().set_stats (_stats);
+
     _handshake_complete = false;
+    _framing.reset ();
 
     ASIO_DBG_WS ("opened with path=%s, host=%s", _path.c_str (), _host.c_str ());
     return true;
@@ -111,7 +176,7 @@ bool ws_transport_t::open (boost::asio::io_context &io_context, fd_t fd)
 
 bool ws_transport_t::is_open () const
 {
-    return _ws_stream && _ws_stream->next_layer ().is_open ();
+    return _ws_stream && boost::beast::get_lowest_layer (*_ws_stream).is_open ();
 }
 
 void ws_transport_t::close ()
@@ -122,10 +187,10 @@ void ws_transport_t::close ()
         //  Close the underlying socket first - this cancels all pending async ops
         //  The socket close will cause pending async_read/async_write to complete
         //  with operation_aborted error
-        if (_ws_stream->next_layer ().is_open ()) {
-            _ws_stream->next_layer ().shutdown (
+        if (boost::beast::get_lowest_layer (*_ws_stream).is_open ()) {
+            boost::beast::get_lowest_layer (*_ws_stream).shutdown (
               boost::asio::ip::tcp::socket::shutdown_both, ec);
-            _ws_stream->next_layer ().close (ec);
+            boost::beast::get_lowest_layer (*_ws_stream).close (ec);
         }
 
         //  Note: We don't reset the stream here - let the caller drain pending
@@ -156,19 +221,65 @@ void ws_transport_t::async_read_some (unsigned char *buffer,
         return;
     }
 
+    if (_framing.active ()) {
+        _framing.async_read (buffer, buffer_size, handler);
+        return;
+    }
+
+    ws_deflate_stats_t *const stats = _stats;
     _ws_stream->async_read_some (
       boost::asio::buffer (buffer, buffer_size),
-      [handler] (const boost::system::error_code &ec,
-                 std::size_t bytes_transferred) {
+      [handler, stats] (const boost::system::error_code &ec,
+                        std::size_t bytes_transferred) {
           if (ec) {
               ASIO_DBG_WS ("read failed: %s", ec.message ().c_str ());
           }
+          if (stats)
+              stats->rx_payload_bytes += bytes_transferred;
           if (handler) {
               handler (ec, bytes_transferred);
           }
       });
 }
 
+void ws_transport_t::async_wait_readable (completion_handler_t handler)
+{
+    if (!_ws_stream || !_framing.active ()) {
+        if (handler) {
+            handler (boost::asio::error::not_connected, 0);
+        }
+        return;
+    }
+
+    //  Bytes left over from the upgrade request can be read right away.
+    if (_framing.read_ready ()) {
+        if (handler) {
+            boost::asio::post (
+              _ws_stream->get_executor (), [handler] () {
+                  handler (boost::system::error_code (), 0);
+              });
+        }
+        return;
+    }
+
+    boost::beast::get_lowest_layer (*_ws_stream)
+      .async_wait (boost::asio::socket_base::wait_read,
+                   [this, handler] (const boost::system::error_code &ec) {
+                       //  read_frames never blocks, so it can't tell EOF
+                       //  from no data; a readable socket with nothing
+                       //  in it is the peer closing.
+                       boost::system::error_code result = ec;
+                       if (!result && _ws_stream) {
+                           boost::asio::ip::tcp::socket &socket =
+                             boost::beast::get_lowest_layer (*_ws_stream);
+                           if (socket.available (result) == 0 && !result)
+                               result = boost::asio::error::eof;
+                       }
+                       if (handler)
+                           handler (result, 0);
+                   });
+}
+
 std::size_t ws_transport_t::read_some (std::uint8_t *buffer, std::size_t len)
 {
     if (len == 0) {
@@ -182,8 +293,21 @@ std::size_t ws_transport_t::read_some (std::uint8_t *buffer, std::size_t len)
     }
 
     boost::system::error_code ec;
-    const std::size_t bytes_read =
-      _ws_stream->read_some (boost::asio::buffer (buffer, len), ec);
+    std::size_t bytes_read = 0;
+    if (_framing.active ())
+        bytes_read = _framing.read (buffer, len, ec);
+    else if (boost::beast::get_lowest_layer (*_ws_stream).available (ec) == 0
+             && !ec) {
+        //  Beast's synchronous read waits for a frame, which would block
+        //  the I/O thread; anything it has buffered is picked up by the
+        //  async read the engine falls back to.
+        ec = boost::asio::error::would_block;
+    } else if (!ec) {
+        bytes_read =
+          _ws_stream->read_some (boost::asio::buffer (buffer, len), ec);
+        if (_stats)
+            _stats->rx_payload_bytes += bytes_read;
+    }
 
     if (ec) {
         if (ec == boost::asio::error::would_block
@@ -225,12 +349,20 @@ void ws_transport_t::async_write_some (const unsigned char *buffer,
 
     //  WebSocket writes are frame-based, so we write the entire buffer
     //  as a single binary frame
+    if (_framing.active ()) {
+        _framing.async_write (NULL, 0, buffer, buffer_size, handler);
+        return;
+    }
+
+    ws_deflate_stats_t *const stats = _stats;
     _ws_stream->async_write (
       boost::asio::buffer (buffer, buffer_size),
-      [handler] (const boost::system::error_code &ec,
-                 std::size_t bytes_transferred) {
+      [handler, stats] (const boost::system::error_code &ec,
+                        std::size_t bytes_transferred) {
           ASIO_DBG ("WS", "write complete: ec=%s, bytes=%zu",
                     ec.message ().c_str (), bytes_transferred);
+          if (stats)
+              stats->tx_payload_bytes += bytes_transferred;
           if (handler) {
               handler (ec, bytes_transferred);
           }
@@ -250,16 +382,24 @@ void ws_transport_t::async_writev (const unsigned char *header,
         return;
     }
 
+    if (_framing.active ()) {
+        _framing.async_write (header, header_size, body, body_size, handler);
+        return;
+    }
+
     std::array<boost::asio::const_buffer, 2> buffers = {
       boost::asio::buffer (header, header_size),
       boost::asio::buffer (body, body_size)};
 
+    ws_deflate_stats_t *const stats = _stats;
     _ws_stream->async_write (
       buffers,
-      [handler] (const boost::system::error_code &ec,
-                 std::size_t bytes_transferred) {
+      [handler, stats] (const boost::system::error_code &ec,
+                        std::size_t bytes_transferred) {
           ASIO_DBG ("WS", "writev complete: ec=%s, bytes=%zu",
                     ec.message ().c_str (), bytes_transferred);
+          if (stats)
+              stats->tx_payload_bytes += bytes_transferred;
           if (handler) {
               handler (ec, bytes_transferred);
           }
@@ -279,7 +419,7 @@ std::size_t ws_transport_t::write_some (const std::uint8_t *data,
         return 0;
     }
 
-    if (!_ws_stream->next_layer ().is_open ()) {
+    if (!boost::beast::get_lowest_layer (*_ws_stream).is_open ()) {
         errno = EBADF;
         return 0;
     }
@@ -303,8 +443,14 @@ std::size_t ws_transport_t::write_some (const std::uint8_t *data,
 
     //  Use write() to send complete frame (not write_some which is not
     //  available for WebSocket in Beast)
-    bytes_written =
-      _ws_stream->write (boost::asio::buffer (data, len), ec);
+    if (_framing.active ())
+        bytes_written = _framing.write (data, len, ec);
+    else {
+        bytes_written =
+          _ws_stream->write (boost::asio::buffer (data, len), ec);
+        if (_stats)
+            _stats->tx_payload_bytes += bytes_written;
+    }
 
     if (ec) {
         //  Handle would_block case
@@ -367,6 +513,17 @@ void ws_transport_t::async_handshake (int handshake_type,
                   handler (ec, 0);
               }
           });
+    } else if (!_deflate.enabled && !ws_beast_framing ()) {
+        _framing.async_accept (
+          [this, handler] (const boost::system::error_code &ec, std::size_t) {
+              if (!ec) {
+                  _handshake_complete = true;
+                  ASIO_DBG_WS ("server handshake complete (fast framing)");
+              }
+              if (handler) {
+                  handler (ec, 0);
+              }
+          });
     } else {
         //  Server-side WebSocket handshake
         _ws_stream->async_accept (
@@ -8,12 +8,17 @@
 
 #include <boost/asio.hpp>
 #include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
 #include <boost/beast/websocket.hpp>
 #include <array>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "engine/asio/i_asio_transport.hpp"
+#include "transports/ws/ws_deflate.hpp"
+#include "transports/ws/ws_server_framing.hpp"
 
 namespace zlink
 {
@@ -27,6 +32,9 @@ namespace zlink
 //  - Requires HTTP upgrade handshake before data transfer
 //  - Uses binary frames for ZLINK messages (not text frames)
 //  - Frame-based protocol (read_some returns message data chunks)
+//  - On the server side without deflate, frames are parsed and written
+//    directly on the socket once Beast has answered the upgrade request
+//    (ZLINK_WS_BEAST_FRAMING=1 keeps Beast framing for comparison)
 //
 //  Usage:
 //    1. Create ws_transport_t with optional path/protocol
@@ -76,6 +84,11 @@ class ws_transport_t : public i_asio_transport
                           completion_handler_t handler) ZLINK_OVERRIDE;
     bool supports_speculative_write () const ZLINK_OVERRIDE { return false; }
     bool supports_gather_write () const ZLINK_OVERRIDE { return true; }
+    bool supports_async_wait () const ZLINK_OVERRIDE
+    {
+        return _framing.active ();
+    }
+    void async_wait_readable (completion_handler_t handler) ZLINK_OVERRIDE;
     void async_writev (const unsigned char *header,
                        std::size_t header_size,
                        const unsigned char *body,
@@ -90,15 +103,26 @@ class ws_transport_t : public i_asio_transport
     //  Set the path for WebSocket endpoint
     void set_path (const std::string &path) { _path = path; }
 
+    //  Set permessage-deflate parameters (applied on open)
+    void set_deflate (const ws_deflate_config_t &config_) { _deflate = config_; }
+
   private:
-    //  WebSocket stream type (over TCP socket, no compression for simplicity)
-    typedef boost::beast::websocket::stream<boost::asio::ip::tcp::socket>
+    //  WebSocket stream type (over TCP socket, counting wire bytes)
+    typedef boost::beast::websocket::stream<
+      ws_counting_stream_t<boost::asio::ip::tcp::socket> >
       ws_stream_t;
 
     std::string _path;
     std::string _host;
     std::unique_ptr<ws_stream_t> _ws_stream;
     bool _handshake_complete;
+    ws_deflate_config_t _deflate;
+
+    //  Compression counters; NULL unless deflate and stats are enabled
+    ws_deflate_stats_t *_stats;
+
+    //  Framing fast path, used on the server side without deflate.
+    ws_server_framing_t<ws_stream_t> _framing;
 
     ZLINK_NON_COPYABLE_NOR_MOVABLE (ws_transport_t)
 };
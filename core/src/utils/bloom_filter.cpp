@@ -0,0 +1,136 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+#include <string.h>
+
+#include "utils/bloom_filter.hpp"
+
+//  The prefix lengths, spaced closely enough that a typical topic is
+//  filed whole or nearly so.
+static const size_t lengths[] = {1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+
+static const uint64_t multiplier = 0xff51afd7ed558ccdULL;
+
+zlink::bloom_filter_t::bloom_filter_t ()
+{
+    reset (0);
+}
+
+zlink::bloom_filter_t::~bloom_filter_t ()
+{
+}
+
+void zlink::bloom_filter_t::reset (size_t counters_)
+{
+    _blocks = 0;
+    if (counters_ > 0)
+        for (_blocks = 1; _blocks * block_size < counters_; _blocks <<= 1)
+            ;
+    std::vector<unsigned char> buffer (
+      _blocks > 0 ? _blocks * block_size + block_size - 1 : 0, 0);
+    _buffer.swap (buffer);
+    _counters = NULL;
+    if (_blocks > 0) {
+        const uintptr_t start = reinterpret_cast<uintptr_t> (&_buffer[0]);
+        _counters =
+          &_buffer[(block_size - start % block_size) % block_size];
+    }
+    for (int i = 0; i != levels; ++i)
+        _prefixes[i] = 0;
+    _active_count = 0;
+    _match_all = 0;
+}
+
+int zlink::bloom_filter_t::level (size_t size_)
+{
+    int level = -1;
+    while (level + 1 < levels && lengths[level + 1] <= size_)
+        ++level;
+    return level;
+}
+
+uint64_t zlink::bloom_filter_t::hash (const unsigned char *data_, size_t size_)
+{
+    //  One multiplication per eight bytes, the last word overlapping the
+    //  one before if need be, and a fold so that the low bits, which pick
+    //  the block, depend on all of them.
+    uint64_t hash = size_ * 0x9e3779b97f4a7c15ULL;
+    uint64_t word;
+    if (size_ >= 8) {
+        const unsigned char *last = data_ + size_ - 8;
+        for (; data_ < last; data_ += 8) {
+            memcpy (&word, data_, 8);
+            hash = (hash ^ word) * multiplier;
+        }
+        memcpy (&word, last, 8);
+    } else {
+        word = 0;
+        for (size_t i = 0; i != size_; ++i)
+            word |= static_cast<uint64_t> (data_[i]) << (8 * i);
+    }
+    hash = (hash ^ word) * multiplier;
+    return hash ^ (hash >> 32);
+}
+
+void zlink::bloom_filter_t::add (const unsigned char *prefix_, size_t size_)
+{
+    if (!enabled ())
+        return;
+    const int level = bloom_filter_t::level (size_);
+    if (level < 0) {
+        ++_match_all;
+        return;
+    }
+    const uint64_t hash = bloom_filter_t::hash (prefix_, lengths[level]);
+    for (int i = 0; i != hashes; ++i) {
+        unsigned char &count = counter (hash, i);
+        if (count != 0xff)
+            ++count;
+    }
+    if (_prefixes[level]++ == 0)
+        update_levels ();
+}
+
+void zlink::bloom_filter_t::rm (const unsigned char *prefix_, size_t size_)
+{
+    if (!enabled ())
+        return;
+    const int level = bloom_filter_t::level (size_);
+    if (level < 0) {
+        --_match_all;
+        return;
+    }
+    const uint64_t hash = bloom_filter_t::hash (prefix_, lengths[level]);
+    for (int i = 0; i != hashes; ++i) {
+        unsigned char &count = counter (hash, i);
+        if (count != 0xff)
+            --count;
+    }
+    if (--_prefixes[level] == 0)
+        update_levels ();
+}
+
+bool zlink::bloom_filter_t::check (const unsigned char *data_,
+                                   size_t size_) const
+{
+    if (!enabled () || _match_all > 0)
+        return true;
+
+    for (int i = 0; i != _active_count && lengths[_active[i]] <= size_; ++i) {
+        const uint64_t hash = bloom_filter_t::hash (data_, lengths[_active[i]]);
+        int j = 0;
+        while (j != hashes && counter (hash, j))
+            ++j;
+        if (j == hashes)
+            return true;
+    }
+    return false;
+}
+
+void zlink::bloom_filter_t::update_levels ()
+{
+    _active_count = 0;
+    for (int level = 0; level != levels; ++level)
+        if (_prefixes[level] > 0)
+            _active[_active_count++] = level;
+}
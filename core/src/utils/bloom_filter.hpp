@@ -0,0 +1,84 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_BLOOM_FILTER_HPP_INCLUDED__
+#define __ZLINK_BLOOM_FILTER_HPP_INCLUDED__
+
+#include <stddef.h>
+#include <vector>
+
+#include "utils/macros.hpp"
+#include "utils/stdint.hpp"
+
+namespace zlink
+{
+//  Counting Bloom filter over subscription prefixes, telling whether a
+//  message may match any of them. A prefix is filed cut to the longest of
+//  a few fixed lengths, up to 64 bytes, not exceeding its size. A message
+//  can only match if one of its leading parts of those lengths is in the
+//  filter, so checking it takes one hash and one cache line per length in
+//  use. The empty prefix matches everything and is only counted.
+//
+//  Counters saturate rather than wrap: a saturated counter is never
+//  decremented, which may leave false positives but never hides a match.
+class bloom_filter_t
+{
+  public:
+    bloom_filter_t ();
+    ~bloom_filter_t ();
+
+    //  Drops all the prefixes and sets the number of counters, rounded up
+    //  to a power of two of at least a block. 0 disables the filter.
+    void reset (size_t counters_);
+
+    bool enabled () const { return _blocks > 0; }
+
+    //  Add or remove a prefix. Every removal must match an earlier add.
+    void add (const unsigned char *prefix_, size_t size_);
+    void rm (const unsigned char *prefix_, size_t size_);
+
+    //  Returns false if the data matches none of the prefixes for sure.
+    bool check (const unsigned char *data_, size_t size_) const;
+
+  private:
+    enum
+    {
+        //  Number of prefix lengths.
+        levels = 12,
+
+        //  Counters set per prefix, all within one block of a cache line.
+        hashes = 3,
+        block_size = 64
+    };
+
+    //  Level a prefix of the size is filed at, -1 for the empty prefix.
+    static int level (size_t size_);
+
+    static uint64_t hash (const unsigned char *data_, size_t size_);
+
+    //  The i_-th counter of the hash.
+    unsigned char &counter (uint64_t hash_, int i_) const
+    {
+        return _counters[(hash_ & (_blocks - 1)) * block_size
+                         + ((hash_ >> (32 + 6 * i_)) & (block_size - 1))];
+    }
+
+    //  Recomputes _active.
+    void update_levels ();
+
+    //  The counters, aligned on a cache line within _buffer.
+    std::vector<unsigned char> _buffer;
+    unsigned char *_counters;
+    size_t _blocks;
+
+    //  Number of prefixes filed at each level, the levels holding any in
+    //  increasing order, and the number of empty prefixes.
+    uint32_t _prefixes[levels];
+    int _active[levels];
+    int _active_count;
+    uint32_t _match_all;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (bloom_filter_t)
+};
+}
+
+#endif
@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+#include "utils/buffer_pool.hpp"
+#include "utils/config.hpp"
+#include "utils/err.hpp"
+#include "utils/mutex.hpp"
+#include "utils/numa.hpp"
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+struct block_t
+{
+    void *buf;
+    size_t size;
+
+    //  NUMA node of the thread that handed the block back. Blocks are
+    //  only reused on the same node.
+    int node;
+};
+
+struct buffer_pool_t
+{
+    buffer_pool_t () : cached (0) {}
+
+    zlink::mutex_t sync;
+    std::vector<block_t> blocks;
+
+    //  Mirrors blocks.size () so that an empty pool costs no lock.
+    std::atomic<size_t> cached;
+};
+
+buffer_pool_t *create_pool ()
+{
+    buffer_pool_t *p = new (std::nothrow) buffer_pool_t;
+    alloc_assert (p);
+    return p;
+}
+
+//  Never destroyed: message buffers can be released by application
+//  threads while static destructors run at exit.
+buffer_pool_t &pool ()
+{
+    static buffer_pool_t *const instance = create_pool ();
+    return *instance;
+}
+}
+
+void *zlink::buffer_pool_allocate (size_t size_)
+{
+    buffer_pool_t &p = pool ();
+    if (p.cached.load (std::memory_order_relaxed) > 0) {
+        const int node = numa_current_node ();
+        scoped_lock_t lock (p.sync);
+        for (size_t i = p.blocks.size (); i-- > 0;) {
+            if (p.blocks[i].size == size_ && p.blocks[i].node == node) {
+                void *buf = p.blocks[i].buf;
+                p.blocks[i] = p.blocks.back ();
+                p.blocks.pop_back ();
+                p.cached.store (p.blocks.size (), std::memory_order_relaxed);
+                return buf;
+            }
+        }
+    }
+    return malloc (size_);
+}
+
+void zlink::buffer_pool_release (void *buf_, size_t size_)
+{
+    if (!buf_)
+        return;
+
+    buffer_pool_t &p = pool ();
+    const int node = numa_current_node ();
+    {
+        scoped_lock_t lock (p.sync);
+        if (p.blocks.size () < buffer_pool_max_buffers) {
+            const block_t block = {buf_, size_, node};
+            p.blocks.push_back (block);
+            p.cached.store (p.blocks.size (), std::memory_order_relaxed);
+            return;
+        }
+    }
+    free (buf_);
+}
+
+size_t zlink::buffer_pool_size ()
+{
+    return pool ().cached.load (std::memory_order_relaxed);
+}
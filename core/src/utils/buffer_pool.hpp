@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_BUFFER_POOL_HPP_INCLUDED__
+#define __ZLINK_BUFFER_POOL_HPP_INCLUDED__
+
+#include <stddef.h>
+
+namespace zlink
+{
+//  Process-wide cache of I/O buffers handed back by idle engines in
+//  low-memory mode (ZLINK_LOW_MEMORY), so that connections waking up again
+//  don't each go back to malloc. Cached blocks are plain malloc () memory:
+//  a block taken from the pool may be freed with free () like any other.
+//  At most buffer_pool_max_buffers blocks are kept; the rest are freed.
+//  A block is only handed out again on the NUMA node it was returned on.
+//  Only encoders and decoders that have released a buffer (which only
+//  low-memory engines do) allocate from the pool; everyone else calls
+//  malloc () directly and never takes the pool's lock.
+
+//  Returns a block of exactly size_ bytes from the pool, or from malloc ()
+//  if the pool has none. Returns NULL if malloc () fails.
+void *buffer_pool_allocate (size_t size_);
+
+//  Hands a block of size_ bytes to the pool. It is freed straight away if
+//  the pool is full. buf_ may be NULL.
+void buffer_pool_release (void *buf_, size_t size_);
+
+//  Number of blocks currently cached.
+size_t buffer_pool_size ();
+}
+
+#endif
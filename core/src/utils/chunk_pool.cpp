@@ -0,0 +1,119 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+#include "utils/chunk_pool.hpp"
+#include "utils/err.hpp"
+
+#include <new>
+#include <stdlib.h>
+
+zlink::chunk_pool_t::chunk_pool_t (size_t block_size_, int capacity_) :
+    _block_size (block_size_),
+    _capacity (static_cast<size_t> (capacity_)),
+    _cells (new (std::nothrow) cell_t[static_cast<size_t> (capacity_)]),
+    _enqueue_pos (0),
+    _dequeue_pos (0),
+    _hits (0),
+    _misses (0),
+    _drops (0)
+{
+    zlink_assert (capacity_ > 0);
+    alloc_assert (_cells);
+    for (size_t i = 0; i != _capacity; ++i)
+        _cells[i].sequence.store (i, std::memory_order_relaxed);
+}
+
+zlink::chunk_pool_t::~chunk_pool_t ()
+{
+    while (void *block = pop ())
+        free (block);
+    delete[] _cells;
+}
+
+void *zlink::chunk_pool_t::allocate ()
+{
+    void *block = pop ();
+    if (block) {
+        _hits.fetch_add (1, std::memory_order_relaxed);
+        return block;
+    }
+    _misses.fetch_add (1, std::memory_order_relaxed);
+    return allocate_block ();
+}
+
+void zlink::chunk_pool_t::release (void *block_)
+{
+    if (push (block_))
+        return;
+    _drops.fetch_add (1, std::memory_order_relaxed);
+    free (block_);
+}
+
+size_t zlink::chunk_pool_t::cached () const
+{
+    const size_t enqueued = _enqueue_pos.load (std::memory_order_relaxed);
+    const size_t dequeued = _dequeue_pos.load (std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+//  A cell is free for the producer at position p when its sequence is p,
+//  and holds a block for the consumer at position p when its sequence is
+//  p + 1. Taking a block moves the sequence on by a full lap, so the cell
+//  becomes free for the producer one lap later.
+
+bool zlink::chunk_pool_t::push (void *block_)
+{
+    size_t pos = _enqueue_pos.load (std::memory_order_relaxed);
+    while (true) {
+        cell_t &cell = _cells[pos % _capacity];
+        const size_t seq = cell.sequence.load (std::memory_order_acquire);
+        const intptr_t diff =
+          static_cast<intptr_t> (seq) - static_cast<intptr_t> (pos);
+        if (diff == 0) {
+            if (_enqueue_pos.compare_exchange_weak (
+                  pos, pos + 1, std::memory_order_relaxed)) {
+                cell.block = block_;
+                cell.sequence.store (pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0)
+            return false;
+        else
+            pos = _enqueue_pos.load (std::memory_order_relaxed);
+    }
+}
+
+void *zlink::chunk_pool_t::pop ()
+{
+    size_t pos = _dequeue_pos.load (std::memory_order_relaxed);
+    while (true) {
+        cell_t &cell = _cells[pos % _capacity];
+        const size_t seq = cell.sequence.load (std::memory_order_acquire);
+        const intptr_t diff =
+          static_cast<intptr_t> (seq) - static_cast<intptr_t> (pos + 1);
+        if (diff == 0) {
+            if (_dequeue_pos.compare_exchange_weak (
+                  pos, pos + 1, std::memory_order_relaxed)) {
+                void *block = cell.block;
+                cell.sequence.store (pos + _capacity,
+                                     std::memory_order_release);
+                return block;
+            }
+        } else if (diff < 0)
+            return NULL;
+        else
+            pos = _dequeue_pos.load (std::memory_order_relaxed);
+    }
+}
+
+void *zlink::chunk_pool_t::allocate_block () const
+{
+#if defined HAVE_POSIX_MEMALIGN
+    void *pv;
+    if (posix_memalign (&pv, ZLINK_CACHELINE_SIZE, _block_size) != 0)
+        return NULL;
+    return pv;
+#else
+    return malloc (_block_size);
+#endif
+}
@@ -0,0 +1,87 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_CHUNK_POOL_HPP_INCLUDED__
+#define __ZLINK_CHUNK_POOL_HPP_INCLUDED__
+
+#include <atomic>
+#include <stddef.h>
+
+#include "utils/macros.hpp"
+#include "utils/stdint.hpp"
+#include "platform.hpp"
+
+namespace zlink
+{
+//  Lock-free cache of equally sized memory blocks, shared by the message
+//  pipes of a context (see ZLINK_CHUNK_POOL_SIZE). Queue chunks freed by
+//  one pipe are handed to the next pipe that needs one instead of going
+//  back to the system allocator.
+//
+//  Any number of threads may allocate and release concurrently. The cache
+//  is a bounded ring of cells with per-cell sequence numbers, so neither
+//  operation ever takes a lock or spins on another thread's progress for
+//  longer than it takes to finish a single store.
+//
+//  Blocks are cache line aligned where posix_memalign is available and
+//  plain malloc () memory otherwise, exactly like yqueue_t chunks, so a
+//  block may be freed with free () instead of being released.
+
+class chunk_pool_t
+{
+  public:
+    //  Creates a pool keeping up to capacity_ blocks of block_size_ bytes.
+    chunk_pool_t (size_t block_size_, int capacity_);
+
+    //  Frees the cached blocks. Blocks still in use are not affected.
+    ~chunk_pool_t ();
+
+    size_t block_size () const { return _block_size; }
+
+    //  Returns a cached block, or a newly allocated one if the cache is
+    //  empty. Returns NULL if the allocation fails.
+    void *allocate ();
+
+    //  Caches the block, or frees it if the cache is full.
+    void release (void *block_);
+
+    //  Statistics. hits and misses count allocations served from the
+    //  cache and from the system allocator, drops count releases that
+    //  found the cache full. All are approximate while the pool is used.
+    uint64_t hits () const { return _hits.load (std::memory_order_relaxed); }
+    uint64_t misses () const
+    {
+        return _misses.load (std::memory_order_relaxed);
+    }
+    uint64_t drops () const { return _drops.load (std::memory_order_relaxed); }
+    size_t cached () const;
+
+  private:
+    struct cell_t
+    {
+        std::atomic<size_t> sequence;
+        void *block;
+    };
+
+    bool push (void *block_);
+    void *pop ();
+
+    void *allocate_block () const;
+
+    const size_t _block_size;
+    const size_t _capacity;
+    cell_t *const _cells;
+
+    //  Producer and consumer positions live on separate cache lines as
+    //  they are bumped by different threads.
+    alignas (ZLINK_CACHELINE_SIZE) std::atomic<size_t> _enqueue_pos;
+    alignas (ZLINK_CACHELINE_SIZE) std::atomic<size_t> _dequeue_pos;
+
+    alignas (ZLINK_CACHELINE_SIZE) std::atomic<uint64_t> _hits;
+    std::atomic<uint64_t> _misses;
+    std::atomic<uint64_t> _drops;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (chunk_pool_t)
+};
+}
+
+#endif
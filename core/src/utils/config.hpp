@@ -14,6 +14,35 @@ enum
     //  memory allocation by approximately 99.6%
     message_pipe_granularity = 256,
 
+    //  Size of the first chunk of a message pipe created in low-memory
+    //  mode (ZLINK_LOW_MEMORY). Later chunks double in size up to
+    //  message_pipe_granularity.
+    message_pipe_low_memory_granularity = 8,
+
+    //  Most I/O buffers kept in the process-wide pool that idle engines
+    //  in low-memory mode return their buffers to.
+    buffer_pool_max_buffers = 256,
+
+    //  Length of the window, in milliseconds, over which an I/O thread
+    //  measures the traffic used to place new sessions on the least
+    //  busy thread.
+    traffic_window_ms = 1000,
+
+    //  Shape of the timer wheels behind I/O thread and zlink_timers_*
+    //  timers: levels of 2^timer_wheel_slot_bits slots of 1 ms, 64 ms,
+    //  4 s and 4.5 min. Longer timeouts wait on an overflow list.
+    timer_wheel_slot_bits = 6,
+    timer_wheel_levels = 4,
+
+    //  Number of items from which zlink_poll keeps them registered with
+    //  epoll between calls instead of passing them all to poll ().
+    poll_epoll_threshold = 64,
+
+    //  Number of such item sets each thread keeps registered, so that a
+    //  thread alternating between a few large sets doesn't re-register
+    //  them on every call.
+    poll_epoll_cache_slots = 4,
+
     //  Commands in pipe per allocation event.
     command_pipe_granularity = 16,
 
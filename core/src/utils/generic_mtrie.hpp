@@ -5,6 +5,7 @@
 
 #include <stddef.h>
 #include <set>
+#include <vector>
 
 #include "utils/macros.hpp"
 #include "utils/stdint.hpp"
@@ -57,6 +58,11 @@ template <typename T> class generic_mtrie_t
                 void (*func_) (value_t *value_, Arg arg_),
                 Arg arg_);
 
+    //  Calls a callback function for each prefix in the trie.
+    template <typename Arg>
+    void apply (void (*func_) (prefix_t data_, size_t size_, Arg arg_),
+                Arg arg_);
+
     //  Retrieve the number of prefixes stored in this trie (added - removed)
     //  Note this is a multithread safe function.
     uint32_t num_prefixes () const { return _num_prefixes.get (); }
@@ -64,6 +70,11 @@ template <typename T> class generic_mtrie_t
   private:
     bool is_redundant () const;
 
+    template <typename Arg>
+    void apply_helper (std::vector<unsigned char> &buff_,
+                       void (*func_) (prefix_t data_, size_t size_, Arg arg_),
+                       Arg arg_) const;
+
     typedef std::set<value_t *> pipes_t;
     pipes_t *_pipes;
 
@@ -560,6 +560,48 @@ void generic_mtrie_t<T>::match (prefix_t data_,
     }
 }
 
+template <typename T>
+template <typename Arg>
+void generic_mtrie_t<T>::apply (void (*func_) (prefix_t data_,
+                                               size_t size_,
+                                               Arg arg_),
+                                Arg arg_)
+{
+    std::vector<unsigned char> buff;
+    apply_helper (buff, func_, arg_);
+}
+
+template <typename T>
+template <typename Arg>
+void generic_mtrie_t<T>::apply_helper (
+  std::vector<unsigned char> &buff_,
+  void (*func_) (prefix_t data_, size_t size_, Arg arg_),
+  Arg arg_) const
+{
+    //  If this node is a subscription, apply the function.
+    if (_pipes)
+        func_ (buff_.empty () ? NULL : &buff_[0], buff_.size (), arg_);
+
+    //  If there's one subnode (optimisation).
+    if (_count == 1) {
+        if (_next.node) {
+            buff_.push_back (_min);
+            _next.node->apply_helper (buff_, func_, arg_);
+            buff_.pop_back ();
+        }
+        return;
+    }
+
+    //  If there are multiple subnodes.
+    for (unsigned short c = 0; c < _count; c++) {
+        if (_next.table[c]) {
+            buff_.push_back (static_cast<unsigned char> (_min + c));
+            _next.table[c]->apply_helper (buff_, func_, arg_);
+            buff_.pop_back ();
+        }
+    }
+}
+
 template <typename T> bool generic_mtrie_t<T>::is_redundant () const
 {
     return !_pipes && _live_nodes == 0;
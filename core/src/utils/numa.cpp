@@ -0,0 +1,146 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+#include "utils/numa.hpp"
+#include "utils/err.hpp"
+
+#include <algorithm>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef ZLINK_HAVE_LINUX
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+struct topology_t
+{
+    std::vector<zlink::numa_node_t> nodes;
+
+    //  Node id by CPU number, -1 for CPUs not listed under any node.
+    std::vector<int> cpu_nodes;
+};
+
+#ifdef ZLINK_HAVE_LINUX
+//  Parses a sysfs CPU list such as "0-3,8-11".
+void parse_cpu_list (const char *list_, std::set<int> &cpus_)
+{
+    const char *p = list_;
+    while (*p) {
+        char *end;
+        const long first = strtol (p, &end, 10);
+        if (end == p)
+            break;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol (p + 1, &end, 10);
+            if (end == p + 1)
+                break;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last; ++cpu)
+            cpus_.insert (static_cast<int> (cpu));
+        if (*p != ',')
+            break;
+        ++p;
+    }
+}
+
+void read_topology (topology_t &topology_)
+{
+    DIR *dir = opendir ("/sys/devices/system/node");
+    if (!dir)
+        return;
+    while (const struct dirent *entry = readdir (dir)) {
+        int id;
+        char tail;
+        if (sscanf (entry->d_name, "node%d%c", &id, &tail) != 1)
+            continue;
+
+        char path[64];
+        snprintf (path, sizeof (path), "/sys/devices/system/node/node%d/cpulist",
+                  id);
+        FILE *f = fopen (path, "r");
+        if (!f)
+            continue;
+        char list[1024] = "";
+        const bool ok = fgets (list, sizeof (list), f) != NULL;
+        fclose (f);
+        if (!ok)
+            continue;
+
+        zlink::numa_node_t node;
+        node.id = id;
+        parse_cpu_list (list, node.cpus);
+
+        //  Memory-only nodes have no CPUs to run I/O threads on.
+        if (!node.cpus.empty ())
+            topology_.nodes.push_back (node);
+    }
+    closedir (dir);
+}
+#endif
+
+bool lower_id (const zlink::numa_node_t &a_, const zlink::numa_node_t &b_)
+{
+    return a_.id < b_.id;
+}
+
+topology_t *create_topology ()
+{
+    topology_t *topology = new (std::nothrow) topology_t;
+    alloc_assert (topology);
+#ifdef ZLINK_HAVE_LINUX
+    read_topology (*topology);
+#endif
+    if (topology->nodes.empty ()) {
+        zlink::numa_node_t node;
+        node.id = 0;
+        topology->nodes.push_back (node);
+    }
+    std::sort (topology->nodes.begin (), topology->nodes.end (), lower_id);
+
+    for (size_t i = 0, size = topology->nodes.size (); i != size; ++i) {
+        const zlink::numa_node_t &node = topology->nodes[i];
+        for (std::set<int>::const_iterator it = node.cpus.begin (),
+                                           end = node.cpus.end ();
+             it != end; ++it) {
+            if (*it >= static_cast<int> (topology->cpu_nodes.size ()))
+                topology->cpu_nodes.resize (*it + 1, -1);
+            topology->cpu_nodes[*it] = node.id;
+        }
+    }
+    return topology;
+}
+
+//  Never destroyed, like the buffer pool: it may be consulted by threads
+//  that are still running while static destructors run at exit.
+const topology_t &topology ()
+{
+    static const topology_t *const instance = create_topology ();
+    return *instance;
+}
+}
+
+const std::vector<zlink::numa_node_t> &zlink::numa_nodes ()
+{
+    return topology ().nodes;
+}
+
+int zlink::numa_current_node ()
+{
+    const topology_t &t = topology ();
+    if (t.nodes.size () == 1)
+        return t.nodes[0].id;
+#ifdef ZLINK_HAVE_LINUX
+    const int cpu = sched_getcpu ();
+    if (cpu >= 0 && cpu < static_cast<int> (t.cpu_nodes.size ())
+        && t.cpu_nodes[cpu] >= 0)
+        return t.cpu_nodes[cpu];
+#endif
+    return t.nodes[0].id;
+}
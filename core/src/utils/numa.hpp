@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_NUMA_HPP_INCLUDED__
+#define __ZLINK_NUMA_HPP_INCLUDED__
+
+#include <set>
+#include <vector>
+
+namespace zlink
+{
+//  NUMA topology of the machine, read once per process. On Linux it comes
+//  from /sys/devices/system/node; elsewhere, or when that is unavailable,
+//  the machine is reported as a single node 0 without a CPU list.
+
+struct numa_node_t
+{
+    //  Node number as used by the operating system.
+    int id;
+
+    //  CPUs belonging to the node.
+    std::set<int> cpus;
+};
+
+//  Returns the nodes ordered by id. There is always at least one.
+const std::vector<numa_node_t> &numa_nodes ();
+
+//  Returns the id of the node the calling thread is running on. With a
+//  single node this is answered without asking the kernel.
+int numa_current_node ();
+}
+
+#endif
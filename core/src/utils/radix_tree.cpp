@@ -7,9 +7,81 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include <iterator>
 #include <vector>
 
+//  Edge search compares a byte against 32 or 16 first bytes at once when
+//  the compiler targets AVX2 or SSE2 (always the case on x86-64). A
+//  run-time dispatch would cost more than the search on typical nodes.
+#if defined __AVX2__
+#include <immintrin.h>
+#define ZLINK_RADIX_EDGE_VECTOR 32
+#elif defined __SSE2__ || defined _M_X64                                     \
+  || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZLINK_RADIX_EDGE_VECTOR 16
+#else
+#define ZLINK_RADIX_EDGE_VECTOR 1
+#endif
+
+#if defined _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+//  Index of the lowest set bit; value_ must not be zero.
+inline size_t lowest_bit (uint32_t value_)
+{
+#if defined __GNUC__ || defined __clang__
+    return __builtin_ctz (value_);
+#elif defined _MSC_VER
+    unsigned long index;
+    _BitScanForward (&index, value_);
+    return index;
+#else
+    size_t index = 0;
+    while (!(value_ & 1)) {
+        value_ >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+//  Number of leading bytes a_ and b_ have in common, up to size_,
+//  comparing a word at a time.
+inline size_t
+common_prefix (const unsigned char *a_, const unsigned char *b_, size_t size_)
+{
+    size_t i = 0;
+    for (; i + sizeof (uint64_t) <= size_; i += sizeof (uint64_t)) {
+        uint64_t a, b;
+        memcpy (&a, a_ + i, sizeof a);
+        memcpy (&b, b_ + i, sizeof b);
+        if (a != b)
+            break;
+    }
+    while (i < size_ && a_[i] == b_[i])
+        ++i;
+    return i;
+}
+
+//  Size of a node's data. A vector load at the last first byte must not
+//  run past the end of the node; the node pointers usually cover that.
+inline size_t node_size (size_t prefix_length_, size_t edgecount_)
+{
+    const size_t tail = edgecount_ * sizeof (void *);
+    const size_t padding =
+      edgecount_ > 0 && tail < ZLINK_RADIX_EDGE_VECTOR - 1
+        ? ZLINK_RADIX_EDGE_VECTOR - 1 - tail
+        : 0;
+    return 3 * sizeof (uint32_t) + prefix_length_ + edgecount_ + tail
+           + padding;
+}
+}
+
 node_t::node_t (unsigned char *data_) : _data (data_)
 {
 }
@@ -101,6 +173,44 @@ node_t node_t::node_at (size_t index_)
     return node_t (data);
 }
 
+size_t node_t::find_edge (unsigned char byte_)
+{
+    const unsigned char *const bytes = first_bytes ();
+    const size_t count = edgecount ();
+#if ZLINK_RADIX_EDGE_VECTOR == 32
+    const __m256i needle = _mm256_set1_epi8 (static_cast<char> (byte_));
+    for (size_t i = 0; i < count; i += 32) {
+        const __m256i chunk =
+          _mm256_loadu_si256 (reinterpret_cast<const __m256i *> (bytes + i));
+        uint32_t mask = static_cast<uint32_t> (
+          _mm256_movemask_epi8 (_mm256_cmpeq_epi8 (chunk, needle)));
+        if (count - i < 32)
+            mask &= (1u << (count - i)) - 1;
+        if (mask)
+            return i + lowest_bit (mask);
+    }
+    return count;
+#elif ZLINK_RADIX_EDGE_VECTOR == 16
+    const __m128i needle = _mm_set1_epi8 (static_cast<char> (byte_));
+    for (size_t i = 0; i < count; i += 16) {
+        const __m128i chunk =
+          _mm_loadu_si128 (reinterpret_cast<const __m128i *> (bytes + i));
+        uint32_t mask = static_cast<uint32_t> (
+          _mm_movemask_epi8 (_mm_cmpeq_epi8 (chunk, needle)));
+        if (count - i < 16)
+            mask &= (1u << (count - i)) - 1;
+        if (mask)
+            return i + lowest_bit (mask);
+    }
+    return count;
+#else
+    for (size_t i = 0; i < count; ++i)
+        if (bytes[i] == byte_)
+            return i;
+    return count;
+#endif
+}
+
 void node_t::set_node_at (size_t index_, node_t node_)
 {
     zlink_assert (index_ < edgecount ());
@@ -128,10 +238,8 @@ bool node_t::operator!= (node_t other_) const
 
 void node_t::resize (size_t prefix_length_, size_t edgecount_)
 {
-    const size_t node_size = 3 * sizeof (uint32_t) + prefix_length_
-                             + edgecount_ * (1 + sizeof (void *));
-    unsigned char *new_data =
-      static_cast<unsigned char *> (realloc (_data, node_size));
+    unsigned char *new_data = static_cast<unsigned char *> (
+      realloc (_data, node_size (prefix_length_, edgecount_)));
     zlink_assert (new_data);
     _data = new_data;
     set_prefix_length (static_cast<uint32_t> (prefix_length_));
@@ -140,10 +248,8 @@ void node_t::resize (size_t prefix_length_, size_t edgecount_)
 
 node_t make_node (size_t refcount_, size_t prefix_length_, size_t edgecount_)
 {
-    const size_t node_size = 3 * sizeof (uint32_t) + prefix_length_
-                             + edgecount_ * (1 + sizeof (void *));
-
-    unsigned char *data = static_cast<unsigned char *> (malloc (node_size));
+    unsigned char *data = static_cast<unsigned char *> (
+      malloc (node_size (prefix_length_, edgecount_)));
     zlink_assert (data);
 
     node_t node (data);
@@ -211,12 +317,10 @@ match_result_t zlink::radix_tree_t::match (const unsigned char *key_,
         const unsigned char *const prefix = current_node.prefix ();
         const size_t prefix_length = current_node.prefix_length ();
 
-        for (prefix_byte_index = 0;
-             prefix_byte_index < prefix_length && key_byte_index < key_size_;
-             ++prefix_byte_index, ++key_byte_index) {
-            if (prefix[prefix_byte_index] != key_[key_byte_index])
-                break;
-        }
+        prefix_byte_index =
+          common_prefix (prefix, key_ + key_byte_index,
+                         std::min (prefix_length, key_size_ - key_byte_index));
+        key_byte_index += prefix_byte_index;
 
         // Even if a prefix of the key matches and we're doing a
         // lookup, this means we've found a matching subscription.
@@ -233,19 +337,12 @@ match_result_t zlink::radix_tree_t::match (const unsigned char *key_,
 
         // We need to match the rest of the key. Check if there's an
         // outgoing edge from this node.
-        node_t next_node = current_node;
-        for (size_t i = 0, edgecount = current_node.edgecount (); i < edgecount;
-             ++i) {
-            if (current_node.first_byte_at (i) == key_[key_byte_index]) {
-                parent_edge_index = edge_index;
-                edge_index = i;
-                next_node = current_node.node_at (i);
-                break;
-            }
-        }
-
-        if (next_node == current_node)
+        const size_t i = current_node.find_edge (key_[key_byte_index]);
+        if (i == current_node.edgecount ())
             break; // No outgoing edge.
+        parent_edge_index = edge_index;
+        edge_index = i;
+        node_t next_node = current_node.node_at (i);
         grandparent_node = parent_node;
         parent_node = current_node;
         current_node = next_node;
@@ -34,6 +34,9 @@
 // The link to each child is looked up using its index, e.g. the child
 // with index 0 will have its first byte and node pointer at the start
 // of the chunk of first bytes and node pointers respectively.
+//
+// Nodes with few edges are padded at the end so that the chunk of first
+// bytes can be searched a whole vector register at a time.
 struct node_t
 {
     explicit node_t (unsigned char *data_);
@@ -49,6 +52,9 @@ struct node_t
     unsigned char first_byte_at (size_t index_);
     unsigned char *node_pointers ();
     node_t node_at (size_t index_);
+    //  Index of the edge whose first byte is byte_, or edgecount () if
+    //  there's none.
+    size_t find_edge (unsigned char byte_);
     void set_refcount (uint32_t value_);
     void set_prefix_length (uint32_t value_);
     void set_edgecount (uint32_t value_);
@@ -0,0 +1,323 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+#include "utils/timer_wheel.hpp"
+#include "utils/err.hpp"
+
+#include <new>
+
+#if defined _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+//  Index of the lowest set bit; value_ must not be zero.
+inline int lowest_bit (uint64_t value_)
+{
+#if defined __GNUC__ || defined __clang__
+    return __builtin_ctzll (value_);
+#elif defined _MSC_VER && defined _WIN64
+    unsigned long index;
+    _BitScanForward64 (&index, value_);
+    return static_cast<int> (index);
+#else
+    int index = 0;
+    while (!(value_ & 1)) {
+        value_ >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+//  Index of the highest set bit; value_ must not be zero.
+inline int highest_bit (uint64_t value_)
+{
+#if defined __GNUC__ || defined __clang__
+    return 63 - __builtin_clzll (value_);
+#elif defined _MSC_VER && defined _WIN64
+    unsigned long index;
+    _BitScanReverse64 (&index, value_);
+    return static_cast<int> (index);
+#else
+    int index = 0;
+    while (value_ >>= 1)
+        ++index;
+    return index;
+#endif
+}
+
+inline uint64_t rotate_right (uint64_t value_, int count_)
+{
+    return count_ == 0 ? value_ : (value_ >> count_) | (value_ << (64 - count_));
+}
+}
+
+zlink::timer_wheel_t::timer_wheel_t () : _now (0), _count (0), _free (NULL)
+{
+    //  A level's occupancy is one 64-bit word.
+    static_assert (timer_wheel_slot_bits == 6, "slots must fill the bitmap");
+    static_assert (timer_wheel_slot_bits * timer_wheel_levels < 64,
+                   "wheel span too large");
+
+    for (int level = 0; level != level_count; ++level) {
+        for (int slot = 0; slot != slot_count; ++slot)
+            list_init (&_slots[level][slot]);
+        _occupied[level] = 0;
+    }
+    list_init (&_overflow);
+    list_init (&_expired);
+}
+
+zlink::timer_wheel_t::~timer_wheel_t ()
+{
+    for (size_t i = 0, n = _buckets.size (); i != n; ++i)
+        while (node_t *node = _buckets[i]) {
+            _buckets[i] = node->hash_next;
+            delete node;
+        }
+    while (node_t *node = _free) {
+        _free = node->hash_next;
+        delete node;
+    }
+}
+
+void zlink::timer_wheel_t::add (uint64_t now_,
+                                uint64_t timeout_,
+                                void *sink_,
+                                int id_)
+{
+    //  An empty wheel can jump to the current time at no cost, which
+    //  keeps the timer in the lowest level its timeout allows.
+    if (_count == 0 && now_ > _now)
+        _now = now_;
+
+    node_t *node = _free;
+    if (node)
+        _free = node->hash_next;
+    else {
+        node = new (std::nothrow) node_t;
+        alloc_assert (node);
+    }
+    node->expiry = now_ + timeout_;
+    node->sink = sink_;
+    node->id = id_;
+
+    place (node);
+    hash_insert (node);
+}
+
+bool zlink::timer_wheel_t::cancel (void *sink_, int id_)
+{
+    if (_count == 0)
+        return false;
+
+    node_t *node = _buckets[bucket (sink_, id_)];
+    while (node && (node->sink != sink_ || node->id != id_))
+        node = node->hash_next;
+    if (!node)
+        return false;
+
+    unlink (node);
+    hash_remove (node);
+    node->hash_next = _free;
+    _free = node;
+    return true;
+}
+
+void zlink::timer_wheel_t::advance (uint64_t now_)
+{
+    if (now_ <= _now)
+        return;
+
+    //  Take every timer out of the slots the wheel moves past, then put
+    //  them back relative to the new time. Those that are due end up on
+    //  the expired list, the others in a lower level than before.
+    link_t pending;
+    list_init (&pending);
+    for (int level = 0; level != level_count; ++level) {
+        const int shift = level * timer_wheel_slot_bits;
+        const uint64_t from = _now >> shift;
+        const uint64_t to = now_ >> shift;
+        if (from == to)
+            break;
+
+        uint64_t passed = ~static_cast<uint64_t> (0);
+        if (to - from < slot_count) {
+            //  Slots from + 1 up to and including to.
+            const uint64_t run = (static_cast<uint64_t> (1) << (to - from)) - 1;
+            const int first = static_cast<int> ((from + 1) & (slot_count - 1));
+            passed = rotate_right (run, (64 - first) & 63);
+        }
+        uint64_t due = _occupied[level] & passed;
+        while (due) {
+            const int slot = lowest_bit (due);
+            due &= due - 1;
+            list_splice (&pending, &_slots[level][slot]);
+        }
+        _occupied[level] &= ~passed;
+    }
+    const int top_shift = level_count * timer_wheel_slot_bits;
+    if ((_now >> top_shift) != (now_ >> top_shift))
+        list_splice (&pending, &_overflow);
+
+    _now = now_;
+    while (pending.next != &pending) {
+        node_t *node = static_cast<node_t *> (pending.next);
+        list_unlink (node);
+        place (node);
+    }
+}
+
+bool zlink::timer_wheel_t::pop (uint64_t now_, void **sink_, int *id_)
+{
+    if (_count == 0)
+        return false;
+
+    advance (now_);
+    if (_expired.next == &_expired)
+        return false;
+
+    node_t *node = static_cast<node_t *> (_expired.next);
+    *sink_ = node->sink;
+    *id_ = node->id;
+    list_unlink (node);
+    hash_remove (node);
+    node->hash_next = _free;
+    _free = node;
+    return true;
+}
+
+uint64_t zlink::timer_wheel_t::next_expiry () const
+{
+    if (_count == 0)
+        return UINT64_MAX;
+    if (_expired.next != &_expired)
+        return _now;
+
+    //  A lower level always comes due before a higher one, so the first
+    //  occupied level decides.
+    for (int level = 0; level != level_count; ++level) {
+        if (!_occupied[level])
+            continue;
+        const int shift = level * timer_wheel_slot_bits;
+        const uint64_t current = _now >> shift;
+        const int first = static_cast<int> ((current + 1) & (slot_count - 1));
+        const uint64_t ahead = rotate_right (_occupied[level], first);
+        return (current + 1 + lowest_bit (ahead)) << shift;
+    }
+
+    const int top_shift = level_count * timer_wheel_slot_bits;
+    return ((_now >> top_shift) + 1) << top_shift;
+}
+
+void zlink::timer_wheel_t::list_init (link_t *list_)
+{
+    list_->prev = list_;
+    list_->next = list_;
+}
+
+void zlink::timer_wheel_t::list_push (link_t *list_, node_t *node_)
+{
+    node_->prev = list_->prev;
+    node_->next = list_;
+    list_->prev->next = node_;
+    list_->prev = node_;
+}
+
+void zlink::timer_wheel_t::list_splice (link_t *to_, link_t *from_)
+{
+    if (from_->next == from_)
+        return;
+    from_->next->prev = to_->prev;
+    to_->prev->next = from_->next;
+    from_->prev->next = to_;
+    to_->prev = from_->prev;
+    list_init (from_);
+}
+
+void zlink::timer_wheel_t::list_unlink (node_t *node_)
+{
+    node_->prev->next = node_->next;
+    node_->next->prev = node_->prev;
+}
+
+void zlink::timer_wheel_t::place (node_t *node_)
+{
+    if (node_->expiry <= _now) {
+        node_->level = -1;
+        list_push (&_expired, node_);
+        return;
+    }
+
+    //  The highest bit group in which expiry and now differ picks the
+    //  level; the groups above it are equal, so the slot lies ahead of
+    //  the wheel's current position at that level.
+    const int level =
+      highest_bit (node_->expiry ^ _now) / timer_wheel_slot_bits;
+    if (level >= level_count) {
+        node_->level = -1;
+        list_push (&_overflow, node_);
+        return;
+    }
+    const int slot =
+      static_cast<int> ((node_->expiry >> (level * timer_wheel_slot_bits))
+                        & (slot_count - 1));
+    node_->level = level;
+    node_->slot = slot;
+    list_push (&_slots[level][slot], node_);
+    _occupied[level] |= static_cast<uint64_t> (1) << slot;
+}
+
+void zlink::timer_wheel_t::unlink (node_t *node_)
+{
+    list_unlink (node_);
+    if (node_->level >= 0) {
+        link_t *slot = &_slots[node_->level][node_->slot];
+        if (slot->next == slot)
+            _occupied[node_->level] &= ~(static_cast<uint64_t> (1)
+                                         << node_->slot);
+    }
+}
+
+size_t zlink::timer_wheel_t::bucket (void *sink_, int id_) const
+{
+    uint64_t hash = reinterpret_cast<uintptr_t> (sink_)
+                    ^ static_cast<uint64_t> (static_cast<unsigned int> (id_))
+                        * 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 29;
+    return static_cast<size_t> (hash) & (_buckets.size () - 1);
+}
+
+void zlink::timer_wheel_t::hash_insert (node_t *node_)
+{
+    if (_count >= _buckets.size ())
+        rehash (_buckets.empty () ? 64 : _buckets.size () * 2);
+    const size_t index = bucket (node_->sink, node_->id);
+    node_->hash_next = _buckets[index];
+    _buckets[index] = node_;
+    ++_count;
+}
+
+void zlink::timer_wheel_t::hash_remove (node_t *node_)
+{
+    node_t **link = &_buckets[bucket (node_->sink, node_->id)];
+    while (*link != node_)
+        link = &(*link)->hash_next;
+    *link = node_->hash_next;
+    --_count;
+}
+
+void zlink::timer_wheel_t::rehash (size_t buckets_)
+{
+    std::vector<node_t *> buckets (buckets_, static_cast<node_t *> (NULL));
+    _buckets.swap (buckets);
+    for (size_t i = 0, n = buckets.size (); i != n; ++i)
+        while (node_t *node = buckets[i]) {
+            buckets[i] = node->hash_next;
+            const size_t index = bucket (node->sink, node->id);
+            node->hash_next = _buckets[index];
+            _buckets[index] = node;
+        }
+}
@@ -0,0 +1,120 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_TIMER_WHEEL_HPP_INCLUDED__
+#define __ZLINK_TIMER_WHEEL_HPP_INCLUDED__
+
+#include <stddef.h>
+#include <vector>
+
+#include "utils/config.hpp"
+#include "utils/macros.hpp"
+#include "utils/stdint.hpp"
+
+namespace zlink
+{
+//  Hierarchical timing wheel keyed by (sink, id) pairs, with times in
+//  milliseconds. Level k has 2^timer_wheel_slot_bits slots, each covering
+//  2^(k * timer_wheel_slot_bits) ms; a timer is kept in the lowest level
+//  whose span reaches its expiry and moves down as the wheel advances.
+//  Timers further out than the top level wait on an overflow list.
+//
+//  Arming and cancelling are O(1): both take a node from a free list and
+//  link or unlink it, and cancel finds the node through an intrusive hash
+//  of its (sink, id) key. Advancing touches only occupied slots, found
+//  through one bitmap per level.
+//
+//  The same (sink, id) may be armed more than once; cancel removes one of
+//  the timers. Not thread-safe.
+
+class timer_wheel_t
+{
+  public:
+    timer_wheel_t ();
+    ~timer_wheel_t ();
+
+    //  Arms a timer for (sink_, id_) expiring timeout_ ms after now_.
+    void add (uint64_t now_, uint64_t timeout_, void *sink_, int id_);
+
+    //  Cancels a timer armed for (sink_, id_). Returns false if there is
+    //  none, e.g. because it has expired already.
+    bool cancel (void *sink_, int id_);
+
+    //  Moves the timers due at now_ to the expired list.
+    void advance (uint64_t now_);
+
+    //  Advances to now_ and takes the first expired timer off the wheel.
+    //  Returns false if no timer is due. Timers may be armed and cancelled
+    //  between calls.
+    bool pop (uint64_t now_, void **sink_, int *id_);
+
+    //  Returns the time by which the wheel has to be advanced next, or
+    //  UINT64_MAX if no timer is armed. Exact for timers within the first
+    //  level; for later ones it is the time they move down a level, so a
+    //  caller waiting for it may wake up early but never late.
+    uint64_t next_expiry () const;
+
+    bool empty () const { return _count == 0; }
+    size_t size () const { return _count; }
+
+  private:
+    enum
+    {
+        slot_count = 1 << timer_wheel_slot_bits,
+        level_count = timer_wheel_levels
+    };
+
+    struct link_t
+    {
+        link_t *prev;
+        link_t *next;
+    };
+
+    struct node_t : link_t
+    {
+        uint64_t expiry;
+        void *sink;
+        int id;
+
+        //  Level and slot the timer is linked into, or -1 while it is on
+        //  the overflow or the expired list.
+        int level;
+        int slot;
+
+        //  Next node in the same hash bucket, or in the free list.
+        node_t *hash_next;
+    };
+
+    static void list_init (link_t *list_);
+    static void list_push (link_t *list_, node_t *node_);
+    static void list_splice (link_t *to_, link_t *from_);
+    static void list_unlink (node_t *node_);
+
+    //  Links the node into the list matching its expiry.
+    void place (node_t *node_);
+
+    //  Unlinks the node from its list, clearing the slot bit if needed.
+    void unlink (node_t *node_);
+
+    size_t bucket (void *sink_, int id_) const;
+    void hash_insert (node_t *node_);
+    void hash_remove (node_t *node_);
+    void rehash (size_t buckets_);
+
+    //  Time up to which the wheel has been advanced.
+    uint64_t _now;
+
+    size_t _count;
+
+    link_t _slots[level_count][slot_count];
+    uint64_t _occupied[level_count];
+    link_t _overflow;
+    link_t _expired;
+
+    std::vector<node_t *> _buckets;
+    node_t *_free;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (timer_wheel_t)
+};
+}
+
+#endif
@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_TOPIC_LIST_HPP_INCLUDED__
+#define __ZLINK_TOPIC_LIST_HPP_INCLUDED__
+
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+#include "protocol/wire.hpp"
+
+namespace zlink
+{
+//  A packed topic list, as taken by ZLINK_SUBSCRIBE_BULK and carried by
+//  bulk subscribe/cancel messages, is a sequence of topics, each its size
+//  as a 4-byte big-endian integer followed by its bytes.
+
+//  Steps *pos_ over the next topic of the list ending at end_, storing
+//  the topic in *topic_ and *size_. Returns false at the end of the list
+//  or if what is left of it is malformed.
+inline bool next_topic (const unsigned char **pos_,
+                        const unsigned char *end_,
+                        const unsigned char **topic_,
+                        size_t *size_)
+{
+    if (static_cast<size_t> (end_ - *pos_) < 4)
+        return false;
+    const size_t size = get_uint32 (*pos_);
+    if (static_cast<size_t> (end_ - *pos_) - 4 < size)
+        return false;
+    *topic_ = *pos_ + 4;
+    *size_ = size;
+    *pos_ += 4 + size;
+    return true;
+}
+
+//  Checks that the list is well formed.
+inline bool is_topic_list (const unsigned char *data_, size_t size_)
+{
+    const unsigned char *pos = data_;
+    const unsigned char *end = data_ + size_;
+    const unsigned char *topic;
+    size_t topic_size;
+    while (next_topic (&pos, end, &topic, &topic_size))
+        ;
+    return pos == end;
+}
+
+//  Appends the topic to the list.
+inline void
+add_topic (std::vector<unsigned char> &list_, const unsigned char *topic_, size_t size_)
+{
+    const size_t pos = list_.size ();
+    list_.resize (pos + 4 + size_);
+    put_uint32 (&list_[pos], static_cast<uint32_t> (size_));
+    if (size_ > 0)
+        memcpy (&list_[pos + 4], topic_, size_);
+}
+}
+
+#endif
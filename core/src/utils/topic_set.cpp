@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "utils/precompiled.hpp"
+#include "utils/topic_set.hpp"
+
+zlink::topic_set_t::topic_set_t ()
+{
+}
+
+zlink::topic_set_t::~topic_set_t ()
+{
+}
+
+bool zlink::topic_set_t::add (const unsigned char *topic_, size_t size_)
+{
+    topics_t::iterator it = _topics.find (
+      blob_t (const_cast<unsigned char *> (topic_), size_, reference_tag_t ()));
+    if (it != _topics.end ()) {
+        ++it->second;
+        return false;
+    }
+    _topics.ZLINK_MAP_INSERT_OR_EMPLACE (blob_t (topic_, size_), 1u);
+    _num_prefixes.add (1);
+    return true;
+}
+
+bool zlink::topic_set_t::rm (const unsigned char *topic_, size_t size_)
+{
+    topics_t::iterator it = _topics.find (
+      blob_t (const_cast<unsigned char *> (topic_), size_, reference_tag_t ()));
+    if (it == _topics.end ())
+        return false;
+    if (--it->second > 0)
+        return false;
+    _topics.erase (it);
+    _num_prefixes.sub (1);
+    return true;
+}
+
+bool zlink::topic_set_t::check (const unsigned char *topic_, size_t size_) const
+{
+    return _topics.find (
+             blob_t (const_cast<unsigned char *> (topic_), size_,
+                     reference_tag_t ()))
+           != _topics.end ();
+}
+
+void zlink::topic_set_t::apply (void (*func_) (unsigned char *data_,
+                                               size_t size_,
+                                               void *arg_),
+                                void *arg_)
+{
+    for (topics_t::iterator it = _topics.begin (), end = _topics.end ();
+         it != end; ++it)
+        func_ (const_cast<unsigned char *> (it->first.data ()),
+               it->first.size (), arg_);
+}
@@ -0,0 +1,241 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#ifndef __ZLINK_TOPIC_SET_HPP_INCLUDED__
+#define __ZLINK_TOPIC_SET_HPP_INCLUDED__
+
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/macros.hpp"
+#include "utils/stdint.hpp"
+#include "utils/atomic_counter.hpp"
+#include "utils/blob.hpp"
+#include "utils/blob_hash.hpp"
+
+namespace zlink
+{
+//  With a topic delimiter set (ZLINK_TOPIC_DELIMITER), the topic of a
+//  message is its bytes up to and including the first delimiter. A
+//  subscription holding exactly one delimiter, as its last byte, matches
+//  a message as a prefix iff it equals the message's topic, so such
+//  subscriptions can be looked up with one hash instead of a trie walk.
+
+//  Returns true if the subscription is an exact topic for delimiter_
+//  (-1 meaning none).
+inline bool
+is_exact_topic (const unsigned char *data_, size_t size_, int delimiter_)
+{
+    return delimiter_ >= 0 && size_ > 0 && data_[size_ - 1] == delimiter_
+           && !memchr (data_, delimiter_, size_ - 1);
+}
+
+//  Returns the size of the topic of a message, or 0 if it has none.
+inline size_t
+topic_size (const unsigned char *data_, size_t size_, int delimiter_)
+{
+    const void *end = memchr (data_, delimiter_, size_);
+    return end ? static_cast<const unsigned char *> (end) - data_ + 1 : 0;
+}
+
+//  Exact topics with a reference count each; the hash table counterpart
+//  of trie_with_size_t for XSUB.
+class topic_set_t
+{
+  public:
+    topic_set_t ();
+    ~topic_set_t ();
+
+    //  Add the topic. Returns true if it was not in the set before.
+    bool add (const unsigned char *topic_, size_t size_);
+
+    //  Drop a reference to the topic. Returns true if the topic is
+    //  actually removed from the set.
+    bool rm (const unsigned char *topic_, size_t size_);
+
+    //  Check whether the topic is in the set.
+    bool check (const unsigned char *topic_, size_t size_) const;
+
+    //  Apply the function supplied to each topic in the set.
+    void apply (void (*func_) (unsigned char *data_, size_t size_, void *arg_),
+                void *arg_);
+
+    bool empty () const { return _topics.empty (); }
+
+    //  Number of topics in the set. Note this is a multithread safe
+    //  function.
+    uint32_t num_prefixes () const { return _num_prefixes.get (); }
+
+  private:
+    typedef std::unordered_map<blob_t, uint32_t, blob_hash, blob_equal>
+      topics_t;
+    topics_t _topics;
+    atomic_counter_t _num_prefixes;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (topic_set_t)
+};
+
+//  Exact topics mapped to the values subscribed to them; the hash table
+//  counterpart of generic_mtrie_t for XPUB.
+template <typename T> class generic_topic_map_t
+{
+  public:
+    typedef T value_t;
+
+    enum rm_result
+    {
+        not_found,
+        last_value_removed,
+        values_remain
+    };
+
+    generic_topic_map_t () {}
+
+    //  Add the value to the topic. Returns true iff the topic had no
+    //  values before.
+    bool add (const unsigned char *topic_, size_t size_, value_t *value_);
+
+    //  Remove the value from every topic, with the same callback semantics
+    //  as generic_mtrie_t::rm.
+    template <typename Arg>
+    void rm (value_t *value_,
+             void (*func_) (const unsigned char *data_, size_t size_, Arg arg_),
+             Arg arg_,
+             bool call_on_uniq_);
+
+    //  Remove the value from the topic.
+    rm_result rm (const unsigned char *topic_, size_t size_, value_t *value_);
+
+    //  Calls a callback function for each value of the topic.
+    template <typename Arg>
+    void match (const unsigned char *topic_,
+                size_t size_,
+                void (*func_) (value_t *value_, Arg arg_),
+                Arg arg_);
+
+    //  Calls a callback function for each topic with at least one value.
+    template <typename Arg>
+    void apply (void (*func_) (const unsigned char *data_, size_t size_, Arg arg_),
+                Arg arg_);
+
+    bool empty () const { return _topics.empty (); }
+
+    //  Number of topics with at least one value. Note this is a multithread
+    //  safe function.
+    uint32_t num_prefixes () const { return _num_prefixes.get (); }
+
+  private:
+    typedef std::vector<value_t *> values_t;
+    typedef std::unordered_map<blob_t, values_t, blob_hash, blob_equal>
+      topics_t;
+    topics_t _topics;
+    atomic_counter_t _num_prefixes;
+
+    ZLINK_NON_COPYABLE_NOR_MOVABLE (generic_topic_map_t)
+};
+
+template <typename T>
+bool generic_topic_map_t<T>::add (const unsigned char *topic_,
+                                  size_t size_,
+                                  value_t *value_)
+{
+    typename topics_t::iterator it = _topics.find (
+      blob_t (const_cast<unsigned char *> (topic_), size_, reference_tag_t ()));
+    if (it == _topics.end ()) {
+        _topics.ZLINK_MAP_INSERT_OR_EMPLACE (blob_t (topic_, size_),
+                                             values_t (1, value_));
+        _num_prefixes.add (1);
+        return true;
+    }
+    //  Like the trie, hold each value once per topic.
+    if (std::find (it->second.begin (), it->second.end (), value_)
+        == it->second.end ())
+        it->second.push_back (value_);
+    return false;
+}
+
+template <typename T>
+template <typename Arg>
+void generic_topic_map_t<T>::rm (value_t *value_,
+                                 void (*func_) (const unsigned char *data_,
+                                                size_t size_,
+                                                Arg arg_),
+                                 Arg arg_,
+                                 bool call_on_uniq_)
+{
+    typename topics_t::iterator it = _topics.begin ();
+    while (it != _topics.end ()) {
+        values_t &values = it->second;
+        const typename values_t::iterator pos =
+          std::find (values.begin (), values.end (), value_);
+        if (pos == values.end ()) {
+            ++it;
+            continue;
+        }
+        values.erase (pos);
+        if (!call_on_uniq_ || values.empty ())
+            func_ (it->first.data (), it->first.size (), arg_);
+        if (values.empty ()) {
+            it = _topics.erase (it);
+            _num_prefixes.sub (1);
+        } else
+            ++it;
+    }
+}
+
+template <typename T>
+typename generic_topic_map_t<T>::rm_result generic_topic_map_t<T>::rm (
+  const unsigned char *topic_, size_t size_, value_t *value_)
+{
+    typename topics_t::iterator it = _topics.find (
+      blob_t (const_cast<unsigned char *> (topic_), size_, reference_tag_t ()));
+    if (it == _topics.end ())
+        return not_found;
+    values_t &values = it->second;
+    const typename values_t::iterator pos =
+      std::find (values.begin (), values.end (), value_);
+    if (pos == values.end ())
+        return not_found;
+    values.erase (pos);
+    if (!values.empty ())
+        return values_remain;
+    _topics.erase (it);
+    _num_prefixes.sub (1);
+    return last_value_removed;
+}
+
+template <typename T>
+template <typename Arg>
+void generic_topic_map_t<T>::match (const unsigned char *topic_,
+                                    size_t size_,
+                                    void (*func_) (value_t *value_, Arg arg_),
+                                    Arg arg_)
+{
+    typename topics_t::iterator it = _topics.find (
+      blob_t (const_cast<unsigned char *> (topic_), size_, reference_tag_t ()));
+    if (it == _topics.end ())
+        return;
+    const values_t &values = it->second;
+    for (typename values_t::size_type i = 0, n = values.size (); i != n; ++i)
+        func_ (values[i], arg_);
+}
+
+template <typename T>
+template <typename Arg>
+void generic_topic_map_t<T>::apply (void (*func_) (const unsigned char *data_,
+                                                   size_t size_,
+                                                   Arg arg_),
+                                    Arg arg_)
+{
+    for (typename topics_t::iterator it = _topics.begin (), end = _topics.end ();
+         it != end; ++it)
+        func_ (it->first.data (), it->first.size (), arg_);
+}
+
+class pipe_t;
+typedef generic_topic_map_t<pipe_t> topic_map_t;
+}
+
+#endif
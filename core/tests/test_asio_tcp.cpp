@@ -380,6 +380,191 @@ void test_socket_bounce ()
     test_context_socket_close (server);
 }
 
+// Test 11: Accept sharding across I/O threads (SO_REUSEPORT group)
+void test_accept_shards ()
+{
+    void *ctx = zlink_ctx_new ();
+    TEST_ASSERT_NOT_NULL (ctx);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_ctx_set (ctx, ZLINK_IO_THREADS, 4));
+
+    void *router = zlink_socket (ctx, ZLINK_ROUTER);
+    TEST_ASSERT_NOT_NULL (router);
+
+    int shards = -1;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      router, ZLINK_TCP_ACCEPT_SHARDS, &shards, sizeof (shards)));
+    int cpu_affinity = 1;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      router, ZLINK_TCP_ACCEPT_CPU_AFFINITY, &cpu_affinity,
+      sizeof (cpu_affinity)));
+
+    int value = 0;
+    size_t value_len = sizeof (value);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (router, ZLINK_TCP_ACCEPT_SHARDS, &value, &value_len));
+    TEST_ASSERT_EQUAL_INT (-1, value);
+
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (router, "tcp://127.0.0.1:*"));
+
+    char endpoint[MAX_SOCKET_STRING];
+    size_t endpoint_len = sizeof (endpoint);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (router, ZLINK_LAST_ENDPOINT, endpoint, &endpoint_len));
+
+    //  Whichever acceptor takes a connection, all of them must end up
+    //  routable through the one socket.
+    const int dealer_count = 16;
+    void *dealers[dealer_count];
+    for (int i = 0; i < dealer_count; ++i) {
+        dealers[i] = zlink_socket (ctx, ZLINK_DEALER);
+        TEST_ASSERT_NOT_NULL (dealers[i]);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (dealers[i], endpoint));
+        send_string_expect_success (dealers[i], "hello", 0);
+    }
+
+    for (int i = 0; i < dealer_count; ++i) {
+        zlink_msg_t routing_id;
+        zlink_msg_init (&routing_id);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_msg_recv (&routing_id, router, 0));
+        recv_string_expect_success (router, "hello", 0);
+        TEST_ASSERT_SUCCESS_ERRNO (
+          zlink_msg_send (&routing_id, router, ZLINK_SNDMORE));
+        send_string_expect_success (router, "world", 0);
+    }
+    for (int i = 0; i < dealer_count; ++i)
+        recv_string_expect_success (dealers[i], "world", 0);
+
+    //  Unbinding tears down every acceptor so the port can be reused.
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_unbind (router, endpoint));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (router, endpoint));
+
+    for (int i = 0; i < dealer_count; ++i)
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_close (dealers[i]));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_close (router));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_ctx_term (ctx));
+}
+
+// Test 12: Coalescing delay for small writes
+void test_coalesce_delay ()
+{
+    void *server = test_context_socket (ZLINK_PAIR);
+    void *client = test_context_socket (ZLINK_PAIR);
+
+    const int delay = 500;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      server, ZLINK_COALESCE_DELAY, &delay, sizeof (delay)));
+    int value = 0;
+    size_t value_len = sizeof (value);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (server, ZLINK_COALESCE_DELAY, &value, &value_len));
+    TEST_ASSERT_EQUAL_INT (delay, value);
+
+    const int invalid = -1;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (server, ZLINK_COALESCE_DELAY, &invalid,
+                                sizeof (invalid)));
+
+    char endpoint[MAX_SOCKET_STRING];
+    bind_loopback_ipv4 (server, endpoint, sizeof (endpoint));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (client, endpoint));
+
+    msleep (SETTLE_TIME);
+
+    //  A lone small message still leaves once the delay expires.
+    send_string_expect_success (server, "single", 0);
+    recv_string_expect_success (client, "single", 0);
+
+    //  Held batches keep message order across timer flushes.
+    const int num_messages = 1000;
+    for (int i = 0; i < num_messages; i++) {
+        char msg[32];
+        snprintf (msg, sizeof (msg), "Message %d", i);
+        send_string_expect_success (server, msg, 0);
+    }
+    for (int i = 0; i < num_messages; i++) {
+        char expected[32];
+        snprintf (expected, sizeof (expected), "Message %d", i);
+        recv_string_expect_success (client, expected, 0);
+    }
+
+    test_context_socket_close (client);
+    test_context_socket_close (server);
+}
+
+// Test 13: Low-memory mode keeps working across idle buffer release
+void test_low_memory ()
+{
+    void *server = test_context_socket (ZLINK_PAIR);
+    void *client = test_context_socket (ZLINK_PAIR);
+
+    int value = -1;
+    size_t value_len = sizeof (value);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (server, ZLINK_LOW_MEMORY, &value, &value_len));
+    TEST_ASSERT_EQUAL_INT (0, value);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (server, ZLINK_LOW_MEMORY_IDLE_IVL, &value, &value_len));
+    TEST_ASSERT_EQUAL_INT (1000, value);
+    const int invalid = 0;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (server, ZLINK_LOW_MEMORY_IDLE_IVL, &invalid,
+                                sizeof (invalid)));
+
+    const int enabled = 1;
+    const int idle_ivl = 50;
+    void *sockets[2] = {server, client};
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+          sockets[i], ZLINK_LOW_MEMORY, &enabled, sizeof (enabled)));
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+          sockets[i], ZLINK_LOW_MEMORY_IDLE_IVL, &idle_ivl, sizeof (idle_ivl)));
+    }
+
+    char endpoint[MAX_SOCKET_STRING];
+    bind_loopback_ipv4 (server, endpoint, sizeof (endpoint));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (client, endpoint));
+
+    msleep (SETTLE_TIME);
+    bounce (server, client);
+
+    //  Let both engines release their buffers, then wake them up with a
+    //  burst that grows the pipes well past their initial chunk.
+    msleep (idle_ivl * 4);
+    const int num_messages = 1000;
+    for (int i = 0; i < num_messages; i++) {
+        char msg[32];
+        snprintf (msg, sizeof (msg), "Message %d", i);
+        send_string_expect_success (client, msg, 0);
+    }
+    for (int i = 0; i < num_messages; i++) {
+        char expected[32];
+        snprintf (expected, sizeof (expected), "Message %d", i);
+        recv_string_expect_success (server, expected, 0);
+    }
+
+    //  Once more after the pipes have drained, with a message larger than
+    //  the engine buffers.
+    msleep (idle_ivl * 4);
+    const size_t large_size = 100 * 1024;
+    char *sent = static_cast<char *> (malloc (large_size));
+    char *received = static_cast<char *> (malloc (large_size));
+    TEST_ASSERT_NOT_NULL (sent);
+    TEST_ASSERT_NOT_NULL (received);
+    for (size_t i = 0; i < large_size; i++)
+        sent[i] = static_cast<char> (i % 251);
+    TEST_ASSERT_EQUAL_INT (static_cast<int> (large_size),
+                           zlink_send (server, sent, large_size, 0));
+    TEST_ASSERT_EQUAL_INT (static_cast<int> (large_size),
+                           zlink_recv (client, received, large_size, 0));
+    TEST_ASSERT_EQUAL_MEMORY (sent, received, large_size);
+    free (sent);
+    free (received);
+    bounce (server, client);
+
+    test_context_socket_close (client);
+    test_context_socket_close (server);
+}
+
 #else  // !ZLINK_IOTHREAD_POLLER_USE_ASIO
 
 void setUp ()
@@ -415,6 +600,9 @@ int main ()
     RUN_TEST (test_xpub_xsub_pattern);
     RUN_TEST (test_hwm_behavior);
     RUN_TEST (test_socket_bounce);
+    RUN_TEST (test_accept_shards);
+    RUN_TEST (test_coalesce_delay);
+    RUN_TEST (test_low_memory);
 #else
     RUN_TEST (test_asio_tcp_not_enabled);
 #endif
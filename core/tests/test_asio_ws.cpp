@@ -657,6 +657,216 @@ void test_zlink_ws_with_path ()
     teardown_zlink_ctx ();
 }
 
+static void set_ws_deflate (void *socket_, int enabled_)
+{
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (socket_, ZLINK_WS_DEFLATE, &enabled_, sizeof (enabled_)));
+    const int window_bits = 12;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      socket_, ZLINK_WS_DEFLATE_SERVER_WINDOW_BITS, &window_bits,
+      sizeof (window_bits)));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      socket_, ZLINK_WS_DEFLATE_CLIENT_WINDOW_BITS, &window_bits,
+      sizeof (window_bits)));
+    const int threshold = 64;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      socket_, ZLINK_WS_DEFLATE_THRESHOLD, &threshold, sizeof (threshold)));
+}
+
+static void ws_deflate_roundtrip (int server_deflate_, int client_deflate_)
+{
+    void *server = zlink_socket (g_ctx, ZLINK_PAIR);
+    void *client = zlink_socket (g_ctx, ZLINK_PAIR);
+    TEST_ASSERT_NOT_NULL (server);
+    TEST_ASSERT_NOT_NULL (client);
+    set_ws_deflate (server, server_deflate_);
+    set_ws_deflate (client, client_deflate_);
+
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (server, "ws://127.0.0.1:*"));
+    char endpoint[256];
+    size_t endpoint_len = sizeof (endpoint);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (server, ZLINK_LAST_ENDPOINT, endpoint, &endpoint_len));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (client, endpoint));
+
+    //  Below the threshold, then a large compressible message each way
+    send_string_expect_success (client, "small", 0);
+    recv_string_expect_success (server, "small", 0);
+
+    std::string snapshot;
+    for (int i = 0; i < 512; ++i)
+        snapshot += "{\"symbol\":\"BTC-USD\",\"bid\":1,\"ask\":2},";
+    std::vector<char> buf (snapshot.size () + 1);
+    for (int i = 0; i < 2; ++i) {
+        void *from = i == 0 ? client : server;
+        void *to = i == 0 ? server : client;
+        TEST_ASSERT_EQUAL_INT (
+          static_cast<int> (snapshot.size ()),
+          zlink_send (from, snapshot.data (), snapshot.size (), 0));
+        TEST_ASSERT_EQUAL_INT (static_cast<int> (snapshot.size ()),
+                               zlink_recv (to, &buf[0], buf.size (), 0));
+        TEST_ASSERT_EQUAL_MEMORY (snapshot.data (), &buf[0], snapshot.size ());
+    }
+
+    zlink_close (client);
+    zlink_close (server);
+}
+
+//  Test 11: ZLINK WebSocket with permessage-deflate
+void test_zlink_ws_deflate ()
+{
+    setup_zlink_ctx ();
+
+    void *socket = zlink_socket (g_ctx, ZLINK_PAIR);
+    TEST_ASSERT_NOT_NULL (socket);
+    int value = -1;
+    size_t value_len = sizeof (value);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (socket, ZLINK_WS_DEFLATE, &value, &value_len));
+    TEST_ASSERT_EQUAL_INT (0, value);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_getsockopt (
+      socket, ZLINK_WS_DEFLATE_SERVER_WINDOW_BITS, &value, &value_len));
+    TEST_ASSERT_EQUAL_INT (15, value);
+    const int too_small = 8;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (socket, ZLINK_WS_DEFLATE_CLIENT_WINDOW_BITS,
+                                &too_small, sizeof (too_small)));
+    const int too_large = 16;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (socket, ZLINK_WS_DEFLATE_SERVER_WINDOW_BITS,
+                                &too_large, sizeof (too_large)));
+    zlink_close (socket);
+
+    //  Both sides enabled, and each side alone (negotiation declines)
+    ws_deflate_roundtrip (1, 1);
+    ws_deflate_roundtrip (1, 0);
+    ws_deflate_roundtrip (0, 1);
+
+    teardown_zlink_ctx ();
+}
+
+//  Test 12: ZLINK WebSocket server answers a ping sent in the same write
+//  as the upgrade request
+void test_zlink_ws_pipelined_ping ()
+{
+    setup_zlink_ctx ();
+
+    void *server = zlink_socket (g_ctx, ZLINK_PAIR);
+    TEST_ASSERT_NOT_NULL (server);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (server, "ws://127.0.0.1:*"));
+    char endpoint[256];
+    size_t endpoint_len = sizeof (endpoint);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (server, ZLINK_LAST_ENDPOINT, endpoint, &endpoint_len));
+    const unsigned short port =
+      static_cast<unsigned short> (atoi (strrchr (endpoint, ':') + 1));
+
+    boost::asio::io_context ioc;
+    boost::asio::ip::tcp::socket socket (ioc);
+    socket.connect (boost::asio::ip::tcp::endpoint (
+      boost::asio::ip::make_address ("127.0.0.1"), port));
+
+    std::string request = "GET / HTTP/1.1\r\n"
+                          "Host: 127.0.0.1\r\n"
+                          "Upgrade: websocket\r\n"
+                          "Connection: Upgrade\r\n"
+                          "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                          "Sec-WebSocket-Version: 13\r\n\r\n";
+    const unsigned char key[4] = {0x11, 0x22, 0x33, 0x44};
+    request += static_cast<char> (0x89);
+    request += static_cast<char> (0x80 | 2);
+    request.append (reinterpret_cast<const char *> (key), sizeof (key));
+    request += static_cast<char> ('h' ^ key[0]);
+    request += static_cast<char> ('i' ^ key[1]);
+    boost::asio::write (socket, boost::asio::buffer (request));
+
+    boost::asio::streambuf response;
+    const size_t header_size =
+      boost::asio::read_until (socket, response, "\r\n\r\n");
+    const std::string status (
+      boost::asio::buffers_begin (response.data ()),
+      boost::asio::buffers_begin (response.data ()) + header_size);
+    TEST_ASSERT_NOT_NULL (strstr (status.c_str (), " 101 "));
+    response.consume (header_size);
+
+    auto read_bytes = [&] (size_t size_) {
+        if (response.size () < size_)
+            boost::asio::read (
+              socket, response,
+              boost::asio::transfer_exactly (size_ - response.size ()));
+        const std::string bytes (
+          boost::asio::buffers_begin (response.data ()),
+          boost::asio::buffers_begin (response.data ()) + size_);
+        response.consume (size_);
+        return bytes;
+    };
+
+    //  Skip the server's greeting frames until the pong arrives
+    bool pong = false;
+    for (int i = 0; i < 8 && !pong; ++i) {
+        const std::string header = read_bytes (2);
+        const unsigned char opcode =
+          static_cast<unsigned char> (header[0]) & 0x0f;
+        const unsigned char len_byte = static_cast<unsigned char> (header[1]);
+        TEST_ASSERT_EQUAL_INT (0, len_byte & 0x80);
+        size_t len = len_byte & 0x7f;
+        TEST_ASSERT_TRUE (len < 127);
+        if (len == 126) {
+            const std::string ext = read_bytes (2);
+            len = (static_cast<unsigned char> (ext[0]) << 8)
+                  | static_cast<unsigned char> (ext[1]);
+        }
+        const std::string payload = read_bytes (len);
+        if (opcode == 0xa) {
+            TEST_ASSERT_EQUAL_STRING ("hi", payload.c_str ());
+            pong = true;
+        }
+    }
+    TEST_ASSERT_TRUE (pong);
+
+    socket.close ();
+    zlink_close (server);
+    teardown_zlink_ctx ();
+}
+
+//  Test 13: ZLINK WebSocket server in low-memory mode keeps working after
+//  its idle connection has given up its buffers
+void test_zlink_ws_low_memory ()
+{
+    setup_zlink_ctx ();
+
+    void *server = zlink_socket (g_ctx, ZLINK_PAIR);
+    TEST_ASSERT_NOT_NULL (server);
+    const int enabled = 1;
+    const int idle_ivl = 50;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (server, ZLINK_LOW_MEMORY, &enabled, sizeof (enabled)));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      server, ZLINK_LOW_MEMORY_IDLE_IVL, &idle_ivl, sizeof (idle_ivl)));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (server, "ws://127.0.0.1:*"));
+    char endpoint[256];
+    size_t endpoint_len = sizeof (endpoint);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (server, ZLINK_LAST_ENDPOINT, endpoint, &endpoint_len));
+
+    void *client = zlink_socket (g_ctx, ZLINK_PAIR);
+    TEST_ASSERT_NOT_NULL (client);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (client, endpoint));
+    msleep (200);
+
+    for (int round = 0; round < 3; ++round) {
+        send_string_expect_success (client, "ping", 0);
+        recv_string_expect_success (server, "ping", 0);
+        send_string_expect_success (server, "pong", 0);
+        recv_string_expect_success (client, "pong", 0);
+        msleep (idle_ivl * 4);
+    }
+
+    zlink_close (client);
+    zlink_close (server);
+    teardown_zlink_ctx ();
+}
+
 #if defined ZLINK_HAVE_WSS
 void test_zlink_wss_pair_message ()
 {
@@ -756,6 +966,9 @@ int main ()
     RUN_TEST (test_zlink_ws_pair_message);
     RUN_TEST (test_zlink_ws_pubsub);
     RUN_TEST (test_zlink_ws_with_path);
+    RUN_TEST (test_zlink_ws_deflate);
+    RUN_TEST (test_zlink_ws_pipelined_ping);
+    RUN_TEST (test_zlink_ws_low_memory);
 #if defined ZLINK_HAVE_WSS
     RUN_TEST (test_zlink_wss_pair_message);
 #endif
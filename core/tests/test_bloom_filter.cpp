@@ -0,0 +1,178 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <string.h>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+static int get_int (void *socket_, int option_)
+{
+    int value = -1;
+    size_t size = sizeof value;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (socket_, option_, &value, &size));
+    return value;
+}
+
+static void set_int (void *socket_, int option_, int value_)
+{
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (socket_, option_, &value_, sizeof value_));
+}
+
+static uint64_t get_counter (void *socket_, int option_)
+{
+    uint64_t value = 0;
+    size_t size = sizeof value;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (socket_, option_, &value, &size));
+    return value;
+}
+
+static void subscribe (void *sub_, void *xpub_, const char *topic_)
+{
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub_, ZLINK_SUBSCRIBE, topic_, strlen (topic_)));
+    char buffer[32];
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_recv (xpub_, buffer, sizeof buffer, 0));
+}
+
+static void expect_nothing (void *socket_)
+{
+    char buffer[32];
+    TEST_ASSERT_FAILURE_ERRNO (EAGAIN,
+                               zlink_recv (socket_, buffer, sizeof buffer, 0));
+}
+
+void test_invalid_option ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    void *sub = test_context_socket (ZLINK_SUB);
+    TEST_ASSERT_EQUAL_INT (0, get_int (xpub, ZLINK_BLOOM_FILTER));
+    TEST_ASSERT_EQUAL_INT (0, get_int (sub, ZLINK_BLOOM_FILTER));
+
+    int value = -1;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (xpub, ZLINK_BLOOM_FILTER, &value, sizeof value));
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (sub, ZLINK_BLOOM_FILTER, &value, sizeof value));
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_xpub_filter ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    set_int (xpub, ZLINK_BLOOM_FILTER, 4096);
+    TEST_ASSERT_EQUAL_INT (4096, get_int (xpub, ZLINK_BLOOM_FILTER));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://bloom_xpub"));
+
+    void *sub = test_context_socket (ZLINK_SUB);
+    set_int (sub, ZLINK_RCVTIMEO, 100);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, "inproc://bloom_xpub"));
+    subscribe (sub, xpub, "A");
+    subscribe (sub, xpub, "prices.");
+    subscribe (sub, xpub, "prices.EURUSD.bid");
+
+    send_string_expect_success (xpub, "A1", 0);
+    send_string_expect_success (xpub, "B1", 0);
+    send_string_expect_success (xpub, "prices.EURUSD.bid 1.1", 0);
+    send_string_expect_success (xpub, "news.EURUSD", 0);
+    recv_string_expect_success (sub, "A1", 0);
+    recv_string_expect_success (sub, "prices.EURUSD.bid 1.1", 0);
+    expect_nothing (sub);
+    TEST_ASSERT_EQUAL_UINT64 (2, get_counter (xpub, ZLINK_BLOOM_REJECTED)
+                                   + get_counter (xpub,
+                                                  ZLINK_BLOOM_FALSE_POSITIVES));
+
+    //  Once the subscriber is gone, its subscriptions leave the filter.
+    test_context_socket_close (sub);
+    for (int i = 0; i != 100 && zlink_socket_peer_count (xpub) > 0; ++i) {
+        msleep (10);
+        get_int (xpub, ZLINK_EVENTS);
+    }
+    TEST_ASSERT_EQUAL_INT (0, zlink_socket_peer_count (xpub));
+    const uint64_t rejected = get_counter (xpub, ZLINK_BLOOM_REJECTED);
+    send_string_expect_success (xpub, "A2", 0);
+    TEST_ASSERT_EQUAL_UINT64 (rejected + 1,
+                              get_counter (xpub, ZLINK_BLOOM_REJECTED));
+
+    test_context_socket_close (xpub);
+}
+
+void test_xpub_filter_enabled_late ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://bloom_late"));
+
+    void *sub = test_context_socket (ZLINK_SUB);
+    set_int (sub, ZLINK_RCVTIMEO, 100);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, "inproc://bloom_late"));
+    subscribe (sub, xpub, "topic");
+
+    //  The filter picks up the subscriptions already in place.
+    set_int (xpub, ZLINK_BLOOM_FILTER, 1024);
+    send_string_expect_success (xpub, "topic 1", 0);
+    send_string_expect_success (xpub, "other 1", 0);
+    recv_string_expect_success (sub, "topic 1", 0);
+    expect_nothing (sub);
+    TEST_ASSERT_EQUAL_UINT64 (1, get_counter (xpub, ZLINK_BLOOM_REJECTED));
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_sub_filter ()
+{
+    //  A manual XPUB subscribes the SUB to everything, leaving the
+    //  filtering to the SUB.
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    set_int (xpub, ZLINK_XPUB_MANUAL, 1);
+    set_int (xpub, ZLINK_RCVTIMEO, 100);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://bloom_sub"));
+
+    void *sub = test_context_socket (ZLINK_SUB);
+    set_int (sub, ZLINK_BLOOM_FILTER, 4096);
+    set_int (sub, ZLINK_RCVTIMEO, 100);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, "inproc://bloom_sub"));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (sub, ZLINK_SUBSCRIBE, "A", 1));
+    char buffer[32];
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_recv (xpub, buffer, sizeof buffer, 0));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (xpub, ZLINK_SUBSCRIBE, "", 0));
+
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_SUBSCRIBE, "topic.", 6));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (sub, ZLINK_SUBSCRIBE, "B", 1));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (sub, ZLINK_UNSUBSCRIBE, "B", 1));
+    for (int i = 0; i != 3; ++i)
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_recv (xpub, buffer, sizeof buffer, 0));
+
+    send_string_expect_success (xpub, "A1", 0);
+    send_string_expect_success (xpub, "B1", 0);
+    send_string_expect_success (xpub, "topic.x", 0);
+    send_string_expect_success (xpub, "C1", 0);
+    recv_string_expect_success (sub, "A1", 0);
+    recv_string_expect_success (sub, "topic.x", 0);
+    expect_nothing (sub);
+    TEST_ASSERT_EQUAL_UINT64 (2, get_counter (sub, ZLINK_BLOOM_REJECTED)
+                                   + get_counter (sub,
+                                                  ZLINK_BLOOM_FALSE_POSITIVES));
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_invalid_option);
+    RUN_TEST (test_xpub_filter);
+    RUN_TEST (test_xpub_filter_enabled_late);
+    RUN_TEST (test_sub_filter);
+    return UNITY_END ();
+}
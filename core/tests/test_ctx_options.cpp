@@ -241,6 +241,130 @@ void test_ctx_option_blocky ()
     test_context_socket_close (router);
 }
 
+void test_ctx_option_chunk_pool ()
+{
+    void *ctx = get_test_context ();
+    TEST_ASSERT_EQUAL_INT (ZLINK_CHUNK_POOL_SIZE_DFLT,
+                           zlink_ctx_get (ctx, ZLINK_CHUNK_POOL_SIZE));
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_ctx_set (ctx, ZLINK_CHUNK_POOL_SIZE, -1));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_ctx_set (ctx, ZLINK_CHUNK_POOL_SIZE, 4));
+    TEST_ASSERT_EQUAL_INT (4, zlink_ctx_get (ctx, ZLINK_CHUNK_POOL_SIZE));
+    TEST_ASSERT_EQUAL_INT (0, zlink_ctx_get (ctx, ZLINK_CHUNK_POOL_HITS));
+
+    void *sender = test_context_socket (ZLINK_PAIR);
+    void *receiver = test_context_socket (ZLINK_PAIR);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (receiver, "inproc://chunk-pool"));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sender, "inproc://chunk-pool"));
+
+    //  Bursts span several pipe chunks; after the first one the chunks
+    //  drained by the receiver come back from the pool.
+    for (int burst = 0; burst < 4; ++burst) {
+        for (int i = 0; i < 900; ++i)
+            send_string_expect_success (sender, "x", 0);
+        for (int i = 0; i < 900; ++i)
+            recv_string_expect_success (receiver, "x", 0);
+    }
+    TEST_ASSERT_GREATER_THAN_INT (0, zlink_ctx_get (ctx, ZLINK_CHUNK_POOL_HITS));
+    TEST_ASSERT_GREATER_THAN_INT (0,
+                                  zlink_ctx_get (ctx, ZLINK_CHUNK_POOL_MISSES));
+    TEST_ASSERT_LESS_OR_EQUAL_INT (4,
+                                   zlink_ctx_get (ctx, ZLINK_CHUNK_POOL_CACHED));
+    TEST_ASSERT_GREATER_OR_EQUAL_INT (
+      0, zlink_ctx_get (ctx, ZLINK_CHUNK_POOL_DROPS));
+
+    test_context_socket_close (sender);
+    test_context_socket_close (receiver);
+}
+
+void test_ctx_option_numa_aware ()
+{
+    void *ctx = get_test_context ();
+    TEST_ASSERT_EQUAL_INT (0, zlink_ctx_get (ctx, ZLINK_NUMA_AWARE));
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_ctx_set (ctx, ZLINK_NUMA_AWARE, -1));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_ctx_set (ctx, ZLINK_NUMA_AWARE, 1));
+    TEST_ASSERT_EQUAL_INT (1, zlink_ctx_get (ctx, ZLINK_NUMA_AWARE));
+
+    void *server = test_context_socket (ZLINK_PAIR);
+    void *client = test_context_socket (ZLINK_PAIR);
+
+    int node;
+    size_t size = sizeof (node);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (server, ZLINK_NUMA_NODE, &node, &size));
+    TEST_ASSERT_EQUAL_INT (-1, node);
+    node = -2;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (server, ZLINK_NUMA_NODE, &node, sizeof (node)));
+
+    //  Node 0 always exists; a node that doesn't falls back to the others.
+    node = 0;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (server, ZLINK_NUMA_NODE, &node, sizeof (node)));
+    node = 1000;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (client, ZLINK_NUMA_NODE, &node, sizeof (node)));
+
+    char endpoint[MAX_SOCKET_STRING];
+    bind_loopback_ipv4 (server, endpoint, sizeof endpoint);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (client, endpoint));
+
+    for (int i = 0; i < 900; ++i)
+        send_string_expect_success (client, "x", 0);
+    for (int i = 0; i < 900; ++i)
+        recv_string_expect_success (server, "x", 0);
+    send_string_expect_success (server, "y", 0);
+    recv_string_expect_success (client, "y", 0);
+
+    test_context_socket_close (client);
+    test_context_socket_close (server);
+}
+
+void test_ctx_option_mailbox_counters ()
+{
+    void *ctx = get_test_context ();
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_ctx_set (ctx, ZLINK_MAILBOX_COMMANDS, 0));
+    //  Wake-ups are read first as the counters may still be moving.
+    const int initial_wakeups = zlink_ctx_get (ctx, ZLINK_MAILBOX_WAKEUPS);
+    const int commands = zlink_ctx_get (ctx, ZLINK_MAILBOX_COMMANDS);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT (0, initial_wakeups);
+    TEST_ASSERT_LESS_OR_EQUAL_INT (commands, initial_wakeups);
+
+    void *pub = test_context_socket (ZLINK_PUB);
+    char endpoint[MAX_SOCKET_STRING];
+    bind_loopback_ipv4 (pub, endpoint, sizeof endpoint);
+    const int sub_count = 8;
+    void *subs[sub_count];
+    for (int i = 0; i < sub_count; ++i) {
+        subs[i] = test_context_socket (ZLINK_SUB);
+        TEST_ASSERT_SUCCESS_ERRNO (
+          zlink_setsockopt (subs[i], ZLINK_SUBSCRIBE, "", 0));
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (subs[i], endpoint));
+    }
+    msleep (SETTLE_TIME);
+
+    for (int i = 0; i < 100; ++i)
+        send_string_expect_success (pub, "x", 0);
+    for (int i = 0; i < sub_count; ++i)
+        for (int j = 0; j < 100; ++j)
+            recv_string_expect_success (subs[i], "x", 0);
+
+    //  Commands sent while the receiving thread is already awake don't
+    //  need a wake-up of their own.
+    const int wakeups = zlink_ctx_get (ctx, ZLINK_MAILBOX_WAKEUPS);
+    TEST_ASSERT_GREATER_THAN_INT (commands,
+                                  zlink_ctx_get (ctx, ZLINK_MAILBOX_COMMANDS));
+    TEST_ASSERT_GREATER_THAN_INT (initial_wakeups, wakeups);
+    TEST_ASSERT_LESS_OR_EQUAL_INT (zlink_ctx_get (ctx, ZLINK_MAILBOX_COMMANDS),
+                                   wakeups);
+
+    for (int i = 0; i < sub_count; ++i)
+        test_context_socket_close (subs[i]);
+    test_context_socket_close (pub);
+}
+
 void test_ctx_option_invalid ()
 {
     TEST_ASSERT_EQUAL_INT (-1, zlink_ctx_set (get_test_context (), -1, 0));
@@ -263,6 +387,9 @@ int main (void)
     RUN_TEST (test_ctx_thread_opts);
     RUN_TEST (test_ctx_zero_copy);
     RUN_TEST (test_ctx_option_blocky);
+    RUN_TEST (test_ctx_option_chunk_pool);
+    RUN_TEST (test_ctx_option_numa_aware);
+    RUN_TEST (test_ctx_option_mailbox_counters);
     RUN_TEST (test_ctx_option_invalid);
     return UNITY_END ();
 }
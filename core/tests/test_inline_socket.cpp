@@ -0,0 +1,188 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <string.h>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+//  Callbacks run on an I/O thread, where Unity assertions cannot be used,
+//  so failures are counted and checked by the test afterwards. Hints are
+//  static as they must outlive the test context.
+struct forward_t
+{
+    void *peer;
+    int failures;
+};
+
+static forward_t to_frontend;
+static forward_t to_backend;
+
+static void forward (void *, zlink_msg_t *msg_, void *hint_)
+{
+    forward_t *forward = static_cast<forward_t *> (hint_);
+    const int flags = zlink_msg_more (msg_) ? ZLINK_SNDMORE : 0;
+    if (zlink_msg_send (msg_, forward->peer, flags) == -1)
+        ++forward->failures;
+}
+
+static void echo (void *socket_, zlink_msg_t *msg_, void *hint_)
+{
+    forward_t *forward = static_cast<forward_t *> (hint_);
+    const int flags = zlink_msg_more (msg_) ? ZLINK_SNDMORE : 0;
+    if (zlink_msg_send (msg_, socket_, flags) == -1)
+        ++forward->failures;
+}
+
+void test_set_inline_invalid ()
+{
+    void *socket = test_context_socket (ZLINK_PAIR);
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_socket_set_inline (socket, NULL, NULL));
+    TEST_ASSERT_FAILURE_ERRNO (ENOTSOCK,
+                               zlink_socket_set_inline (NULL, echo, NULL));
+
+    //  Only sockets without endpoints can be made inline, and only once.
+    char my_endpoint[MAX_SOCKET_STRING];
+    bind_loopback_ipv4 (socket, my_endpoint, sizeof my_endpoint);
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_socket_set_inline (socket, echo, NULL));
+    test_context_socket_close (socket);
+
+    socket = test_context_socket (ZLINK_PAIR);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_socket_set_inline (socket, echo, &to_frontend));
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_socket_set_inline (socket, echo, &to_frontend));
+    test_context_socket_close (socket);
+}
+
+void test_inline_echo ()
+{
+    to_frontend.failures = 0;
+    void *server = test_context_socket (ZLINK_PAIR);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_socket_set_inline (server, echo, &to_frontend));
+    char my_endpoint[MAX_SOCKET_STRING];
+    bind_loopback_ipv4 (server, my_endpoint, sizeof my_endpoint);
+
+    void *client = test_context_socket (ZLINK_PAIR);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (client, my_endpoint));
+
+    for (int i = 0; i != 1000; ++i) {
+        send_string_expect_success (client, "ping", ZLINK_SNDMORE);
+        send_string_expect_success (client, "pong", 0);
+        recv_string_expect_success (client, "ping", 0);
+        recv_string_expect_success (client, "pong", 0);
+    }
+
+    test_context_socket_close (client);
+    test_context_socket_close (server);
+    TEST_ASSERT_EQUAL_INT (0, to_frontend.failures);
+}
+
+void test_inline_endpoints_from_app_thread ()
+{
+    //  Endpoint and option calls made here run on the socket's I/O thread.
+    to_frontend.failures = 0;
+    void *server = test_context_socket (ZLINK_PAIR);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_socket_set_inline (server, echo, &to_frontend));
+
+    for (int round = 0; round != 3; ++round) {
+        char my_endpoint[MAX_SOCKET_STRING];
+        bind_loopback_ipv4 (server, my_endpoint, sizeof my_endpoint);
+        int hwm = 100 + round;
+        TEST_ASSERT_SUCCESS_ERRNO (
+          zlink_setsockopt (server, ZLINK_SNDHWM, &hwm, sizeof hwm));
+
+        void *client = test_context_socket (ZLINK_PAIR);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (client, my_endpoint));
+        send_string_expect_success (client, "ping", 0);
+        recv_string_expect_success (client, "ping", 0);
+        test_context_socket_close (client);
+
+        hwm = 0;
+        size_t size = sizeof hwm;
+        TEST_ASSERT_SUCCESS_ERRNO (
+          zlink_getsockopt (server, ZLINK_SNDHWM, &hwm, &size));
+        TEST_ASSERT_EQUAL_INT (100 + round, hwm);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_unbind (server, my_endpoint));
+    }
+
+    test_context_socket_close (server);
+    TEST_ASSERT_EQUAL_INT (0, to_frontend.failures);
+}
+
+void test_inline_forward ()
+{
+    //  Both halves of the forwarder share I/O thread 0.
+    const uint64_t affinity = 1;
+
+    void *worker = test_context_socket (ZLINK_ROUTER);
+    char worker_endpoint[MAX_SOCKET_STRING];
+    bind_loopback_ipv4 (worker, worker_endpoint, sizeof worker_endpoint);
+
+    void *frontend = test_context_socket (ZLINK_ROUTER);
+    void *backend = test_context_socket (ZLINK_DEALER);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (frontend, ZLINK_AFFINITY, &affinity, sizeof affinity));
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (backend, ZLINK_AFFINITY, &affinity, sizeof affinity));
+    to_frontend.peer = frontend;
+    to_frontend.failures = 0;
+    to_backend.peer = backend;
+    to_backend.failures = 0;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_socket_set_inline (frontend, forward, &to_backend));
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_socket_set_inline (backend, forward, &to_frontend));
+
+    char frontend_endpoint[MAX_SOCKET_STRING];
+    bind_loopback_ipv4 (frontend, frontend_endpoint, sizeof frontend_endpoint);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (backend, worker_endpoint));
+
+    void *client = test_context_socket (ZLINK_DEALER);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (client, frontend_endpoint));
+
+    for (int i = 0; i != 100; ++i) {
+        send_string_expect_success (client, "request", 0);
+
+        //  The worker sees the backend's routing id, then the client's as
+        //  added by the frontend, then the payload.
+        zlink_msg_t parts[3];
+        for (int part = 0; part != 3; ++part) {
+            TEST_ASSERT_SUCCESS_ERRNO (zlink_msg_init (&parts[part]));
+            TEST_ASSERT_SUCCESS_ERRNO (
+              zlink_msg_recv (&parts[part], worker, 0));
+            TEST_ASSERT_EQUAL_INT (part != 2, zlink_msg_more (&parts[part]));
+        }
+        TEST_ASSERT_EQUAL_INT (7, zlink_msg_size (&parts[2]));
+        TEST_ASSERT_EQUAL_MEMORY ("request", zlink_msg_data (&parts[2]), 7);
+        for (int part = 0; part != 3; ++part)
+            TEST_ASSERT_SUCCESS_ERRNO (zlink_msg_send (
+              &parts[part], worker, part != 2 ? ZLINK_SNDMORE : 0));
+
+        recv_string_expect_success (client, "request", 0);
+    }
+
+    test_context_socket_close (client);
+    test_context_socket_close (frontend);
+    test_context_socket_close (backend);
+    test_context_socket_close (worker);
+    TEST_ASSERT_EQUAL_INT (0, to_frontend.failures);
+    TEST_ASSERT_EQUAL_INT (0, to_backend.failures);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_set_inline_invalid);
+    RUN_TEST (test_inline_echo);
+    RUN_TEST (test_inline_endpoints_from_app_thread);
+    RUN_TEST (test_inline_forward);
+    return UNITY_END ();
+}
@@ -0,0 +1,154 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <stdio.h>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+//  Large enough for zlink_poll to keep the items registered between calls
+//  where epoll is available. More sockets than the test context tracks,
+//  so they are closed here.
+static const int pair_count = 200;
+
+static void *receivers[pair_count];
+static void *senders[pair_count];
+static zlink_pollitem_t items[2 * pair_count];
+
+static void create_pairs ()
+{
+    for (int i = 0; i != pair_count; ++i) {
+        char endpoint[64];
+        snprintf (endpoint, sizeof endpoint, "inproc://poll-large-%d", i);
+        receivers[i] = zlink_socket (get_test_context (), ZLINK_PAIR);
+        TEST_ASSERT_NOT_NULL (receivers[i]);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (receivers[i], endpoint));
+        senders[i] = zlink_socket (get_test_context (), ZLINK_PAIR);
+        TEST_ASSERT_NOT_NULL (senders[i]);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (senders[i], endpoint));
+
+        zlink_pollitem_t receiver = {receivers[i], 0, ZLINK_POLLIN, 0};
+        zlink_pollitem_t sender = {senders[i], 0, 0, 0};
+        items[i] = receiver;
+        items[pair_count + i] = sender;
+    }
+}
+
+static void close_pairs ()
+{
+    for (int i = 0; i != pair_count; ++i) {
+        close_zero_linger (senders[i]);
+        close_zero_linger (receivers[i]);
+    }
+}
+
+static int poll_items (long timeout_)
+{
+    return TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_poll (items, 2 * pair_count, timeout_));
+}
+
+void test_poll_large_ready_only ()
+{
+    create_pairs ();
+    TEST_ASSERT_EQUAL_INT (0, poll_items (0));
+
+    send_string_expect_success (senders[17], "a", 0);
+    send_string_expect_success (senders[150], "b", 0);
+    int found = 0;
+    while (found < 2)
+        found = poll_items (1000);
+    TEST_ASSERT_EQUAL_INT (2, found);
+    for (int i = 0; i != 2 * pair_count; ++i)
+        TEST_ASSERT_EQUAL_INT (i == 17 || i == 150 ? ZLINK_POLLIN : 0,
+                               items[i].revents);
+
+    //  Until a socket has been drained it is reported again.
+    recv_string_expect_success (receivers[17], "a", 0);
+    TEST_ASSERT_EQUAL_INT (1, poll_items (0));
+    TEST_ASSERT_EQUAL_INT (ZLINK_POLLIN, items[150].revents);
+    recv_string_expect_success (receivers[150], "b", 0);
+    TEST_ASSERT_EQUAL_INT (0, poll_items (0));
+
+    close_pairs ();
+}
+
+void test_poll_large_recv_outside_poll ()
+{
+    create_pairs ();
+    TEST_ASSERT_EQUAL_INT (0, poll_items (0));
+
+    //  Receiving the first message outside zlink_poll picks up the
+    //  socket's pending commands; the second one must still be reported.
+    send_string_expect_success (senders[5], "first", 0);
+    send_string_expect_success (senders[5], "second", 0);
+    recv_string_expect_success (receivers[5], "first", 0);
+    TEST_ASSERT_EQUAL_INT (1, poll_items (0));
+    TEST_ASSERT_EQUAL_INT (ZLINK_POLLIN, items[5].revents);
+    recv_string_expect_success (receivers[5], "second", 0);
+    TEST_ASSERT_EQUAL_INT (0, poll_items (0));
+
+    close_pairs ();
+}
+
+void test_poll_large_change_events ()
+{
+    create_pairs ();
+    TEST_ASSERT_EQUAL_INT (0, poll_items (0));
+
+    //  Asking for more events on an already polled item.
+    items[pair_count + 7].events = ZLINK_POLLOUT;
+    TEST_ASSERT_EQUAL_INT (1, poll_items (0));
+    TEST_ASSERT_EQUAL_INT (ZLINK_POLLOUT, items[pair_count + 7].revents);
+
+    items[pair_count + 7].events = 0;
+    TEST_ASSERT_EQUAL_INT (0, poll_items (0));
+
+    close_pairs ();
+}
+
+void test_poll_large_alternating_sets ()
+{
+    create_pairs ();
+
+    //  A second set over the senders only, polled in turn with the first;
+    //  each keeps reporting its own items.
+    zlink_pollitem_t *sender_items = items + pair_count;
+    zlink_pollitem_t writable[pair_count];
+    for (int i = 0; i != pair_count; ++i) {
+        writable[i] = sender_items[i];
+        writable[i].events = i < 3 ? ZLINK_POLLOUT : 0;
+    }
+
+    send_string_expect_success (senders[42], "a", 0);
+    for (int round = 0; round != 3; ++round) {
+        int found = 0;
+        while (found < 1)
+            found = poll_items (1000);
+        TEST_ASSERT_EQUAL_INT (1, found);
+        TEST_ASSERT_EQUAL_INT (ZLINK_POLLIN, items[42].revents);
+
+        TEST_ASSERT_EQUAL_INT (
+          3, TEST_ASSERT_SUCCESS_ERRNO (zlink_poll (writable, pair_count, 0)));
+        for (int i = 0; i != pair_count; ++i)
+            TEST_ASSERT_EQUAL_INT (i < 3 ? ZLINK_POLLOUT : 0,
+                                   writable[i].revents);
+    }
+    recv_string_expect_success (receivers[42], "a", 0);
+    TEST_ASSERT_EQUAL_INT (0, poll_items (0));
+
+    close_pairs ();
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_poll_large_ready_only);
+    RUN_TEST (test_poll_large_recv_outside_poll);
+    RUN_TEST (test_poll_large_change_events);
+    RUN_TEST (test_poll_large_alternating_sets);
+    return UNITY_END ();
+}
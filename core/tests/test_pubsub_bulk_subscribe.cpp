@@ -0,0 +1,178 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <string.h>
+#include <string>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+//  Packs the topics as ZLINK_SUBSCRIBE_BULK takes them.
+static std::string topic_list (const char *topics_[], int count_)
+{
+    std::string list;
+    for (int i = 0; i != count_; ++i) {
+        const size_t size = strlen (topics_[i]);
+        const char prefix[4] = {0, 0, static_cast<char> (size >> 8),
+                                static_cast<char> (size)};
+        list.append (prefix, 4);
+        list.append (topics_[i]);
+    }
+    return list;
+}
+
+static int get_int (void *socket_, int option_)
+{
+    int value = 0;
+    size_t size = sizeof value;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (socket_, option_, &value, &size));
+    return value;
+}
+
+//  Receives the (un)subscription of topic_ on xpub_.
+static void recv_notification (void *xpub_, bool subscribe_, const char *topic_)
+{
+    char buffer[32];
+    const int rc =
+      TEST_ASSERT_SUCCESS_ERRNO (zlink_recv (xpub_, buffer, sizeof buffer, 0));
+    TEST_ASSERT_EQUAL_INT (strlen (topic_) + 1, rc);
+    TEST_ASSERT_EQUAL_UINT8 (subscribe_ ? 1 : 0, buffer[0]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (topic_, buffer + 1, rc - 1);
+}
+
+static void expect_nothing (void *socket_)
+{
+    char buffer[32];
+    TEST_ASSERT_FAILURE_ERRNO (EAGAIN,
+                               zlink_recv (socket_, buffer, sizeof buffer, 0));
+}
+
+void test_invalid_list ()
+{
+    void *sub = test_context_socket (ZLINK_SUB);
+
+    //  The size of the second topic runs past the end.
+    const char *topics[] = {"A", "BC"};
+    std::string list = topic_list (topics, 2);
+    list.resize (list.size () - 1);
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_setsockopt (sub, ZLINK_SUBSCRIBE_BULK,
+                                                 list.data (), list.size ()));
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_setsockopt (sub, ZLINK_UNSUBSCRIBE_BULK,
+                                                 list.data (), 2));
+    TEST_ASSERT_EQUAL_INT (0, get_int (sub, ZLINK_TOPICS_COUNT));
+
+    test_context_socket_close (sub);
+}
+
+static void test_bulk_subscribe (const char *endpoint_)
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    int timeout = 100;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (xpub, ZLINK_RCVTIMEO, &timeout, sizeof timeout));
+    char endpoint[MAX_SOCKET_STRING];
+    if (strcmp (endpoint_, "tcp") == 0)
+        bind_loopback_ipv4 (xpub, endpoint, sizeof endpoint);
+    else {
+        strcpy (endpoint, endpoint_);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, endpoint));
+    }
+
+    void *sub = test_context_socket (ZLINK_SUB);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_RCVTIMEO, &timeout, sizeof timeout));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, endpoint));
+
+    //  The publisher sees each topic as if subscribed on its own.
+    const char *topics[] = {"A", "BC", "DEF"};
+    const std::string list = topic_list (topics, 3);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (sub, ZLINK_SUBSCRIBE_BULK,
+                                                 list.data (), list.size ()));
+    TEST_ASSERT_EQUAL_INT (3, get_int (sub, ZLINK_TOPICS_COUNT));
+    for (int i = 0; i != 3; ++i)
+        recv_notification (xpub, true, topics[i]);
+    TEST_ASSERT_EQUAL_INT (3, get_int (xpub, ZLINK_TOPICS_COUNT));
+
+    send_string_expect_success (xpub, "A1", 0);
+    send_string_expect_success (xpub, "X1", 0);
+    send_string_expect_success (xpub, "DEF1", 0);
+    recv_string_expect_success (sub, "A1", 0);
+    recv_string_expect_success (sub, "DEF1", 0);
+    expect_nothing (sub);
+
+    //  Only the subscriptions actually removed go upstream.
+    const char *cancelled[] = {"A", "X", "DEF"};
+    const std::string cancel = topic_list (cancelled, 3);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (sub, ZLINK_UNSUBSCRIBE_BULK,
+                                                 cancel.data (), cancel.size ()));
+    TEST_ASSERT_EQUAL_INT (1, get_int (sub, ZLINK_TOPICS_COUNT));
+    recv_notification (xpub, false, "A");
+    recv_notification (xpub, false, "DEF");
+    expect_nothing (xpub);
+
+    send_string_expect_success (xpub, "A2", 0);
+    send_string_expect_success (xpub, "BC2", 0);
+    recv_string_expect_success (sub, "BC2", 0);
+    expect_nothing (sub);
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_bulk_subscribe_inproc ()
+{
+    test_bulk_subscribe ("inproc://bulk_subscribe");
+}
+
+void test_bulk_subscribe_tcp ()
+{
+    test_bulk_subscribe ("tcp");
+}
+
+void test_resubscribe_on_connect ()
+{
+    //  More subscriptions than fit in one bulk message.
+    const int count = 2000;
+
+    void *sub = test_context_socket (ZLINK_SUB);
+    for (int i = 0; i != count; ++i) {
+        char topic[16];
+        snprintf (topic, sizeof topic, "topic-%04d", i);
+        TEST_ASSERT_SUCCESS_ERRNO (
+          zlink_setsockopt (sub, ZLINK_SUBSCRIBE, topic, strlen (topic)));
+    }
+
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    char endpoint[MAX_SOCKET_STRING];
+    bind_loopback_ipv4 (xpub, endpoint, sizeof endpoint);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, endpoint));
+
+    for (int i = 0; i != count; ++i) {
+        char topic[16];
+        snprintf (topic, sizeof topic, "topic-%04d", i);
+        recv_notification (xpub, true, topic);
+    }
+    TEST_ASSERT_EQUAL_INT (count, get_int (xpub, ZLINK_TOPICS_COUNT));
+
+    send_string_expect_success (xpub, "topic-1999 value", 0);
+    recv_string_expect_success (sub, "topic-1999 value", 0);
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_invalid_list);
+    RUN_TEST (test_bulk_subscribe_inproc);
+    RUN_TEST (test_bulk_subscribe_tcp);
+    RUN_TEST (test_resubscribe_on_connect);
+    return UNITY_END ();
+}
@@ -0,0 +1,157 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <string.h>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+static void set_delimiter (void *socket_, int delimiter_)
+{
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      socket_, ZLINK_TOPIC_DELIMITER, &delimiter_, sizeof delimiter_));
+}
+
+static int get_int (void *socket_, int option_)
+{
+    int value = 0;
+    size_t size = sizeof value;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (socket_, option_, &value, &size));
+    return value;
+}
+
+static void subscribe (void *sub_, const char *topic_)
+{
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub_, ZLINK_SUBSCRIBE, topic_, strlen (topic_)));
+}
+
+//  Receives the (un)subscription of topic_ on xpub_.
+static void recv_notification (void *xpub_, bool subscribe_, const char *topic_)
+{
+    char buffer[32];
+    const int rc =
+      TEST_ASSERT_SUCCESS_ERRNO (zlink_recv (xpub_, buffer, sizeof buffer, 0));
+    TEST_ASSERT_EQUAL_INT (strlen (topic_) + 1, rc);
+    TEST_ASSERT_EQUAL_UINT8 (subscribe_ ? 1 : 0, buffer[0]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (topic_, buffer + 1, rc - 1);
+}
+
+static void expect_nothing (void *socket_)
+{
+    char buffer[32];
+    TEST_ASSERT_FAILURE_ERRNO (EAGAIN,
+                               zlink_recv (socket_, buffer, sizeof buffer, 0));
+}
+
+void test_invalid_delimiter ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    void *sub = test_context_socket (ZLINK_SUB);
+    TEST_ASSERT_EQUAL_INT (-1, get_int (xpub, ZLINK_TOPIC_DELIMITER));
+    TEST_ASSERT_EQUAL_INT (-1, get_int (sub, ZLINK_TOPIC_DELIMITER));
+
+    int delimiter = 256;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (xpub, ZLINK_TOPIC_DELIMITER, &delimiter,
+                                sizeof delimiter));
+    delimiter = -2;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (sub, ZLINK_TOPIC_DELIMITER, &delimiter,
+                                sizeof delimiter));
+
+    //  The delimiter cannot change under existing exact topics.
+    set_delimiter (sub, '.');
+    TEST_ASSERT_EQUAL_INT ('.', get_int (sub, ZLINK_TOPIC_DELIMITER));
+    subscribe (sub, "a.");
+    delimiter = '/';
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (sub, ZLINK_TOPIC_DELIMITER, &delimiter,
+                                sizeof delimiter));
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_UNSUBSCRIBE, "a.", 2));
+    set_delimiter (sub, '/');
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_exact_topics ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    set_delimiter (xpub, '.');
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://exact_topics"));
+
+    void *sub = test_context_socket (ZLINK_SUB);
+    set_delimiter (sub, '.');
+    int timeout = 100;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_RCVTIMEO, &timeout, sizeof timeout));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, "inproc://exact_topics"));
+
+    //  Exact topics and plain prefixes side by side.
+    subscribe (sub, "quote.");
+    recv_notification (xpub, true, "quote.");
+    subscribe (sub, "trade.a.");
+    recv_notification (xpub, true, "trade.a.");
+    subscribe (sub, "ne");
+    recv_notification (xpub, true, "ne");
+    TEST_ASSERT_EQUAL_INT (3, get_int (xpub, ZLINK_TOPICS_COUNT));
+    TEST_ASSERT_EQUAL_INT (3, get_int (sub, ZLINK_TOPICS_COUNT));
+
+    send_string_expect_success (xpub, "quote.AAPL", 0);
+    recv_string_expect_success (sub, "quote.AAPL", 0);
+    send_string_expect_success (xpub, "quote.", 0);
+    recv_string_expect_success (sub, "quote.", 0);
+    //  Prefix semantics hold for subscriptions with several delimiters.
+    send_string_expect_success (xpub, "trade.a.1", 0);
+    recv_string_expect_success (sub, "trade.a.1", 0);
+    send_string_expect_success (xpub, "news", 0);
+    recv_string_expect_success (sub, "news", 0);
+
+    send_string_expect_success (xpub, "quotes.AAPL", 0);
+    send_string_expect_success (xpub, "quote", 0);
+    send_string_expect_success (xpub, "trade.b.1", 0);
+    expect_nothing (sub);
+
+    //  Unsubscribing from an exact topic.
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_UNSUBSCRIBE, "quote.", 6));
+    recv_notification (xpub, false, "quote.");
+    TEST_ASSERT_EQUAL_INT (2, get_int (xpub, ZLINK_TOPICS_COUNT));
+    TEST_ASSERT_EQUAL_INT (2, get_int (sub, ZLINK_TOPICS_COUNT));
+    send_string_expect_success (xpub, "quote.AAPL", 0);
+    expect_nothing (sub);
+
+    //  A subscriber without the delimiter gets the same messages.
+    void *plain = test_context_socket (ZLINK_SUB);
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (plain, ZLINK_RCVTIMEO, &timeout, sizeof timeout));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (plain, "inproc://exact_topics"));
+    subscribe (plain, "quote.");
+    recv_notification (xpub, true, "quote.");
+    send_string_expect_success (xpub, "quote.MSFT", 0);
+    recv_string_expect_success (plain, "quote.MSFT", 0);
+    expect_nothing (sub);
+
+    //  Closing a subscriber drops its exact topics.
+    test_context_socket_close (plain);
+    msleep (SETTLE_TIME);
+    recv_notification (xpub, false, "quote.");
+    TEST_ASSERT_EQUAL_INT (2, get_int (xpub, ZLINK_TOPICS_COUNT));
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_invalid_delimiter);
+    RUN_TEST (test_exact_topics);
+    return UNITY_END ();
+}
@@ -0,0 +1,203 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+void setUp ()
+{
+}
+
+void tearDown ()
+{
+}
+
+static void handler (int timer_id_, void *arg_)
+{
+    (void) timer_id_;
+    ++*static_cast<int *> (arg_);
+}
+
+struct cancel_arg_t
+{
+    void *timers;
+    int calls;
+};
+
+static void cancel_self (int timer_id_, void *arg_)
+{
+    cancel_arg_t *arg = static_cast<cancel_arg_t *> (arg_);
+    ++arg->calls;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_cancel (arg->timers, timer_id_));
+}
+
+//  Sleeps until the set's next timer is due and runs it.
+static void sleep_and_execute (void *timers_)
+{
+    long timeout = zlink_timers_timeout (timers_);
+    while (timeout > 0) {
+        msleep (timeout);
+        timeout = zlink_timers_timeout (timers_);
+    }
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_execute (timers_));
+}
+
+void test_null_timer_pointers ()
+{
+    void *timers = NULL;
+
+    TEST_ASSERT_FAILURE_ERRNO (EFAULT, zlink_timers_destroy (&timers));
+    TEST_ASSERT_FAILURE_ERRNO (EFAULT, zlink_timers_destroy (NULL));
+
+    const size_t dummy_interval = 100;
+    const int dummy_timer_id = 1;
+
+    TEST_ASSERT_FAILURE_ERRNO (
+      EFAULT, zlink_timers_add (timers, dummy_interval, &handler, NULL));
+    TEST_ASSERT_FAILURE_ERRNO (EFAULT,
+                               zlink_timers_cancel (timers, dummy_timer_id));
+    TEST_ASSERT_FAILURE_ERRNO (
+      EFAULT, zlink_timers_set_interval (timers, dummy_timer_id, dummy_interval));
+    TEST_ASSERT_FAILURE_ERRNO (EFAULT,
+                               zlink_timers_reset (timers, dummy_timer_id));
+    TEST_ASSERT_FAILURE_ERRNO (EFAULT, zlink_timers_timeout (timers));
+    TEST_ASSERT_FAILURE_ERRNO (EFAULT, zlink_timers_execute (timers));
+}
+
+void test_corner_cases ()
+{
+    void *timers = zlink_timers_new ();
+    TEST_ASSERT_NOT_NULL (timers);
+
+    const size_t dummy_interval = SIZE_MAX;
+    const int dummy_timer_id = 1;
+
+    //  Unknown ids and a missing handler.
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_timers_cancel (timers, dummy_timer_id));
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_timers_set_interval (timers, dummy_timer_id, dummy_interval));
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_timers_reset (timers, dummy_timer_id));
+    TEST_ASSERT_FAILURE_ERRNO (
+      EFAULT, zlink_timers_add (timers, dummy_interval, NULL, NULL));
+
+    //  Nothing armed.
+    TEST_ASSERT_EQUAL_INT (-1, zlink_timers_timeout (timers));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_execute (timers));
+
+    //  A cancelled timer cannot be cancelled again.
+    const int timer_id = TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_timers_add (timers, 100, &handler, NULL));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_cancel (timers, timer_id));
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL, zlink_timers_cancel (timers, timer_id));
+    TEST_ASSERT_EQUAL_INT (-1, zlink_timers_timeout (timers));
+
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_destroy (&timers));
+    TEST_ASSERT_NULL (timers);
+}
+
+void test_timers ()
+{
+    void *timers = zlink_timers_new ();
+    TEST_ASSERT_NOT_NULL (timers);
+
+    int calls = 0;
+    const int full_timeout = 100;
+    const int timer_id = TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_timers_add (timers, full_timeout, &handler, &calls));
+
+    //  Not due yet; the timeout may be shorter than the time left, never
+    //  longer.
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_execute (timers));
+    TEST_ASSERT_EQUAL_INT (0, calls);
+    long timeout = zlink_timers_timeout (timers);
+    TEST_ASSERT_GREATER_OR_EQUAL (0, timeout);
+    TEST_ASSERT_LESS_OR_EQUAL (full_timeout, timeout);
+
+    void *watch = zlink_stopwatch_start ();
+    sleep_and_execute (timers);
+    TEST_ASSERT_GREATER_OR_EQUAL (full_timeout * 1000 - 2000,
+                                  zlink_stopwatch_stop (watch));
+    TEST_ASSERT_EQUAL_INT (1, calls);
+
+    //  The timer repeats.
+    sleep_and_execute (timers);
+    TEST_ASSERT_EQUAL_INT (2, calls);
+
+    //  Reset postpones it.
+    msleep (full_timeout / 2);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_reset (timers, timer_id));
+    msleep (full_timeout / 2 + 10);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_execute (timers));
+    TEST_ASSERT_EQUAL_INT (2, calls);
+    sleep_and_execute (timers);
+    TEST_ASSERT_EQUAL_INT (3, calls);
+
+    //  A shorter interval takes over from now.
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_timers_set_interval (timers, timer_id, full_timeout / 4));
+    TEST_ASSERT_LESS_OR_EQUAL (full_timeout / 4, zlink_timers_timeout (timers));
+    sleep_and_execute (timers);
+    TEST_ASSERT_EQUAL_INT (4, calls);
+
+    //  Cancelled timers stay quiet.
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_cancel (timers, timer_id));
+    msleep (full_timeout);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_execute (timers));
+    TEST_ASSERT_EQUAL_INT (4, calls);
+
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_destroy (&timers));
+}
+
+void test_cancel_in_handler ()
+{
+    void *timers = zlink_timers_new ();
+    TEST_ASSERT_NOT_NULL (timers);
+
+    cancel_arg_t arg = {timers, 0};
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_add (timers, 10, &cancel_self, &arg));
+    sleep_and_execute (timers);
+    TEST_ASSERT_EQUAL_INT (1, arg.calls);
+    TEST_ASSERT_EQUAL_INT (-1, zlink_timers_timeout (timers));
+
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_destroy (&timers));
+}
+
+void test_many_timers ()
+{
+    //  Timeouts spread over several wheel levels all fire once.
+    void *timers = zlink_timers_new ();
+    TEST_ASSERT_NOT_NULL (timers);
+
+    const int count = 200;
+    int calls[count] = {0};
+    for (int i = 0; i != count; ++i)
+        TEST_ASSERT_SUCCESS_ERRNO (
+          zlink_timers_add (timers, 1 + i * 3, &handler, &calls[i]));
+
+    void *watch = zlink_stopwatch_start ();
+    while (zlink_stopwatch_intermediate (watch) < 3 * count * 1000) {
+        const long timeout = zlink_timers_timeout (timers);
+        if (timeout > 0)
+            msleep (timeout);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_execute (timers));
+    }
+    zlink_stopwatch_stop (watch);
+    for (int i = 0; i != count; ++i)
+        TEST_ASSERT_GREATER_OR_EQUAL (1, calls[i]);
+
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_timers_destroy (&timers));
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_null_timer_pointers);
+    RUN_TEST (test_corner_cases);
+    RUN_TEST (test_timers);
+    RUN_TEST (test_cancel_in_handler);
+    RUN_TEST (test_many_timers);
+    return UNITY_END ();
+}
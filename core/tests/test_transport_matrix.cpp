@@ -245,6 +245,79 @@ static void run_router_router (const char *transport_)
         cleanup_tls_test_files (tls_files);
 }
 
+//  Enough messages for the receive HWM to push back on the engine many
+//  times while the receiver pauses.
+static const int backpressure_count = 20000;
+
+struct backpressure_sender_t
+{
+    void *socket;
+    bool failed;
+};
+
+//  Runs in its own thread, so it only records failures.
+static void backpressure_sender (void *arg_)
+{
+    backpressure_sender_t *sender = static_cast<backpressure_sender_t *> (arg_);
+    for (int i = 0; i != backpressure_count; ++i)
+        if (zlink_send (sender->socket, &i, sizeof i, 0)
+            != static_cast<int> (sizeof i)) {
+            sender->failed = true;
+            return;
+        }
+}
+
+static void run_backpressure (const char *transport_)
+{
+    if (!is_transport_available (transport_))
+        TEST_IGNORE_MESSAGE ("transport not available");
+
+    void *server = test_context_socket (ZLINK_DEALER);
+    void *client = test_context_socket (ZLINK_DEALER);
+
+    const int hwm = 10;
+    const int timeout = 5000;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (server, ZLINK_RCVHWM, &hwm, sizeof (hwm)));
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (server, ZLINK_RCVTIMEO, &timeout, sizeof (timeout)));
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (client, ZLINK_SNDHWM, &hwm, sizeof (hwm)));
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (client, ZLINK_SNDTIMEO, &timeout, sizeof (timeout)));
+
+    tls_test_files_t tls_files;
+    if (is_tls_transport (transport_)) {
+        tls_files = make_tls_test_files ();
+        configure_tls (server, client, tls_files);
+    }
+
+    char endpoint[MAX_SOCKET_STRING];
+    bind_endpoint (server, transport_, "matrix_backpressure", endpoint,
+                   sizeof (endpoint));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (client, endpoint));
+
+    //  Every message must arrive exactly once and in order, also when the
+    //  engine had to stop reading because the receiver fell behind.
+    backpressure_sender_t sender_data = {client, false};
+    void *sender = zlink_threadstart (&backpressure_sender, &sender_data);
+    for (int i = 0; i != backpressure_count; ++i) {
+        int value = -1;
+        TEST_ASSERT_EQUAL_INT (static_cast<int> (sizeof value),
+                               zlink_recv (server, &value, sizeof value, 0));
+        TEST_ASSERT_EQUAL_INT (i, value);
+        if (i % 1000 == 0)
+            msleep (2);
+    }
+    zlink_threadclose (sender);
+    TEST_ASSERT_FALSE (sender_data.failed);
+
+    test_context_socket_close (client);
+    test_context_socket_close (server);
+    if (is_tls_transport (transport_))
+        cleanup_tls_test_files (tls_files);
+}
+
 static void test_transport_matrix (const char *transport_)
 {
     fprintf (stderr, "Testing transport: %s\n", transport_);
@@ -265,6 +338,10 @@ static void test_transport_matrix (const char *transport_)
     run_router_router (transport_);
     fprintf (stderr, "  ROUTER/ROUTER complete\n");
     fflush (stderr);
+
+    run_backpressure (transport_);
+    fprintf (stderr, "  backpressure complete\n");
+    fflush (stderr);
 }
 
 void test_matrix_tcp ()
@@ -0,0 +1,169 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <string.h>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+static uint64_t conflated (void *xpub_)
+{
+    uint64_t value = 0;
+    size_t size = sizeof value;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (xpub_, ZLINK_XPUB_CONFLATED, &value, &size));
+    return value;
+}
+
+//  Lets the publisher see that the subscriber's pipe drained.
+static void process_commands (void *socket_)
+{
+    int events;
+    size_t size = sizeof events;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (socket_, ZLINK_EVENTS, &events, &size));
+}
+
+static void *create_xpub (int conflate_)
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    int hwm = 1;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (xpub, ZLINK_SNDHWM, &hwm, sizeof hwm));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (xpub, ZLINK_XPUB_CONFLATE,
+                                                 &conflate_, sizeof conflate_));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://conflate"));
+    return xpub;
+}
+
+static void *create_sub (void *xpub_)
+{
+    void *sub = test_context_socket (ZLINK_SUB);
+    int hwm = 1;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_RCVHWM, &hwm, sizeof hwm));
+    int timeout = 100;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_RCVTIMEO, &timeout, sizeof timeout));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, "inproc://conflate"));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (sub, ZLINK_SUBSCRIBE, "", 0));
+    char buffer[8];
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_recv (xpub_, buffer, sizeof buffer, 0));
+    return sub;
+}
+
+//  Receives everything the subscriber gets, letting the publisher refill
+//  the pipe in between, into a space separated list.
+static void recv_all (void *xpub_, void *sub_, char *out_)
+{
+    out_[0] = 0;
+    char buffer[32];
+    int rc;
+    while ((rc = zlink_recv (sub_, buffer, sizeof buffer - 1, 0)) != -1) {
+        buffer[rc] = 0;
+        if (out_[0])
+            strcat (out_, " ");
+        strcat (out_, buffer);
+        int more;
+        size_t size = sizeof more;
+        TEST_ASSERT_SUCCESS_ERRNO (
+          zlink_getsockopt (sub_, ZLINK_RCVMORE, &more, &size));
+        if (more)
+            strcat (out_, "+");
+        process_commands (xpub_);
+    }
+    TEST_ASSERT_EQUAL_INT (EAGAIN, errno);
+}
+
+static void send_all (void *xpub_, const char *updates_[], size_t count_)
+{
+    for (size_t i = 0; i != count_; ++i)
+        send_string_expect_success (xpub_, updates_[i], 0);
+}
+
+void test_invalid_option ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    int conflate = -2;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL,
+      zlink_setsockopt (xpub, ZLINK_XPUB_CONFLATE, &conflate, sizeof conflate));
+    TEST_ASSERT_EQUAL_UINT64 (0, conflated (xpub));
+    test_context_socket_close (xpub);
+}
+
+void test_drop_without_conflate ()
+{
+    void *xpub = create_xpub (-1);
+    void *sub = create_sub (xpub);
+
+    const char *updates[] = {"a1", "b1", "c1", "a2", "b2"};
+    send_all (xpub, updates, sizeof updates / sizeof updates[0]);
+
+    char received[256];
+    recv_all (xpub, sub, received);
+    TEST_ASSERT_EQUAL_STRING ("a1 b1", received);
+    TEST_ASSERT_EQUAL_UINT64 (0, conflated (xpub));
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_conflate_prefix ()
+{
+    //  The topic is the first byte. Once the pipe is full, updates wait in
+    //  topic order and newer ones replace older ones in place.
+    void *xpub = create_xpub (1);
+    void *sub = create_sub (xpub);
+
+    const char *updates[] = {"a1", "b1", "c1", "a2", "b2", "a3", "d1", "b3"};
+    send_all (xpub, updates, sizeof updates / sizeof updates[0]);
+    TEST_ASSERT_EQUAL_UINT64 (2, conflated (xpub));
+
+    char received[256];
+    recv_all (xpub, sub, received);
+    TEST_ASSERT_EQUAL_STRING ("a1 b1 c1 a3 b3 d1", received);
+
+    //  With the backlog gone, messages flow directly again.
+    send_string_expect_success (xpub, "a4", 0);
+    recv_all (xpub, sub, received);
+    TEST_ASSERT_EQUAL_STRING ("a4", received);
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_conflate_multipart ()
+{
+    //  The topic is the whole first frame.
+    void *xpub = create_xpub (0);
+    void *sub = create_sub (xpub);
+
+    const char *updates[][2] = {{"x", "1"}, {"y", "1"}, {"x", "2"},
+                                {"xx", "1"}, {"x", "3"}};
+    for (size_t i = 0; i != sizeof updates / sizeof updates[0]; ++i) {
+        send_string_expect_success (xpub, updates[i][0], ZLINK_SNDMORE);
+        send_string_expect_success (xpub, updates[i][1], 0);
+    }
+    TEST_ASSERT_EQUAL_UINT64 (1, conflated (xpub));
+
+    char received[256];
+    recv_all (xpub, sub, received);
+    TEST_ASSERT_EQUAL_STRING ("x+ 1 y+ 1 x+ 3 xx+ 1", received);
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_invalid_option);
+    RUN_TEST (test_drop_without_conflate);
+    RUN_TEST (test_conflate_prefix);
+    RUN_TEST (test_conflate_multipart);
+    return UNITY_END ();
+}
@@ -0,0 +1,157 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <string.h>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+static void *create_xpub (int budget_, int delimiter_)
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      xpub, ZLINK_XPUB_LAST_VALUE_CACHE, &budget_, sizeof budget_));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      xpub, ZLINK_TOPIC_DELIMITER, &delimiter_, sizeof delimiter_));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://last_value"));
+    return xpub;
+}
+
+static uint64_t cache_size (void *xpub_)
+{
+    uint64_t value = 0;
+    size_t size = sizeof value;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_getsockopt (
+      xpub_, ZLINK_XPUB_LAST_VALUE_CACHE_SIZE, &value, &size));
+    return value;
+}
+
+//  Connects a subscriber to topic_ and waits for the publisher to see
+//  the subscription.
+static void *create_sub (void *xpub_, const char *topic_)
+{
+    void *sub = test_context_socket (ZLINK_SUB);
+    int timeout = 100;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_RCVTIMEO, &timeout, sizeof timeout));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, "inproc://last_value"));
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_SUBSCRIBE, topic_, strlen (topic_)));
+
+    char buffer[32];
+    const int rc =
+      TEST_ASSERT_SUCCESS_ERRNO (zlink_recv (xpub_, buffer, sizeof buffer, 0));
+    TEST_ASSERT_EQUAL_INT (strlen (topic_) + 1, rc);
+    return sub;
+}
+
+static void expect_nothing (void *sub_)
+{
+    char buffer[32];
+    TEST_ASSERT_FAILURE_ERRNO (EAGAIN,
+                               zlink_recv (sub_, buffer, sizeof buffer, 0));
+}
+
+void test_invalid_budget ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    int budget = -1;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (xpub, ZLINK_XPUB_LAST_VALUE_CACHE, &budget,
+                                sizeof budget));
+    TEST_ASSERT_EQUAL_UINT64 (0, cache_size (xpub));
+    test_context_socket_close (xpub);
+}
+
+void test_late_join ()
+{
+    void *xpub = create_xpub (1024, '.');
+
+    //  Nobody listens yet, but the latest value of each topic is kept.
+    send_string_expect_success (xpub, "a.1", 0);
+    send_string_expect_success (xpub, "b.1", 0);
+    send_string_expect_success (xpub, "a.2", 0);
+    send_string_expect_success (xpub, "no topic", 0);
+    TEST_ASSERT_EQUAL_UINT64 (10, cache_size (xpub));
+
+    void *sub_a = create_sub (xpub, "a.");
+    recv_string_expect_success (sub_a, "a.2", 0);
+    expect_nothing (sub_a);
+
+    //  Values are replayed oldest first, then live messages follow.
+    void *sub_all = create_sub (xpub, "");
+    recv_string_expect_success (sub_all, "b.1", 0);
+    recv_string_expect_success (sub_all, "a.2", 0);
+    send_string_expect_success (xpub, "a.3", 0);
+    recv_string_expect_success (sub_a, "a.3", 0);
+    recv_string_expect_success (sub_all, "a.3", 0);
+    expect_nothing (sub_all);
+
+    test_context_socket_close (sub_a);
+    test_context_socket_close (sub_all);
+    test_context_socket_close (xpub);
+}
+
+void test_multipart ()
+{
+    //  Without a delimiter the first frame is the topic.
+    void *xpub = create_xpub (1024, -1);
+    send_string_expect_success (xpub, "t1", ZLINK_SNDMORE);
+    send_string_expect_success (xpub, "old", 0);
+    send_string_expect_success (xpub, "t1", ZLINK_SNDMORE);
+    send_string_expect_success (xpub, "new", 0);
+    send_string_expect_success (xpub, "t2", ZLINK_SNDMORE);
+    send_string_expect_success (xpub, "x", 0);
+    TEST_ASSERT_EQUAL_UINT64 (12, cache_size (xpub));
+
+    void *sub = create_sub (xpub, "t1");
+    recv_string_expect_success (sub, "t1", ZLINK_RCVMORE);
+    recv_string_expect_success (sub, "new", 0);
+    expect_nothing (sub);
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_budget ()
+{
+    void *xpub = create_xpub (10, '.');
+    send_string_expect_success (xpub, "a.123", 0);
+    TEST_ASSERT_EQUAL_UINT64 (7, cache_size (xpub));
+
+    //  The topic published least recently makes room.
+    send_string_expect_success (xpub, "b.123", 0);
+    TEST_ASSERT_EQUAL_UINT64 (7, cache_size (xpub));
+
+    //  A value over the budget is not kept, nor is the one it replaces.
+    send_string_expect_success (xpub, "b.123456789", 0);
+    TEST_ASSERT_EQUAL_UINT64 (0, cache_size (xpub));
+    send_string_expect_success (xpub, "c.1", 0);
+    TEST_ASSERT_EQUAL_UINT64 (5, cache_size (xpub));
+
+    void *sub = create_sub (xpub, "");
+    recv_string_expect_success (sub, "c.1", 0);
+    expect_nothing (sub);
+
+    //  Turning the cache off empties it.
+    int budget = 0;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (
+      xpub, ZLINK_XPUB_LAST_VALUE_CACHE, &budget, sizeof budget));
+    TEST_ASSERT_EQUAL_UINT64 (0, cache_size (xpub));
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_invalid_budget);
+    RUN_TEST (test_late_join);
+    RUN_TEST (test_multipart);
+    RUN_TEST (test_budget);
+    return UNITY_END ();
+}
@@ -0,0 +1,169 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <string.h>
+#include <vector>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+//  Enough subscribers for the I/O threads to be asked for help.
+static const int subscriber_count = 300;
+
+static int get_int (void *socket_, int option_)
+{
+    int value = 0;
+    size_t size = sizeof value;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (socket_, option_, &value, &size));
+    return value;
+}
+
+static void set_int (void *socket_, int option_, int value_)
+{
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (socket_, option_, &value_, sizeof value_));
+}
+
+//  Connects subscriber_count SUB sockets subscribed to everything and
+//  waits until the XPUB, which must be verbose, has seen all the
+//  subscriptions.
+static void connect_subscribers (void *xpub_,
+                                 const char *endpoint_,
+                                 std::vector<void *> &subs_,
+                                 int rcvhwm_)
+{
+    for (int i = 0; i != subscriber_count; ++i) {
+        void *sub = zlink_socket (get_test_context (), ZLINK_SUB);
+        TEST_ASSERT_NOT_NULL (sub);
+        set_int (sub, ZLINK_RCVTIMEO, 1000);
+        set_int (sub, ZLINK_RCVHWM, rcvhwm_);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, endpoint_));
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (sub, ZLINK_SUBSCRIBE, "", 0));
+        subs_.push_back (sub);
+    }
+    char buffer[8];
+    for (int i = 0; i != subscriber_count; ++i)
+        TEST_ASSERT_EQUAL_INT (1, zlink_recv (xpub_, buffer, sizeof buffer, 0));
+}
+
+static void close_subscribers (std::vector<void *> &subs_)
+{
+    for (size_t i = 0; i != subs_.size (); ++i) {
+        set_int (subs_[i], ZLINK_LINGER, 0);
+        TEST_ASSERT_SUCCESS_ERRNO (zlink_close (subs_[i]));
+    }
+    subs_.clear ();
+}
+
+void test_option ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    TEST_ASSERT_EQUAL_INT (0, get_int (xpub, ZLINK_XPUB_SHARDS));
+    set_int (xpub, ZLINK_XPUB_SHARDS, -1);
+    TEST_ASSERT_EQUAL_INT (-1, get_int (xpub, ZLINK_XPUB_SHARDS));
+    set_int (xpub, ZLINK_XPUB_SHARDS, 2);
+    TEST_ASSERT_EQUAL_INT (2, get_int (xpub, ZLINK_XPUB_SHARDS));
+
+    int value = -2;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (xpub, ZLINK_XPUB_SHARDS, &value, sizeof value));
+    test_context_socket_close (xpub);
+}
+
+void test_fan_out ()
+{
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_ctx_set (get_test_context (), ZLINK_IO_THREADS, 4));
+
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    set_int (xpub, ZLINK_XPUB_SHARDS, -1);
+    set_int (xpub, ZLINK_XPUB_VERBOSE, 1);
+    set_int (xpub, ZLINK_RCVTIMEO, 1000);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://xpub_shards"));
+
+    std::vector<void *> subs;
+    connect_subscribers (xpub, "inproc://xpub_shards", subs, 1000);
+
+    //  Messages small enough to be copied and large enough to be shared,
+    //  and a multi-part one.
+    char large[256];
+    memset (large, 'x', sizeof large);
+    for (int round = 0; round != 10; ++round) {
+        send_string_expect_success (xpub, "short", 0);
+        TEST_ASSERT_EQUAL_INT (
+          static_cast<int> (sizeof large),
+          zlink_send (xpub, large, sizeof large, 0));
+        send_string_expect_success (xpub, "part1", ZLINK_SNDMORE);
+        send_string_expect_success (xpub, "part2", 0);
+    }
+
+    char buffer[512];
+    for (size_t i = 0; i != subs.size (); ++i) {
+        for (int round = 0; round != 10; ++round) {
+            recv_string_expect_success (subs[i], "short", 0);
+            TEST_ASSERT_EQUAL_INT (
+              static_cast<int> (sizeof large),
+              zlink_recv (subs[i], buffer, sizeof buffer, 0));
+            TEST_ASSERT_EQUAL_MEMORY (large, buffer, sizeof large);
+            recv_string_expect_success (subs[i], "part1", 0);
+            TEST_ASSERT_TRUE (get_int (subs[i], ZLINK_RCVMORE));
+            recv_string_expect_success (subs[i], "part2", 0);
+        }
+    }
+
+    close_subscribers (subs);
+    test_context_socket_close (xpub);
+}
+
+void test_fan_out_past_hwm ()
+{
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_ctx_set (get_test_context (), ZLINK_IO_THREADS, 4));
+
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    set_int (xpub, ZLINK_XPUB_SHARDS, -1);
+    set_int (xpub, ZLINK_XPUB_VERBOSE, 1);
+    set_int (xpub, ZLINK_SNDHWM, 10);
+    set_int (xpub, ZLINK_RCVTIMEO, 1000);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://xpub_shards_hwm"));
+
+    std::vector<void *> subs;
+    connect_subscribers (xpub, "inproc://xpub_shards_hwm", subs, 10);
+
+    //  The subscribers don't read, so most messages are dropped for them;
+    //  each one gets the leading messages, in order.
+    char large[256];
+    for (int i = 0; i != 100; ++i) {
+        memset (large, 'a' + i % 26, sizeof large);
+        TEST_ASSERT_EQUAL_INT (static_cast<int> (sizeof large),
+                               zlink_send (xpub, large, sizeof large, 0));
+    }
+
+    char buffer[512];
+    for (size_t i = 0; i != subs.size (); ++i) {
+        int received = 0;
+        while (zlink_recv (subs[i], buffer, sizeof buffer, ZLINK_DONTWAIT)
+               != -1) {
+            TEST_ASSERT_EQUAL_INT ('a' + received % 26, buffer[0]);
+            ++received;
+        }
+        TEST_ASSERT_GREATER_THAN_INT (0, received);
+        TEST_ASSERT_LESS_THAN_INT (100, received);
+    }
+
+    close_subscribers (subs);
+    test_context_socket_close (xpub);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_option);
+    RUN_TEST (test_fan_out);
+    RUN_TEST (test_fan_out_past_hwm);
+    return UNITY_END ();
+}
@@ -0,0 +1,196 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <string.h>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+static int get_int (void *socket_, int option_)
+{
+    int value = -1;
+    size_t size = sizeof value;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_getsockopt (socket_, option_, &value, &size));
+    return value;
+}
+
+static void set_int (void *socket_, int option_, int value_)
+{
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (socket_, option_, &value_, sizeof value_));
+}
+
+static zlink_peer_info_t peer_info (void *xpub_)
+{
+    zlink_peer_info_t info;
+    size_t count = 1;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_socket_peers (xpub_, &info, &count));
+    TEST_ASSERT_EQUAL_UINT64 (1, count);
+    return info;
+}
+
+static void *create_xpub (int policy_, int limit_)
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    set_int (xpub, ZLINK_SNDHWM, 1);
+    set_int (xpub, ZLINK_XPUB_SLOW_POLICY, policy_);
+    set_int (xpub, ZLINK_XPUB_SLOW_LIMIT, limit_);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://slow_policy"));
+    return xpub;
+}
+
+static void *create_sub (void *xpub_)
+{
+    void *sub = test_context_socket (ZLINK_SUB);
+    set_int (sub, ZLINK_RCVHWM, 1);
+    set_int (sub, ZLINK_RCVTIMEO, 100);
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, "inproc://slow_policy"));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_setsockopt (sub, ZLINK_SUBSCRIBE, "", 0));
+    char buffer[8];
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_recv (xpub_, buffer, sizeof buffer, 0));
+    return sub;
+}
+
+//  Sends m1 to m<count_>. With both high-water marks at 1 the pipe takes
+//  two of them.
+static void send_updates (void *xpub_, int count_)
+{
+    for (int i = 1; i <= count_; ++i) {
+        char update[8];
+        snprintf (update, sizeof update, "m%d", i);
+        send_string_expect_success (xpub_, update, 0);
+    }
+}
+
+//  Receives everything the subscriber gets, letting the publisher refill
+//  the pipe in between, into a space separated list.
+static void recv_all (void *xpub_, void *sub_, char *out_)
+{
+    out_[0] = 0;
+    char buffer[32];
+    int rc;
+    while ((rc = zlink_recv (sub_, buffer, sizeof buffer - 1, 0)) != -1) {
+        buffer[rc] = 0;
+        if (out_[0])
+            strcat (out_, " ");
+        strcat (out_, buffer);
+        get_int (xpub_, ZLINK_EVENTS);
+    }
+    TEST_ASSERT_EQUAL_INT (EAGAIN, errno);
+}
+
+void test_invalid_options ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    TEST_ASSERT_EQUAL_INT (ZLINK_XPUB_DROP_NEWEST,
+                           get_int (xpub, ZLINK_XPUB_SLOW_POLICY));
+    TEST_ASSERT_EQUAL_INT (1000, get_int (xpub, ZLINK_XPUB_SLOW_LIMIT));
+
+    int value = ZLINK_XPUB_DISCONNECT + 1;
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_setsockopt (xpub, ZLINK_XPUB_SLOW_POLICY,
+                                                 &value, sizeof value));
+    value = -1;
+    TEST_ASSERT_FAILURE_ERRNO (EINVAL,
+                               zlink_setsockopt (xpub, ZLINK_XPUB_SLOW_POLICY,
+                                                 &value, sizeof value));
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL,
+      zlink_setsockopt (xpub, ZLINK_XPUB_SLOW_LIMIT, &value, sizeof value));
+    test_context_socket_close (xpub);
+}
+
+void test_drop_newest ()
+{
+    void *xpub = create_xpub (ZLINK_XPUB_DROP_NEWEST, 2);
+    void *sub = create_sub (xpub);
+
+    send_updates (xpub, 5);
+    zlink_peer_info_t info = peer_info (xpub);
+    TEST_ASSERT_EQUAL_UINT64 (3, info.msgs_dropped);
+    TEST_ASSERT_EQUAL_UINT64 (2, info.lag);
+
+    char received[256];
+    recv_all (xpub, sub, received);
+    TEST_ASSERT_EQUAL_STRING ("m1 m2", received);
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_spill ()
+{
+    void *xpub = create_xpub (ZLINK_XPUB_SPILL, 2);
+    void *sub = create_sub (xpub);
+
+    //  Two more wait in the spill buffer, the rest are dropped.
+    send_updates (xpub, 6);
+    zlink_peer_info_t info = peer_info (xpub);
+    TEST_ASSERT_EQUAL_UINT64 (2, info.msgs_dropped);
+    TEST_ASSERT_EQUAL_UINT64 (4, info.lag);
+
+    char received[256];
+    recv_all (xpub, sub, received);
+    TEST_ASSERT_EQUAL_STRING ("m1 m2 m3 m4", received);
+
+    //  With the buffer drained, messages flow directly again.
+    send_string_expect_success (xpub, "m7", 0);
+    recv_all (xpub, sub, received);
+    TEST_ASSERT_EQUAL_STRING ("m7", received);
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_drop_oldest ()
+{
+    void *xpub = create_xpub (ZLINK_XPUB_DROP_OLDEST, 2);
+    void *sub = create_sub (xpub);
+
+    //  Messages already in the pipe stay; the buffer keeps the newest.
+    send_updates (xpub, 6);
+    zlink_peer_info_t info = peer_info (xpub);
+    TEST_ASSERT_EQUAL_UINT64 (2, info.msgs_dropped);
+    TEST_ASSERT_EQUAL_UINT64 (4, info.lag);
+
+    char received[256];
+    recv_all (xpub, sub, received);
+    TEST_ASSERT_EQUAL_STRING ("m1 m2 m5 m6", received);
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+void test_disconnect ()
+{
+    void *xpub = create_xpub (ZLINK_XPUB_DISCONNECT, 2);
+    void *sub = create_sub (xpub);
+
+    //  The second drop cuts the subscriber off; what was in the pipe is
+    //  still delivered.
+    send_updates (xpub, 5);
+    char received[256];
+    recv_all (xpub, sub, received);
+    TEST_ASSERT_EQUAL_STRING ("m1 m2", received);
+
+    msleep (SETTLE_TIME);
+    TEST_ASSERT_EQUAL_INT (0, zlink_socket_peer_count (xpub));
+
+    test_context_socket_close (sub);
+    test_context_socket_close (xpub);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_invalid_options);
+    RUN_TEST (test_drop_newest);
+    RUN_TEST (test_spill);
+    RUN_TEST (test_drop_oldest);
+    RUN_TEST (test_disconnect);
+    return UNITY_END ();
+}
@@ -0,0 +1,140 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "testutil.hpp"
+#include "testutil_unity.hpp"
+
+#include <string.h>
+
+SETUP_TEARDOWN_TESTCONTEXT
+
+static uint64_t get_counter (void *xpub_, int option_)
+{
+    uint64_t value = 0;
+    size_t size = sizeof value;
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_getsockopt (xpub_, option_, &value, &size));
+    TEST_ASSERT_EQUAL_UINT64 (sizeof value, size);
+    return value;
+}
+
+static void *create_sub (const char *topic_)
+{
+    void *sub = test_context_socket (ZLINK_SUB);
+    int timeout = 100;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_RCVTIMEO, &timeout, sizeof timeout));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_connect (sub, "inproc://topic_cache"));
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub, ZLINK_SUBSCRIBE, topic_, strlen (topic_)));
+    return sub;
+}
+
+//  Receives the (un)subscription of topic_ on xpub_.
+static void recv_notification (void *xpub_, bool subscribe_, const char *topic_)
+{
+    char buffer[32];
+    const int rc =
+      TEST_ASSERT_SUCCESS_ERRNO (zlink_recv (xpub_, buffer, sizeof buffer, 0));
+    TEST_ASSERT_EQUAL_INT (strlen (topic_) + 1, rc);
+    TEST_ASSERT_EQUAL_UINT8 (subscribe_ ? 1 : 0, buffer[0]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY (topic_, buffer + 1, rc - 1);
+}
+
+//  Publishes str_ and checks which of the subscribers got it.
+static void publish (void *xpub_,
+                     const char *str_,
+                     void *receivers_[],
+                     int receiver_count_,
+                     void *others_[],
+                     int other_count_)
+{
+    send_string_expect_success (xpub_, str_, 0);
+    for (int i = 0; i != receiver_count_; ++i)
+        recv_string_expect_success (receivers_[i], str_, 0);
+    for (int i = 0; i != other_count_; ++i) {
+        char buffer[32];
+        TEST_ASSERT_FAILURE_ERRNO (
+          EAGAIN, zlink_recv (others_[i], buffer, sizeof buffer, 0));
+    }
+}
+
+void test_invalid_size ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    int size = -1;
+    TEST_ASSERT_FAILURE_ERRNO (
+      EINVAL, zlink_setsockopt (xpub, ZLINK_XPUB_TOPIC_CACHE, &size, sizeof size));
+    TEST_ASSERT_EQUAL_UINT64 (0, get_counter (xpub, ZLINK_XPUB_TOPIC_CACHE_HITS));
+    TEST_ASSERT_EQUAL_UINT64 (0,
+                              get_counter (xpub, ZLINK_XPUB_TOPIC_CACHE_MISSES));
+    test_context_socket_close (xpub);
+}
+
+void test_topic_cache ()
+{
+    void *xpub = test_context_socket (ZLINK_XPUB);
+    int size = 16;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (xpub, ZLINK_XPUB_TOPIC_CACHE, &size, sizeof size));
+    TEST_ASSERT_SUCCESS_ERRNO (zlink_bind (xpub, "inproc://topic_cache"));
+
+    void *sub_a = create_sub ("A");
+    recv_notification (xpub, true, "A");
+    void *sub_ab = create_sub ("AB");
+    recv_notification (xpub, true, "AB");
+
+    void *both[] = {sub_a, sub_ab};
+    void *only_a[] = {sub_a};
+    void *only_ab[] = {sub_ab};
+
+    //  Messages agreeing on the first two bytes share an entry.
+    publish (xpub, "ABC1", both, 2, NULL, 0);
+    publish (xpub, "ABC2", both, 2, NULL, 0);
+    publish (xpub, "AX", only_a, 1, only_ab, 1);
+    publish (xpub, "B", NULL, 0, both, 2);
+    TEST_ASSERT_EQUAL_UINT64 (3,
+                              get_counter (xpub, ZLINK_XPUB_TOPIC_CACHE_MISSES));
+    TEST_ASSERT_EQUAL_UINT64 (1, get_counter (xpub, ZLINK_XPUB_TOPIC_CACHE_HITS));
+
+    //  Unsubscribing drops the cached entries.
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (sub_ab, ZLINK_UNSUBSCRIBE, "AB", 2));
+    recv_notification (xpub, false, "AB");
+    publish (xpub, "ABC3", only_a, 1, only_ab, 1);
+
+    //  A longer subscription makes more of the message significant.
+    void *sub_abcd = create_sub ("ABCD");
+    recv_notification (xpub, true, "ABCD");
+    void *a_and_abcd[] = {sub_a, sub_abcd};
+    void *only_abcd[] = {sub_abcd};
+    publish (xpub, "ABCD", a_and_abcd, 2, only_ab, 1);
+    publish (xpub, "ABCE", only_a, 1, only_abcd, 1);
+
+    //  A closed subscriber's pipe is not used any more.
+    test_context_socket_close (sub_a);
+    msleep (SETTLE_TIME);
+    publish (xpub, "ABCD", only_abcd, 1, only_ab, 1);
+
+    //  With room for a single topic, alternating topics still reach the
+    //  right subscribers.
+    size = 1;
+    TEST_ASSERT_SUCCESS_ERRNO (
+      zlink_setsockopt (xpub, ZLINK_XPUB_TOPIC_CACHE, &size, sizeof size));
+    for (int i = 0; i != 3; ++i) {
+        publish (xpub, "ABCD", only_abcd, 1, only_ab, 1);
+        publish (xpub, "ABCX", NULL, 0, only_abcd, 1);
+    }
+
+    test_context_socket_close (sub_ab);
+    test_context_socket_close (sub_abcd);
+    test_context_socket_close (xpub);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_invalid_size);
+    RUN_TEST (test_topic_cache);
+    return UNITY_END ();
+}
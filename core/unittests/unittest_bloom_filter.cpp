@@ -0,0 +1,161 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "../tests/testutil.hpp"
+
+#include <bloom_filter.hpp>
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include <unity.h>
+
+void setUp ()
+{
+}
+void tearDown ()
+{
+}
+
+static void filter_add (zlink::bloom_filter_t &filter_, const std::string &prefix_)
+{
+    filter_.add (reinterpret_cast<const unsigned char *> (prefix_.data ()),
+                 prefix_.size ());
+}
+
+static void filter_rm (zlink::bloom_filter_t &filter_, const std::string &prefix_)
+{
+    filter_.rm (reinterpret_cast<const unsigned char *> (prefix_.data ()),
+                prefix_.size ());
+}
+
+static bool filter_check (const zlink::bloom_filter_t &filter_,
+                          const std::string &data_)
+{
+    return filter_.check (reinterpret_cast<const unsigned char *> (data_.data ()),
+                          data_.size ());
+}
+
+static std::string random_string (size_t size_)
+{
+    std::string s (size_, 0);
+    for (size_t i = 0; i != size_; ++i)
+        s[i] = static_cast<char> ('a' + rand () % 26);
+    return s;
+}
+
+void test_disabled ()
+{
+    zlink::bloom_filter_t filter;
+    TEST_ASSERT_FALSE (filter.enabled ());
+    filter_add (filter, "foo");
+    TEST_ASSERT_TRUE (filter_check (filter, "bar"));
+}
+
+void test_empty ()
+{
+    zlink::bloom_filter_t filter;
+    filter.reset (1024);
+    TEST_ASSERT_TRUE (filter.enabled ());
+    TEST_ASSERT_FALSE (filter_check (filter, ""));
+    TEST_ASSERT_FALSE (filter_check (filter, "foo"));
+}
+
+void test_prefix_lengths ()
+{
+    zlink::bloom_filter_t filter;
+    filter.reset (1024);
+
+    //  Sizes on, between and past the fixed lengths.
+    const std::string prefixes[] = {"a", "bc", "def", "ghijk",
+                                    random_string (40)};
+    for (int i = 0; i != 5; ++i)
+        filter_add (filter, prefixes[i]);
+    for (int i = 0; i != 5; ++i) {
+        TEST_ASSERT_TRUE (filter_check (filter, prefixes[i]));
+        TEST_ASSERT_TRUE (filter_check (filter, prefixes[i] + "suffix"));
+    }
+
+    //  Shorter than the prefix filed at the level.
+    TEST_ASSERT_FALSE (filter_check (filter, "b"));
+    TEST_ASSERT_FALSE (filter_check (filter, "xyz"));
+
+    for (int i = 0; i != 5; ++i)
+        filter_rm (filter, prefixes[i]);
+    for (int i = 0; i != 5; ++i)
+        TEST_ASSERT_FALSE (filter_check (filter, prefixes[i] + "suffix"));
+}
+
+void test_match_all ()
+{
+    zlink::bloom_filter_t filter;
+    filter.reset (1024);
+    filter_add (filter, "");
+    TEST_ASSERT_TRUE (filter_check (filter, ""));
+    TEST_ASSERT_TRUE (filter_check (filter, "anything"));
+    filter_rm (filter, "");
+    TEST_ASSERT_FALSE (filter_check (filter, "anything"));
+}
+
+void test_no_false_negatives ()
+{
+    zlink::bloom_filter_t filter;
+    filter.reset (4096);
+
+    std::vector<std::string> prefixes;
+    for (int i = 0; i != 2000; ++i) {
+        prefixes.push_back (random_string (1 + rand () % 48));
+        filter_add (filter, prefixes.back ());
+    }
+    for (size_t i = 0; i != prefixes.size (); ++i)
+        TEST_ASSERT_TRUE (filter_check (filter, prefixes[i] + random_string (8)));
+
+    //  Removing half of them leaves the other half matching.
+    for (size_t i = 0; i < prefixes.size (); i += 2)
+        filter_rm (filter, prefixes[i]);
+    for (size_t i = 1; i < prefixes.size (); i += 2)
+        TEST_ASSERT_TRUE (filter_check (filter, prefixes[i] + random_string (8)));
+}
+
+void test_false_positive_rate ()
+{
+    zlink::bloom_filter_t filter;
+    filter.reset (65536);
+    for (int i = 0; i != 1000; ++i)
+        filter_add (filter, "A" + random_string (15));
+
+    int false_positives = 0;
+    for (int i = 0; i != 10000; ++i)
+        if (filter_check (filter, "B" + random_string (31)))
+            ++false_positives;
+    TEST_ASSERT_LESS_THAN_INT (100, false_positives);
+}
+
+void test_saturation ()
+{
+    zlink::bloom_filter_t filter;
+    filter.reset (16);
+
+    //  A saturated counter stays set rather than wrapping to zero.
+    for (int i = 0; i != 300; ++i)
+        filter_add (filter, "foo");
+    filter_add (filter, "bar");
+    for (int i = 0; i != 300; ++i)
+        filter_rm (filter, "foo");
+    TEST_ASSERT_TRUE (filter_check (filter, "foo"));
+    TEST_ASSERT_TRUE (filter_check (filter, "bar"));
+}
+
+int main (void)
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_disabled);
+    RUN_TEST (test_empty);
+    RUN_TEST (test_prefix_lengths);
+    RUN_TEST (test_match_all);
+    RUN_TEST (test_no_false_negatives);
+    RUN_TEST (test_false_positive_rate);
+    RUN_TEST (test_saturation);
+    return UNITY_END ();
+}
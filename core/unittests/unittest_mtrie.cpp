@@ -8,6 +8,8 @@
 
 #include <generic_mtrie_impl.hpp>
 
+#include <set>
+#include <string>
 #include <unity.h>
 
 void setUp ()
@@ -431,6 +433,38 @@ void test_rm_with_callback_duplicate_uniq_only ()
     mtrie.rm (&pipes[1], check_count, &count, true);
 }
 
+void collect_prefix (const unsigned char *data_,
+                     size_t size_,
+                     std::set<std::string> *prefixes_)
+{
+    prefixes_->insert (
+      std::string (reinterpret_cast<const char *> (data_), size_));
+}
+
+void test_apply ()
+{
+    const char *names[] = {"", "foo", "foobar", "fob", "baz", "bazaar"};
+    int pipes[2];
+    zlink::generic_mtrie_t<int> mtrie;
+    for (int i = 0; i != 6; ++i) {
+        const zlink::generic_mtrie_t<int>::prefix_t name_data =
+          reinterpret_cast<zlink::generic_mtrie_t<int>::prefix_t> (names[i]);
+        mtrie.add (name_data, getlen (name_data), &pipes[i % 2]);
+    }
+    const zlink::generic_mtrie_t<int>::prefix_t removed =
+      reinterpret_cast<zlink::generic_mtrie_t<int>::prefix_t> ("fob");
+    mtrie.rm (removed, getlen (removed), &pipes[1]);
+
+    std::set<std::string> prefixes;
+    mtrie.apply (collect_prefix, &prefixes);
+    TEST_ASSERT_EQUAL_INT (5, prefixes.size ());
+    TEST_ASSERT_TRUE (prefixes.count (""));
+    TEST_ASSERT_TRUE (prefixes.count ("foo"));
+    TEST_ASSERT_TRUE (prefixes.count ("foobar"));
+    TEST_ASSERT_TRUE (prefixes.count ("baz"));
+    TEST_ASSERT_TRUE (prefixes.count ("bazaar"));
+}
+
 int main (void)
 {
     setup_test_environment ();
@@ -463,5 +497,7 @@ int main (void)
     RUN_TEST (test_rm_with_callback_duplicate);
     RUN_TEST (test_rm_with_callback_duplicate_uniq_only);
 
+    RUN_TEST (test_apply);
+
     return UNITY_END ();
 }
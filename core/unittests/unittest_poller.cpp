@@ -5,6 +5,7 @@
 #include <poller.hpp>
 #include <i_poll_events.hpp>
 #include <ip.hpp>
+#include <config.hpp>
 
 #include <boost/asio.hpp>
 #include <unity.h>
@@ -186,6 +187,45 @@ void test_add_fd_and_remove_by_timer ()
     wait_timer_events (events);
 }
 
+void test_traffic_window ()
+{
+    zlink::thread_ctx_t thread_ctx;
+    zlink::poller_t poller (thread_ctx);
+
+    boost::asio::io_context &io_context = poller.get_io_context ();
+    boost::asio::ip::tcp::socket server (io_context);
+    boost::asio::ip::tcp::socket client (io_context);
+    create_connected_tcp_pair (io_context, &server, &client);
+
+    test_events_t events (poller);
+
+    zlink::poller_t::handle_t handle = poller.add_tcp_socket (&server, &events);
+    events.set_handle (handle);
+
+    //  Traffic accounted to the first window shows up once it closes and
+    //  is gone again after the following, empty, window. Placements only
+    //  count until the window closes.
+    poller.add_traffic (1000);
+    poller.add_placement ();
+    poller.add_placement ();
+    TEST_ASSERT_EQUAL_INT (2, poller.get_placements ());
+    poller.add_timer (zlink::traffic_window_ms * 5 / 2, &events, 0);
+    TEST_ASSERT_EQUAL_UINT64 (0, poller.get_traffic ());
+    poller.start ();
+
+    while (poller.get_traffic () == 0)
+        msleep (1);
+    const uint64_t traffic = poller.get_traffic ();
+    TEST_ASSERT_LESS_OR_EQUAL_UINT64 (1000, traffic);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT64 (500, traffic);
+    TEST_ASSERT_EQUAL_INT (0, poller.get_placements ());
+
+    while (poller.get_traffic () != 0)
+        msleep (1);
+
+    wait_timer_events (events);
+}
+
 int main (void)
 {
     UNITY_BEGIN ();
@@ -196,6 +236,7 @@ int main (void)
     RUN_TEST (test_create);
     RUN_TEST (test_add_fd_and_start_and_receive_data);
     RUN_TEST (test_add_fd_and_remove_by_timer);
+    RUN_TEST (test_traffic_window);
 
     zlink::shutdown_network ();
 
@@ -0,0 +1,211 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "../tests/testutil.hpp"
+
+#include <timer_wheel.hpp>
+
+#include <stdlib.h>
+#include <unity.h>
+#include <vector>
+
+void setUp ()
+{
+}
+void tearDown ()
+{
+}
+
+//  Arbitrary start, not aligned to any level of the wheel.
+static const uint64_t start = 123456789;
+
+static int sink_a, sink_b;
+
+//  Advances the wheel a millisecond at a time up to until_ and returns the
+//  time the timer (sink_, id_) fired at, or 0 if it did not.
+static uint64_t run_until (zlink::timer_wheel_t &wheel_,
+                           uint64_t from_,
+                           uint64_t until_,
+                           void *sink_,
+                           int id_)
+{
+    uint64_t fired = 0;
+    for (uint64_t now = from_; now <= until_; ++now) {
+        void *sink;
+        int id;
+        while (wheel_.pop (now, &sink, &id)) {
+            TEST_ASSERT_EQUAL_PTR (sink_, sink);
+            TEST_ASSERT_EQUAL_INT (id_, id);
+            TEST_ASSERT_EQUAL_UINT64 (0, fired);
+            fired = now;
+        }
+    }
+    return fired;
+}
+
+void test_empty ()
+{
+    zlink::timer_wheel_t wheel;
+    TEST_ASSERT_TRUE (wheel.empty ());
+    TEST_ASSERT_EQUAL_UINT64 (UINT64_MAX, wheel.next_expiry ());
+    void *sink;
+    int id;
+    TEST_ASSERT_FALSE (wheel.pop (start, &sink, &id));
+    TEST_ASSERT_FALSE (wheel.cancel (&sink_a, 1));
+}
+
+void test_fires_on_time ()
+{
+    //  One timeout per level, and the first ones past a level boundary.
+    const uint64_t timeouts[] = {0, 1, 63, 64, 65, 1000, 4095, 4096, 5000};
+    for (size_t i = 0; i != sizeof timeouts / sizeof timeouts[0]; ++i) {
+        zlink::timer_wheel_t wheel;
+        wheel.add (start, timeouts[i], &sink_a, 7);
+        TEST_ASSERT_EQUAL_UINT64 (1, wheel.size ());
+        TEST_ASSERT_EQUAL_UINT64 (
+          start + timeouts[i],
+          run_until (wheel, start, start + timeouts[i] + 10, &sink_a, 7));
+        TEST_ASSERT_TRUE (wheel.empty ());
+    }
+}
+
+void test_fires_after_jump ()
+{
+    //  Long timeouts cascade correctly when the wheel is advanced in
+    //  large steps, including past the overflow list.
+    const uint64_t timeouts[] = {70, 300000, 20000000, 50000000};
+    for (size_t i = 0; i != sizeof timeouts / sizeof timeouts[0]; ++i) {
+        zlink::timer_wheel_t wheel;
+        wheel.add (start, timeouts[i], &sink_a, 1);
+        void *sink;
+        int id;
+        uint64_t now = start;
+        while (now < start + timeouts[i] - 1) {
+            //  Jump straight to where the wheel needs attention.
+            const uint64_t next = wheel.next_expiry ();
+            TEST_ASSERT_TRUE (next > now);
+            TEST_ASSERT_TRUE (next <= start + timeouts[i]);
+            now = next < start + timeouts[i] - 1 ? next : start + timeouts[i] - 1;
+            TEST_ASSERT_FALSE (wheel.pop (now, &sink, &id));
+        }
+        TEST_ASSERT_TRUE (wheel.pop (start + timeouts[i], &sink, &id));
+        TEST_ASSERT_EQUAL_PTR (&sink_a, sink);
+        TEST_ASSERT_TRUE (wheel.empty ());
+    }
+}
+
+void test_next_expiry ()
+{
+    zlink::timer_wheel_t wheel;
+    wheel.add (start, 10, &sink_a, 1);
+    TEST_ASSERT_EQUAL_UINT64 (start + 10, wheel.next_expiry ());
+
+    //  A later timer does not move it, an earlier one does.
+    wheel.add (start, 5000, &sink_a, 2);
+    TEST_ASSERT_EQUAL_UINT64 (start + 10, wheel.next_expiry ());
+    wheel.add (start, 3, &sink_a, 3);
+    TEST_ASSERT_EQUAL_UINT64 (start + 3, wheel.next_expiry ());
+
+    //  With the first level empty it is a lower bound.
+    TEST_ASSERT_TRUE (wheel.cancel (&sink_a, 1));
+    TEST_ASSERT_TRUE (wheel.cancel (&sink_a, 3));
+    TEST_ASSERT_TRUE (wheel.next_expiry () > start);
+    TEST_ASSERT_TRUE (wheel.next_expiry () <= start + 5000);
+
+    //  Due timers make it the current time.
+    wheel.add (start, 0, &sink_a, 4);
+    TEST_ASSERT_EQUAL_UINT64 (start, wheel.next_expiry ());
+}
+
+void test_cancel ()
+{
+    zlink::timer_wheel_t wheel;
+    wheel.add (start, 100, &sink_a, 1);
+    wheel.add (start, 100, &sink_b, 1);
+    wheel.add (start, 200, &sink_a, 2);
+    TEST_ASSERT_EQUAL_UINT64 (3, wheel.size ());
+
+    TEST_ASSERT_TRUE (wheel.cancel (&sink_a, 1));
+    TEST_ASSERT_FALSE (wheel.cancel (&sink_a, 1));
+    TEST_ASSERT_TRUE (wheel.cancel (&sink_a, 2));
+    TEST_ASSERT_EQUAL_UINT64 (1, wheel.size ());
+    TEST_ASSERT_EQUAL_UINT64 (start + 100,
+                              run_until (wheel, start, start + 300, &sink_b, 1));
+}
+
+void test_cancel_due ()
+{
+    //  A due timer not yet popped can still be cancelled.
+    zlink::timer_wheel_t wheel;
+    wheel.add (start, 5, &sink_a, 1);
+    wheel.add (start, 5, &sink_a, 2);
+    void *sink;
+    int id;
+    TEST_ASSERT_TRUE (wheel.pop (start + 5, &sink, &id));
+    TEST_ASSERT_TRUE (wheel.cancel (&sink_a, id == 1 ? 2 : 1));
+    TEST_ASSERT_FALSE (wheel.pop (start + 5, &sink, &id));
+    TEST_ASSERT_TRUE (wheel.empty ());
+}
+
+void test_duplicates ()
+{
+    zlink::timer_wheel_t wheel;
+    wheel.add (start, 10, &sink_a, 1);
+    wheel.add (start, 20, &sink_a, 1);
+    TEST_ASSERT_TRUE (wheel.cancel (&sink_a, 1));
+    TEST_ASSERT_EQUAL_UINT64 (1, wheel.size ());
+    TEST_ASSERT_TRUE (wheel.cancel (&sink_a, 1));
+    TEST_ASSERT_TRUE (wheel.empty ());
+}
+
+void test_many ()
+{
+    //  Random timeouts across all levels, a quarter of them cancelled, and
+    //  the wheel advanced in uneven steps: every remaining timer fires
+    //  exactly once, at its expiry or within the step that passed it.
+    zlink::timer_wheel_t wheel;
+    const int count = 20000;
+    std::vector<uint64_t> expiry (count);
+    std::vector<int> fired (count, 0);
+    srand (1);
+    for (int i = 0; i != count; ++i) {
+        const uint64_t timeout = 1 + static_cast<uint64_t> (rand ()) % 400000;
+        expiry[i] = start + timeout;
+        wheel.add (start, timeout, &sink_a, i);
+    }
+    for (int i = 0; i < count; i += 4) {
+        TEST_ASSERT_TRUE (wheel.cancel (&sink_a, i));
+        fired[i] = -1;
+    }
+
+    uint64_t now = start;
+    while (!wheel.empty ()) {
+        const uint64_t previous = now;
+        now += 1 + static_cast<uint64_t> (rand ()) % 700;
+        void *sink;
+        int id;
+        while (wheel.pop (now, &sink, &id)) {
+            TEST_ASSERT_EQUAL_INT (0, fired[id]);
+            TEST_ASSERT_TRUE (expiry[id] <= now);
+            TEST_ASSERT_TRUE (expiry[id] > previous);
+            fired[id] = 1;
+        }
+    }
+    for (int i = 0; i != count; ++i)
+        TEST_ASSERT_EQUAL_INT (i % 4 == 0 ? -1 : 1, fired[i]);
+}
+
+int main ()
+{
+    setup_test_environment ();
+
+    UNITY_BEGIN ();
+    RUN_TEST (test_empty);
+    RUN_TEST (test_fires_on_time);
+    RUN_TEST (test_fires_after_jump);
+    RUN_TEST (test_next_expiry);
+    RUN_TEST (test_cancel);
+    RUN_TEST (test_cancel_due);
+    RUN_TEST (test_duplicates);
+    RUN_TEST (test_many);
+    return UNITY_END ();
+}
@@ -0,0 +1,268 @@
+/* SPDX-License-Identifier: MPL-2.0 */
+
+#include "../tests/testutil.hpp"
+
+#include "transports/ws/ws_frame.hpp"
+
+#include <unity.h>
+#include <string.h>
+#include <vector>
+
+void setUp ()
+{
+}
+
+void tearDown ()
+{
+}
+
+static const unsigned char key[4] = {0x12, 0x34, 0x56, 0x78};
+
+static void append_frame (std::vector<unsigned char> &buf_,
+                          unsigned char opcode_,
+                          const unsigned char *data_,
+                          size_t size_,
+                          const unsigned char *key_)
+{
+    unsigned char header[zlink::ws_max_frame_header_size];
+    const size_t header_size =
+      zlink::ws_encode_frame_header (header, opcode_, size_, key_);
+    buf_.insert (buf_.end (), header, header + header_size);
+    const size_t offset = buf_.size ();
+    buf_.insert (buf_.end (), data_, data_ + size_);
+    if (key_ && size_ > 0)
+        zlink::ws_mask (&buf_[offset], size_, key_, 0);
+}
+
+void test_encode_header_sizes ()
+{
+    unsigned char header[zlink::ws_max_frame_header_size];
+
+    TEST_ASSERT_EQUAL_INT (2, zlink::ws_encode_frame_header (
+                                header, zlink::ws_opcode_binary, 125, NULL));
+    TEST_ASSERT_EQUAL_HEX8 (0x82, header[0]);
+    TEST_ASSERT_EQUAL_HEX8 (125, header[1]);
+
+    TEST_ASSERT_EQUAL_INT (4, zlink::ws_encode_frame_header (
+                                header, zlink::ws_opcode_binary, 126, NULL));
+    TEST_ASSERT_EQUAL_HEX8 (126, header[1]);
+
+    TEST_ASSERT_EQUAL_INT (14, zlink::ws_encode_frame_header (
+                                 header, zlink::ws_opcode_binary, 70000, key));
+    TEST_ASSERT_EQUAL_HEX8 (0x80 | 127, header[1]);
+    TEST_ASSERT_EQUAL_MEMORY (key, header + 10, 4);
+}
+
+void test_mask_offset ()
+{
+    unsigned char data[37];
+    for (size_t i = 0; i < sizeof data; ++i)
+        data[i] = static_cast<unsigned char> (i * 7);
+
+    //  Masking in two pieces must match masking in one.
+    unsigned char whole[sizeof data];
+    memcpy (whole, data, sizeof data);
+    zlink::ws_mask (whole, sizeof whole, key, 0);
+    for (size_t i = 0; i < sizeof data; ++i)
+        TEST_ASSERT_EQUAL_HEX8 (data[i] ^ key[i & 3], whole[i]);
+
+    zlink::ws_mask (data, 5, key, 0);
+    zlink::ws_mask (data + 5, sizeof data - 5, key, 5);
+    TEST_ASSERT_EQUAL_MEMORY (whole, data, sizeof data);
+}
+
+//  Random sizes, start alignments and key offsets; the kernel must match
+//  a plain byte loop. Kernels the host can't run are skipped.
+static void test_mask_kernel (zlink::ws_mask_kernel_t kernel_)
+{
+    const zlink::ws_mask_fn fn = zlink::ws_mask_kernel (kernel_);
+    if (!fn)
+        TEST_IGNORE_MESSAGE ("kernel not supported on this host");
+
+    uint32_t state = 12345;
+    std::vector<unsigned char> reference (4200);
+    std::vector<unsigned char> masked (reference.size ());
+
+    for (int round = 0; round < 2000; ++round) {
+        unsigned char round_key[4];
+        for (size_t i = 0; i < reference.size (); ++i) {
+            state = state * 1103515245 + 12345;
+            reference[i] = static_cast<unsigned char> (state >> 16);
+        }
+        for (size_t i = 0; i < sizeof round_key; ++i)
+            round_key[i] = reference[i];
+        masked = reference;
+
+        const size_t start = state % 64;
+        const size_t size =
+          round < 200 ? round : (state >> 8) % (reference.size () - 64);
+        const size_t offset = (state >> 4) % 4;
+
+        for (size_t i = 0; i < size; ++i)
+            reference[start + i] ^= round_key[(offset + i) & 3];
+        fn (&masked[start], size, round_key, offset);
+
+        TEST_ASSERT_EQUAL_MEMORY (&reference[0], &masked[0],
+                                  reference.size ());
+    }
+}
+
+void test_mask_scalar ()
+{
+    test_mask_kernel (zlink::ws_mask_kernel_scalar);
+}
+
+void test_mask_sse2 ()
+{
+    test_mask_kernel (zlink::ws_mask_kernel_sse2);
+}
+
+void test_mask_avx2 ()
+{
+    test_mask_kernel (zlink::ws_mask_kernel_avx2);
+}
+
+void test_mask_dispatched ()
+{
+    //  Whatever ws_mask picks must agree with the portable kernel.
+    std::vector<unsigned char> scalar (4099);
+    for (size_t i = 0; i < scalar.size (); ++i)
+        scalar[i] = static_cast<unsigned char> (i * 31);
+    std::vector<unsigned char> dispatched (scalar);
+
+    zlink::ws_mask_scalar (&scalar[1], scalar.size () - 1, key, 3);
+    zlink::ws_mask (&dispatched[1], dispatched.size () - 1, key, 3);
+    TEST_ASSERT_EQUAL_MEMORY (&scalar[0], &dispatched[0], scalar.size ());
+}
+
+void test_decode_masked_frames ()
+{
+    zlink::ws_frame_decoder_t decoder (true);
+
+    std::vector<unsigned char> payload (300);
+    for (size_t i = 0; i < payload.size (); ++i)
+        payload[i] = static_cast<unsigned char> (i);
+
+    std::vector<unsigned char> buf;
+    append_frame (buf, zlink::ws_opcode_binary, &payload[0], 100, key);
+    append_frame (buf, zlink::ws_opcode_binary, &payload[100], 200, key);
+
+    size_t size = 0;
+    TEST_ASSERT_EQUAL_INT (0, decoder.decode (&buf[0], buf.size (), &size));
+    TEST_ASSERT_EQUAL_INT (300, size);
+    TEST_ASSERT_EQUAL_MEMORY (&payload[0], &buf[0], 300);
+    TEST_ASSERT_FALSE (decoder.has_reply ());
+}
+
+void test_decode_split_input ()
+{
+    zlink::ws_frame_decoder_t decoder (true);
+
+    const unsigned char payload[] = "split across every byte boundary";
+    std::vector<unsigned char> buf;
+    append_frame (buf, zlink::ws_opcode_binary, payload, sizeof payload, key);
+
+    //  Feed one byte at a time; headers and key offsets carry over.
+    std::vector<unsigned char> out;
+    for (size_t i = 0; i < buf.size (); ++i) {
+        unsigned char byte = buf[i];
+        size_t size = 0;
+        TEST_ASSERT_EQUAL_INT (0, decoder.decode (&byte, 1, &size));
+        if (size)
+            out.push_back (byte);
+    }
+    TEST_ASSERT_EQUAL_INT (sizeof payload, out.size ());
+    TEST_ASSERT_EQUAL_MEMORY (payload, &out[0], sizeof payload);
+}
+
+void test_decode_ping_and_close ()
+{
+    zlink::ws_frame_decoder_t decoder (true);
+
+    const unsigned char ping[] = "hi";
+    const unsigned char data[] = "data";
+    const unsigned char status[] = {0x03, 0xe8, 'b', 'y', 'e'};
+    std::vector<unsigned char> buf;
+    append_frame (buf, zlink::ws_opcode_ping, ping, 2, key);
+    append_frame (buf, zlink::ws_opcode_binary, data, 4, key);
+    append_frame (buf, zlink::ws_opcode_close, status, sizeof status, key);
+    append_frame (buf, zlink::ws_opcode_binary, data, 4, key);
+
+    size_t size = 0;
+    TEST_ASSERT_EQUAL_INT (0, decoder.decode (&buf[0], buf.size (), &size));
+    TEST_ASSERT_EQUAL_INT (4, size);
+    TEST_ASSERT_EQUAL_MEMORY (data, &buf[0], 4);
+    TEST_ASSERT_TRUE (decoder.close_received ());
+    TEST_ASSERT_TRUE (decoder.has_reply ());
+
+    //  Unmasked pong echoing the ping, then the close status code.
+    std::vector<unsigned char> reply;
+    decoder.take_reply (reply);
+    const unsigned char expected[] = {0x8a, 0x02, 'h',  'i',
+                                      0x88, 0x02, 0x03, 0xe8};
+    TEST_ASSERT_EQUAL_INT (sizeof expected, reply.size ());
+    TEST_ASSERT_EQUAL_MEMORY (expected, &reply[0], sizeof expected);
+    TEST_ASSERT_FALSE (decoder.has_reply ());
+}
+
+void test_decode_violations ()
+{
+    const unsigned char data[] = "x";
+    size_t size = 0;
+
+    //  Unmasked client frame.
+    {
+        zlink::ws_frame_decoder_t decoder (true);
+        std::vector<unsigned char> buf;
+        append_frame (buf, zlink::ws_opcode_binary, data, 1, NULL);
+        TEST_ASSERT_EQUAL_INT (-1,
+                               decoder.decode (&buf[0], buf.size (), &size));
+        TEST_ASSERT_EQUAL_INT (EPROTO, errno);
+    }
+    //  Reserved bit set.
+    {
+        zlink::ws_frame_decoder_t decoder (false);
+        std::vector<unsigned char> buf;
+        append_frame (buf, zlink::ws_opcode_binary, data, 1, NULL);
+        buf[0] |= 0x40;
+        TEST_ASSERT_EQUAL_INT (-1,
+                               decoder.decode (&buf[0], buf.size (), &size));
+    }
+    //  Fragmented control frame.
+    {
+        zlink::ws_frame_decoder_t decoder (false);
+        std::vector<unsigned char> buf;
+        append_frame (buf, zlink::ws_opcode_ping, data, 1, NULL);
+        buf[0] &= 0x7f;
+        TEST_ASSERT_EQUAL_INT (-1,
+                               decoder.decode (&buf[0], buf.size (), &size));
+    }
+    //  Unknown opcode.
+    {
+        zlink::ws_frame_decoder_t decoder (false);
+        std::vector<unsigned char> buf;
+        append_frame (buf, 0x3, data, 1, NULL);
+        TEST_ASSERT_EQUAL_INT (-1,
+                               decoder.decode (&buf[0], buf.size (), &size));
+    }
+}
+
+int main (void)
+{
+    UNITY_BEGIN ();
+
+    setup_test_environment ();
+
+    RUN_TEST (test_encode_header_sizes);
+    RUN_TEST (test_mask_offset);
+    RUN_TEST (test_mask_scalar);
+    RUN_TEST (test_mask_sse2);
+    RUN_TEST (test_mask_avx2);
+    RUN_TEST (test_mask_dispatched);
+    RUN_TEST (test_decode_masked_frames);
+    RUN_TEST (test_decode_split_input);
+    RUN_TEST (test_decode_ping_and_close);
+    RUN_TEST (test_decode_violations);
+
+    return UNITY_END ();
+}
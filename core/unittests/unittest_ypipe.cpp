@@ -55,6 +55,81 @@ void test_write_complete_and_flush_and_check_read_and_read ()
     TEST_ASSERT_EQUAL_INT (value, read_value);
 }
 
+void test_small_initial_chunk ()
+{
+    //  Chunks of 2, 4, 8 and then 16 items; values must come out in order
+    //  across every chunk boundary, also after the queue has shrunk.
+    zlink::ypipe_t<int, 16> ypipe (2);
+    int next_write = 0;
+    int next_read = 0;
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 100; ++i)
+            ypipe.write (next_write++, false);
+        ypipe.flush ();
+        int read_value = -1;
+        while (ypipe.read (&read_value))
+            TEST_ASSERT_EQUAL_INT (next_read++, read_value);
+        TEST_ASSERT_EQUAL_INT (next_write, next_read);
+    }
+}
+
+void test_small_initial_chunk_unwrite ()
+{
+    //  Rolling back incomplete items walks back over chunks of different
+    //  sizes.
+    zlink::ypipe_t<int, 16> ypipe (1);
+    for (int i = 0; i < 40; ++i)
+        ypipe.write (i, true);
+    int value = -1;
+    for (int i = 39; i >= 0; --i) {
+        TEST_ASSERT_TRUE (ypipe.unwrite (&value));
+        TEST_ASSERT_EQUAL_INT (i, value);
+    }
+    TEST_ASSERT_FALSE (ypipe.unwrite (&value));
+
+    ypipe.write (7, false);
+    ypipe.flush ();
+    TEST_ASSERT_TRUE (ypipe.read (&value));
+    TEST_ASSERT_EQUAL_INT (7, value);
+}
+
+void test_shared_chunk_pool ()
+{
+    //  Two pipes share a pool; once both have warmed it up, further
+    //  traffic is served from the cache and the cache stays bounded.
+    typedef zlink::ypipe_t<int, 16> pipe_t;
+    zlink::chunk_pool_t pool (zlink::yqueue_t<int, 16>::chunk_bytes (16), 4);
+    {
+        pipe_t a (16, &pool);
+        pipe_t b (16, &pool);
+        for (int round = 0; round < 8; ++round) {
+            pipe_t &ypipe = round % 2 ? b : a;
+            for (int i = 0; i < 100; ++i)
+                ypipe.write (i, false);
+            ypipe.flush ();
+            int value = -1;
+            for (int i = 0; i < 100; ++i) {
+                TEST_ASSERT_TRUE (ypipe.read (&value));
+                TEST_ASSERT_EQUAL_INT (i, value);
+            }
+            TEST_ASSERT_LESS_OR_EQUAL (4, pool.cached ());
+        }
+    }
+    TEST_ASSERT_GREATER_THAN (0, pool.hits ());
+    TEST_ASSERT_GREATER_THAN (0, pool.drops ());
+    TEST_ASSERT_EQUAL (4, pool.cached ());
+
+    //  Small chunks never go through the pool.
+    const uint64_t misses = pool.misses ();
+    {
+        pipe_t ypipe (2, &pool);
+        ypipe.write (1, false);
+        ypipe.write (2, false);
+        ypipe.flush ();
+    }
+    TEST_ASSERT_EQUAL (misses, pool.misses ());
+}
+
 int main (void)
 {
     setup_test_environment ();
@@ -65,6 +140,9 @@ int main (void)
     RUN_TEST (test_read_empty);
     RUN_TEST (test_write_complete_and_check_read_and_read);
     RUN_TEST (test_write_complete_and_flush_and_check_read_and_read);
+    RUN_TEST (test_small_initial_chunk);
+    RUN_TEST (test_small_initial_chunk_unwrite);
+    RUN_TEST (test_shared_chunk_pool);
 
     return UNITY_END ();
 }
@@ -85,6 +85,37 @@ void test_subscribe_cancel_invalid ()
                              decoder.error_code ());
 }
 
+void test_bulk_without_subscribe_invalid ()
+{
+    zlink::zmp_decoder_t decoder (64, -1);
+    unsigned char buf[zlink::zmp_header_size];
+    build_header (buf, zlink::zmp_flag_bulk, 0);
+    size_t processed = 0;
+    const int rc = decoder.decode (buf, sizeof (buf), processed);
+    TEST_ASSERT_EQUAL_INT (-1, rc);
+    TEST_ASSERT_EQUAL_INT (EPROTO, errno);
+    TEST_ASSERT_EQUAL_UINT8 (zlink::zmp_error_flags_invalid,
+                             decoder.error_code ());
+}
+
+void test_bulk_subscribe_cancel ()
+{
+    const unsigned char flags[] = {zlink::zmp_flag_subscribe,
+                                   zlink::zmp_flag_cancel};
+    for (size_t i = 0; i != sizeof flags; ++i) {
+        zlink::zmp_decoder_t decoder (64, -1);
+        unsigned char buf[zlink::zmp_header_size];
+        build_header (buf, flags[i] | zlink::zmp_flag_bulk, 0);
+        size_t processed = 0;
+        const int rc = decoder.decode (buf, sizeof (buf), processed);
+        TEST_ASSERT_EQUAL_INT (1, rc);
+        const zlink::msg_t *msg = decoder.msg ();
+        TEST_ASSERT_EQUAL (i == 0, msg->is_subscribe_bulk ());
+        TEST_ASSERT_EQUAL (i == 1, msg->is_cancel_bulk ());
+        TEST_ASSERT_FALSE (msg->is_subscribe () || msg->is_cancel ());
+    }
+}
+
 void test_body_too_large ()
 {
     zlink::zmp_decoder_t decoder (64, 16);
@@ -173,6 +204,8 @@ int main (void)
     RUN_TEST (test_version_mismatch);
     RUN_TEST (test_flags_invalid);
     RUN_TEST (test_subscribe_cancel_invalid);
+    RUN_TEST (test_bulk_without_subscribe_invalid);
+    RUN_TEST (test_bulk_subscribe_cancel);
     RUN_TEST (test_body_too_large);
     RUN_TEST (test_more_identity_allowed);
     RUN_TEST (test_metadata_parse_valid);